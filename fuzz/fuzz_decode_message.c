@@ -0,0 +1,45 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Fuzz target for decodeOpenDroneID() with single messages as received over
+ * Bluetooth legacy advertising. The decoders must agree with
+ * odid_validate_message() on which messages are valid.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <opendroneid.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    ODID_UAS_Data uas;
+    uint8_t *msg;
+
+    // Message packs are longer than one message, see fuzz_decode_pack.c
+    if (size != ODID_MESSAGE_SIZE || decodeMessageType(data[0]) == ODID_MESSAGETYPE_PACKED)
+        return 0;
+
+    // Exactly sized copy, so that the sanitizers catch reads past the end
+    msg = malloc(size);
+    if (!msg)
+        return 0;
+    memcpy(msg, data, size);
+
+    memset(&uas, 0, sizeof(uas));
+    ODID_messagetype_t type = decodeOpenDroneID(&uas, msg);
+    if ((type != ODID_MESSAGETYPE_INVALID) != (odid_validate_message(msg) != 0))
+        abort();
+
+    free(msg);
+    return 0;
+}
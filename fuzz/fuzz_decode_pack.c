@@ -0,0 +1,46 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Fuzz target for decodeMessagePack(). A pack that odid_validate_pack()
+ * accepts must decode, and a rejected pack must leave the output untouched.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <opendroneid.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    ODID_UAS_Data uas, before;
+    ODID_MessagePack_encoded *pack;
+
+    if (size > sizeof(*pack))
+        return 0;
+
+    // The API takes a whole pack structure, the received bytes fill its start
+    pack = calloc(1, sizeof(*pack));
+    if (!pack)
+        return 0;
+    memcpy(pack, data, size);
+
+    memset(&uas, 0x5A, sizeof(uas));
+    before = uas;
+    int ret = decodeMessagePack(&uas, pack);
+    if (odid_validate_pack((const uint8_t *) pack, size) && ret != ODID_SUCCESS)
+        abort();
+    if (ret != ODID_SUCCESS && memcmp(&uas, &before, sizeof(uas)) != 0)
+        abort();
+
+    free(pack);
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Fuzz target for odid_json_read_lines() and odid_json_read() with NDJSON as
+ * replayed from recordings. Every document that is read must be written back
+ * by odid_json_write() as a document that can be read again.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <opendroneid.h>
+
+#define FLAGS (ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID)
+
+static int checkDocument(void *user, const ODID_UAS_Data *uasData)
+{
+    static char buf[ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    ODID_UAS_Data again;
+
+    (void) user;
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    if (odid_json_write(&writer, uasData, FLAGS) != ODID_SUCCESS)
+        abort();
+    if (odid_json_read(&again, buf, writer.Length, NULL) != ODID_SUCCESS)
+        abort();
+    return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    char *json;
+
+    // Exactly sized copy without a null terminator, like a memory mapped file
+    json = malloc(size ? size : 1);
+    if (!json)
+        return 0;
+    memcpy(json, data, size);
+
+    odid_json_read_lines(json, size, checkDocument, NULL, NULL);
+
+    free(json);
+    return 0;
+}
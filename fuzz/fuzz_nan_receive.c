@@ -0,0 +1,54 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Fuzz target for odid_wifi_receive_message_pack_nan_action_frame() and
+ * odid_wifi_parse_message_pack_nan_action_frame(), with the received frame
+ * starting at the IEEE 802.11 management header. A frame is received if it
+ * parses and its message pack decodes.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <opendroneid.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    struct odid_nan_frame_view view;
+    ODID_UAS_Data uas;
+    char mac[6];
+    uint8_t *frame;
+
+    // Exactly sized copy, so that the sanitizers catch reads past the end
+    frame = malloc(size ? size : 1);
+    if (!frame)
+        return 0;
+    memcpy(frame, data, size);
+
+    memset(&uas, 0, sizeof(uas));
+    int received = odid_wifi_receive_message_pack_nan_action_frame(&uas, mac, frame, size) == 0;
+
+    int parsed = odid_wifi_parse_message_pack_nan_action_frame(&view, frame, size) == 0;
+    if (parsed) {
+        for (int i = 0; i < view.count; i++) {
+            if (view.messages[i] < frame || view.messages[i] + ODID_MESSAGE_SIZE > frame + size)
+                abort();
+        }
+        memset(&uas, 0, sizeof(uas));
+        parsed = decodeMessagePack(&uas, (ODID_MessagePack_encoded *) view.pack) == ODID_SUCCESS;
+    }
+    if (received != parsed)
+        abort();
+
+    free(frame);
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Fuzz target for the stream decoder. The first byte of the input gives the
+ * chunk size, the rest is pushed into the decoder in chunks of that size.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <opendroneid.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    ODID_Stream_decoder stream;
+    uint64_t consumed = 0;
+
+    if (size < 1)
+        return 0;
+
+    size_t chunk = (size_t) data[0] + 1;
+    data++;
+    size--;
+
+    odid_stream_init(&stream, NULL, NULL);
+    while (size > 0) {
+        size_t len = size < chunk ? size : chunk;
+        // Exactly sized copy, so that the sanitizers catch reads past the end
+        uint8_t *buf = malloc(len);
+        if (!buf)
+            return 0;
+        memcpy(buf, data, len);
+        odid_stream_push(&stream, buf, len);
+        free(buf);
+        data += len;
+        size -= len;
+        consumed += len;
+    }
+    odid_stream_flush(&stream);
+
+    // Every byte is either discarded or part of a decoded frame
+    if (stream.Length != 0 || stream.Discarded > consumed)
+        abort();
+    return 0;
+}
@@ -0,0 +1,38 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Fuzz target for odid_message_decode_pack(), the message pack parser of
+ * the Wi-Fi NAN frames.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <opendroneid.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    ODID_UAS_Data uas;
+    uint8_t *pack;
+
+    // Exactly sized copy, so that the sanitizers catch reads past the end
+    pack = malloc(size ? size : 1);
+    if (!pack)
+        return 0;
+    memcpy(pack, data, size);
+
+    memset(&uas, 0, sizeof(uas));
+    odid_message_decode_pack(&uas, pack, size);
+
+    free(pack);
+    return 0;
+}
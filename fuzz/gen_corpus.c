@@ -0,0 +1,146 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Writes the seed corpus of each fuzz target, using the messages of the
+ * simulator in test/opendroneid_sim.c, to <dir>/<target>/
+ */
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <opendroneid.h>
+
+#define SIM_STEPS 4
+
+// Simulator, in test/opendroneid_sim.c
+void ODID_getSimData(uint8_t *message, uint8_t msgType);
+extern ODID_BasicID_data basicID_data;
+extern ODID_Location_data location_data;
+extern ODID_Auth_data auth_data;
+extern ODID_SelfID_data selfID_data;
+extern ODID_System_data system_data;
+extern ODID_OperatorID_data operatorID_data;
+
+static const char *outDir;
+
+static int makeDir(const char *path)
+{
+    if (mkdir(path, 0755) != 0 && errno != EEXIST) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+static int writeSeed(const char *target, const char *name, int index,
+                     const void *data, size_t size)
+{
+    char path[4096];
+    FILE *f;
+
+    snprintf(path, sizeof(path), "%s/%s", outDir, target);
+    if (makeDir(path) != 0)
+        return -1;
+
+    snprintf(path, sizeof(path), "%s/%s/%s_%d", outDir, target, name, index);
+    f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    size_t written = fwrite(data, 1, size, f);
+    if (fclose(f) != 0 || written != size) {
+        perror(path);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    uint8_t msgs[ODID_MESSAGETYPE_OPERATOR_ID + 1][ODID_MESSAGE_SIZE];
+    ODID_MessagePack_data packData;
+    ODID_MessagePack_encoded pack;
+    ODID_UAS_Data uas;
+    uint8_t buf[1024];
+    char json[2 * ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    char mac[6] = { 0x02, 0x00, 0x00, 0x0D, 0x1D, 0x00 };
+    int errors = 0;
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s DIR\n", argv[0]);
+        return 2;
+    }
+    outDir = argv[1];
+    if (makeDir(outDir) != 0)
+        return 1;
+
+    for (int step = 0; step < SIM_STEPS; step++) {
+        for (uint8_t type = 0; type <= ODID_MESSAGETYPE_OPERATOR_ID; type++) {
+            ODID_getSimData(msgs[type], type);
+            errors += writeSeed("decode_message", "message", step * 6 + type,
+                                msgs[type], ODID_MESSAGE_SIZE);
+        }
+
+        // Packs with the first one, three and all six message types
+        packData.SingleMessageSize = ODID_MESSAGE_SIZE;
+        for (int count = 1; count <= ODID_MESSAGETYPE_OPERATOR_ID + 1; count += count == 1 ? 2 : 3) {
+            packData.MsgPackSize = (uint8_t) count;
+            for (int i = 0; i < count; i++)
+                memcpy(packData.Messages[i].rawData, msgs[i], ODID_MESSAGE_SIZE);
+            encodeMessagePack(&pack, &packData);
+            size_t size = offsetof(ODID_MessagePack_encoded, Messages) + (size_t) count * ODID_MESSAGE_SIZE;
+            errors += writeSeed("decode_pack", "pack", step * 10 + count, &pack, size);
+
+            // Stream of the pack and the single messages, in chunks of 7 bytes
+            buf[0] = 6;
+            memcpy(&buf[1], &pack, size);
+            memcpy(&buf[1 + size], msgs, sizeof(msgs));
+            errors += writeSeed("stream", "stream", step * 10 + count, buf, 1 + size + sizeof(msgs));
+        }
+
+        memset(&uas, 0, sizeof(uas));
+        uas.BasicID = basicID_data;
+        uas.Location = location_data;
+        uas.Auth[0] = auth_data;
+        uas.SelfID = selfID_data;
+        uas.System = system_data;
+        uas.OperatorID = operatorID_data;
+        uas.BasicIDValid = uas.LocationValid = uas.AuthValid[0] = 1;
+        uas.SelfIDValid = uas.SystemValid = uas.OperatorIDValid = 1;
+
+        int len = odid_message_encode_pack(&uas, buf, sizeof(buf));
+        if (len > 0)
+            errors += writeSeed("wifi_decode_pack", "pack", step, buf, (size_t) len);
+        else
+            errors++;
+
+        len = odid_wifi_build_message_pack_nan_action_frame(&uas, mac, (uint8_t) step, buf, sizeof(buf));
+        if (len > 0)
+            errors += writeSeed("nan_receive", "frame", step, buf, (size_t) len);
+        else
+            errors++;
+
+        // NDJSON with the exported schema, with and without the optional fields
+        odid_json_init(&writer, json, sizeof(json), NULL, NULL);
+        errors += odid_json_write(&writer, &uas, ODID_JSON_NEWLINE) != ODID_SUCCESS;
+        errors += odid_json_write(&writer, &uas, ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID |
+                                  ODID_JSON_NEWLINE) != ODID_SUCCESS;
+        errors += writeSeed("json_read", "lines", step, json, writer.Length);
+    }
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,171 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Standalone driver for the fuzz targets, for compilers without libFuzzer
+ * and for AFL++, e.g. afl-fuzz -i corpus -o findings -- ./fuzz_nan_receive_replay @@
+ *
+ * Runs the target on each input file, or on all files in each directory
+ * given, or on stdin without arguments. Every input is run a number of times
+ * to time it. The decode throughput is reported at the end, and inputs that
+ * take longer than the threshold are reported as slow. The exit code is 1 if
+ * there were slow inputs.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define REPLAY_MAX_INPUT (1 << 20)
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+struct replayStats {
+    int runs;               // Runs per input
+    double slowUs;          // Threshold for slow inputs, in microseconds per run
+    size_t inputs;
+    size_t bytes;
+    double seconds;
+    size_t slow;
+    double maxUs;
+    char maxPath[256];
+};
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static void runInput(struct replayStats *stats, const char *path, const uint8_t *data, size_t size)
+{
+    double start = now();
+    for (int r = 0; r < stats->runs; r++)
+        LLVMFuzzerTestOneInput(data, size);
+    double seconds = now() - start;
+    double us = seconds * 1e6 / stats->runs;
+
+    stats->inputs++;
+    stats->bytes += size * (size_t) stats->runs;
+    stats->seconds += seconds;
+    if (us > stats->maxUs) {
+        stats->maxUs = us;
+        snprintf(stats->maxPath, sizeof(stats->maxPath), "%s", path);
+    }
+    if (us > stats->slowUs) {
+        stats->slow++;
+        printf("Slow input: %s (%zu bytes, %.1f us)\n", path, size, us);
+    }
+}
+
+static int runFile(struct replayStats *stats, const char *path, FILE *f)
+{
+    static uint8_t data[REPLAY_MAX_INPUT];
+    size_t size = fread(data, 1, sizeof(data), f);
+
+    if (ferror(f)) {
+        perror(path);
+        return -1;
+    }
+    runInput(stats, path, data, size);
+    return 0;
+}
+
+static int runPath(struct replayStats *stats, const char *path)
+{
+    struct stat st;
+
+    if (stat(path, &st) != 0) {
+        perror(path);
+        return -1;
+    }
+
+    if (S_ISDIR(st.st_mode)) {
+        DIR *dir = opendir(path);
+        struct dirent *entry;
+        int ret = 0;
+
+        if (!dir) {
+            perror(path);
+            return -1;
+        }
+        while ((entry = readdir(dir)) != NULL) {
+            char file[4096];
+            if (entry->d_name[0] == '.')
+                continue;
+            snprintf(file, sizeof(file), "%s/%s", path, entry->d_name);
+            if (stat(file, &st) == 0 && S_ISREG(st.st_mode) && runPath(stats, file) != 0)
+                ret = -1;
+        }
+        closedir(dir);
+        return ret;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+    int ret = runFile(stats, path, f);
+    fclose(f);
+    return ret;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [-r RUNS] [-t SLOW_US] [FILE|DIR]...\n"
+            "  -r RUNS     Runs per input for timing (default 100)\n"
+            "  -t SLOW_US  Report inputs slower than this many microseconds (default 1000)\n"
+            "Without files the input is read from stdin\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+    struct replayStats stats = { .runs = 100, .slowUs = 1000 };
+    int i, ret = 0;
+
+    for (i = 1; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            stats.runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            stats.slowUs = atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (stats.runs <= 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (i == argc && runFile(&stats, "<stdin>", stdin) != 0)
+        ret = 2;
+    for (; i < argc; i++) {
+        if (runPath(&stats, argv[i]) != 0)
+            ret = 2;
+    }
+
+    if (stats.inputs > 0 && stats.seconds > 0) {
+        printf("%zu inputs, %.0f inputs/s, %.1f MB/s, slowest %.1f us (%s), %zu slow\n",
+               stats.inputs, stats.inputs * stats.runs / stats.seconds,
+               stats.bytes / stats.seconds / 1e6, stats.maxUs, stats.maxPath, stats.slow);
+    }
+    if (ret == 0 && stats.slow > 0)
+        ret = 1;
+    return ret;
+}
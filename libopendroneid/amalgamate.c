@@ -0,0 +1,293 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Generates opendroneid_single.h, a single header build of the library in the
+ * style of the stb libraries, from opendroneid.h, wire.h and the library
+ * sources:
+ *
+ *   odid_amalgamate <output> <opendroneid.h> <wire.h> <source.c>...
+ *
+ * The public functions and global constants defined in the sources get an
+ * ODIDDEF or ODIDVAR storage class, both in their definition and in their
+ * prototype in opendroneid.h, so that ODID_STATIC can turn them all into
+ * static (inline) definitions. The local includes of the sources are dropped
+ * and #line directives keep compiler messages pointing at the original files.
+ */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_LINE 1024
+#define MAX_NAMES 512
+#define MAX_NAME 64
+
+static char names[MAX_NAMES][MAX_NAME];
+static int nameCount;
+
+// Tracks /* */ comments across lines, so that comment text is never parsed
+static int inComment(const char *line, int *comment)
+{
+    int wasComment = *comment;
+    const char *p = line;
+
+    while (*p) {
+        if (*comment) {
+            p = strstr(p, "*/");
+            if (!p)
+                break;
+            *comment = 0;
+            p += 2;
+        } else {
+            const char *open = strstr(p, "/*");
+            const char *lineComment = strstr(p, "//");
+            if (!open || (lineComment && lineComment < open))
+                break;
+            *comment = 1;
+            p = open + 2;
+        }
+    }
+    return wasComment;
+}
+
+static const char *baseName(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+static int startsWithWord(const char *line, const char *word)
+{
+    size_t len = strlen(word);
+    return strncmp(line, word, len) == 0 && !isalnum((unsigned char) line[len]) && line[len] != '_';
+}
+
+/**
+* Check whether a line starts a file scope function or object declaration
+* without a storage class, the way this library writes them: at column 0,
+* with the return type and the name on the same line.
+*
+* @param line   Line of source code
+* @param name   Output: name of the declared function or object
+* @return       '(' for a function, '=' for an object, 0 otherwise
+*/
+static int declaration(const char *line, char *name)
+{
+    static const char *skip[] = { "static", "typedef", "struct", "enum", "union", "extern",
+                                  "return", "else", "if", "for", "while", "do", "switch" };
+    const char *paren, *assign, *end, *start;
+    int kind;
+
+    if (!isalpha((unsigned char) line[0]) && line[0] != '_')
+        return 0;
+    for (size_t i = 0; i < sizeof(skip) / sizeof(skip[0]); i++) {
+        if (startsWithWord(line, skip[i]))
+            return 0;
+    }
+
+    paren = strchr(line, '(');
+    assign = strchr(line, '=');
+    if (assign && (!paren || assign < paren)) {
+        end = assign;
+        kind = '=';
+    } else if (paren) {
+        end = paren;
+        kind = '(';
+    } else {
+        return 0;
+    }
+
+    // The name is the last identifier before the '(' or '=', skipping array sizes
+    while (end > line && (isspace((unsigned char) end[-1]) || end[-1] == ']')) {
+        if (end[-1] == ']') {
+            while (end > line && end[-1] != '[')
+                end--;
+        }
+        end--;
+    }
+    start = end;
+    while (start > line && (isalnum((unsigned char) start[-1]) || start[-1] == '_'))
+        start--;
+    if (start == end || start == line || end - start >= MAX_NAME)
+        return 0;
+
+    memcpy(name, start, (size_t) (end - start));
+    name[end - start] = 0;
+    return kind;
+}
+
+static int knownName(const char *name)
+{
+    for (int i = 0; i < nameCount; i++) {
+        if (strcmp(names[i], name) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+// Returns the storage class macro for a line that declares a library symbol
+static const char *storageClass(const char *line, int comment)
+{
+    char name[MAX_NAME];
+    int kind;
+
+    if (comment)
+        return NULL;
+    kind = declaration(line, name);
+    if (!kind || !knownName(name))
+        return NULL;
+    return kind == '(' ? "ODIDDEF " : "ODIDVAR ";
+}
+
+// First pass: collect the names of the functions and objects the sources define
+static int collectNames(const char *path)
+{
+    char line[MAX_LINE], name[MAX_NAME];
+    int comment = 0;
+    FILE *in = fopen(path, "r");
+
+    if (!in) {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), in)) {
+        size_t len = strlen(line);
+
+        if (inComment(line, &comment) || !declaration(line, name))
+            continue;
+        // Skip prototypes, only definitions count
+        while (len > 0 && isspace((unsigned char) line[len - 1]))
+            len--;
+        if (len > 0 && line[len - 1] == ';' && !strchr(line, '='))
+            continue;
+        if (!knownName(name)) {
+            if (nameCount == MAX_NAMES) {
+                fprintf(stderr, "%s: too many definitions\n", path);
+                fclose(in);
+                return -1;
+            }
+            strcpy(names[nameCount++], name);
+        }
+    }
+    fclose(in);
+    return 0;
+}
+
+/**
+* Copy a file to the output
+*
+* @param out        Output file
+* @param path       File to copy
+* @param sourceFile Non-zero to drop local includes and emit #line directives
+* @return           0 on success, -1 on failure
+*/
+static int copyFile(FILE *out, const char *path, int sourceFile)
+{
+    char line[MAX_LINE];
+    int comment = 0;
+    FILE *in = fopen(path, "r");
+
+    if (!in) {
+        perror(path);
+        return -1;
+    }
+    if (sourceFile)
+        fprintf(out, "#line 1 \"%s\"\n", baseName(path));
+    while (fgets(line, sizeof(line), in)) {
+        const char *storage = storageClass(line, inComment(line, &comment));
+
+        // Keep the line count for the #line directive
+        if (sourceFile && strncmp(line, "#include \"", 10) == 0) {
+            fputs("\n", out);
+            continue;
+        }
+        if (storage)
+            fputs(storage, out);
+        fputs(line, out);
+    }
+    fclose(in);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    FILE *out;
+    int ret = EXIT_FAILURE;
+
+    if (argc < 5) {
+        fprintf(stderr, "Usage: %s <output> <opendroneid.h> <wire.h> <source.c>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    for (int i = 4; i < argc; i++) {
+        if (collectNames(argv[i]) != 0)
+            return EXIT_FAILURE;
+    }
+
+    out = fopen(argv[1], "w");
+    if (!out) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(out, "/*\n"
+            " * Single header build of the Open Drone ID C Library, generated by\n"
+            " * odid_amalgamate from %s, %s and", baseName(argv[2]), baseName(argv[3]));
+    for (int i = 4; i < argc; i++)
+        fprintf(out, " %s", baseName(argv[i]));
+    fprintf(out, ".\n"
+            " * Do not edit.\n"
+            " *\n"
+            " * Include it anywhere for the declarations. In exactly one source file,\n"
+            " * #define ODID_IMPLEMENTATION before the include to compile the library\n"
+            " * into that file. Alternatively #define ODID_STATIC before every include\n"
+            " * to get a private static inline copy of the library in each file, which\n"
+            " * lets the compiler inline the encoders and decoders into the caller.\n"
+            " *\n"
+            " * Functions declared here but not defined by the sources above still need\n"
+            " * the library.\n"
+            " */\n\n"
+            "#ifndef _OPENDRONEID_SINGLE_H_\n"
+            "#define _OPENDRONEID_SINGLE_H_\n\n"
+            "#ifdef ODID_STATIC\n"
+            "#define ODIDDEF static inline\n"
+            "#define ODIDVAR static\n"
+            "#ifndef ODID_IMPLEMENTATION\n"
+            "#define ODID_IMPLEMENTATION\n"
+            "#endif\n"
+            "#else\n"
+            "#define ODIDDEF\n"
+            "#define ODIDVAR\n"
+            "#endif\n\n");
+    if (copyFile(out, argv[2], 0) != 0)
+        goto out;
+    fprintf(out, "\n#endif // _OPENDRONEID_SINGLE_H_\n\n"
+            "#if defined(ODID_IMPLEMENTATION) && !defined(_OPENDRONEID_SINGLE_IMPLEMENTATION_)\n"
+            "#define _OPENDRONEID_SINGLE_IMPLEMENTATION_\n\n");
+    if (copyFile(out, argv[3], 0) != 0)
+        goto out;
+    for (int i = 4; i < argc; i++) {
+        fputs("\n", out);
+        if (copyFile(out, argv[i], 1) != 0)
+            goto out;
+    }
+    fprintf(out, "\n#endif // ODID_IMPLEMENTATION\n");
+    ret = EXIT_SUCCESS;
+
+out:
+    if (fclose(out) != 0)
+        ret = EXIT_FAILURE;
+    if (ret != EXIT_SUCCESS)
+        remove(argv[1]);
+    return ret;
+}
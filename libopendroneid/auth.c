@@ -0,0 +1,254 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include "opendroneid.h"
+#include "wire.h"
+#include <string.h>
+
+/*
+ * Splitting authentication data into Auth pages and joining received pages
+ * back together. Both work on the encoded pages, as the authentication data
+ * is binary and may contain zero bytes, which the string based AuthData of
+ * ODID_Auth_data does not keep.
+ *
+ * The reassembly sets live in a table supplied by the caller. Each source is
+ * hashed to a short run of table entries, so finding its set takes a bounded
+ * number of steps however many sources there are.
+ */
+
+#define AUTH_PAGE_0_DATA_SIZE   (ODID_STR_SIZE - ODID_AUTH_PAGE_0_DATA_SIZE)
+#define AUTH_SET_PROBES         8
+
+// Offset of the data of a page in the complete authentication data
+static inline size_t pageOffset(int page)
+{
+    return page == 0 ? 0 : AUTH_PAGE_0_DATA_SIZE + (size_t) (page - 1) * ODID_STR_SIZE;
+}
+
+static inline size_t pageDataSize(int page)
+{
+    return page == 0 ? AUTH_PAGE_0_DATA_SIZE : ODID_STR_SIZE;
+}
+
+static inline const uint8_t *pageData(const uint8_t *msg, int page)
+{
+    return &msg[page == 0 ? ODID_AUTH_DATA_PAGE_0 : ODID_AUTH_DATA_PAGE_1_4];
+}
+
+/**
+* Split authentication data into encoded Auth pages
+*
+* The pages carry the page count, length and timestamp in page 0 and are
+* ready for broadcast. Unused bytes of the last page are set to zero.
+*
+* @param pages      Output: ODID_AUTH_MAX_PAGES encoded pages
+* @param authType   Type of the authentication data
+* @param timestamp  Page 0 timestamp, relative to 00:00:00 01/01/2019
+* @param data       The authentication data
+* @param len        Length of the data, at most ODID_AUTH_MAX_DATA_SIZE
+* @param pageCount  Output: Number of pages used
+* @return           ODID_SUCCESS or ODID_FAIL;
+*/
+int odid_auth_segment(ODID_Auth_encoded *pages, ODID_authtype_t authType,
+                      uint32_t timestamp, const uint8_t *data, size_t len,
+                      int *pageCount)
+{
+    if (!pages || (!data && len) || !pageCount || len == 0 ||
+        len > ODID_AUTH_MAX_DATA_SIZE || (unsigned) authType > 15)
+        return ODID_FAIL;
+
+    int count = 1;
+    while (pageOffset(count) < len)
+        count++;
+
+    for (int page = 0; page < count; page++) {
+        uint8_t *out = (uint8_t *) &pages[page];
+        size_t offset = pageOffset(page);
+        size_t size = len - offset < pageDataSize(page) ? len - offset : pageDataSize(page);
+
+        memset(out, 0, ODID_MESSAGE_SIZE);
+        out[0] = ODID_WIRE_HEADER(ODID_MESSAGETYPE_AUTH);
+        out[ODID_AUTH_TYPE_PAGE] = ODID_WIRE_NIBBLES(authType, page);
+        if (page == 0) {
+            out[ODID_AUTH_PAGE_COUNT] = (uint8_t) count;
+            out[ODID_AUTH_LENGTH] = (uint8_t) len;
+            odid_put_le32(&out[ODID_AUTH_TIMESTAMP], timestamp);
+        }
+        memcpy((uint8_t *) pageData(out, page), &data[offset], size);
+    }
+    *pageCount = count;
+    return ODID_SUCCESS;
+}
+
+/**
+* Initialize an Auth page reassembly context
+*
+* @param ctx        Reassembly context
+* @param sets       Table for the partial sets, one per source at a time
+* @param count      Number of entries in the table
+* @param timeout    Partial sets without new pages for longer than this are
+*                   dropped. In the time unit used for odid_auth_reassemble()
+*/
+void odid_auth_reassembly_init(ODID_Auth_reassembly *ctx, ODID_Auth_set *sets,
+                               size_t count, uint32_t timeout)
+{
+    if (!ctx)
+        return;
+
+    ctx->Sets = sets;
+    ctx->Count = sets ? count : 0;
+    ctx->Timeout = timeout;
+    if (ctx->Count)
+        memset(sets, 0, count * sizeof(*sets));
+}
+
+static inline int setExpired(const ODID_Auth_reassembly *ctx, const ODID_Auth_set *set, uint32_t now)
+{
+    return now - set->LastUpdate > ctx->Timeout;
+}
+
+/**
+* Find the set of a source, or a free or the least recently updated entry
+* for it among the entries its hash maps to
+*
+* @param ctx    Reassembly context
+* @param source Source of the page
+* @param now    Current time
+* @return       The set, cleared if it is not the source's own
+*/
+static ODID_Auth_set *findSet(ODID_Auth_reassembly *ctx, uint64_t source, uint32_t now)
+{
+    size_t index = (size_t) ((source * 0x9E3779B97F4A7C15ULL) >> 32) % ctx->Count;
+    ODID_Auth_set *reuse = NULL;
+
+    for (int i = 0; i < AUTH_SET_PROBES && (size_t) i < ctx->Count; i++) {
+        ODID_Auth_set *set = &ctx->Sets[index];
+
+        if (set->InUse && set->Source == source) {
+            if (!setExpired(ctx, set, now))
+                return set;
+            reuse = set;
+            break;
+        }
+        if (!set->InUse || setExpired(ctx, set, now)) {
+            if (!reuse || reuse->InUse)
+                reuse = set;
+        } else if (!reuse || (reuse->InUse && now - set->LastUpdate > now - reuse->LastUpdate)) {
+            reuse = set;
+        }
+        if (++index == ctx->Count)
+            index = 0;
+    }
+
+    memset(reuse, 0, sizeof(*reuse));
+    reuse->InUse = 1;
+    reuse->Source = source;
+    return reuse;
+}
+
+/**
+* Check whether a page holds the same contents as the one already in the set
+*/
+static int samePage(const ODID_Auth_set *set, const uint8_t *msg, int page)
+{
+    if (page == 0 &&
+        (msg[ODID_AUTH_PAGE_COUNT] != set->PageCount ||
+         msg[ODID_AUTH_LENGTH] != set->Length ||
+         odid_get_le32(&msg[ODID_AUTH_TIMESTAMP]) != set->Timestamp))
+        return 0;
+    return memcmp(&set->AuthData[pageOffset(page)], pageData(msg, page), pageDataSize(page)) == 0;
+}
+
+/**
+* Add a received Auth page to the set of its source
+*
+* A page that differs from the one already received for its position, is
+* beyond the page count or has a different authentication type starts a new
+* set: the source has moved on to new authentication data.
+*
+* @param ctx    Reassembly context
+* @param source Identifies the sender, e.g. its MAC address
+* @param auth   The encoded Auth page
+* @param now    Receive time, in the unit of the timeout
+* @return       The set when this page completes it, otherwise NULL. The
+*               authentication data is in AuthData, Length bytes long
+*/
+const ODID_Auth_set *odid_auth_reassemble(ODID_Auth_reassembly *ctx, uint64_t source,
+                                          const ODID_Auth_encoded *auth, uint32_t now)
+{
+    const uint8_t *msg = (const uint8_t *) auth;
+
+    if (!ctx || !ctx->Count || !msg || ODID_WIRE_TYPE(msg[0]) != ODID_MESSAGETYPE_AUTH)
+        return NULL;
+
+    int page = msg[ODID_AUTH_TYPE_PAGE] & 0x0F;
+    ODID_authtype_t authType = (ODID_authtype_t) (msg[ODID_AUTH_TYPE_PAGE] >> 4);
+    if (page >= ODID_AUTH_MAX_PAGES)
+        return NULL;
+    if (page == 0) {
+        uint8_t count = msg[ODID_AUTH_PAGE_COUNT];
+        uint8_t length = msg[ODID_AUTH_LENGTH];
+        if (count == 0 || count > ODID_AUTH_MAX_PAGES ||
+            length == 0 || length > pageOffset(count - 1) + pageDataSize(count - 1))
+            return NULL;
+    }
+
+    ODID_Auth_set *set = findSet(ctx, source, now);
+    uint8_t bit = (uint8_t) (1 << page);
+
+    if (set->Pages && (set->AuthType != authType ||
+                       ((set->Pages & 1) && page >= set->PageCount) ||
+                       ((set->Pages & bit) && !samePage(set, msg, page)))) {
+        set->Pages = 0;
+        set->Complete = 0;
+    }
+    set->AuthType = authType;
+    set->LastUpdate = now;
+
+    if (set->Pages & bit)
+        return NULL;
+
+    set->Pages |= bit;
+    memcpy(&set->AuthData[pageOffset(page)], pageData(msg, page), pageDataSize(page));
+    if (page == 0) {
+        set->PageCount = msg[ODID_AUTH_PAGE_COUNT];
+        set->Length = msg[ODID_AUTH_LENGTH];
+        set->Timestamp = odid_get_le32(&msg[ODID_AUTH_TIMESTAMP]);
+        set->Pages &= (uint8_t) ((1 << set->PageCount) - 1);
+    }
+
+    if ((set->Pages & 1) && set->Pages == (uint8_t) ((1 << set->PageCount) - 1)) {
+        set->Complete = 1;
+        return set;
+    }
+    return NULL;
+}
+
+/**
+* Drop all partial sets that have not received a page within the timeout
+*
+* This is not needed for correctness, expired sets are also dropped when
+* their table entries are reused. It visits every entry of the table.
+*
+* @param ctx    Reassembly context
+* @param now    Current time
+*/
+void odid_auth_expire(ODID_Auth_reassembly *ctx, uint32_t now)
+{
+    if (!ctx)
+        return;
+
+    for (size_t i = 0; i < ctx->Count; i++) {
+        if (ctx->Sets[i].InUse && setExpired(ctx, &ctx->Sets[i], now))
+            ctx->Sets[i].InUse = 0;
+    }
+}
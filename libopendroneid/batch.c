@@ -0,0 +1,511 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include "opendroneid.h"
+#include "wire.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ODID_VEC_AVX2
+#define ODID_VEC_WIDTH 8
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define ODID_VEC_SSE
+#define ODID_VEC_WIDTH 4
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define ODID_VEC_NEON
+#define ODID_VEC_WIDTH 4
+#else
+#define ODID_VEC_WIDTH 4
+#endif
+
+// Must match the constants used by the scalar encoders in opendroneid.c
+#define BATCH_SPEED_DIV_LOW 0.25f
+#define BATCH_SPEED_DIV_HIGH 0.75f
+#define BATCH_SPEED_LOW_MAX (UINT8_MAX * BATCH_SPEED_DIV_LOW)
+#define BATCH_LATLON_MULT 10000000
+#define BATCH_ALT_ADDER 1000
+
+/*
+ * The lanes of one chunk of Location messages, in structure of arrays form.
+ * The float/double inputs are gathered here, quantized in place by the
+ * vector kernel and then scattered into the packed output structures.
+ */
+typedef struct {
+    float Direction[ODID_VEC_WIDTH];
+    float SpeedHorizontal[ODID_VEC_WIDTH];
+    float SpeedVertical[ODID_VEC_WIDTH];
+    double Latitude[ODID_VEC_WIDTH];
+    double Longitude[ODID_VEC_WIDTH];
+    float AltitudeBaro[ODID_VEC_WIDTH];
+    float AltitudeGeo[ODID_VEC_WIDTH];
+    float Height[ODID_VEC_WIDTH];
+    float TimeStamp[ODID_VEC_WIDTH];
+
+    int32_t DirectionEnc[ODID_VEC_WIDTH];
+    int32_t SpeedLowEnc[ODID_VEC_WIDTH];
+    int32_t SpeedHighEnc[ODID_VEC_WIDTH];
+    int32_t SpeedMult[ODID_VEC_WIDTH];
+    int32_t SpeedVerticalEnc[ODID_VEC_WIDTH];
+    int32_t LatitudeEnc[ODID_VEC_WIDTH];
+    int32_t LongitudeEnc[ODID_VEC_WIDTH];
+    int32_t AltitudeBaroEnc[ODID_VEC_WIDTH];
+    int32_t AltitudeGeoEnc[ODID_VEC_WIDTH];
+    int32_t HeightEnc[ODID_VEC_WIDTH];
+    int32_t TimeStampEnc[ODID_VEC_WIDTH];
+} location_lanes;
+
+/*
+ * Minimal vector abstraction used by the quantization kernel. VF is a vector of
+ * ODID_VEC_WIDTH floats, VI the same number of int32 lanes and VD holds half of
+ * them as doubles. Conversions truncate towards zero, like the C casts used by
+ * the scalar encoders.
+ */
+#if defined(ODID_VEC_AVX2)
+typedef __m256 VF;
+typedef __m256i VI;
+#define VD_WIDTH 4
+#define vf_load(p)          _mm256_loadu_ps(p)
+#define vf_set1(x)          _mm256_set1_ps(x)
+#define vf_add(a, b)        _mm256_add_ps(a, b)
+#define vf_sub(a, b)        _mm256_sub_ps(a, b)
+#define vf_mul(a, b)        _mm256_mul_ps(a, b)
+#define vf_div(a, b)        _mm256_div_ps(a, b)
+#define vf_min(a, b)        _mm256_min_ps(a, b)
+#define vf_max(a, b)        _mm256_max_ps(a, b)
+#define vf_cvtt(a)          _mm256_cvttps_epi32(a)
+#define vi_cvt(a)           _mm256_cvtepi32_ps(a)
+#define vi_store(p, a)      _mm256_storeu_si256((__m256i *) (p), a)
+#define vi_ge_mask(a, b)    _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_GE_OQ))
+#define vi_gt_mask(a, b)    _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_GT_OQ))
+#define vi_sub(a, b)        _mm256_sub_epi32(a, b)
+#define vd_latlon(out, in) do { \
+        __m256d v_ = _mm256_mul_pd(_mm256_loadu_pd(in), _mm256_set1_pd(BATCH_LATLON_MULT)); \
+        v_ = _mm256_max_pd(v_, _mm256_set1_pd(-180.0 * BATCH_LATLON_MULT)); \
+        v_ = _mm256_min_pd(v_, _mm256_set1_pd(180.0 * BATCH_LATLON_MULT)); \
+        _mm_storeu_si128((__m128i *) (out), _mm256_cvttpd_epi32(v_)); \
+    } while (0)
+#elif defined(ODID_VEC_SSE)
+typedef __m128 VF;
+typedef __m128i VI;
+#define VD_WIDTH 2
+#define vf_load(p)          _mm_loadu_ps(p)
+#define vf_set1(x)          _mm_set1_ps(x)
+#define vf_add(a, b)        _mm_add_ps(a, b)
+#define vf_sub(a, b)        _mm_sub_ps(a, b)
+#define vf_mul(a, b)        _mm_mul_ps(a, b)
+#define vf_div(a, b)        _mm_div_ps(a, b)
+#define vf_min(a, b)        _mm_min_ps(a, b)
+#define vf_max(a, b)        _mm_max_ps(a, b)
+#define vf_cvtt(a)          _mm_cvttps_epi32(a)
+#define vi_cvt(a)           _mm_cvtepi32_ps(a)
+#define vi_store(p, a)      _mm_storeu_si128((__m128i *) (p), a)
+#define vi_ge_mask(a, b)    _mm_castps_si128(_mm_cmpge_ps(a, b))
+#define vi_gt_mask(a, b)    _mm_castps_si128(_mm_cmpgt_ps(a, b))
+#define vi_sub(a, b)        _mm_sub_epi32(a, b)
+#define vd_latlon(out, in) do { \
+        __m128d v_ = _mm_mul_pd(_mm_loadu_pd(in), _mm_set1_pd(BATCH_LATLON_MULT)); \
+        v_ = _mm_max_pd(v_, _mm_set1_pd(-180.0 * BATCH_LATLON_MULT)); \
+        v_ = _mm_min_pd(v_, _mm_set1_pd(180.0 * BATCH_LATLON_MULT)); \
+        _mm_storel_epi64((__m128i *) (out), _mm_cvttpd_epi32(v_)); \
+    } while (0)
+#elif defined(ODID_VEC_NEON)
+typedef float32x4_t VF;
+typedef int32x4_t VI;
+#define VD_WIDTH 2
+#define vf_load(p)          vld1q_f32(p)
+#define vf_set1(x)          vdupq_n_f32(x)
+#define vf_add(a, b)        vaddq_f32(a, b)
+#define vf_sub(a, b)        vsubq_f32(a, b)
+#define vf_mul(a, b)        vmulq_f32(a, b)
+#define vf_div(a, b)        vdivq_f32(a, b)
+#define vf_min(a, b)        vminq_f32(a, b)
+#define vf_max(a, b)        vmaxq_f32(a, b)
+#define vf_cvtt(a)          vcvtq_s32_f32(a)
+#define vi_cvt(a)           vcvtq_f32_s32(a)
+#define vi_store(p, a)      vst1q_s32(p, a)
+#define vi_ge_mask(a, b)    vreinterpretq_s32_u32(vcgeq_f32(a, b))
+#define vi_gt_mask(a, b)    vreinterpretq_s32_u32(vcgtq_f32(a, b))
+#define vi_sub(a, b)        vsubq_s32(a, b)
+#define vd_latlon(out, in) do { \
+        float64x2_t v_ = vmulq_f64(vld1q_f64(in), vdupq_n_f64(BATCH_LATLON_MULT)); \
+        v_ = vmaxq_f64(v_, vdupq_n_f64(-180.0 * BATCH_LATLON_MULT)); \
+        v_ = vminq_f64(v_, vdupq_n_f64(180.0 * BATCH_LATLON_MULT)); \
+        vst1_s32(out, vmovn_s64(vcvtq_s64_f64(v_))); \
+    } while (0)
+#endif
+
+#if defined(ODID_VEC_AVX2) || defined(ODID_VEC_SSE) || defined(ODID_VEC_NEON)
+
+/**
+* Round non-negative lanes half away from zero, like roundf()/round() do
+*
+* The lanes must already be clamped to a range that fits an int32. Truncating
+* and then comparing the exact fractional part avoids the round-half-to-even
+* behavior of the native vector rounding instructions.
+*/
+static inline VI vf_round_pos(VF x)
+{
+    VI t = vf_cvtt(x);
+    VF frac = vf_sub(x, vi_cvt(t));
+    // The comparison mask is -1 where the fraction is >= 0.5
+    return vi_sub(t, vi_ge_mask(frac, vf_set1(0.5f)));
+}
+
+/**
+* Quantize one chunk of Location lanes into their integer wire values
+*
+* Each field is clamped in the same order and with the same bounds as the
+* corresponding scalar encoder in opendroneid.c, which makes clamping before
+* the float to integer conversion equivalent to the scalar clamp afterwards.
+*/
+static void quantizeLocationLanes(location_lanes *l)
+{
+    VF v;
+
+    v = vf_load(l->Direction);
+    v = vf_min(vf_max(v, vf_set1(0)), vf_set1(361));
+    vi_store(l->DirectionEnc, vf_round_pos(v));
+
+    v = vf_load(l->SpeedHorizontal);
+    v = vf_min(vf_max(v, vf_set1(0)), vf_set1(255));
+    vi_store(l->SpeedLowEnc, vf_cvtt(vf_div(v, vf_set1(BATCH_SPEED_DIV_LOW))));
+    vi_store(l->SpeedHighEnc, vf_cvtt(vf_div(vf_sub(v, vf_set1(BATCH_SPEED_LOW_MAX)),
+                                             vf_set1(BATCH_SPEED_DIV_HIGH))));
+    vi_store(l->SpeedMult, vi_gt_mask(v, vf_set1(BATCH_SPEED_LOW_MAX)));
+
+    v = vf_load(l->SpeedVertical);
+    v = vf_min(vf_max(v, vf_set1(-63)), vf_set1(63));
+    vi_store(l->SpeedVerticalEnc, vf_cvtt(vf_div(v, vf_set1(0.5f))));
+
+    v = vf_load(l->AltitudeBaro);
+    v = vf_min(vf_max(v, vf_set1(-1000)), vf_set1(31767.5f));
+    vi_store(l->AltitudeBaroEnc, vf_cvtt(vf_div(vf_add(v, vf_set1(BATCH_ALT_ADDER)), vf_set1(0.5f))));
+
+    v = vf_load(l->AltitudeGeo);
+    v = vf_min(vf_max(v, vf_set1(-1000)), vf_set1(31767.5f));
+    vi_store(l->AltitudeGeoEnc, vf_cvtt(vf_div(vf_add(v, vf_set1(BATCH_ALT_ADDER)), vf_set1(0.5f))));
+
+    v = vf_load(l->Height);
+    v = vf_min(vf_max(v, vf_set1(-1000)), vf_set1(31767.5f));
+    vi_store(l->HeightEnc, vf_cvtt(vf_div(vf_add(v, vf_set1(BATCH_ALT_ADDER)), vf_set1(0.5f))));
+
+    v = vf_mul(vf_load(l->TimeStamp), vf_set1(10));
+    v = vf_min(vf_max(v, vf_set1(0)), vf_set1(60 * 60 * 10));
+    vi_store(l->TimeStampEnc, vf_round_pos(v));
+
+    for (int i = 0; i < ODID_VEC_WIDTH; i += VD_WIDTH) {
+        vd_latlon(&l->LatitudeEnc[i], &l->Latitude[i]);
+        vd_latlon(&l->LongitudeEnc[i], &l->Longitude[i]);
+    }
+}
+
+#else // No vector unit available
+
+static int32_t clampInt32(int64_t value, int32_t min, int32_t max)
+{
+    return value < min ? min : (value > max ? max : (int32_t) value);
+}
+
+static float clampFloat(float value, float min, float max)
+{
+    if (value < min)
+        value = min;
+    if (value > max)
+        value = max;
+    return value;
+}
+
+/**
+* Scalar version of the quantization kernel for targets without a vector unit
+*/
+static void quantizeLocationLanes(location_lanes *l)
+{
+    for (int i = 0; i < ODID_VEC_WIDTH; i++) {
+        float v = clampFloat(l->Direction[i], 0, 361);
+        l->DirectionEnc[i] = (int32_t) roundf(v);
+
+        v = clampFloat(l->SpeedHorizontal[i], 0, 255);
+        l->SpeedLowEnc[i] = (int32_t) (v / BATCH_SPEED_DIV_LOW);
+        l->SpeedHighEnc[i] = (int32_t) ((v - BATCH_SPEED_LOW_MAX) / BATCH_SPEED_DIV_HIGH);
+        l->SpeedMult[i] = v > BATCH_SPEED_LOW_MAX ? -1 : 0;
+
+        v = clampFloat(l->SpeedVertical[i], -63, 63);
+        l->SpeedVerticalEnc[i] = (int32_t) (v / 0.5f);
+
+        v = clampFloat(l->AltitudeBaro[i], -1000, 31767.5f);
+        l->AltitudeBaroEnc[i] = (int32_t) ((v + BATCH_ALT_ADDER) / 0.5f);
+        v = clampFloat(l->AltitudeGeo[i], -1000, 31767.5f);
+        l->AltitudeGeoEnc[i] = (int32_t) ((v + BATCH_ALT_ADDER) / 0.5f);
+        v = clampFloat(l->Height[i], -1000, 31767.5f);
+        l->HeightEnc[i] = (int32_t) ((v + BATCH_ALT_ADDER) / 0.5f);
+
+        l->TimeStampEnc[i] = (int32_t) round(clampFloat(l->TimeStamp[i] * 10, 0, 60 * 60 * 10));
+
+        l->LatitudeEnc[i] = clampInt32(l->Latitude[i] * BATCH_LATLON_MULT,
+                                       -180 * BATCH_LATLON_MULT, 180 * BATCH_LATLON_MULT);
+        l->LongitudeEnc[i] = clampInt32(l->Longitude[i] * BATCH_LATLON_MULT,
+                                        -180 * BATCH_LATLON_MULT, 180 * BATCH_LATLON_MULT);
+    }
+}
+
+#endif
+
+/**
+* Check whether a Location record can take the vectorized path
+*
+* Records with out of range enums are left to encodeLocationMessage(), which
+* rejects them. So are records with NaN/Inf or with a latitude, longitude or
+* timestamp too large to be converted to an integer, since the result of that
+* conversion is platform dependent in the scalar encoders.
+*
+* @param in Input data (non encoded/packed) structure
+* @return   1 = yes, 0 = no
+*/
+static int locationIsVectorSafe(const ODID_Location_data *in)
+{
+    if ((unsigned) in->Status > 15 || (unsigned) in->HeightType > 1 ||
+        (unsigned) in->HorizAccuracy > 15 || (unsigned) in->VertAccuracy > 15 ||
+        (unsigned) in->BaroAccuracy > 15 || (unsigned) in->SpeedAccuracy > 15 ||
+        (unsigned) in->TSAccuracy > 15)
+        return 0;
+
+    return fabs(in->Latitude) < 1e11 && fabs(in->Longitude) < 1e11 &&
+           fabsf(in->TimeStamp) < 1e17f &&
+           fabsf(in->Direction) <= FLT_MAX && fabsf(in->SpeedHorizontal) <= FLT_MAX &&
+           fabsf(in->SpeedVertical) <= FLT_MAX && fabsf(in->AltitudeBaro) <= FLT_MAX &&
+           fabsf(in->AltitudeGeo) <= FLT_MAX && fabsf(in->Height) <= FLT_MAX;
+}
+
+static void gatherLocationLane(location_lanes *l, int lane, const ODID_Location_data *in)
+{
+    l->Direction[lane] = in->Direction;
+    l->SpeedHorizontal[lane] = in->SpeedHorizontal;
+    l->SpeedVertical[lane] = in->SpeedVertical;
+    l->Latitude[lane] = in->Latitude;
+    l->Longitude[lane] = in->Longitude;
+    l->AltitudeBaro[lane] = in->AltitudeBaro;
+    l->AltitudeGeo[lane] = in->AltitudeGeo;
+    l->Height[lane] = in->Height;
+    l->TimeStamp[lane] = in->TimeStamp;
+}
+
+static uint8_t clampUint8(int32_t value)
+{
+    return value < 0 ? 0 : (value > UINT8_MAX ? UINT8_MAX : (uint8_t) value);
+}
+
+/**
+* Write one quantized lane into a packed Location message
+*
+* Every field is assigned, in the same way as encodeLocationMessage() does,
+* so the output is byte-identical to the single message encoder. With
+* ODID_BYTE_CODEC the fields are stored byte by byte at their wire offsets.
+*/
+static void scatterLocationLane(ODID_Location_encoded *out, const location_lanes *l,
+                                int lane, const ODID_Location_data *in)
+{
+    int32_t direction = l->DirectionEnc[lane];
+    int speedMult = l->SpeedMult[lane] != 0;
+    uint8_t speed = speedMult ? clampUint8(l->SpeedHighEnc[lane]) : (uint8_t) l->SpeedLowEnc[lane];
+
+#ifdef ODID_BYTE_CODEC
+    uint8_t *bytes = (uint8_t *) out;
+    bytes[0] = ODID_WIRE_HEADER(ODID_MESSAGETYPE_LOCATION);
+    bytes[ODID_LOC_FLAGS] = (uint8_t) ((in->Status & 0x0F) << 4) |
+                            (in->HeightType & 0x01 ? ODID_LOC_FLAG_HEIGHT_TYPE : 0) |
+                            (direction >= 180 ? ODID_LOC_FLAG_EW_DIRECTION : 0) |
+                            (speedMult ? ODID_LOC_FLAG_SPEED_MULT : 0);
+    bytes[ODID_LOC_DIRECTION] = clampUint8(direction >= 180 ? direction - 180 : direction);
+    bytes[ODID_LOC_SPEED_HORIZONTAL] = speed;
+    bytes[ODID_LOC_SPEED_VERTICAL] = (uint8_t) l->SpeedVerticalEnc[lane];
+    odid_put_le32(&bytes[ODID_LOC_LATITUDE], (uint32_t) l->LatitudeEnc[lane]);
+    odid_put_le32(&bytes[ODID_LOC_LONGITUDE], (uint32_t) l->LongitudeEnc[lane]);
+    odid_put_le16(&bytes[ODID_LOC_ALTITUDE_BARO], (uint16_t) l->AltitudeBaroEnc[lane]);
+    odid_put_le16(&bytes[ODID_LOC_ALTITUDE_GEO], (uint16_t) l->AltitudeGeoEnc[lane]);
+    odid_put_le16(&bytes[ODID_LOC_HEIGHT], (uint16_t) l->HeightEnc[lane]);
+    bytes[ODID_LOC_HV_ACCURACY] = ODID_WIRE_NIBBLES(in->VertAccuracy, in->HorizAccuracy);
+    bytes[ODID_LOC_BS_ACCURACY] = ODID_WIRE_NIBBLES(in->BaroAccuracy, in->SpeedAccuracy);
+    odid_put_le16(&bytes[ODID_LOC_TIMESTAMP], (uint16_t) l->TimeStampEnc[lane]);
+    bytes[ODID_LOC_TS_ACCURACY] = ODID_WIRE_NIBBLES(0, in->TSAccuracy);
+    bytes[ODID_LOC_RESERVED3] = 0;
+#else
+    out->MessageType = ODID_MESSAGETYPE_LOCATION;
+    out->ProtoVersion = ODID_PROTOCOL_VERSION;
+    out->Status = in->Status;
+    out->Reserved = 0;
+    out->EWDirection = direction >= 180;
+    out->Direction = clampUint8(direction >= 180 ? direction - 180 : direction);
+    out->SpeedMult = speedMult;
+    out->SpeedHorizontal = speed;
+    out->SpeedVertical = (int8_t) l->SpeedVerticalEnc[lane];
+    out->Latitude = l->LatitudeEnc[lane];
+    out->Longitude = l->LongitudeEnc[lane];
+    out->AltitudeBaro = (uint16_t) l->AltitudeBaroEnc[lane];
+    out->AltitudeGeo = (uint16_t) l->AltitudeGeoEnc[lane];
+    out->HeightType = in->HeightType;
+    out->Height = (uint16_t) l->HeightEnc[lane];
+    out->HorizAccuracy = in->HorizAccuracy;
+    out->VertAccuracy = in->VertAccuracy;
+    out->BaroAccuracy = in->BaroAccuracy;
+    out->SpeedAccuracy = in->SpeedAccuracy;
+    out->TSAccuracy = in->TSAccuracy;
+    out->Reserved2 = 0;
+    out->TimeStamp = (uint16_t) l->TimeStampEnc[lane];
+    out->Reserved3 = 0;
+#endif
+}
+
+/**
+* Encode an array of Location messages (packed, ready for broadcast)
+*
+* The output is byte-identical to calling encodeLocationMessage() on each
+* element. The float to integer quantization is done for several messages at
+* once, using AVX2, SSE or NEON when the compiler targets them. Messages that
+* fail validation leave their output element untouched.
+*
+* @param outEncoded Output (encoded/packed) array of n structures
+* @param inData     Input data (non encoded/packed) array of n structures
+* @param n          Number of messages to encode
+* @return           ODID_SUCCESS if all messages were encoded, otherwise ODID_FAIL
+*/
+int encodeLocationMessageBatch(ODID_Location_encoded *outEncoded,
+                               const ODID_Location_data *inData, size_t n)
+{
+    location_lanes lanes;
+    size_t index[ODID_VEC_WIDTH];
+    int ret = ODID_SUCCESS;
+    int used = 0;
+
+    if (!outEncoded || !inData)
+        return ODID_FAIL;
+
+    memset(&lanes, 0, sizeof(lanes));
+    for (size_t i = 0; i < n; i++) {
+        if (!locationIsVectorSafe(&inData[i])) {
+            if (encodeLocationMessage(&outEncoded[i], (ODID_Location_data *) &inData[i]) != ODID_SUCCESS)
+                ret = ODID_FAIL;
+            continue;
+        }
+
+        gatherLocationLane(&lanes, used, &inData[i]);
+        index[used++] = i;
+        if (used == ODID_VEC_WIDTH) {
+            quantizeLocationLanes(&lanes);
+            for (int lane = 0; lane < used; lane++)
+                scatterLocationLane(&outEncoded[index[lane]], &lanes, lane, &inData[index[lane]]);
+            used = 0;
+        }
+    }
+
+    if (used > 0) {
+        // Unused lanes keep stale but finite values, which are simply ignored
+        quantizeLocationLanes(&lanes);
+        for (int lane = 0; lane < used; lane++)
+            scatterLocationLane(&outEncoded[index[lane]], &lanes, lane, &inData[index[lane]]);
+    }
+    return ret;
+}
+
+/**
+* Classify the message type nibble of a buffer of back-to-back messages
+*
+* With AVX2 the first bytes of eight messages are gathered and shifted at once.
+* Message pack headers are marked invalid since a pack does not fit in a
+* single ODID_MESSAGE_SIZE slot.
+*
+* @param types  Output: one ODID_messagetype_t per message
+* @param msgs   Buffer with count * ODID_MESSAGE_SIZE bytes
+* @param count  Number of messages in the buffer
+*/
+static void classifyMessages(ODID_messagetype_t *types, const uint8_t *msgs, size_t count)
+{
+    size_t i = 0;
+
+#if defined(ODID_VEC_AVX2)
+    const __m256i offsets = _mm256_setr_epi32(0, 1 * ODID_MESSAGE_SIZE, 2 * ODID_MESSAGE_SIZE,
+                                              3 * ODID_MESSAGE_SIZE, 4 * ODID_MESSAGE_SIZE,
+                                              5 * ODID_MESSAGE_SIZE, 6 * ODID_MESSAGE_SIZE,
+                                              7 * ODID_MESSAGE_SIZE);
+    const __m256i lastType = _mm256_set1_epi32(ODID_MESSAGETYPE_OPERATOR_ID);
+    int32_t lanes[8];
+
+    // The gather loads four bytes per message, all within that message
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_i32gather_epi32((const int *) (msgs + i * ODID_MESSAGE_SIZE), offsets, 1);
+        v = _mm256_srli_epi32(_mm256_and_si256(v, _mm256_set1_epi32(0xF0)), 4);
+        // Lanes above the last regular message type become ODID_MESSAGETYPE_INVALID
+        v = _mm256_or_si256(v, _mm256_and_si256(_mm256_cmpgt_epi32(v, lastType),
+                                                _mm256_set1_epi32(ODID_MESSAGETYPE_INVALID)));
+        _mm256_storeu_si256((__m256i *) lanes, v);
+        for (int lane = 0; lane < 8; lane++)
+            types[i + lane] = (ODID_messagetype_t) (lanes[lane] & 0xFF);
+    }
+#endif
+
+    for (; i < count; i++) {
+        ODID_messagetype_t type = decodeMessageType(msgs[i * ODID_MESSAGE_SIZE]);
+        types[i] = type == ODID_MESSAGETYPE_PACKED ? ODID_MESSAGETYPE_INVALID : type;
+    }
+}
+
+/**
+* Decode a buffer of back-to-back ODID_MESSAGE_SIZE messages
+*
+* All message types are classified first. Each message type is then decoded in
+* its own loop, into element i of the matching output array of outData. Output
+* arrays that are NULL are skipped, and their messages are reported as
+* ODID_MESSAGETYPE_INVALID. The decoded data is identical to what the
+* decode*Message() functions produce.
+*
+* @param outData Output: arrays of at least count elements per message type
+* @param status  Output: per message, the decoded message type or
+*                ODID_MESSAGETYPE_INVALID if the message could not be decoded
+* @param msgs    Buffer with count * ODID_MESSAGE_SIZE bytes
+* @param count   Number of messages in the buffer
+* @return        The number of successfully decoded messages
+*/
+int decodeOpenDroneIDBatch(ODID_Batch_data *outData, ODID_messagetype_t *status,
+                           const uint8_t *msgs, size_t count)
+{
+    int decoded = 0;
+
+    if (!outData || !status || !msgs)
+        return 0;
+
+    classifyMessages(status, msgs, count);
+
+#define DECODE_BATCH_GROUP(type, array, decoder, encodedType) \
+    for (size_t i = 0; i < count; i++) { \
+        if (status[i] != type) \
+            continue; \
+        if (outData->array && \
+            decoder(&outData->array[i], (encodedType *) &msgs[i * ODID_MESSAGE_SIZE]) == ODID_SUCCESS) \
+            decoded++; \
+        else \
+            status[i] = ODID_MESSAGETYPE_INVALID; \
+    }
+
+    DECODE_BATCH_GROUP(ODID_MESSAGETYPE_BASIC_ID, BasicID, decodeBasicIDMessage, ODID_BasicID_encoded);
+    DECODE_BATCH_GROUP(ODID_MESSAGETYPE_LOCATION, Location, decodeLocationMessage, ODID_Location_encoded);
+    DECODE_BATCH_GROUP(ODID_MESSAGETYPE_AUTH, Auth, decodeAuthMessage, ODID_Auth_encoded);
+    DECODE_BATCH_GROUP(ODID_MESSAGETYPE_SELF_ID, SelfID, decodeSelfIDMessage, ODID_SelfID_encoded);
+    DECODE_BATCH_GROUP(ODID_MESSAGETYPE_SYSTEM, System, decodeSystemMessage, ODID_System_encoded);
+    DECODE_BATCH_GROUP(ODID_MESSAGETYPE_OPERATOR_ID, OperatorID, decodeOperatorIDMessage, ODID_OperatorID_encoded);
+#undef DECODE_BATCH_GROUP
+
+    return decoded;
+}
@@ -0,0 +1,350 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include "opendroneid.h"
+#include "wire.h"
+
+/*
+ * Fixed-point versions of the Location and System message codecs. They use
+ * integer arithmetic only and produce the same wire bytes as the float
+ * encoders for the same quantized values. The units are:
+ *
+ *   latitude/longitude   degE7 (degrees * 10^7), i.e. the wire value
+ *   altitude/height      decimetres
+ *   horizontal speed     cm/s
+ *   vertical speed       cm/s
+ *   direction            degrees
+ *   timestamp            tenths of seconds after the full hour, i.e. the wire value
+ */
+
+#define FIXED_LATLON_MAX 1800000000      // 180 degrees in degE7
+#define FIXED_ALT_MIN (-10000)           // -1000 m in dm
+#define FIXED_ALT_MAX 317675             // 31767.5 m in dm
+#define FIXED_ALT_DIV 5                  // 0.5 m in dm
+#define FIXED_SPEED_DIV_LOW 25           // 0.25 m/s in cm/s
+#define FIXED_SPEED_DIV_HIGH 75          // 0.75 m/s in cm/s
+#define FIXED_SPEED_LOW_MAX (UINT8_MAX * FIXED_SPEED_DIV_LOW)
+#define FIXED_SPEED_MAX 25500            // 255 m/s in cm/s
+#define FIXED_VSPEED_DIV 50              // 0.5 m/s in cm/s
+#define FIXED_VSPEED_MAX 6300            // 63 m/s in cm/s
+#define FIXED_TIMESTAMP_MAX (60 * 60 * 10)
+
+static int32_t clampInt(int32_t value, int32_t min, int32_t max)
+{
+    if (value < min)
+        return min;
+    if (value > max)
+        return max;
+    return value;
+}
+
+static uint8_t encodeDirectionFixed(uint16_t direction, uint8_t *EWDirection)
+{
+    if (direction > 361)
+        direction = 361;
+
+    if (direction < 180) {
+        *EWDirection = 0;
+        return (uint8_t) direction;
+    }
+    *EWDirection = 1;
+    return (uint8_t) (direction - 180);
+}
+
+static uint8_t encodeSpeedHorizontalFixed(uint16_t speed, uint8_t *mult)
+{
+    if (speed > FIXED_SPEED_MAX)
+        speed = FIXED_SPEED_MAX;
+
+    if (speed <= FIXED_SPEED_LOW_MAX) {
+        *mult = 0;
+        return (uint8_t) (speed / FIXED_SPEED_DIV_LOW);
+    }
+    *mult = 1;
+    return (uint8_t) clampInt((speed - FIXED_SPEED_LOW_MAX) / FIXED_SPEED_DIV_HIGH, 0, UINT8_MAX);
+}
+
+static uint8_t encodeSpeedVerticalFixed(int16_t speed)
+{
+    int32_t value = clampInt(speed, -FIXED_VSPEED_MAX, FIXED_VSPEED_MAX) / FIXED_VSPEED_DIV;
+    return (uint8_t) (int8_t) value;
+}
+
+static uint32_t encodeLatLonFixed(int32_t latLon)
+{
+    return (uint32_t) clampInt(latLon, -FIXED_LATLON_MAX, FIXED_LATLON_MAX);
+}
+
+static uint16_t encodeAltitudeFixed(int32_t altitude)
+{
+    altitude = clampInt(altitude, FIXED_ALT_MIN, FIXED_ALT_MAX);
+    return (uint16_t) ((altitude - FIXED_ALT_MIN) / FIXED_ALT_DIV);
+}
+
+static int32_t decodeAltitudeFixed(uint16_t altitude)
+{
+    return (int32_t) altitude * FIXED_ALT_DIV + FIXED_ALT_MIN;
+}
+
+/**
+* Encode Location message from fixed-point data (packed, ready for broadcast)
+*
+* @param outEncoded Output (encoded/packed) structure
+* @param inData     Input data (non encoded/packed) structure
+* @return           ODID_SUCCESS or ODID_FAIL;
+*/
+int encodeLocationMessageFixed(ODID_Location_encoded *outEncoded, ODID_Location_fixed *inData)
+{
+    uint8_t *out = (uint8_t *) outEncoded;
+    uint8_t ewDirection, speedMult;
+
+    if (!outEncoded || !inData ||
+        (unsigned) inData->Status > 15 ||
+        (unsigned) inData->HeightType > 1 ||
+        (unsigned) inData->HorizAccuracy > 15 ||
+        (unsigned) inData->VertAccuracy > 15 ||
+        (unsigned) inData->BaroAccuracy > 15 ||
+        (unsigned) inData->SpeedAccuracy > 15 ||
+        (unsigned) inData->TSAccuracy > 15)
+        return ODID_FAIL;
+
+    out[0] = ODID_WIRE_HEADER(ODID_MESSAGETYPE_LOCATION);
+    out[ODID_LOC_DIRECTION] = encodeDirectionFixed(inData->Direction, &ewDirection);
+    out[ODID_LOC_SPEED_HORIZONTAL] = encodeSpeedHorizontalFixed(inData->SpeedHorizontal, &speedMult);
+    out[ODID_LOC_FLAGS] = (uint8_t) ((inData->Status & 0x0F) << 4) |
+                          (inData->HeightType & 0x01 ? ODID_LOC_FLAG_HEIGHT_TYPE : 0) |
+                          (ewDirection ? ODID_LOC_FLAG_EW_DIRECTION : 0) |
+                          (speedMult ? ODID_LOC_FLAG_SPEED_MULT : 0);
+    out[ODID_LOC_SPEED_VERTICAL] = encodeSpeedVerticalFixed(inData->SpeedVertical);
+    odid_put_le32(&out[ODID_LOC_LATITUDE], encodeLatLonFixed(inData->Latitude));
+    odid_put_le32(&out[ODID_LOC_LONGITUDE], encodeLatLonFixed(inData->Longitude));
+    odid_put_le16(&out[ODID_LOC_ALTITUDE_BARO], encodeAltitudeFixed(inData->AltitudeBaro));
+    odid_put_le16(&out[ODID_LOC_ALTITUDE_GEO], encodeAltitudeFixed(inData->AltitudeGeo));
+    odid_put_le16(&out[ODID_LOC_HEIGHT], encodeAltitudeFixed(inData->Height));
+    out[ODID_LOC_HV_ACCURACY] = ODID_WIRE_NIBBLES(inData->VertAccuracy, inData->HorizAccuracy);
+    out[ODID_LOC_BS_ACCURACY] = ODID_WIRE_NIBBLES(inData->BaroAccuracy, inData->SpeedAccuracy);
+    odid_put_le16(&out[ODID_LOC_TIMESTAMP],
+                  inData->TimeStamp > FIXED_TIMESTAMP_MAX ? FIXED_TIMESTAMP_MAX : inData->TimeStamp);
+    out[ODID_LOC_TS_ACCURACY] = ODID_WIRE_NIBBLES(0, inData->TSAccuracy);
+    out[ODID_LOC_RESERVED3] = 0;
+    return ODID_SUCCESS;
+}
+
+/**
+* Encode System message from fixed-point data (packed, ready for broadcast)
+*
+* @param outEncoded Output (encoded/packed) structure
+* @param inData     Input data (non encoded/packed) structure
+* @return           ODID_SUCCESS or ODID_FAIL;
+*/
+int encodeSystemMessageFixed(ODID_System_encoded *outEncoded, ODID_System_fixed *inData)
+{
+    uint8_t *out = (uint8_t *) outEncoded;
+
+    if (!outEncoded || !inData)
+        return ODID_FAIL;
+
+    out[0] = ODID_WIRE_HEADER(ODID_MESSAGETYPE_SYSTEM);
+    out[ODID_SYSTEM_FLAGS] = inData->LocationSource & 0x01 ? ODID_SYSTEM_LOCATION_SOURCE : 0;
+    odid_put_le32(&out[ODID_SYSTEM_OPERATOR_LAT], encodeLatLonFixed(inData->OperatorLatitude));
+    odid_put_le32(&out[ODID_SYSTEM_OPERATOR_LON], encodeLatLonFixed(inData->OperatorLongitude));
+    odid_put_le16(&out[ODID_SYSTEM_AREA_COUNT], inData->AreaCount);
+    out[ODID_SYSTEM_AREA_RADIUS] = (uint8_t) clampInt(inData->AreaRadius / 10, 0, UINT8_MAX);
+    odid_put_le16(&out[ODID_SYSTEM_AREA_CEILING], encodeAltitudeFixed(inData->AreaCeiling));
+    odid_put_le16(&out[ODID_SYSTEM_AREA_FLOOR], encodeAltitudeFixed(inData->AreaFloor));
+    for (int i = ODID_SYSTEM_RESERVED2; i < ODID_MESSAGE_SIZE; i++)
+        out[i] = 0;
+    return ODID_SUCCESS;
+}
+
+/**
+* Decode Location message into fixed-point data
+*
+* @param outData   Output: decoded message
+* @param inEncoded Input message (encoded/packed) structure
+* @return          ODID_SUCCESS or ODID_FAIL;
+*/
+int decodeLocationMessageFixed(ODID_Location_fixed *outData, ODID_Location_encoded *inEncoded)
+{
+    const uint8_t *in = (const uint8_t *) inEncoded;
+
+    if (!outData || !in || ODID_WIRE_TYPE(in[0]) != ODID_MESSAGETYPE_LOCATION)
+        return ODID_FAIL;
+
+    uint8_t flags = in[ODID_LOC_FLAGS];
+    uint8_t speed = in[ODID_LOC_SPEED_HORIZONTAL];
+    outData->Status = (ODID_status_t) (flags >> 4);
+    outData->Direction = (uint16_t) (in[ODID_LOC_DIRECTION] +
+                                     (flags & ODID_LOC_FLAG_EW_DIRECTION ? 180 : 0));
+    if (flags & ODID_LOC_FLAG_SPEED_MULT)
+        outData->SpeedHorizontal = (uint16_t) (speed * FIXED_SPEED_DIV_HIGH + FIXED_SPEED_LOW_MAX);
+    else
+        outData->SpeedHorizontal = (uint16_t) (speed * FIXED_SPEED_DIV_LOW);
+    outData->SpeedVertical = (int16_t) ((int8_t) in[ODID_LOC_SPEED_VERTICAL] * FIXED_VSPEED_DIV);
+    outData->Latitude = (int32_t) odid_get_le32(&in[ODID_LOC_LATITUDE]);
+    outData->Longitude = (int32_t) odid_get_le32(&in[ODID_LOC_LONGITUDE]);
+    outData->AltitudeBaro = decodeAltitudeFixed(odid_get_le16(&in[ODID_LOC_ALTITUDE_BARO]));
+    outData->AltitudeGeo = decodeAltitudeFixed(odid_get_le16(&in[ODID_LOC_ALTITUDE_GEO]));
+    outData->HeightType = (ODID_Height_reference_t) ((flags & ODID_LOC_FLAG_HEIGHT_TYPE) != 0);
+    outData->Height = decodeAltitudeFixed(odid_get_le16(&in[ODID_LOC_HEIGHT]));
+    outData->HorizAccuracy = (ODID_Horizontal_accuracy_t) (in[ODID_LOC_HV_ACCURACY] & 0x0F);
+    outData->VertAccuracy = (ODID_Vertical_accuracy_t) (in[ODID_LOC_HV_ACCURACY] >> 4);
+    outData->BaroAccuracy = (ODID_Vertical_accuracy_t) (in[ODID_LOC_BS_ACCURACY] >> 4);
+    outData->SpeedAccuracy = (ODID_Speed_accuracy_t) (in[ODID_LOC_BS_ACCURACY] & 0x0F);
+    outData->TSAccuracy = (ODID_Timestamp_accuracy_t) (in[ODID_LOC_TS_ACCURACY] & 0x0F);
+    outData->TimeStamp = odid_get_le16(&in[ODID_LOC_TIMESTAMP]);
+    return ODID_SUCCESS;
+}
+
+/**
+* Decode System message into fixed-point data
+*
+* @param outData   Output: decoded message
+* @param inEncoded Input message (encoded/packed) structure
+* @return          ODID_SUCCESS or ODID_FAIL;
+*/
+int decodeSystemMessageFixed(ODID_System_fixed *outData, ODID_System_encoded *inEncoded)
+{
+    const uint8_t *in = (const uint8_t *) inEncoded;
+
+    if (!outData || !in || ODID_WIRE_TYPE(in[0]) != ODID_MESSAGETYPE_SYSTEM)
+        return ODID_FAIL;
+
+    outData->LocationSource = (ODID_location_source_t) ((in[ODID_SYSTEM_FLAGS] & ODID_SYSTEM_LOCATION_SOURCE) != 0);
+    outData->OperatorLatitude = (int32_t) odid_get_le32(&in[ODID_SYSTEM_OPERATOR_LAT]);
+    outData->OperatorLongitude = (int32_t) odid_get_le32(&in[ODID_SYSTEM_OPERATOR_LON]);
+    outData->AreaCount = odid_get_le16(&in[ODID_SYSTEM_AREA_COUNT]);
+    outData->AreaRadius = (uint16_t) (in[ODID_SYSTEM_AREA_RADIUS] * 10);
+    outData->AreaCeiling = decodeAltitudeFixed(odid_get_le16(&in[ODID_SYSTEM_AREA_CEILING]));
+    outData->AreaFloor = decodeAltitudeFixed(odid_get_le16(&in[ODID_SYSTEM_AREA_FLOOR]));
+    return ODID_SUCCESS;
+}
+
+/**
+* Decode one message, not a pack, into fixed-point UAS data
+*
+* @param uasData Output: Structure containing buffers for all message data
+* @param msg     Pointer to a buffer containing a full encoded message
+* @return        The message type: ODID_messagetype_t, ODID_MESSAGETYPE_INVALID
+*                if the message cannot be decoded
+*/
+static ODID_messagetype_t decodeMessageFixed(ODID_UAS_fixed *uasData, uint8_t *msg)
+{
+    int pageNum;
+
+    switch (decodeMessageType(msg[0]))
+    {
+    case ODID_MESSAGETYPE_BASIC_ID:
+        if (decodeBasicIDMessage(&uasData->BasicID, (ODID_BasicID_encoded *) msg) != ODID_SUCCESS)
+            break;
+        uasData->BasicIDValid = 1;
+        return ODID_MESSAGETYPE_BASIC_ID;
+    case ODID_MESSAGETYPE_LOCATION:
+        if (decodeLocationMessageFixed(&uasData->Location, (ODID_Location_encoded *) msg) != ODID_SUCCESS)
+            break;
+        uasData->LocationValid = 1;
+        return ODID_MESSAGETYPE_LOCATION;
+    case ODID_MESSAGETYPE_AUTH:
+        if (getAuthPageNum((ODID_Auth_encoded *) msg, &pageNum) != ODID_SUCCESS ||
+            decodeAuthMessage(&uasData->Auth[pageNum], (ODID_Auth_encoded *) msg) != ODID_SUCCESS)
+            break;
+        uasData->AuthValid[pageNum] = 1;
+        return ODID_MESSAGETYPE_AUTH;
+    case ODID_MESSAGETYPE_SELF_ID:
+        if (decodeSelfIDMessage(&uasData->SelfID, (ODID_SelfID_encoded *) msg) != ODID_SUCCESS)
+            break;
+        uasData->SelfIDValid = 1;
+        return ODID_MESSAGETYPE_SELF_ID;
+    case ODID_MESSAGETYPE_SYSTEM:
+        if (decodeSystemMessageFixed(&uasData->System, (ODID_System_encoded *) msg) != ODID_SUCCESS)
+            break;
+        uasData->SystemValid = 1;
+        return ODID_MESSAGETYPE_SYSTEM;
+    case ODID_MESSAGETYPE_OPERATOR_ID:
+        if (decodeOperatorIDMessage(&uasData->OperatorID, (ODID_OperatorID_encoded *) msg) != ODID_SUCCESS)
+            break;
+        uasData->OperatorIDValid = 1;
+        return ODID_MESSAGETYPE_OPERATOR_ID;
+    default:
+        break;
+    }
+    return ODID_MESSAGETYPE_INVALID;
+}
+
+/**
+* Decode Message Pack into fixed-point UAS data
+*
+* Accepts the same packs as decodeMessagePack(): no nested packs and at most
+* one message of each type, except up to five Authentication pages. A rejected
+* pack leaves uasData untouched, single messages that fail to decode are
+* skipped.
+*
+* @param uasData Output: Structure containing buffers for all message data
+* @param pack    Pointer to an encoded packed message
+* @return        ODID_SUCCESS or ODID_FAIL;
+*/
+int decodeMessagePackFixed(ODID_UAS_fixed *uasData, ODID_MessagePack_encoded *pack)
+{
+    uint8_t *in = (uint8_t *) pack;
+    uint8_t numMessages[ODID_MESSAGETYPE_OPERATOR_ID + 1] = { 0 };
+    ODID_UAS_fixed staging;
+    int amount;
+
+    if (!uasData || !in || ODID_WIRE_TYPE(in[0]) != ODID_MESSAGETYPE_PACKED ||
+        in[ODID_PACK_SINGLE_MESSAGE_SIZE] != ODID_MESSAGE_SIZE)
+        return ODID_FAIL;
+
+    amount = in[ODID_PACK_MSG_PACK_SIZE];
+    if (amount == 0 || amount > ODID_PACK_MAX_MESSAGES)
+        return ODID_FAIL;
+
+    // The decoders only fail before writing, so decoding into a copy keeps
+    // the last value of messages that do not decode
+    staging = *uasData;
+    for (int i = 0; i < amount; i++) {
+        uint8_t *msg = &in[ODID_PACK_MESSAGES + i * ODID_MESSAGE_SIZE];
+        ODID_messagetype_t type = decodeMessageType(msg[0]);
+
+        if (type == ODID_MESSAGETYPE_INVALID || type == ODID_MESSAGETYPE_PACKED)
+            return ODID_FAIL;
+        if (++numMessages[type] > (type == ODID_MESSAGETYPE_AUTH ? ODID_AUTH_MAX_PAGES : 1))
+            return ODID_FAIL;
+        decodeMessageFixed(&staging, msg);
+    }
+    *uasData = staging;
+    return ODID_SUCCESS;
+}
+
+/**
+* Fixed-point version of decodeOpenDroneID(). Decode a message or a pack from
+* Open Drone ID packed format into fixed-point UAS data
+*
+* This function assumes that msgData points to a buffer containing all
+* ODID_MESSAGE_SIZE bytes of an Open Drone ID message, or all bytes of a pack.
+*
+* @param uasData    Structure containing buffers for all message data
+* @param msgData    Pointer to a buffer containing a full encoded Open Drone ID
+*                   message
+* @return           The message type: ODID_messagetype_t
+*/
+ODID_messagetype_t decodeOpenDroneIDFixed(ODID_UAS_fixed *uasData, uint8_t *msgData)
+{
+    if (!uasData || !msgData)
+        return ODID_MESSAGETYPE_INVALID;
+
+    if (decodeMessageType(msgData[0]) == ODID_MESSAGETYPE_PACKED) {
+        if (decodeMessagePackFixed(uasData, (ODID_MessagePack_encoded *) msgData) == ODID_SUCCESS)
+            return ODID_MESSAGETYPE_PACKED;
+        return ODID_MESSAGETYPE_INVALID;
+    }
+    return decodeMessageFixed(uasData, msgData);
+}
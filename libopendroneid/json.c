@@ -0,0 +1,1167 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include "opendroneid.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * JSON export of ODID_UAS_Data without heap allocations or printf style
+ * formatting of the common cases. The document is a single line:
+ *
+ * {"Version":"0.0","Response":{
+ *   "BasicID":{"UAType":n,"IDType":n,"UASID":"s"},
+ *   "Location":{"Status":n,"Direction":f,"SpeedHorizontal":f,"SpeedVertical":f,
+ *     "Latitude":f,"Longitude":f,"AltitudeBaro":f,"AltitudeGeo":f,"HeightType":n,
+ *     "Height":f,"HorizAccuracy":n,"VertAccuracy":n,"BaroAccuracy":n,
+ *     "SpeedAccuracy":n,"TSAccuracy":n,"TimeStamp":f},
+ *   "Authentication":{"AuthType":n,"AuthToken":"s"},
+ *   "SelfID":{"Name":"string","DescType":n,"Description":"s"},
+ *   "Operator":{"LocationSource":n,"OperatorLatitude":f,"OperatorLongitude":f,
+ *     "AreaCount":n,"AreaRadius":n,"AreaCeiling":f,"AreaFloor":f}}}
+ *
+ * These are the keys of the pretty-printed document drone_export_gps_data()
+ * used to write, including the "Name" placeholder, plus the fields it left
+ * out: HeightType, BaroAccuracy, DescType and AreaFloor. Strings are now
+ * quoted, so the document is valid JSON. Only the messages whose Valid flag is
+ * set are written, Operator holds the System message and Authentication page
+ * 0, so a document that is read back has the same Valid flags.
+ *
+ * With ODID_JSON_AUTH_PAGES, Authentication also has "PageCount", "Length",
+ * "Timestamp" and "Pages", an array with the AuthData of pages 1 and up, null
+ * for the pages that are not valid. With ODID_JSON_OPERATOR_ID, Response ends
+ * with "OperatorID":{"OperatorIdType":n,"OperatorId":"s"}.
+ *
+ * Latitudes and longitudes have up to 7 decimals, the other floats up to 2,
+ * which is finer than the resolution of the encoded messages. Trailing zeros
+ * are dropped. Infinite and NaN values are written as null. Strings end at the
+ * first null byte or at the size of their field. Bytes from 0x80 up are
+ * written as \u00XX escapes, like the control characters, so binary
+ * authentication data stays valid JSON and every byte can be read back.
+ *
+ * odid_json_read() parses documents of this schema back in place, without
+ * allocations. Keys are looked up with a perfect hash, unknown keys and
+ * sections are skipped.
+ */
+
+#define JSON_NUMBER_SIZE 32     // Longest number, including the %.17g fallback
+#define JSON_LATLON_DECIMALS 7
+#define JSON_FLOAT_DECIMALS 2
+
+// Largest scaled value that is formatted with integer arithmetic, exact in a double
+#define JSON_FIXED_MAX 9e15
+
+static const uint64_t POW10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
+
+static const char DIGIT_PAIRS[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+// Keys are string literals, with the separator in front of them
+#define JSON_RAW(w, lit)                jsonRaw(w, lit, sizeof(lit) - 1)
+#define JSON_INT(w, key, value)         jsonInt(w, key, sizeof(key) - 1, value)
+#define JSON_FLOAT(w, key, value, dec)  jsonFloat(w, key, sizeof(key) - 1, value, dec)
+#define JSON_STRING(w, key, str, size)  jsonString(w, key, sizeof(key) - 1, str, size)
+
+// Stop at the first failure, so a sink never gets a document with a gap
+#define JSON_CHECK(call) do { if ((call) != ODID_SUCCESS) goto fail; } while (0)
+
+static int jsonFlush(ODID_Json_writer *writer)
+{
+    if (!writer->Sink)
+        return ODID_FAIL;
+    if (writer->Length > 0 && writer->Sink(writer->User, writer->Buffer, writer->Length) != 0)
+        return ODID_FAIL;
+    writer->Length = 0;
+    return ODID_SUCCESS;
+}
+
+/**
+* Make room for a number of bytes at the end of the buffer
+*
+* Without a sink, one more byte is kept free for the terminating null.
+*
+* @param writer JSON writer
+* @param count  Number of bytes to write
+* @return       Where to write them, NULL if they don't fit
+*/
+static char *jsonReserve(ODID_Json_writer *writer, size_t count)
+{
+    size_t needed = count + (writer->Sink ? 0 : 1);
+
+    if (writer->Size - writer->Length >= needed)
+        return writer->Buffer + writer->Length;
+    if (needed > writer->Size || jsonFlush(writer) != ODID_SUCCESS)
+        return NULL;
+    return writer->Buffer;
+}
+
+static inline void jsonCommit(ODID_Json_writer *writer, const char *end)
+{
+    writer->Length = (size_t) (end - writer->Buffer);
+}
+
+static char *putUint(char *p, uint64_t value)
+{
+    char digits[20];
+    char *d = digits + sizeof(digits);
+
+    while (value >= 100) {
+        d -= 2;
+        memcpy(d, &DIGIT_PAIRS[(value % 100) * 2], 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        d -= 2;
+        memcpy(d, &DIGIT_PAIRS[value * 2], 2);
+    } else {
+        *--d = (char) ('0' + value);
+    }
+    memcpy(p, d, (size_t) (digits + sizeof(digits) - d));
+    return p + (digits + sizeof(digits) - d);
+}
+
+static char *putInt(char *p, int64_t value)
+{
+    if (value < 0) {
+        *p++ = '-';
+        return putUint(p, (uint64_t) 0 - (uint64_t) value);
+    }
+    return putUint(p, (uint64_t) value);
+}
+
+/**
+* Format a number with at most the given number of decimals
+*
+* @param p          Output, with room for JSON_NUMBER_SIZE bytes
+* @param value      Number to format
+* @param decimals   Maximum number of decimals, up to JSON_LATLON_DECIMALS
+* @return           End of the formatted number
+*/
+static char *putFloat(char *p, double value, int decimals)
+{
+    uint64_t scale = POW10[decimals];
+    double magnitude = (value < 0 ? -value : value) * (double) scale;
+    uint64_t scaled, fraction;
+
+    // NaN fails the comparison, infinity is above the limit
+    if (!(magnitude < JSON_FIXED_MAX)) {
+        if (value != value || value - value != 0) {
+            memcpy(p, "null", 4);
+            return p + 4;
+        }
+        return p + snprintf(p, JSON_NUMBER_SIZE, "%.17g", value);
+    }
+
+    scaled = (uint64_t) (magnitude + 0.5);
+    if (value < 0 && scaled > 0)
+        *p++ = '-';
+    p = putUint(p, scaled / scale);
+    fraction = scaled % scale;
+    if (fraction == 0)
+        return p;
+
+    while (fraction % 10 == 0) {
+        fraction /= 10;
+        decimals--;
+    }
+    *p++ = '.';
+    for (int i = decimals - 1; i >= 0; i--) {
+        p[i] = (char) ('0' + fraction % 10);
+        fraction /= 10;
+    }
+    return p + decimals;
+}
+
+static int jsonRaw(ODID_Json_writer *writer, const char *str, size_t len)
+{
+    char *p = jsonReserve(writer, len);
+
+    if (!p)
+        return ODID_FAIL;
+    memcpy(p, str, len);
+    jsonCommit(writer, p + len);
+    return ODID_SUCCESS;
+}
+
+static int jsonInt(ODID_Json_writer *writer, const char *key, size_t keyLen, int64_t value)
+{
+    char *p = jsonReserve(writer, keyLen + JSON_NUMBER_SIZE);
+
+    if (!p)
+        return ODID_FAIL;
+    memcpy(p, key, keyLen);
+    jsonCommit(writer, putInt(p + keyLen, value));
+    return ODID_SUCCESS;
+}
+
+static int jsonFloat(ODID_Json_writer *writer, const char *key, size_t keyLen,
+                     double value, int decimals)
+{
+    char *p = jsonReserve(writer, keyLen + JSON_NUMBER_SIZE);
+
+    if (!p)
+        return ODID_FAIL;
+    memcpy(p, key, keyLen);
+    jsonCommit(writer, putFloat(p + keyLen, value, decimals));
+    return ODID_SUCCESS;
+}
+
+/**
+* Write a key and a quoted, escaped string
+*
+* @param writer JSON writer
+* @param key    Key, with its separator
+* @param keyLen Length of the key
+* @param str    String, ends at a null byte or after size bytes
+* @param size   Size of the string field
+* @return       ODID_SUCCESS or ODID_FAIL
+*/
+static int jsonString(ODID_Json_writer *writer, const char *key, size_t keyLen,
+                      const char *str, size_t size)
+{
+    // Every byte takes at most 6 characters, as \u00XX
+    char *p = jsonReserve(writer, keyLen + 2 + size * 6);
+
+    if (!p)
+        return ODID_FAIL;
+    memcpy(p, key, keyLen);
+    p += keyLen;
+    *p++ = '"';
+    for (size_t i = 0; i < size && str[i]; i++) {
+        uint8_t c = (uint8_t) str[i];
+
+        if (c >= 0x20 && c < 0x80 && c != '"' && c != '\\') {
+            *p++ = (char) c;
+            continue;
+        }
+        *p++ = '\\';
+        switch (c) {
+        case '"': *p++ = '"'; break;
+        case '\\': *p++ = '\\'; break;
+        case '\b': *p++ = 'b'; break;
+        case '\f': *p++ = 'f'; break;
+        case '\n': *p++ = 'n'; break;
+        case '\r': *p++ = 'r'; break;
+        case '\t': *p++ = 't'; break;
+        default:
+            memcpy(p, "u00", 3);
+            p[3] = HEX_DIGITS[c >> 4];
+            p[4] = HEX_DIGITS[c & 0x0F];
+            p += 5;
+            break;
+        }
+    }
+    *p++ = '"';
+    jsonCommit(writer, p);
+    return ODID_SUCCESS;
+}
+
+// A comma in front of every message object but the first one
+static int jsonNext(ODID_Json_writer *writer, int *objects)
+{
+    return (*objects)++ ? JSON_RAW(writer, ",") : ODID_SUCCESS;
+}
+
+static int jsonAuth(ODID_Json_writer *writer, const ODID_Auth_data *auth,
+                    const uint8_t *valid, int flags)
+{
+    JSON_CHECK(JSON_INT(writer, "\"Authentication\":{\"AuthType\":", auth[0].AuthType));
+    if (flags & ODID_JSON_AUTH_PAGES) {
+        int pageCount = auth[0].PageCount;
+
+        if (pageCount > ODID_AUTH_MAX_PAGES)
+            pageCount = ODID_AUTH_MAX_PAGES;
+        JSON_CHECK(JSON_INT(writer, ",\"PageCount\":", auth[0].PageCount));
+        JSON_CHECK(JSON_INT(writer, ",\"Length\":", auth[0].Length));
+        JSON_CHECK(JSON_INT(writer, ",\"Timestamp\":", auth[0].Timestamp));
+        JSON_CHECK(JSON_STRING(writer, ",\"AuthToken\":", auth[0].AuthData,
+                               ODID_STR_SIZE - ODID_AUTH_PAGE_0_DATA_SIZE));
+        JSON_CHECK(JSON_RAW(writer, ",\"Pages\":["));
+        for (int page = 1; page < pageCount; page++) {
+            if (page > 1)
+                JSON_CHECK(JSON_RAW(writer, ","));
+            if (valid[page])
+                JSON_CHECK(JSON_STRING(writer, "", auth[page].AuthData, ODID_STR_SIZE));
+            else
+                JSON_CHECK(JSON_RAW(writer, "null"));
+        }
+        JSON_CHECK(JSON_RAW(writer, "]}"));
+    } else {
+        JSON_CHECK(JSON_STRING(writer, ",\"AuthToken\":", auth[0].AuthData,
+                               ODID_STR_SIZE - ODID_AUTH_PAGE_0_DATA_SIZE));
+        JSON_CHECK(JSON_RAW(writer, "}"));
+    }
+    return ODID_SUCCESS;
+
+fail:
+    return ODID_FAIL;
+}
+
+/**
+* Initialize a JSON writer
+*
+* Without a sink, the documents are collected in the buffer, which is kept null
+* terminated. With a sink, the buffer only needs ODID_JSON_MIN_SIZE bytes: when
+* it is full, its contents are passed to the sink and it is reused.
+*
+* @param writer JSON writer context
+* @param buffer Output buffer
+* @param size   Size of the output buffer
+* @param sink   Called with the contents of the full buffer, may be NULL
+* @param user   Passed to the sink
+*/
+void odid_json_init(ODID_Json_writer *writer, char *buffer, size_t size,
+                    ODID_Json_sink sink, void *user)
+{
+    if (!writer)
+        return;
+
+    writer->Buffer = buffer;
+    writer->Size = buffer ? size : 0;
+    writer->Length = 0;
+    writer->Sink = sink;
+    writer->User = user;
+    if (!sink && writer->Size > 0)
+        buffer[0] = 0;
+}
+
+/**
+* Append a JSON document with the contents of an ODID_UAS_Data to a writer
+*
+* Only the messages with their Valid flag set are written.
+*
+* Without a sink, a document that does not fit in the rest of the buffer is
+* not written at all. With a sink, writing stops when the sink fails: the part
+* of the document already written stays in the buffer or has been passed to
+* the sink, the rest is not written.
+*
+* @param writer     JSON writer context
+* @param uasData    Data to write
+* @param flags      ODID_JSON_* flags
+* @return           ODID_SUCCESS or ODID_FAIL
+*/
+int odid_json_write(ODID_Json_writer *writer, const ODID_UAS_Data *uasData, int flags)
+{
+    if (!writer || !writer->Buffer || !uasData)
+        return ODID_FAIL;
+
+    const ODID_BasicID_data *basicID = &uasData->BasicID;
+    const ODID_Location_data *loc = &uasData->Location;
+    const ODID_System_data *sys = &uasData->System;
+    size_t start = writer->Length;
+    int objects = 0;
+
+    JSON_CHECK(JSON_RAW(writer, "{\"Version\":\"0.0\",\"Response\":{"));
+
+    if (uasData->BasicIDValid) {
+        JSON_CHECK(jsonNext(writer, &objects));
+        JSON_CHECK(JSON_INT(writer, "\"BasicID\":{\"UAType\":", basicID->UAType));
+        JSON_CHECK(JSON_INT(writer, ",\"IDType\":", basicID->IDType));
+        JSON_CHECK(JSON_STRING(writer, ",\"UASID\":", basicID->UASID, ODID_ID_SIZE));
+        JSON_CHECK(JSON_RAW(writer, "}"));
+    }
+
+    if (uasData->LocationValid) {
+        JSON_CHECK(jsonNext(writer, &objects));
+        JSON_CHECK(JSON_INT(writer, "\"Location\":{\"Status\":", loc->Status));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"Direction\":", loc->Direction, JSON_FLOAT_DECIMALS));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"SpeedHorizontal\":", loc->SpeedHorizontal, JSON_FLOAT_DECIMALS));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"SpeedVertical\":", loc->SpeedVertical, JSON_FLOAT_DECIMALS));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"Latitude\":", loc->Latitude, JSON_LATLON_DECIMALS));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"Longitude\":", loc->Longitude, JSON_LATLON_DECIMALS));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"AltitudeBaro\":", loc->AltitudeBaro, JSON_FLOAT_DECIMALS));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"AltitudeGeo\":", loc->AltitudeGeo, JSON_FLOAT_DECIMALS));
+        JSON_CHECK(JSON_INT(writer, ",\"HeightType\":", loc->HeightType));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"Height\":", loc->Height, JSON_FLOAT_DECIMALS));
+        JSON_CHECK(JSON_INT(writer, ",\"HorizAccuracy\":", loc->HorizAccuracy));
+        JSON_CHECK(JSON_INT(writer, ",\"VertAccuracy\":", loc->VertAccuracy));
+        JSON_CHECK(JSON_INT(writer, ",\"BaroAccuracy\":", loc->BaroAccuracy));
+        JSON_CHECK(JSON_INT(writer, ",\"SpeedAccuracy\":", loc->SpeedAccuracy));
+        JSON_CHECK(JSON_INT(writer, ",\"TSAccuracy\":", loc->TSAccuracy));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"TimeStamp\":", loc->TimeStamp, JSON_FLOAT_DECIMALS));
+        JSON_CHECK(JSON_RAW(writer, "}"));
+    }
+
+    if (uasData->AuthValid[0]) {
+        JSON_CHECK(jsonNext(writer, &objects));
+        JSON_CHECK(jsonAuth(writer, uasData->Auth, uasData->AuthValid, flags));
+    }
+
+    if (uasData->SelfIDValid) {
+        JSON_CHECK(jsonNext(writer, &objects));
+        JSON_CHECK(JSON_INT(writer, "\"SelfID\":{\"Name\":\"string\",\"DescType\":", uasData->SelfID.DescType));
+        JSON_CHECK(JSON_STRING(writer, ",\"Description\":", uasData->SelfID.Desc, ODID_STR_SIZE));
+        JSON_CHECK(JSON_RAW(writer, "}"));
+    }
+
+    if (uasData->SystemValid) {
+        JSON_CHECK(jsonNext(writer, &objects));
+        JSON_CHECK(JSON_INT(writer, "\"Operator\":{\"LocationSource\":", sys->LocationSource));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"OperatorLatitude\":", sys->OperatorLatitude, JSON_LATLON_DECIMALS));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"OperatorLongitude\":", sys->OperatorLongitude, JSON_LATLON_DECIMALS));
+        JSON_CHECK(JSON_INT(writer, ",\"AreaCount\":", sys->AreaCount));
+        JSON_CHECK(JSON_INT(writer, ",\"AreaRadius\":", sys->AreaRadius));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"AreaCeiling\":", sys->AreaCeiling, JSON_FLOAT_DECIMALS));
+        JSON_CHECK(JSON_FLOAT(writer, ",\"AreaFloor\":", sys->AreaFloor, JSON_FLOAT_DECIMALS));
+        JSON_CHECK(JSON_RAW(writer, "}"));
+    }
+
+    if ((flags & ODID_JSON_OPERATOR_ID) && uasData->OperatorIDValid) {
+        JSON_CHECK(jsonNext(writer, &objects));
+        JSON_CHECK(JSON_INT(writer, "\"OperatorID\":{\"OperatorIdType\":", uasData->OperatorID.OperatorIdType));
+        JSON_CHECK(JSON_STRING(writer, ",\"OperatorId\":", uasData->OperatorID.OperatorId, ODID_ID_SIZE));
+        JSON_CHECK(JSON_RAW(writer, "}"));
+    }
+
+    if (flags & ODID_JSON_NEWLINE)
+        JSON_CHECK(JSON_RAW(writer, "}}\n"));
+    else
+        JSON_CHECK(JSON_RAW(writer, "}}"));
+
+    if (!writer->Sink)
+        writer->Buffer[writer->Length] = 0;
+    return ODID_SUCCESS;
+
+fail:
+    if (!writer->Sink) {
+        writer->Length = start;
+        writer->Buffer[writer->Length] = 0;
+    }
+    return ODID_FAIL;
+}
+
+/**
+* Pass the contents of the buffer to the sink
+*
+* @param writer JSON writer context
+* @return       ODID_SUCCESS, or ODID_FAIL without a sink or if the sink fails
+*/
+int odid_json_flush(ODID_Json_writer *writer)
+{
+    if (!writer)
+        return ODID_FAIL;
+
+    return jsonFlush(writer);
+}
+
+/*
+ * JSON import. The keys of the schema are numbered in the order below, 0 is
+ * an unknown key. JSON_KEY_HASH() maps each of them to a different slot of
+ * KEY_TABLE, so a lookup is one hash and one compare.
+ */
+enum {
+    JSON_KEY_NONE,
+    JSON_KEY_VERSION,
+    JSON_KEY_RESPONSE,
+    JSON_KEY_BASIC_ID,
+    JSON_KEY_UA_TYPE,
+    JSON_KEY_ID_TYPE,
+    JSON_KEY_UASID,
+    JSON_KEY_LOCATION,
+    JSON_KEY_STATUS,
+    JSON_KEY_DIRECTION,
+    JSON_KEY_SPEED_HORIZONTAL,
+    JSON_KEY_SPEED_VERTICAL,
+    JSON_KEY_LATITUDE,
+    JSON_KEY_LONGITUDE,
+    JSON_KEY_ALTITUDE_BARO,
+    JSON_KEY_ALTITUDE_GEO,
+    JSON_KEY_HEIGHT_TYPE,
+    JSON_KEY_HEIGHT,
+    JSON_KEY_HORIZ_ACCURACY,
+    JSON_KEY_VERT_ACCURACY,
+    JSON_KEY_BARO_ACCURACY,
+    JSON_KEY_SPEED_ACCURACY,
+    JSON_KEY_TS_ACCURACY,
+    JSON_KEY_TIME_STAMP,
+    JSON_KEY_AUTHENTICATION,
+    JSON_KEY_AUTH_TYPE,
+    JSON_KEY_PAGE_COUNT,
+    JSON_KEY_LENGTH,
+    JSON_KEY_TIMESTAMP,
+    JSON_KEY_AUTH_TOKEN,
+    JSON_KEY_PAGES,
+    JSON_KEY_SELF_ID,
+    JSON_KEY_DESC_TYPE,
+    JSON_KEY_DESCRIPTION,
+    JSON_KEY_OPERATOR,
+    JSON_KEY_LOCATION_SOURCE,
+    JSON_KEY_OPERATOR_LATITUDE,
+    JSON_KEY_OPERATOR_LONGITUDE,
+    JSON_KEY_AREA_COUNT,
+    JSON_KEY_AREA_RADIUS,
+    JSON_KEY_AREA_CEILING,
+    JSON_KEY_AREA_FLOOR,
+    JSON_KEY_OPERATOR_ID_MESSAGE,
+    JSON_KEY_OPERATOR_ID_TYPE,
+    JSON_KEY_OPERATOR_ID,
+    JSON_KEY_COUNT
+};
+
+static const char *const KEY_NAMES[JSON_KEY_COUNT] = {
+    "", "Version", "Response",
+    "BasicID", "UAType", "IDType", "UASID",
+    "Location", "Status", "Direction", "SpeedHorizontal", "SpeedVertical", "Latitude",
+    "Longitude", "AltitudeBaro", "AltitudeGeo", "HeightType", "Height", "HorizAccuracy",
+    "VertAccuracy", "BaroAccuracy", "SpeedAccuracy", "TSAccuracy", "TimeStamp",
+    "Authentication", "AuthType", "PageCount", "Length", "Timestamp", "AuthToken", "Pages",
+    "SelfID", "DescType", "Description",
+    "Operator", "LocationSource", "OperatorLatitude", "OperatorLongitude", "AreaCount",
+    "AreaRadius", "AreaCeiling", "AreaFloor",
+    "OperatorID", "OperatorIdType", "OperatorId",
+};
+
+// The object each key belongs to, JSON_KEY_NONE for the top level
+static const uint8_t KEY_PARENT[JSON_KEY_COUNT] = {
+    JSON_KEY_NONE, JSON_KEY_NONE, JSON_KEY_NONE,
+    JSON_KEY_RESPONSE, JSON_KEY_BASIC_ID, JSON_KEY_BASIC_ID, JSON_KEY_BASIC_ID,
+    JSON_KEY_RESPONSE, JSON_KEY_LOCATION, JSON_KEY_LOCATION, JSON_KEY_LOCATION, JSON_KEY_LOCATION,
+    JSON_KEY_LOCATION, JSON_KEY_LOCATION, JSON_KEY_LOCATION, JSON_KEY_LOCATION, JSON_KEY_LOCATION,
+    JSON_KEY_LOCATION, JSON_KEY_LOCATION, JSON_KEY_LOCATION, JSON_KEY_LOCATION, JSON_KEY_LOCATION,
+    JSON_KEY_LOCATION, JSON_KEY_LOCATION,
+    JSON_KEY_RESPONSE, JSON_KEY_AUTHENTICATION, JSON_KEY_AUTHENTICATION, JSON_KEY_AUTHENTICATION,
+    JSON_KEY_AUTHENTICATION, JSON_KEY_AUTHENTICATION, JSON_KEY_AUTHENTICATION,
+    JSON_KEY_RESPONSE, JSON_KEY_SELF_ID, JSON_KEY_SELF_ID,
+    JSON_KEY_RESPONSE, JSON_KEY_OPERATOR, JSON_KEY_OPERATOR, JSON_KEY_OPERATOR, JSON_KEY_OPERATOR,
+    JSON_KEY_OPERATOR, JSON_KEY_OPERATOR, JSON_KEY_OPERATOR,
+    JSON_KEY_RESPONSE, JSON_KEY_OPERATOR_ID_MESSAGE, JSON_KEY_OPERATOR_ID_MESSAGE,
+};
+
+#define JSON_KEY_MAX_LENGTH 17   // OperatorLongitude
+
+#define JSON_KEY_HASH(key, len) \
+    (((len) * 44 + (uint8_t) (key)[0] + (uint8_t) (key)[(len) - 1] * 27 + (uint8_t) (key)[(len) / 2]) & 127)
+
+static const uint8_t KEY_TABLE[128] = {
+     0,  0, 36, 23,  0,  0,  0, 44,  0,  0,  0,  3, 19,  0,  0,  0,
+     0,  0,  0,  0,  0,  0, 34,  1,  0, 41,  0, 16, 25,  0,  0, 32,
+     0,  0,  0, 28,  0,  0,  0, 42,  0,  0, 18, 33, 24,  0, 37,  0,
+     6,  0,  0, 27, 30, 21,  0,  0,  0,  0,  7, 29,  0, 10,  0,  0,
+     0,  0,  0,  0, 22,  0,  0, 12,  2, 35,  0,  0, 38,  9,  0, 15,
+    43,  0,  0,  0,  0,  0,  0,  0, 11,  0,  0, 26,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0, 40, 13,  0, 14,  0,  0, 31,  0,  0,
+     8,  5,  0, 17,  0,  0,  0,  0, 20,  0,  0, 39,  0,  4,  0,  0,
+};
+
+#define JSON_MAX_DEPTH 16
+#define JSON_FAST_DIGITS 15     // Mantissas up to this many digits are exact in a double
+
+// String characters that are copied as they are
+#define JSON_PLAIN(c) ((uint8_t) (c) >= 0x20 && (c) != '"' && (c) != '\\')
+
+static const double POW10_DOUBLE[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+typedef struct {
+    const char *p;
+    const char *end;
+} JsonInput;
+
+static int lookupKey(const char *key, size_t len)
+{
+    int id;
+
+    if (len == 0 || len > JSON_KEY_MAX_LENGTH)
+        return JSON_KEY_NONE;
+    id = KEY_TABLE[JSON_KEY_HASH(key, len)];
+    if (strlen(KEY_NAMES[id]) != len || memcmp(KEY_NAMES[id], key, len) != 0)
+        return JSON_KEY_NONE;
+    return id;
+}
+
+static void skipSpace(JsonInput *in)
+{
+    while (in->p < in->end && (*in->p == ' ' || *in->p == '\t' || *in->p == '\n' || *in->p == '\r'))
+        in->p++;
+}
+
+// Skip white space and consume the given character
+static int expect(JsonInput *in, char c)
+{
+    skipSpace(in);
+    if (in->p == in->end || *in->p != c)
+        return ODID_FAIL;
+    in->p++;
+    return ODID_SUCCESS;
+}
+
+static int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+static int readHex4(JsonInput *in, uint32_t *value)
+{
+    *value = 0;
+    if (in->end - in->p < 4)
+        return ODID_FAIL;
+    for (int i = 0; i < 4; i++) {
+        int digit = hexValue(in->p[i]);
+        if (digit < 0)
+            return ODID_FAIL;
+        *value = *value << 4 | (uint32_t) digit;
+    }
+    in->p += 4;
+    return ODID_SUCCESS;
+}
+
+/**
+* Read a quoted string
+*
+* Escapes up to \u00FF give single bytes, like the writer uses them. Other code
+* points are stored as UTF-8.
+*
+* @param in     Input, after white space
+* @param str    Output, size + 1 bytes, null padded. NULL to skip the string
+* @param size   Maximum length of the string
+* @return       ODID_SUCCESS, or ODID_FAIL if the string is invalid or too long
+*/
+static int readString(JsonInput *in, char *str, size_t size)
+{
+    size_t len = 0;
+
+    if (in->p == in->end || *in->p != '"')
+        return ODID_FAIL;
+    in->p++;
+
+    while (in->p < in->end) {
+        const char *run = in->p;
+        uint8_t bytes[4];
+        size_t count = 1;
+        uint8_t c;
+
+        // Copy runs of characters that need no decoding at once
+        while (in->p < in->end && JSON_PLAIN(*in->p))
+            in->p++;
+        if (str && in->p > run) {
+            if (size - len < (size_t) (in->p - run))
+                return ODID_FAIL;
+            memcpy(str + len, run, (size_t) (in->p - run));
+            len += (size_t) (in->p - run);
+        }
+        if (in->p == in->end)
+            break;
+
+        c = (uint8_t) *in->p++;
+        if (c == '"') {
+            if (str)
+                memset(str + len, 0, size + 1 - len);
+            return ODID_SUCCESS;
+        }
+        if (c < 0x20)
+            return ODID_FAIL;
+        bytes[0] = c;
+        if (c == '\\') {
+            uint32_t cp;
+
+            if (in->p == in->end)
+                return ODID_FAIL;
+            switch (*in->p++) {
+            case '"': bytes[0] = '"'; break;
+            case '\\': bytes[0] = '\\'; break;
+            case '/': bytes[0] = '/'; break;
+            case 'b': bytes[0] = '\b'; break;
+            case 'f': bytes[0] = '\f'; break;
+            case 'n': bytes[0] = '\n'; break;
+            case 'r': bytes[0] = '\r'; break;
+            case 't': bytes[0] = '\t'; break;
+            case 'u':
+                if (readHex4(in, &cp) != ODID_SUCCESS || (cp >= 0xDC00 && cp < 0xE000))
+                    return ODID_FAIL;
+                if (cp >= 0xD800 && cp < 0xDC00) {
+                    uint32_t low;
+                    if (in->end - in->p < 2 || in->p[0] != '\\' || in->p[1] != 'u')
+                        return ODID_FAIL;
+                    in->p += 2;
+                    if (readHex4(in, &low) != ODID_SUCCESS || low < 0xDC00 || low >= 0xE000)
+                        return ODID_FAIL;
+                    cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                }
+                if (cp < 0x100) {
+                    bytes[0] = (uint8_t) cp;
+                } else if (cp < 0x800) {
+                    bytes[0] = (uint8_t) (0xC0 | cp >> 6);
+                    bytes[1] = (uint8_t) (0x80 | (cp & 0x3F));
+                    count = 2;
+                } else if (cp < 0x10000) {
+                    bytes[0] = (uint8_t) (0xE0 | cp >> 12);
+                    bytes[1] = (uint8_t) (0x80 | ((cp >> 6) & 0x3F));
+                    bytes[2] = (uint8_t) (0x80 | (cp & 0x3F));
+                    count = 3;
+                } else {
+                    bytes[0] = (uint8_t) (0xF0 | cp >> 18);
+                    bytes[1] = (uint8_t) (0x80 | ((cp >> 12) & 0x3F));
+                    bytes[2] = (uint8_t) (0x80 | ((cp >> 6) & 0x3F));
+                    bytes[3] = (uint8_t) (0x80 | (cp & 0x3F));
+                    count = 4;
+                }
+                break;
+            default:
+                return ODID_FAIL;
+            }
+        }
+        if (str) {
+            if (size - len < count)
+                return ODID_FAIL;
+            memcpy(str + len, bytes, count);
+            len += count;
+        }
+    }
+    return ODID_FAIL;
+}
+
+/**
+* Read an object key and the colon after it
+*
+* @param in     Input
+* @param key    Output: JSON_KEY_*, JSON_KEY_NONE for unknown keys
+* @return       ODID_SUCCESS or ODID_FAIL
+*/
+static int readKey(JsonInput *in, int *key)
+{
+    const char *start;
+
+    skipSpace(in);
+    if (in->p == in->end || *in->p != '"')
+        return ODID_FAIL;
+    start = in->p + 1;
+    in->p = start;
+    while (in->p < in->end && JSON_PLAIN(*in->p))
+        in->p++;
+
+    if (in->p < in->end && *in->p == '"') {
+        *key = lookupKey(start, (size_t) (in->p - start));
+        in->p++;
+    } else {
+        // Keys with escapes are not in the schema
+        in->p = start - 1;
+        if (readString(in, NULL, 0) != ODID_SUCCESS)
+            return ODID_FAIL;
+        *key = JSON_KEY_NONE;
+    }
+    return expect(in, ':');
+}
+
+/**
+* Read a number, or null as NaN
+*
+* Numbers with up to JSON_FAST_DIGITS digits and no exponent, which includes
+* everything the writer produces, are converted with one division and give the
+* same result as strtod(). Others are passed to strtod().
+*
+* @param in     Input, after white space
+* @param value  Output
+* @return       ODID_SUCCESS or ODID_FAIL
+*/
+static int readNumber(JsonInput *in, double *value)
+{
+    const char *p = in->p, *start = in->p;
+    uint64_t mantissa = 0;
+    int digits = 0, decimals = 0, exponent = 0;
+
+    if (in->end - p >= 4 && memcmp(p, "null", 4) == 0) {
+        *value = NAN;
+        in->p += 4;
+        return ODID_SUCCESS;
+    }
+
+    if (p < in->end && *p == '-')
+        p++;
+    if (p == in->end || *p < '0' || *p > '9')
+        return ODID_FAIL;
+    if (*p == '0') {
+        p++;
+    } else {
+        for (; p < in->end && *p >= '0' && *p <= '9'; p++, digits++)
+            mantissa = mantissa * 10 + (uint64_t) (*p - '0');
+    }
+    if (p < in->end && *p == '.') {
+        p++;
+        if (p == in->end || *p < '0' || *p > '9')
+            return ODID_FAIL;
+        for (; p < in->end && *p >= '0' && *p <= '9'; p++, decimals++)
+            mantissa = mantissa * 10 + (uint64_t) (*p - '0');
+    }
+    if (p < in->end && (*p == 'e' || *p == 'E')) {
+        exponent = 1;
+        p++;
+        if (p < in->end && (*p == '+' || *p == '-'))
+            p++;
+        if (p == in->end || *p < '0' || *p > '9')
+            return ODID_FAIL;
+        while (p < in->end && *p >= '0' && *p <= '9')
+            p++;
+    }
+    in->p = p;
+
+    if (!exponent && digits + decimals <= JSON_FAST_DIGITS) {
+        *value = (double) mantissa / POW10_DOUBLE[decimals];
+        if (*start == '-')
+            *value = -*value;
+        return ODID_SUCCESS;
+    }
+
+    char number[JSON_NUMBER_SIZE * 2];
+    if ((size_t) (p - start) >= sizeof(number))
+        return ODID_FAIL;
+    memcpy(number, start, (size_t) (p - start));
+    number[p - start] = 0;
+    *value = strtod(number, NULL);
+    return ODID_SUCCESS;
+}
+
+static int readFloat(JsonInput *in, float *value)
+{
+    double number;
+
+    skipSpace(in);
+    if (readNumber(in, &number) != ODID_SUCCESS)
+        return ODID_FAIL;
+    *value = (float) number;
+    return ODID_SUCCESS;
+}
+
+static int readDouble(JsonInput *in, double *value)
+{
+    skipSpace(in);
+    return readNumber(in, value);
+}
+
+// Read an integer in the range [0, max]
+static int readUint(JsonInput *in, uint32_t max, uint32_t *value)
+{
+    double number;
+
+    skipSpace(in);
+    if (readNumber(in, &number) != ODID_SUCCESS)
+        return ODID_FAIL;
+    // Also false for NaN
+    if (!(number >= 0 && number <= max) || number != (double) (uint32_t) number)
+        return ODID_FAIL;
+    *value = (uint32_t) number;
+    return ODID_SUCCESS;
+}
+
+#define READ_UINT(in, max, field) \
+    do { \
+        uint32_t v_; \
+        if (readUint(in, max, &v_) != ODID_SUCCESS) \
+            return ODID_FAIL; \
+        field = v_; \
+    } while (0)
+
+#define READ_ENUM(in, type, field) \
+    do { \
+        uint32_t v_; \
+        if (readUint(in, UINT8_MAX, &v_) != ODID_SUCCESS) \
+            return ODID_FAIL; \
+        field = (type) v_; \
+    } while (0)
+
+static int skipValue(JsonInput *in, int depth)
+{
+    double number;
+    int key;
+
+    skipSpace(in);
+    if (in->p == in->end || depth > JSON_MAX_DEPTH)
+        return ODID_FAIL;
+
+    switch (*in->p) {
+    case '"':
+        return readString(in, NULL, 0);
+    case '{':
+        in->p++;
+        if (expect(in, '}') == ODID_SUCCESS)
+            return ODID_SUCCESS;
+        do {
+            if (readKey(in, &key) != ODID_SUCCESS || skipValue(in, depth + 1) != ODID_SUCCESS)
+                return ODID_FAIL;
+        } while (expect(in, ',') == ODID_SUCCESS);
+        return expect(in, '}');
+    case '[':
+        in->p++;
+        if (expect(in, ']') == ODID_SUCCESS)
+            return ODID_SUCCESS;
+        do {
+            if (skipValue(in, depth + 1) != ODID_SUCCESS)
+                return ODID_FAIL;
+        } while (expect(in, ',') == ODID_SUCCESS);
+        return expect(in, ']');
+    case 't':
+        if (in->end - in->p < 4 || memcmp(in->p, "true", 4) != 0)
+            return ODID_FAIL;
+        in->p += 4;
+        return ODID_SUCCESS;
+    case 'f':
+        if (in->end - in->p < 5 || memcmp(in->p, "false", 5) != 0)
+            return ODID_FAIL;
+        in->p += 5;
+        return ODID_SUCCESS;
+    default:
+        return readNumber(in, &number);
+    }
+}
+
+// The Pages array of the Authentication object, with pages 1 and up, null for
+// the pages that were not valid
+static int readPages(JsonInput *in, ODID_UAS_Data *uasData)
+{
+    int page = 1;
+
+    if (expect(in, '[') != ODID_SUCCESS)
+        return ODID_FAIL;
+    if (expect(in, ']') == ODID_SUCCESS)
+        return ODID_SUCCESS;
+    do {
+        if (page == ODID_AUTH_MAX_PAGES)
+            return ODID_FAIL;
+        skipSpace(in);
+        if (in->end - in->p >= 4 && memcmp(in->p, "null", 4) == 0) {
+            // A page that was not valid
+            in->p += 4;
+            page++;
+            continue;
+        }
+        if (readString(in, uasData->Auth[page].AuthData, ODID_STR_SIZE) != ODID_SUCCESS)
+            return ODID_FAIL;
+        uasData->Auth[page].DataPage = (uint8_t) page;
+        uasData->AuthValid[page] = 1;
+        page++;
+    } while (expect(in, ',') == ODID_SUCCESS);
+    return expect(in, ']');
+}
+
+static int readObject(JsonInput *in, ODID_UAS_Data *uasData, int object, int depth);
+
+/**
+* Read the value of a key into the ODID_UAS_Data
+*
+* @param in         Input, after the colon
+* @param uasData    Output
+* @param key        JSON_KEY_* of the value
+* @param depth      Nesting depth of the value
+* @return           ODID_SUCCESS or ODID_FAIL
+*/
+static int readValue(JsonInput *in, ODID_UAS_Data *uasData, int key, int depth)
+{
+    ODID_BasicID_data *basicID = &uasData->BasicID;
+    ODID_Location_data *loc = &uasData->Location;
+    ODID_Auth_data *auth = &uasData->Auth[0];
+    ODID_System_data *sys = &uasData->System;
+
+    switch (key) {
+    case JSON_KEY_RESPONSE:
+        return readObject(in, uasData, key, depth);
+    case JSON_KEY_BASIC_ID:
+        uasData->BasicIDValid = 1;
+        return readObject(in, uasData, key, depth);
+    case JSON_KEY_LOCATION:
+        uasData->LocationValid = 1;
+        return readObject(in, uasData, key, depth);
+    case JSON_KEY_AUTHENTICATION:
+        uasData->AuthValid[0] = 1;
+        return readObject(in, uasData, key, depth);
+    case JSON_KEY_SELF_ID:
+        uasData->SelfIDValid = 1;
+        return readObject(in, uasData, key, depth);
+    case JSON_KEY_OPERATOR:
+        uasData->SystemValid = 1;
+        return readObject(in, uasData, key, depth);
+    case JSON_KEY_OPERATOR_ID_MESSAGE:
+        uasData->OperatorIDValid = 1;
+        return readObject(in, uasData, key, depth);
+
+    case JSON_KEY_UA_TYPE: READ_ENUM(in, ODID_uatype_t, basicID->UAType); break;
+    case JSON_KEY_ID_TYPE: READ_ENUM(in, ODID_idtype_t, basicID->IDType); break;
+    case JSON_KEY_UASID:
+        skipSpace(in);
+        return readString(in, basicID->UASID, ODID_ID_SIZE);
+
+    case JSON_KEY_STATUS: READ_ENUM(in, ODID_status_t, loc->Status); break;
+    case JSON_KEY_DIRECTION: return readFloat(in, &loc->Direction);
+    case JSON_KEY_SPEED_HORIZONTAL: return readFloat(in, &loc->SpeedHorizontal);
+    case JSON_KEY_SPEED_VERTICAL: return readFloat(in, &loc->SpeedVertical);
+    case JSON_KEY_LATITUDE: return readDouble(in, &loc->Latitude);
+    case JSON_KEY_LONGITUDE: return readDouble(in, &loc->Longitude);
+    case JSON_KEY_ALTITUDE_BARO: return readFloat(in, &loc->AltitudeBaro);
+    case JSON_KEY_ALTITUDE_GEO: return readFloat(in, &loc->AltitudeGeo);
+    case JSON_KEY_HEIGHT_TYPE: READ_ENUM(in, ODID_Height_reference_t, loc->HeightType); break;
+    case JSON_KEY_HEIGHT: return readFloat(in, &loc->Height);
+    case JSON_KEY_HORIZ_ACCURACY: READ_ENUM(in, ODID_Horizontal_accuracy_t, loc->HorizAccuracy); break;
+    case JSON_KEY_VERT_ACCURACY: READ_ENUM(in, ODID_Vertical_accuracy_t, loc->VertAccuracy); break;
+    case JSON_KEY_BARO_ACCURACY: READ_ENUM(in, ODID_Vertical_accuracy_t, loc->BaroAccuracy); break;
+    case JSON_KEY_SPEED_ACCURACY: READ_ENUM(in, ODID_Speed_accuracy_t, loc->SpeedAccuracy); break;
+    case JSON_KEY_TS_ACCURACY: READ_ENUM(in, ODID_Timestamp_accuracy_t, loc->TSAccuracy); break;
+    case JSON_KEY_TIME_STAMP: return readFloat(in, &loc->TimeStamp);
+
+    case JSON_KEY_AUTH_TYPE: READ_ENUM(in, ODID_authtype_t, auth->AuthType); break;
+    case JSON_KEY_PAGE_COUNT: READ_UINT(in, UINT8_MAX, auth->PageCount); break;
+    case JSON_KEY_LENGTH: READ_UINT(in, UINT8_MAX, auth->Length); break;
+    case JSON_KEY_TIMESTAMP: READ_UINT(in, UINT32_MAX, auth->Timestamp); break;
+    case JSON_KEY_AUTH_TOKEN:
+        skipSpace(in);
+        return readString(in, auth->AuthData, ODID_STR_SIZE - ODID_AUTH_PAGE_0_DATA_SIZE);
+    case JSON_KEY_PAGES:
+        return readPages(in, uasData);
+
+    case JSON_KEY_DESC_TYPE: READ_ENUM(in, ODID_desctype_t, uasData->SelfID.DescType); break;
+    case JSON_KEY_DESCRIPTION:
+        skipSpace(in);
+        return readString(in, uasData->SelfID.Desc, ODID_STR_SIZE);
+
+    case JSON_KEY_LOCATION_SOURCE: READ_ENUM(in, ODID_location_source_t, sys->LocationSource); break;
+    case JSON_KEY_OPERATOR_LATITUDE: return readDouble(in, &sys->OperatorLatitude);
+    case JSON_KEY_OPERATOR_LONGITUDE: return readDouble(in, &sys->OperatorLongitude);
+    case JSON_KEY_AREA_COUNT: READ_UINT(in, UINT16_MAX, sys->AreaCount); break;
+    case JSON_KEY_AREA_RADIUS: READ_UINT(in, UINT16_MAX, sys->AreaRadius); break;
+    case JSON_KEY_AREA_CEILING: return readFloat(in, &sys->AreaCeiling);
+    case JSON_KEY_AREA_FLOOR: return readFloat(in, &sys->AreaFloor);
+
+    case JSON_KEY_OPERATOR_ID_TYPE:
+        READ_ENUM(in, ODID_operatorIdType_t, uasData->OperatorID.OperatorIdType);
+        break;
+    case JSON_KEY_OPERATOR_ID:
+        skipSpace(in);
+        return readString(in, uasData->OperatorID.OperatorId, ODID_ID_SIZE);
+
+    default:
+        return skipValue(in, depth);
+    }
+    return ODID_SUCCESS;
+}
+
+/**
+* Read an object of the schema
+*
+* Keys that belong to another object, like a Latitude in BasicID, are skipped
+* as unknown keys.
+*
+* @param in         Input
+* @param uasData    Output
+* @param object     JSON_KEY_* of the object, JSON_KEY_NONE for the document
+* @param depth      Nesting depth of the object
+* @return           ODID_SUCCESS or ODID_FAIL
+*/
+static int readObject(JsonInput *in, ODID_UAS_Data *uasData, int object, int depth)
+{
+    int key;
+
+    if (depth > JSON_MAX_DEPTH || expect(in, '{') != ODID_SUCCESS)
+        return ODID_FAIL;
+    if (expect(in, '}') == ODID_SUCCESS)
+        return ODID_SUCCESS;
+    do {
+        if (readKey(in, &key) != ODID_SUCCESS)
+            return ODID_FAIL;
+        if (key != JSON_KEY_NONE && KEY_PARENT[key] != object)
+            key = JSON_KEY_NONE;
+        if (readValue(in, uasData, key, depth + 1) != ODID_SUCCESS)
+            return ODID_FAIL;
+    } while (expect(in, ',') == ODID_SUCCESS);
+    return expect(in, '}');
+}
+
+/**
+* Read a JSON document written by odid_json_write() into an ODID_UAS_Data
+*
+* The data is cleared first. Each message object in the document sets its
+* Valid flag, so only the messages that were valid when the document was
+* written are valid after reading it. Pages sets the flags of the Auth pages
+* from 1 up that are not null. Unknown keys
+* are skipped, so documents with additional fields can be read. The input does
+* not need to be null terminated and is not modified.
+*
+* @param uasData    Output. Undefined if the document is invalid
+* @param json       Start of the document, may be preceded by white space
+* @param len        Number of bytes available, may be more than the document
+* @param used       Output: bytes up to the end of the document. May be NULL
+* @return           ODID_SUCCESS or ODID_FAIL
+*/
+int odid_json_read(ODID_UAS_Data *uasData, const char *json, size_t len, size_t *used)
+{
+    JsonInput in;
+
+    if (!uasData || !json)
+        return ODID_FAIL;
+
+    in.p = json;
+    in.end = json + len;
+    memset(uasData, 0, sizeof(*uasData));
+    if (readObject(&in, uasData, JSON_KEY_NONE, 0) != ODID_SUCCESS)
+        return ODID_FAIL;
+
+    for (int page = 1; page < ODID_AUTH_MAX_PAGES; page++)
+        uasData->Auth[page].AuthType = uasData->Auth[0].AuthType;
+    if (used)
+        *used = (size_t) (in.p - json);
+    return ODID_SUCCESS;
+}
+
+/**
+* Read newline separated JSON documents, as written with ODID_JSON_NEWLINE
+*
+* Invalid lines are counted and skipped. The buffer can be a memory mapped file
+* of any size.
+*
+* @param json       Documents
+* @param len        Length of the documents
+* @param callback   Called with each document, returns non-zero to stop
+* @param user       Passed to the callback
+* @param errors     Output: number of invalid lines. May be NULL
+* @return           Number of documents passed to the callback
+*/
+size_t odid_json_read_lines(const char *json, size_t len, ODID_Json_callback callback,
+                            void *user, size_t *errors)
+{
+    const char *p = json, *end = json + len;
+    ODID_UAS_Data uasData;
+    size_t count = 0, invalid = 0, used;
+
+    if (!json || !callback)
+        return 0;
+
+    while (p < end) {
+        if (*p == '\n' || *p == '\r' || *p == ' ' || *p == '\t') {
+            p++;
+            continue;
+        }
+        if (odid_json_read(&uasData, p, (size_t) (end - p), &used) == ODID_SUCCESS) {
+            p += used;
+            count++;
+            if (callback(user, &uasData) != 0)
+                break;
+            continue;
+        }
+        invalid++;
+        p = memchr(p, '\n', (size_t) (end - p));
+        if (!p)
+            break;
+    }
+    if (errors)
+        *errors = invalid;
+    return count;
+}
@@ -11,23 +11,31 @@ gabriel.c.cox@intel.com
 */
 
 #include "opendroneid.h"
+#include "wire.h"
 #include <stdlib.h>
+#ifndef ODID_NO_FLOAT
 #include <math.h>
+#endif
 #include <string.h>
 #include <stdio.h>
 #define ENABLE_DEBUG 1
 
+#ifndef ODID_NO_FLOAT
 const float SPEED_DIV[2] = {0.25f, 0.75f};
 const float VSPEED_DIV = 0.5;
 const int32_t LATLON_MULT = 10000000;
 const float ALT_DIV = 0.5;
 const int ALT_ADDER = 1000;
 const int DATA_AGE_DIV = 10;
+#endif // ODID_NO_FLOAT
 
 static char *safe_dec_copyfill(char *dstStr, const char *srcStr, int dstSize);
+#ifndef ODID_NO_FLOAT
 static int intRangeMax(int64_t inValue, int startRange, int endRange);
+#endif
 static int intInRange(int inValue, int startRange, int endRange);
 
+#ifndef ODID_NO_FLOAT
 /**
 * Encode direction as defined by Open Drone ID
 *
@@ -166,6 +174,7 @@ static uint16_t encodeAreaRadius(uint16_t Radius)
 {
     return (uint8_t) intRangeMax(Radius / 10, 0, 255);
 }
+#endif // ODID_NO_FLOAT
 
 /**
 * Encode Basic ID message (packed, ready for broadcast)
@@ -181,14 +190,22 @@ int encodeBasicIDMessage(ODID_BasicID_encoded *outEncoded, ODID_BasicID_data *in
         !intInRange(inData->UAType, 0, 15))
         return ODID_FAIL;
 
+#ifdef ODID_BYTE_CODEC
+    uint8_t *out = (uint8_t *) outEncoded;
+    out[0] = ODID_WIRE_HEADER(ODID_MESSAGETYPE_BASIC_ID);
+    out[ODID_BASICID_TYPES] = ODID_WIRE_NIBBLES(inData->IDType, inData->UAType);
+    strncpy((char *) &out[ODID_BASICID_UASID], inData->UASID, ODID_ID_SIZE);
+#else
     outEncoded->MessageType = ODID_MESSAGETYPE_BASIC_ID;
     outEncoded->ProtoVersion = ODID_PROTOCOL_VERSION;
     outEncoded->IDType = inData->IDType;
     outEncoded->UAType = inData->UAType;
     strncpy(outEncoded->UASID, inData->UASID, sizeof(outEncoded->UASID));
+#endif
     return ODID_SUCCESS;
 }
 
+#ifndef ODID_NO_FLOAT
 /**
 * Encode Location message (packed, ready for broadcast)
 *
@@ -201,6 +218,7 @@ int encodeLocationMessage(ODID_Location_encoded *outEncoded, ODID_Location_data
     uint8_t bitflag;
     if (!outEncoded || !inData ||
         !intInRange(inData->Status, 0, 15) ||
+        !intInRange(inData->HeightType, 0, 1) ||
         !intInRange(inData->HorizAccuracy, 0, 15) ||
         !intInRange(inData->VertAccuracy, 0, 15) ||
         !intInRange(inData->BaroAccuracy, 0, 15) ||
@@ -208,6 +226,28 @@ int encodeLocationMessage(ODID_Location_encoded *outEncoded, ODID_Location_data
         !intInRange(inData->TSAccuracy, 0, 15))
         return ODID_FAIL;
 
+#ifdef ODID_BYTE_CODEC
+    uint8_t *out = (uint8_t *) outEncoded;
+    uint8_t speedMult;
+    out[0] = ODID_WIRE_HEADER(ODID_MESSAGETYPE_LOCATION);
+    out[ODID_LOC_DIRECTION] = encodeDirection(inData->Direction, &bitflag);
+    out[ODID_LOC_SPEED_HORIZONTAL] = encodeSpeedHorizontal(inData->SpeedHorizontal, &speedMult);
+    out[ODID_LOC_FLAGS] = (uint8_t) ((inData->Status & 0x0F) << 4) |
+                          (inData->HeightType & 0x01 ? ODID_LOC_FLAG_HEIGHT_TYPE : 0) |
+                          (bitflag & 0x01 ? ODID_LOC_FLAG_EW_DIRECTION : 0) |
+                          (speedMult & 0x01 ? ODID_LOC_FLAG_SPEED_MULT : 0);
+    out[ODID_LOC_SPEED_VERTICAL] = (uint8_t) encodeSpeedVertical(inData->SpeedVertical);
+    odid_put_le32(&out[ODID_LOC_LATITUDE], (uint32_t) encodeLatLon(inData->Latitude));
+    odid_put_le32(&out[ODID_LOC_LONGITUDE], (uint32_t) encodeLatLon(inData->Longitude));
+    odid_put_le16(&out[ODID_LOC_ALTITUDE_BARO], (uint16_t) encodeAltitude(inData->AltitudeBaro));
+    odid_put_le16(&out[ODID_LOC_ALTITUDE_GEO], (uint16_t) encodeAltitude(inData->AltitudeGeo));
+    odid_put_le16(&out[ODID_LOC_HEIGHT], (uint16_t) encodeAltitude(inData->Height));
+    out[ODID_LOC_HV_ACCURACY] = ODID_WIRE_NIBBLES(inData->VertAccuracy, inData->HorizAccuracy);
+    out[ODID_LOC_BS_ACCURACY] = ODID_WIRE_NIBBLES(inData->BaroAccuracy, inData->SpeedAccuracy);
+    odid_put_le16(&out[ODID_LOC_TIMESTAMP], encodeTimeStamp(inData->TimeStamp));
+    out[ODID_LOC_TS_ACCURACY] = ODID_WIRE_NIBBLES(0, inData->TSAccuracy);
+    out[ODID_LOC_RESERVED3] = 0;
+#else
     outEncoded->MessageType = ODID_MESSAGETYPE_LOCATION;
     outEncoded->ProtoVersion = ODID_PROTOCOL_VERSION;
     outEncoded->Status = inData->Status;
@@ -231,8 +271,10 @@ int encodeLocationMessage(ODID_Location_encoded *outEncoded, ODID_Location_data
     outEncoded->Reserved2 = 0;
     outEncoded->TimeStamp = encodeTimeStamp(inData->TimeStamp);
     outEncoded->Reserved3 = 0;
+#endif
     return ODID_SUCCESS;
 }
+#endif // ODID_NO_FLOAT
 
 /**
 * Encode Auth message (packed, ready for broadcast)
@@ -243,9 +285,24 @@ int encodeLocationMessage(ODID_Location_encoded *outEncoded, ODID_Location_data
 */
 int encodeAuthMessage(ODID_Auth_encoded *outEncoded, ODID_Auth_data *inData)
 {
-    if (!outEncoded || !inData || !intInRange(inData->AuthType, 0, 15))
+    if (!outEncoded || !inData || !intInRange(inData->AuthType, 0, 15) ||
+        !intInRange(inData->DataPage, 0, 4))
         return ODID_FAIL;
 
+#ifdef ODID_BYTE_CODEC
+    uint8_t *out = (uint8_t *) outEncoded;
+    out[0] = ODID_WIRE_HEADER(ODID_MESSAGETYPE_AUTH);
+    out[ODID_AUTH_TYPE_PAGE] = ODID_WIRE_NIBBLES(inData->AuthType, inData->DataPage);
+    if (inData->DataPage == 0) {
+        out[ODID_AUTH_PAGE_COUNT] = inData->PageCount;
+        out[ODID_AUTH_LENGTH] = inData->Length;
+        odid_put_le32(&out[ODID_AUTH_TIMESTAMP], inData->Timestamp);
+        strncpy((char *) &out[ODID_AUTH_DATA_PAGE_0], inData->AuthData,
+                ODID_STR_SIZE - ODID_AUTH_PAGE_0_DATA_SIZE);
+    } else {
+        strncpy((char *) &out[ODID_AUTH_DATA_PAGE_1_4], inData->AuthData, ODID_STR_SIZE);
+    }
+#else
     outEncoded->page_0.MessageType = ODID_MESSAGETYPE_AUTH;
     outEncoded->page_0.ProtoVersion = ODID_PROTOCOL_VERSION;
     outEncoded->page_0.AuthType = inData->AuthType;
@@ -260,6 +317,7 @@ int encodeAuthMessage(ODID_Auth_encoded *outEncoded, ODID_Auth_data *inData)
         strncpy(outEncoded->page_1_4.AuthData, inData->AuthData,
                 sizeof(outEncoded->page_1_4.AuthData));
     }
+#endif
     return ODID_SUCCESS;
 }
 
@@ -275,13 +333,21 @@ int encodeSelfIDMessage(ODID_SelfID_encoded *outEncoded, ODID_SelfID_data *inDat
     if (!outEncoded || !inData)
         return ODID_FAIL;
 
+#ifdef ODID_BYTE_CODEC
+    uint8_t *out = (uint8_t *) outEncoded;
+    out[0] = ODID_WIRE_HEADER(ODID_MESSAGETYPE_SELF_ID);
+    out[ODID_SELFID_DESC_TYPE] = (uint8_t) inData->DescType;
+    strncpy((char *) &out[ODID_SELFID_DESC], inData->Desc, ODID_STR_SIZE);
+#else
     outEncoded->MessageType = ODID_MESSAGETYPE_SELF_ID;
     outEncoded->ProtoVersion = ODID_PROTOCOL_VERSION;
     outEncoded->DescType = inData->DescType;
     strncpy(outEncoded->Desc, inData->Desc, sizeof(outEncoded->Desc));
+#endif
     return ODID_SUCCESS;
 }
 
+#ifndef ODID_NO_FLOAT
 /**
 * Encode System message (packed, ready for broadcast)
 *
@@ -294,6 +360,18 @@ int encodeSystemMessage(ODID_System_encoded *outEncoded, ODID_System_data *inDat
     if (!outEncoded || !inData)
         return ODID_FAIL;
 
+#ifdef ODID_BYTE_CODEC
+    uint8_t *out = (uint8_t *) outEncoded;
+    out[0] = ODID_WIRE_HEADER(ODID_MESSAGETYPE_SYSTEM);
+    out[ODID_SYSTEM_FLAGS] = inData->LocationSource & 0x01 ? ODID_SYSTEM_LOCATION_SOURCE : 0;
+    odid_put_le32(&out[ODID_SYSTEM_OPERATOR_LAT], (uint32_t) encodeLatLon(inData->OperatorLatitude));
+    odid_put_le32(&out[ODID_SYSTEM_OPERATOR_LON], (uint32_t) encodeLatLon(inData->OperatorLongitude));
+    odid_put_le16(&out[ODID_SYSTEM_AREA_COUNT], inData->AreaCount);
+    out[ODID_SYSTEM_AREA_RADIUS] = (uint8_t) encodeAreaRadius(inData->AreaRadius);
+    odid_put_le16(&out[ODID_SYSTEM_AREA_CEILING], (uint16_t) encodeAltitude(inData->AreaCeiling));
+    odid_put_le16(&out[ODID_SYSTEM_AREA_FLOOR], (uint16_t) encodeAltitude(inData->AreaFloor));
+    memset(&out[ODID_SYSTEM_RESERVED2], 0, ODID_MESSAGE_SIZE - ODID_SYSTEM_RESERVED2);
+#else
     outEncoded->MessageType = ODID_MESSAGETYPE_SYSTEM;
     outEncoded->ProtoVersion = ODID_PROTOCOL_VERSION;
     outEncoded->Reserved = 0;
@@ -305,8 +383,10 @@ int encodeSystemMessage(ODID_System_encoded *outEncoded, ODID_System_data *inDat
     outEncoded->AreaCeiling = encodeAltitude(inData->AreaCeiling);
     outEncoded->AreaFloor = encodeAltitude(inData->AreaFloor);
     memset(outEncoded->Reserved2, 0, sizeof(outEncoded->Reserved2));
+#endif
     return ODID_SUCCESS;
 }
+#endif // ODID_NO_FLOAT
 
 /**
 * Encode Operator ID message (packed, ready for broadcast)
@@ -320,10 +400,17 @@ int encodeOperatorIDMessage(ODID_OperatorID_encoded *outEncoded, ODID_OperatorID
     if (!outEncoded || !inData)
         return ODID_FAIL;
 
+#ifdef ODID_BYTE_CODEC
+    uint8_t *out = (uint8_t *) outEncoded;
+    out[0] = ODID_WIRE_HEADER(ODID_MESSAGETYPE_OPERATOR_ID);
+    out[ODID_OPERATORID_TYPE] = (uint8_t) inData->OperatorIdType;
+    strncpy((char *) &out[ODID_OPERATORID_ID], inData->OperatorId, ODID_ID_SIZE);
+#else
     outEncoded->MessageType = ODID_MESSAGETYPE_OPERATOR_ID;
     outEncoded->ProtoVersion = ODID_PROTOCOL_VERSION;
     outEncoded->OperatorIdType = inData->OperatorIdType;
     strncpy(outEncoded->OperatorId, inData->OperatorId, sizeof(outEncoded->OperatorId));
+#endif
     return ODID_SUCCESS;
 }
 
@@ -377,11 +464,18 @@ int encodeMessagePack(ODID_MessagePack_encoded *outEncoded, ODID_MessagePack_dat
     if (checkPackContent(inData->Messages, inData->MsgPackSize) != ODID_SUCCESS)
         return ODID_FAIL;
 
+#ifdef ODID_BYTE_CODEC
+    uint8_t *out = (uint8_t *) outEncoded;
+    out[0] = ODID_WIRE_HEADER(ODID_MESSAGETYPE_PACKED);
+    out[ODID_PACK_SINGLE_MESSAGE_SIZE] = inData->SingleMessageSize;
+    out[ODID_PACK_MSG_PACK_SIZE] = inData->MsgPackSize;
+#else
     outEncoded->MessageType = ODID_MESSAGETYPE_PACKED;
     outEncoded->ProtoVersion = ODID_PROTOCOL_VERSION;
 
     outEncoded->SingleMessageSize = inData->SingleMessageSize;
     outEncoded->MsgPackSize = inData->MsgPackSize;
+#endif
 
     for (int i = 0; i < inData->MsgPackSize; i++)
         memcpy(&outEncoded->Messages[i], &inData->Messages[i], ODID_MESSAGE_SIZE);
@@ -389,6 +483,277 @@ int encodeMessagePack(ODID_MessagePack_encoded *outEncoded, ODID_MessagePack_dat
     return ODID_SUCCESS;
 }
 
+#ifndef ODID_NO_FLOAT
+/**
+* Initialize an encoder session. The first odid_session_encode() call encodes
+* all valid messages
+*
+* @param session    The session to initialize
+*/
+void odid_session_init(ODID_Encoder_session *session)
+{
+    memset(session, 0, sizeof(*session));
+}
+
+/**
+* Return the ODID_LOC_FIELD_* bits of the fields that differ between a and b
+*
+* The values are compared before quantization, so a change that encodes to the
+* same wire value is still reported
+*
+* @param a          First Location data
+* @param b          Second Location data
+* @return           Bit mask of the differing fields
+*/
+static uint32_t diffLocationFields(ODID_Location_data *a, ODID_Location_data *b)
+{
+    uint32_t fields = 0;
+
+    fields |= a->Status != b->Status ? ODID_LOC_FIELD_STATUS : 0;
+    fields |= a->Direction != b->Direction ? ODID_LOC_FIELD_DIRECTION : 0;
+    fields |= a->SpeedHorizontal != b->SpeedHorizontal ? ODID_LOC_FIELD_SPEED_HORIZONTAL : 0;
+    fields |= a->SpeedVertical != b->SpeedVertical ? ODID_LOC_FIELD_SPEED_VERTICAL : 0;
+    fields |= a->Latitude != b->Latitude ? ODID_LOC_FIELD_LATITUDE : 0;
+    fields |= a->Longitude != b->Longitude ? ODID_LOC_FIELD_LONGITUDE : 0;
+    fields |= a->AltitudeBaro != b->AltitudeBaro ? ODID_LOC_FIELD_ALTITUDE_BARO : 0;
+    fields |= a->AltitudeGeo != b->AltitudeGeo ? ODID_LOC_FIELD_ALTITUDE_GEO : 0;
+    fields |= a->HeightType != b->HeightType ? ODID_LOC_FIELD_HEIGHT_TYPE : 0;
+    fields |= a->Height != b->Height ? ODID_LOC_FIELD_HEIGHT : 0;
+    fields |= a->HorizAccuracy != b->HorizAccuracy ? ODID_LOC_FIELD_HORIZ_ACCURACY : 0;
+    fields |= a->VertAccuracy != b->VertAccuracy ? ODID_LOC_FIELD_VERT_ACCURACY : 0;
+    fields |= a->BaroAccuracy != b->BaroAccuracy ? ODID_LOC_FIELD_BARO_ACCURACY : 0;
+    fields |= a->SpeedAccuracy != b->SpeedAccuracy ? ODID_LOC_FIELD_SPEED_ACCURACY : 0;
+    fields |= a->TSAccuracy != b->TSAccuracy ? ODID_LOC_FIELD_TS_ACCURACY : 0;
+    fields |= a->TimeStamp != b->TimeStamp ? ODID_LOC_FIELD_TIMESTAMP : 0;
+    return fields;
+}
+
+// Fields that are validated by encodeLocationMessage(). Changes to these go
+// through a full encode instead of a field patch
+#define LOC_FIELDS_VALIDATED (ODID_LOC_FIELD_STATUS | ODID_LOC_FIELD_HEIGHT_TYPE | \
+                              ODID_LOC_FIELD_HORIZ_ACCURACY | ODID_LOC_FIELD_VERT_ACCURACY | \
+                              ODID_LOC_FIELD_BARO_ACCURACY | ODID_LOC_FIELD_SPEED_ACCURACY | \
+                              ODID_LOC_FIELD_TS_ACCURACY)
+
+/**
+* Re-encode only the given fields of an already encoded Location message
+*
+* Produces the same bytes as encodeLocationMessage() for the patched fields.
+* Only fields that do not need validation can be patched this way
+*
+* @param outEncoded Encoded message to update
+* @param inData     Input data (non encoded/packed) structure
+* @param fields     ODID_LOC_FIELD_* bits of the fields to re-encode
+*/
+static void patchLocationFields(ODID_Location_encoded *outEncoded, ODID_Location_data *inData,
+                                uint32_t fields)
+{
+    uint8_t *out = (uint8_t *) outEncoded;
+    uint8_t flag;
+
+    if (fields & ODID_LOC_FIELD_DIRECTION) {
+        out[ODID_LOC_DIRECTION] = encodeDirection(inData->Direction, &flag);
+        out[ODID_LOC_FLAGS] = (uint8_t) ((out[ODID_LOC_FLAGS] & ~ODID_LOC_FLAG_EW_DIRECTION) |
+                                         (flag ? ODID_LOC_FLAG_EW_DIRECTION : 0));
+    }
+    if (fields & ODID_LOC_FIELD_SPEED_HORIZONTAL) {
+        out[ODID_LOC_SPEED_HORIZONTAL] = encodeSpeedHorizontal(inData->SpeedHorizontal, &flag);
+        out[ODID_LOC_FLAGS] = (uint8_t) ((out[ODID_LOC_FLAGS] & ~ODID_LOC_FLAG_SPEED_MULT) |
+                                         (flag ? ODID_LOC_FLAG_SPEED_MULT : 0));
+    }
+    if (fields & ODID_LOC_FIELD_SPEED_VERTICAL)
+        out[ODID_LOC_SPEED_VERTICAL] = (uint8_t) encodeSpeedVertical(inData->SpeedVertical);
+    if (fields & ODID_LOC_FIELD_LATITUDE)
+        odid_put_le32(&out[ODID_LOC_LATITUDE], (uint32_t) encodeLatLon(inData->Latitude));
+    if (fields & ODID_LOC_FIELD_LONGITUDE)
+        odid_put_le32(&out[ODID_LOC_LONGITUDE], (uint32_t) encodeLatLon(inData->Longitude));
+    if (fields & ODID_LOC_FIELD_ALTITUDE_BARO)
+        odid_put_le16(&out[ODID_LOC_ALTITUDE_BARO], (uint16_t) encodeAltitude(inData->AltitudeBaro));
+    if (fields & ODID_LOC_FIELD_ALTITUDE_GEO)
+        odid_put_le16(&out[ODID_LOC_ALTITUDE_GEO], (uint16_t) encodeAltitude(inData->AltitudeGeo));
+    if (fields & ODID_LOC_FIELD_HEIGHT)
+        odid_put_le16(&out[ODID_LOC_HEIGHT], (uint16_t) encodeAltitude(inData->Height));
+    if (fields & ODID_LOC_FIELD_TIMESTAMP)
+        odid_put_le16(&out[ODID_LOC_TIMESTAMP], encodeTimeStamp(inData->TimeStamp));
+}
+
+static int basicIDEqual(ODID_BasicID_data *a, ODID_BasicID_data *b)
+{
+    return a->UAType == b->UAType && a->IDType == b->IDType &&
+           strncmp(a->UASID, b->UASID, sizeof(a->UASID)) == 0;
+}
+
+static int authEqual(ODID_Auth_data *a, ODID_Auth_data *b)
+{
+    return a->DataPage == b->DataPage && a->AuthType == b->AuthType &&
+           a->PageCount == b->PageCount && a->Length == b->Length &&
+           a->Timestamp == b->Timestamp &&
+           strncmp(a->AuthData, b->AuthData, sizeof(a->AuthData)) == 0;
+}
+
+static int selfIDEqual(ODID_SelfID_data *a, ODID_SelfID_data *b)
+{
+    return a->DescType == b->DescType &&
+           strncmp(a->Desc, b->Desc, sizeof(a->Desc)) == 0;
+}
+
+static int systemEqual(ODID_System_data *a, ODID_System_data *b)
+{
+    return a->LocationSource == b->LocationSource &&
+           a->OperatorLatitude == b->OperatorLatitude &&
+           a->OperatorLongitude == b->OperatorLongitude &&
+           a->AreaCount == b->AreaCount && a->AreaRadius == b->AreaRadius &&
+           a->AreaCeiling == b->AreaCeiling && a->AreaFloor == b->AreaFloor;
+}
+
+static int operatorIDEqual(ODID_OperatorID_data *a, ODID_OperatorID_data *b)
+{
+    return a->OperatorIdType == b->OperatorIdType &&
+           strncmp(a->OperatorId, b->OperatorId, sizeof(a->OperatorId)) == 0;
+}
+
+/*
+ * Re-encode one message of the session if it is valid in uasData and its data
+ * differs from the last encode. Updates the dirty/changed bit masks and the
+ * return value of odid_session_encode()
+ */
+#define SESSION_ENCODE(bit, valid, data, last, encoded, equal, encode) do { \
+        if (!(valid)) { \
+            session->Encoded &= ~(uint32_t) (bit); \
+            break; \
+        } \
+        if ((session->Encoded & (bit)) && equal(data, last)) \
+            break; \
+        uint8_t previous_[ODID_MESSAGE_SIZE]; \
+        memcpy(previous_, encoded, ODID_MESSAGE_SIZE); \
+        if (encode(encoded, data) != ODID_SUCCESS) { \
+            memcpy(encoded, previous_, ODID_MESSAGE_SIZE); \
+            ret = ODID_FAIL; \
+            break; \
+        } \
+        *(last) = *(data); \
+        dirtyBits |= (bit); \
+        if (!(session->Encoded & (bit)) || memcmp(previous_, encoded, ODID_MESSAGE_SIZE) != 0) \
+            changedBits |= (bit); \
+        session->Encoded |= (bit); \
+    } while (0)
+
+/**
+* Encode the messages of uasData that changed since the last call
+*
+* Only the messages marked valid in uasData are encoded. Messages whose data is
+* unchanged keep their bytes from the previous call. For the Location message,
+* changes to the validated enum fields cause a full encode, while changes to
+* the other fields only re-encode those fields. The result is identical to
+* encoding every message from scratch.
+*
+* @param session    Encoder session, initialized with odid_session_init()
+* @param uasData    Current data of all messages
+* @param dirty      Output: ODID_SESSION_* bits of the messages whose data
+*                   changed and that were re-encoded. May be NULL
+* @param changed    Output: ODID_SESSION_* bits of the messages whose encoded
+*                   bytes changed. May be NULL
+* @return           ODID_SUCCESS or ODID_FAIL if any message failed to encode.
+*                   A message that fails keeps its previously encoded bytes
+*/
+int odid_session_encode(ODID_Encoder_session *session, ODID_UAS_Data *uasData,
+                        uint32_t *dirty, uint32_t *changed)
+{
+    uint32_t dirtyBits = 0, changedBits = 0;
+    int ret = ODID_SUCCESS;
+
+    if (!session || !uasData)
+        return ODID_FAIL;
+
+    session->LocationFields = 0;
+    if (!uasData->LocationValid) {
+        session->Encoded &= ~(uint32_t) ODID_SESSION_LOCATION;
+    } else if (!(session->Encoded & ODID_SESSION_LOCATION)) {
+        if (encodeLocationMessage(&session->Location, &uasData->Location) == ODID_SUCCESS) {
+            session->Data.Location = uasData->Location;
+            session->LocationFields = ODID_LOC_FIELD_ALL;
+            session->Encoded |= ODID_SESSION_LOCATION;
+            dirtyBits |= ODID_SESSION_LOCATION;
+            changedBits |= ODID_SESSION_LOCATION;
+        } else {
+            ret = ODID_FAIL;
+        }
+    } else {
+        uint32_t fields = diffLocationFields(&uasData->Location, &session->Data.Location);
+        if (fields) {
+            uint8_t previous[ODID_MESSAGE_SIZE];
+            int result = ODID_SUCCESS;
+
+            memcpy(previous, &session->Location, ODID_MESSAGE_SIZE);
+            if (fields & LOC_FIELDS_VALIDATED)
+                result = encodeLocationMessage(&session->Location, &uasData->Location);
+            else
+                patchLocationFields(&session->Location, &uasData->Location, fields);
+
+            if (result == ODID_SUCCESS) {
+                session->Data.Location = uasData->Location;
+                session->LocationFields = fields;
+                dirtyBits |= ODID_SESSION_LOCATION;
+                if (memcmp(previous, &session->Location, ODID_MESSAGE_SIZE) != 0)
+                    changedBits |= ODID_SESSION_LOCATION;
+            } else {
+                memcpy(&session->Location, previous, ODID_MESSAGE_SIZE);
+                ret = ODID_FAIL;
+            }
+        }
+    }
+
+    SESSION_ENCODE(ODID_SESSION_BASIC_ID, uasData->BasicIDValid, &uasData->BasicID,
+                   &session->Data.BasicID, &session->BasicID, basicIDEqual, encodeBasicIDMessage);
+    for (int i = 0; i < ODID_AUTH_MAX_PAGES; i++)
+        SESSION_ENCODE(ODID_SESSION_AUTH(i), uasData->AuthValid[i], &uasData->Auth[i],
+                       &session->Data.Auth[i], &session->Auth[i], authEqual, encodeAuthMessage);
+    SESSION_ENCODE(ODID_SESSION_SELF_ID, uasData->SelfIDValid, &uasData->SelfID,
+                   &session->Data.SelfID, &session->SelfID, selfIDEqual, encodeSelfIDMessage);
+    SESSION_ENCODE(ODID_SESSION_SYSTEM, uasData->SystemValid, &uasData->System,
+                   &session->Data.System, &session->System, systemEqual, encodeSystemMessage);
+    SESSION_ENCODE(ODID_SESSION_OPERATOR_ID, uasData->OperatorIDValid, &uasData->OperatorID,
+                   &session->Data.OperatorID, &session->OperatorID, operatorIDEqual,
+                   encodeOperatorIDMessage);
+
+    if (dirty)
+        *dirty = dirtyBits;
+    if (changed)
+        *changed = changedBits;
+    return ret;
+}
+
+#ifndef ODID_DISABLE_DECODE_TABLES
+/*
+ * Lookup tables for the single byte fields of the Location and System
+ * messages, indexed by the encoded byte (and the flag bit, if there is one).
+ * The entries are constant expressions with the same float arithmetic as the
+ * arithmetic decoders below, so the compiler generates the tables at build
+ * time. They take about 5 kB of read-only data. Define
+ * ODID_DISABLE_DECODE_TABLES to use the arithmetic versions instead, e.g. on
+ * flash constrained microcontrollers.
+ */
+#define TABLE_4(f, i)   f(i), f((i) + 1), f((i) + 2), f((i) + 3)
+#define TABLE_16(f, i)  TABLE_4(f, i), TABLE_4(f, (i) + 4), TABLE_4(f, (i) + 8), TABLE_4(f, (i) + 12)
+#define TABLE_64(f, i)  TABLE_16(f, i), TABLE_16(f, (i) + 16), TABLE_16(f, (i) + 32), TABLE_16(f, (i) + 48)
+#define TABLE_256(f)    TABLE_64(f, 0), TABLE_64(f, 64), TABLE_64(f, 128), TABLE_64(f, 192)
+
+// These must match SPEED_DIV, VSPEED_DIV and the decoders below
+#define DIRECTION_ENTRY(i)      ((float) (i))
+#define DIRECTION_EW_ENTRY(i)   ((float) ((i) + 180))
+#define SPEED_ENTRY(i)          ((float) (i) * 0.25f)
+#define SPEED_MULT_ENTRY(i)     (((float) (i) * 0.75f) + (UINT8_MAX * 0.25f))
+#define SPEED_VERTICAL_ENTRY(i) ((float) ((i) < 128 ? (i) : (i) - 256) * 0.5f)
+#define AREA_RADIUS_ENTRY(i)    ((uint16_t) ((i) * 10))
+
+static const float DIRECTION_TABLE[2][256] = {
+    { TABLE_256(DIRECTION_ENTRY) }, { TABLE_256(DIRECTION_EW_ENTRY) } };
+static const float SPEED_HORIZONTAL_TABLE[2][256] = {
+    { TABLE_256(SPEED_ENTRY) }, { TABLE_256(SPEED_MULT_ENTRY) } };
+static const float SPEED_VERTICAL_TABLE[256] = { TABLE_256(SPEED_VERTICAL_ENTRY) };
+static const uint16_t AREA_RADIUS_TABLE[256] = { TABLE_256(AREA_RADIUS_ENTRY) };
+#endif // ODID_DISABLE_DECODE_TABLES
+
 /**
 * Dencode direction from Open Drone ID packed message
 *
@@ -398,10 +763,14 @@ int encodeMessagePack(ODID_MessagePack_encoded *outEncoded, ODID_MessagePack_dat
 */
 static float decodeDirection(uint8_t Direction_enc, uint8_t EWDirection)
 {
+#ifndef ODID_DISABLE_DECODE_TABLES
+    return DIRECTION_TABLE[EWDirection != 0][Direction_enc];
+#else
     if (EWDirection)
         return Direction_enc + 180;
     else
         return Direction_enc;
+#endif
 }
 
 /**
@@ -413,10 +782,14 @@ static float decodeDirection(uint8_t Direction_enc, uint8_t EWDirection)
 */
 static float decodeSpeedHorizontal(uint8_t Speed_enc, uint8_t mult)
 {
+#ifndef ODID_DISABLE_DECODE_TABLES
+    return SPEED_HORIZONTAL_TABLE[mult != 0][Speed_enc];
+#else
     if (mult)
         return ((float) Speed_enc * SPEED_DIV[1]) + (UINT8_MAX * SPEED_DIV[0]);
     else
         return (float) Speed_enc * SPEED_DIV[0];
+#endif
 }
 
 /**
@@ -427,7 +800,11 @@ static float decodeSpeedHorizontal(uint8_t Speed_enc, uint8_t mult)
 */
 static float decodeSpeedVertical(int8_t SpeedVertical_enc)
 {
+#ifndef ODID_DISABLE_DECODE_TABLES
+    return SPEED_VERTICAL_TABLE[(uint8_t) SpeedVertical_enc];
+#else
     return (float) SpeedVertical_enc * VSPEED_DIV;
+#endif
 }
 
 /**
@@ -473,8 +850,13 @@ static float decodeTimeStamp(uint16_t Seconds_enc)
 */
 static uint16_t decodeAreaRadius(uint8_t Radius_enc)
 {
+#ifndef ODID_DISABLE_DECODE_TABLES
+    return AREA_RADIUS_TABLE[Radius_enc];
+#else
     return (uint16_t) Radius_enc * 10;
+#endif
 }
+#endif // ODID_NO_FLOAT
 
 /**
 * Decode Basic ID data from packed message
@@ -485,6 +867,15 @@ static uint16_t decodeAreaRadius(uint8_t Radius_enc)
 */
 int decodeBasicIDMessage(ODID_BasicID_data *outData, ODID_BasicID_encoded *inEncoded)
 {
+#ifdef ODID_BYTE_CODEC
+    const uint8_t *in = (const uint8_t *) inEncoded;
+    if (!outData || !in || ODID_WIRE_TYPE(in[0]) != ODID_MESSAGETYPE_BASIC_ID)
+        return ODID_FAIL;
+
+    outData->IDType = (ODID_idtype_t) (in[ODID_BASICID_TYPES] >> 4);
+    outData->UAType = (ODID_uatype_t) (in[ODID_BASICID_TYPES] & 0x0F);
+    safe_dec_copyfill(outData->UASID, (const char *) &in[ODID_BASICID_UASID], sizeof(outData->UASID));
+#else
     if (!outData || !inEncoded ||
         inEncoded->MessageType != ODID_MESSAGETYPE_BASIC_ID ||
         !intInRange(inEncoded->IDType, 0, 15) ||
@@ -494,9 +885,11 @@ int decodeBasicIDMessage(ODID_BasicID_data *outData, ODID_BasicID_encoded *inEnc
     outData->IDType = (ODID_idtype_t) inEncoded->IDType;
     outData->UAType = (ODID_uatype_t) inEncoded->UAType;
     safe_dec_copyfill(outData->UASID, inEncoded->UASID, sizeof(outData->UASID));
+#endif
     return ODID_SUCCESS;
 }
 
+#ifndef ODID_NO_FLOAT
 /**
 * Decode Location data from packed message
 *
@@ -506,6 +899,29 @@ int decodeBasicIDMessage(ODID_BasicID_data *outData, ODID_BasicID_encoded *inEnc
 */
 int decodeLocationMessage(ODID_Location_data *outData, ODID_Location_encoded *inEncoded)
 {
+#ifdef ODID_BYTE_CODEC
+    const uint8_t *in = (const uint8_t *) inEncoded;
+    if (!outData || !in || ODID_WIRE_TYPE(in[0]) != ODID_MESSAGETYPE_LOCATION)
+        return ODID_FAIL;
+
+    uint8_t flags = in[ODID_LOC_FLAGS];
+    outData->Status = (ODID_status_t) (flags >> 4);
+    outData->Direction = decodeDirection(in[ODID_LOC_DIRECTION], flags & ODID_LOC_FLAG_EW_DIRECTION);
+    outData->SpeedHorizontal = decodeSpeedHorizontal(in[ODID_LOC_SPEED_HORIZONTAL], flags & ODID_LOC_FLAG_SPEED_MULT);
+    outData->SpeedVertical = decodeSpeedVertical((int8_t) in[ODID_LOC_SPEED_VERTICAL]);
+    outData->Latitude = decodeLatLon((int32_t) odid_get_le32(&in[ODID_LOC_LATITUDE]));
+    outData->Longitude = decodeLatLon((int32_t) odid_get_le32(&in[ODID_LOC_LONGITUDE]));
+    outData->AltitudeBaro = decodeAltitude(odid_get_le16(&in[ODID_LOC_ALTITUDE_BARO]));
+    outData->AltitudeGeo = decodeAltitude(odid_get_le16(&in[ODID_LOC_ALTITUDE_GEO]));
+    outData->HeightType = (ODID_Height_reference_t) ((flags & ODID_LOC_FLAG_HEIGHT_TYPE) != 0);
+    outData->Height = decodeAltitude(odid_get_le16(&in[ODID_LOC_HEIGHT]));
+    outData->HorizAccuracy = (ODID_Horizontal_accuracy_t) (in[ODID_LOC_HV_ACCURACY] & 0x0F);
+    outData->VertAccuracy = (ODID_Vertical_accuracy_t) (in[ODID_LOC_HV_ACCURACY] >> 4);
+    outData->BaroAccuracy = (ODID_Vertical_accuracy_t) (in[ODID_LOC_BS_ACCURACY] >> 4);
+    outData->SpeedAccuracy = (ODID_Speed_accuracy_t) (in[ODID_LOC_BS_ACCURACY] & 0x0F);
+    outData->TSAccuracy = (ODID_Timestamp_accuracy_t) (in[ODID_LOC_TS_ACCURACY] & 0x0F);
+    outData->TimeStamp = decodeTimeStamp(odid_get_le16(&in[ODID_LOC_TIMESTAMP]));
+#else
     if (!outData || !inEncoded ||
         inEncoded->MessageType != ODID_MESSAGETYPE_LOCATION ||
         !intInRange(inEncoded->Status, 0, 15))
@@ -527,8 +943,10 @@ int decodeLocationMessage(ODID_Location_data *outData, ODID_Location_encoded *in
     outData->SpeedAccuracy = (ODID_Speed_accuracy_t) inEncoded->SpeedAccuracy;
     outData->TSAccuracy = (ODID_Timestamp_accuracy_t) inEncoded->TSAccuracy;
     outData->TimeStamp = decodeTimeStamp(inEncoded->TimeStamp);
+#endif
     return ODID_SUCCESS;
 }
+#endif // ODID_NO_FLOAT
 
 /**
 * Get the page number of the authorization message
@@ -539,6 +957,14 @@ int decodeLocationMessage(ODID_Location_data *outData, ODID_Location_encoded *in
 */
 int getAuthPageNum(ODID_Auth_encoded *inEncoded, int *pageNum)
 {
+#ifdef ODID_BYTE_CODEC
+    const uint8_t *in = (const uint8_t *) inEncoded;
+    if (!in || ODID_WIRE_TYPE(in[0]) != ODID_MESSAGETYPE_AUTH ||
+        !intInRange(in[ODID_AUTH_TYPE_PAGE] & 0x0F, 0, 4))
+        return ODID_FAIL;
+
+    *pageNum = in[ODID_AUTH_TYPE_PAGE] & 0x0F;
+#else
     if (!inEncoded ||
         inEncoded->page_0.MessageType != ODID_MESSAGETYPE_AUTH ||
         !intInRange(inEncoded->page_0.AuthType, 0, 15) ||
@@ -546,6 +972,7 @@ int getAuthPageNum(ODID_Auth_encoded *inEncoded, int *pageNum)
         return ODID_FAIL;
 
     *pageNum = inEncoded->page_0.DataPage;
+#endif
     return ODID_SUCCESS;
 }
 
@@ -558,6 +985,25 @@ int getAuthPageNum(ODID_Auth_encoded *inEncoded, int *pageNum)
 */
 int decodeAuthMessage(ODID_Auth_data *outData, ODID_Auth_encoded *inEncoded)
 {
+#ifdef ODID_BYTE_CODEC
+    const uint8_t *in = (const uint8_t *) inEncoded;
+    if (!outData || !in || ODID_WIRE_TYPE(in[0]) != ODID_MESSAGETYPE_AUTH ||
+        !intInRange(in[ODID_AUTH_TYPE_PAGE] & 0x0F, 0, 4))
+        return ODID_FAIL;
+
+    outData->AuthType = (ODID_authtype_t) (in[ODID_AUTH_TYPE_PAGE] >> 4);
+    outData->DataPage = in[ODID_AUTH_TYPE_PAGE] & 0x0F;
+    if (outData->DataPage == 0) {
+        outData->PageCount = in[ODID_AUTH_PAGE_COUNT];
+        outData->Length = in[ODID_AUTH_LENGTH];
+        outData->Timestamp = odid_get_le32(&in[ODID_AUTH_TIMESTAMP]);
+        safe_dec_copyfill(outData->AuthData, (const char *) &in[ODID_AUTH_DATA_PAGE_0],
+                          sizeof(outData->AuthData) - ODID_AUTH_PAGE_0_DATA_SIZE);
+    } else {
+        safe_dec_copyfill(outData->AuthData, (const char *) &in[ODID_AUTH_DATA_PAGE_1_4],
+                          sizeof(outData->AuthData));
+    }
+#else
     if (!outData || !inEncoded ||
         inEncoded->page_0.MessageType != ODID_MESSAGETYPE_AUTH ||
         !intInRange(inEncoded->page_0.AuthType, 0, 15) ||
@@ -576,6 +1022,7 @@ int decodeAuthMessage(ODID_Auth_data *outData, ODID_Auth_encoded *inEncoded)
         safe_dec_copyfill(outData->AuthData, inEncoded->page_1_4.AuthData,
                           sizeof(outData->AuthData));
     }
+#endif
     return ODID_SUCCESS;
 }
 
@@ -588,15 +1035,25 @@ int decodeAuthMessage(ODID_Auth_data *outData, ODID_Auth_encoded *inEncoded)
 */
 int decodeSelfIDMessage(ODID_SelfID_data *outData, ODID_SelfID_encoded *inEncoded)
 {
+#ifdef ODID_BYTE_CODEC
+    const uint8_t *in = (const uint8_t *) inEncoded;
+    if (!outData || !in || ODID_WIRE_TYPE(in[0]) != ODID_MESSAGETYPE_SELF_ID)
+        return ODID_FAIL;
+
+    outData->DescType = (ODID_desctype_t) in[ODID_SELFID_DESC_TYPE];
+    safe_dec_copyfill(outData->Desc, (const char *) &in[ODID_SELFID_DESC], sizeof(outData->Desc));
+#else
     if (!outData || !inEncoded ||
         inEncoded->MessageType != ODID_MESSAGETYPE_SELF_ID)
         return ODID_FAIL;
 
     outData->DescType = (ODID_desctype_t) inEncoded->DescType;
     safe_dec_copyfill(outData->Desc, inEncoded->Desc, sizeof(outData->Desc));
+#endif
     return ODID_SUCCESS;
 }
 
+#ifndef ODID_NO_FLOAT
 /**
 * Decode System data from packed message
 *
@@ -606,6 +1063,19 @@ int decodeSelfIDMessage(ODID_SelfID_data *outData, ODID_SelfID_encoded *inEncode
 */
 int decodeSystemMessage(ODID_System_data *outData, ODID_System_encoded *inEncoded)
 {
+#ifdef ODID_BYTE_CODEC
+    const uint8_t *in = (const uint8_t *) inEncoded;
+    if (!outData || !in || ODID_WIRE_TYPE(in[0]) != ODID_MESSAGETYPE_SYSTEM)
+        return ODID_FAIL;
+
+    outData->LocationSource = (ODID_location_source_t) ((in[ODID_SYSTEM_FLAGS] & ODID_SYSTEM_LOCATION_SOURCE) != 0);
+    outData->OperatorLatitude = decodeLatLon((int32_t) odid_get_le32(&in[ODID_SYSTEM_OPERATOR_LAT]));
+    outData->OperatorLongitude = decodeLatLon((int32_t) odid_get_le32(&in[ODID_SYSTEM_OPERATOR_LON]));
+    outData->AreaCount = odid_get_le16(&in[ODID_SYSTEM_AREA_COUNT]);
+    outData->AreaRadius = decodeAreaRadius(in[ODID_SYSTEM_AREA_RADIUS]);
+    outData->AreaCeiling = decodeAltitude(odid_get_le16(&in[ODID_SYSTEM_AREA_CEILING]));
+    outData->AreaFloor = decodeAltitude(odid_get_le16(&in[ODID_SYSTEM_AREA_FLOOR]));
+#else
     if (!outData || !inEncoded ||
         inEncoded->MessageType != ODID_MESSAGETYPE_SYSTEM)
         return ODID_FAIL;
@@ -617,8 +1087,10 @@ int decodeSystemMessage(ODID_System_data *outData, ODID_System_encoded *inEncode
     outData->AreaRadius = decodeAreaRadius(inEncoded->AreaRadius);
     outData->AreaCeiling = decodeAltitude(inEncoded->AreaCeiling);
     outData->AreaFloor = decodeAltitude(inEncoded->AreaFloor);
+#endif
     return ODID_SUCCESS;
 }
+#endif // ODID_NO_FLOAT
 
 /**
 * Decode Operator ID data from packed message
@@ -629,38 +1101,155 @@ int decodeSystemMessage(ODID_System_data *outData, ODID_System_encoded *inEncode
 */
 int decodeOperatorIDMessage(ODID_OperatorID_data *outData, ODID_OperatorID_encoded *inEncoded)
 {
+#ifdef ODID_BYTE_CODEC
+    const uint8_t *in = (const uint8_t *) inEncoded;
+    if (!outData || !in || ODID_WIRE_TYPE(in[0]) != ODID_MESSAGETYPE_OPERATOR_ID)
+        return ODID_FAIL;
+
+    outData->OperatorIdType = (ODID_operatorIdType_t) in[ODID_OPERATORID_TYPE];
+    safe_dec_copyfill(outData->OperatorId, (const char *) &in[ODID_OPERATORID_ID], sizeof(outData->OperatorId));
+#else
     if (!outData || !inEncoded ||
         inEncoded->MessageType != ODID_MESSAGETYPE_OPERATOR_ID)
         return ODID_FAIL;
 
     outData->OperatorIdType = (ODID_operatorIdType_t) inEncoded->OperatorIdType;
     safe_dec_copyfill(outData->OperatorId, inEncoded->OperatorId, sizeof(outData->OperatorId));
+#endif
     return ODID_SUCCESS;
 }
 
+#ifndef ODID_NO_FLOAT
 /**
 * Decode Message Pack from packed message
 *
+* The messages are classified, counted and decoded in a single pass into a
+* staging structure. Only when the whole pack has been accepted are the
+* decoded messages copied to uasData, so a rejected pack leaves it untouched.
+* As before, single messages that fail to decode are skipped.
+*
 * @param uasData Output: Structure containing buffers for all message data
 * @param pack    Pointer to an encoded packed message
 * @return        ODID_SUCCESS or ODID_FAIL;
 */
 int decodeMessagePack(ODID_UAS_Data *uasData, ODID_MessagePack_encoded *pack)
 {
+    ODID_UAS_Data staging;
+    uint8_t numMessages[ODID_MESSAGETYPE_OPERATOR_ID + 1] = { 0 };
+    int amount;
+
+#ifdef ODID_BYTE_CODEC
+    const uint8_t *in = (const uint8_t *) pack;
+    if (!uasData || !in || ODID_WIRE_TYPE(in[0]) != ODID_MESSAGETYPE_PACKED)
+        return ODID_FAIL;
+
+    if (in[ODID_PACK_SINGLE_MESSAGE_SIZE] != ODID_MESSAGE_SIZE)
+        return ODID_FAIL;
+    amount = in[ODID_PACK_MSG_PACK_SIZE];
+#else
     if (!uasData || !pack || pack->MessageType != ODID_MESSAGETYPE_PACKED)
         return ODID_FAIL;
 
     if (pack->SingleMessageSize != ODID_MESSAGE_SIZE)
         return ODID_FAIL;
+    amount = pack->MsgPackSize;
+#endif
 
-    if (checkPackContent(pack->Messages, pack->MsgPackSize) != ODID_SUCCESS)
+    if (amount == 0 || amount > ODID_PACK_MAX_MESSAGES)
         return ODID_FAIL;
 
-    for (int i = 0; i < pack->MsgPackSize; i++) {
-        decodeOpenDroneID(uasData, pack->Messages[i].rawData);
+    // Only the valid flags need clearing. Each slot starts as a copy of the
+    // caller's data, as the decoders do not write every field (e.g. only
+    // Authentication page 0 has the page count), and is copied back if valid
+    staging.BasicIDValid = staging.LocationValid = 0;
+    staging.SelfIDValid = staging.SystemValid = staging.OperatorIDValid = 0;
+    memset(staging.AuthValid, 0, sizeof(staging.AuthValid));
+
+    for (int i = 0; i < amount; i++) {
+        uint8_t *msg = pack->Messages[i].rawData;
+        int pageNum;
+
+        // Same rules as checkPackContent(): no nested packs and max one of
+        // each message type, except up to five Authentication pages
+        switch (decodeMessageType(msg[0])) {
+        case ODID_MESSAGETYPE_BASIC_ID:
+            if (++numMessages[ODID_MESSAGETYPE_BASIC_ID] > 1)
+                return ODID_FAIL;
+            staging.BasicID = uasData->BasicID;
+            if (decodeBasicIDMessage(&staging.BasicID, (ODID_BasicID_encoded *) msg) == ODID_SUCCESS)
+                staging.BasicIDValid = 1;
+            break;
+        case ODID_MESSAGETYPE_LOCATION:
+            if (++numMessages[ODID_MESSAGETYPE_LOCATION] > 1)
+                return ODID_FAIL;
+            staging.Location = uasData->Location;
+            if (decodeLocationMessage(&staging.Location, (ODID_Location_encoded *) msg) == ODID_SUCCESS)
+                staging.LocationValid = 1;
+            break;
+        case ODID_MESSAGETYPE_AUTH:
+            if (++numMessages[ODID_MESSAGETYPE_AUTH] > ODID_AUTH_MAX_PAGES)
+                return ODID_FAIL;
+            if (getAuthPageNum((ODID_Auth_encoded *) msg, &pageNum) != ODID_SUCCESS)
+                break;
+            staging.Auth[pageNum] = uasData->Auth[pageNum];
+            if (decodeAuthMessage(&staging.Auth[pageNum], (ODID_Auth_encoded *) msg) == ODID_SUCCESS)
+                staging.AuthValid[pageNum] = 1;
+            break;
+        case ODID_MESSAGETYPE_SELF_ID:
+            if (++numMessages[ODID_MESSAGETYPE_SELF_ID] > 1)
+                return ODID_FAIL;
+            staging.SelfID = uasData->SelfID;
+            if (decodeSelfIDMessage(&staging.SelfID, (ODID_SelfID_encoded *) msg) == ODID_SUCCESS)
+                staging.SelfIDValid = 1;
+            break;
+        case ODID_MESSAGETYPE_SYSTEM:
+            if (++numMessages[ODID_MESSAGETYPE_SYSTEM] > 1)
+                return ODID_FAIL;
+            staging.System = uasData->System;
+            if (decodeSystemMessage(&staging.System, (ODID_System_encoded *) msg) == ODID_SUCCESS)
+                staging.SystemValid = 1;
+            break;
+        case ODID_MESSAGETYPE_OPERATOR_ID:
+            if (++numMessages[ODID_MESSAGETYPE_OPERATOR_ID] > 1)
+                return ODID_FAIL;
+            staging.OperatorID = uasData->OperatorID;
+            if (decodeOperatorIDMessage(&staging.OperatorID, (ODID_OperatorID_encoded *) msg) == ODID_SUCCESS)
+                staging.OperatorIDValid = 1;
+            break;
+        default:
+            return ODID_FAIL;
+        }
+    }
+
+    if (staging.BasicIDValid) {
+        uasData->BasicID = staging.BasicID;
+        uasData->BasicIDValid = 1;
+    }
+    if (staging.LocationValid) {
+        uasData->Location = staging.Location;
+        uasData->LocationValid = 1;
+    }
+    for (int i = 0; i < ODID_AUTH_MAX_PAGES; i++) {
+        if (staging.AuthValid[i]) {
+            uasData->Auth[i] = staging.Auth[i];
+            uasData->AuthValid[i] = 1;
+        }
+    }
+    if (staging.SelfIDValid) {
+        uasData->SelfID = staging.SelfID;
+        uasData->SelfIDValid = 1;
+    }
+    if (staging.SystemValid) {
+        uasData->System = staging.System;
+        uasData->SystemValid = 1;
+    }
+    if (staging.OperatorIDValid) {
+        uasData->OperatorID = staging.OperatorID;
+        uasData->OperatorIDValid = 1;
     }
     return ODID_SUCCESS;
 }
+#endif // ODID_NO_FLOAT
 
 /**
 * Decodes the message type of a packed Open Drone ID message
@@ -691,6 +1280,7 @@ ODID_messagetype_t decodeMessageType(uint8_t byte)
     }
 }
 
+#ifndef ODID_NO_FLOAT
 /**
 * Parse encoded Open Drone ID data to identify the message type. Then decode
 * from Open Drone ID packed format into the appropriate Open Drone ID structure
@@ -774,6 +1364,7 @@ ODID_messagetype_t decodeOpenDroneID(ODID_UAS_Data *uasData, uint8_t *msgData)
 
     return ODID_MESSAGETYPE_INVALID;
 }
+#endif // ODID_NO_FLOAT
 
 /**
 * Safely fill then copy string to destination (when decoding)
@@ -794,6 +1385,7 @@ static char *safe_dec_copyfill(char *dstStr, const char *srcStr, int dstSize)
     return dstStr;
 }
 
+#ifndef ODID_NO_FLOAT
 /**
 * Safely range check a value and return the minimum or max within the range if exceeded
 *
@@ -811,6 +1403,7 @@ static int intRangeMax(int64_t inValue, int startRange, int endRange) {
         return (int) inValue;
     }
 }
+#endif // ODID_NO_FLOAT
 
 /**
  * Determine if an Int is in range
@@ -829,6 +1422,53 @@ static int intInRange(int inValue, int startRange, int endRange)
     }
 }
 
+#ifndef ODID_NO_FLOAT
+/**
+* Count the number of thresholds that are strictly below a value
+*
+* The loop has no data dependent branches and compilers turn it into a few
+* vector compares. A NaN value compares false everywhere and gives 0, as in
+* the original if/else chains.
+*
+* @param thresholds Thresholds in ascending order
+* @param count Number of thresholds
+* @param value Value to compare with
+* @return Number of thresholds < value
+*/
+static int countThresholdsBelow(const float *thresholds, int count, float value)
+{
+    int below = 0;
+
+    for (int i = 0; i < count; i++)
+        below += thresholds[i] < value;
+    return below;
+}
+
+// Accuracy thresholds in ascending order. The enum for a value is looked up
+// by how many of the thresholds are below the value.
+static const float HORIZ_ACC_THRESHOLDS[] = { 0, 1, 3, 10, 30, 92.6f, 185.2f, 555.6f, 926, 1852, 3704, 7408 };
+static const uint8_t HORIZ_ACC_ENUMS[] = {
+    ODID_HOR_ACC_UNKNOWN, ODID_HOR_ACC_1_METER, ODID_HOR_ACC_3_METER,
+    ODID_HOR_ACC_10_METER, ODID_HOR_ACC_30_METER, ODID_HOR_ACC_0_05NM,
+    ODID_HOR_ACC_0_1NM, ODID_HOR_ACC_0_3NM, ODID_HOR_ACC_0_5NM, ODID_HOR_ACC_1NM,
+    ODID_HOR_ACC_2NM, ODID_HOR_ACC_4NM, ODID_HOR_ACC_10NM };
+static const float VERT_ACC_THRESHOLDS[] = { 0, 1, 3, 10, 25, 45 };
+static const uint8_t VERT_ACC_ENUMS[] = {
+    ODID_VER_ACC_UNKNOWN, ODID_VER_ACC_1_METER, ODID_VER_ACC_3_METER,
+    ODID_VER_ACC_10_METER, ODID_VER_ACC_25_METER, ODID_VER_ACC_45_METER,
+    ODID_VER_ACC_150_METER };
+static const float SPEED_ACC_THRESHOLDS[] = { 0, 0.3f, 1, 3 };
+static const uint8_t SPEED_ACC_ENUMS[] = {
+    ODID_SPEED_ACC_UNKNOWN, ODID_SPEED_ACC_0_3_METERS_PER_SECOND,
+    ODID_SPEED_ACC_1_METERS_PER_SECOND, ODID_SPEED_ACC_3_METERS_PER_SECOND,
+    ODID_SPEED_ACC_10_METERS_PER_SECOND };
+// The timestamp enums are equal to the number of thresholds below the value,
+// except that values above 1.5 s (all 16 thresholds) are unknown
+static const float TIME_ACC_THRESHOLDS[] = { 0.0f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f,
+                                             0.8f, 0.9f, 1.0f, 1.1f, 1.2f, 1.3f, 1.4f, 1.5f };
+
+#define ARRAY_COUNT(a) ((int) (sizeof(a) / sizeof((a)[0])))
+
 /**
 * This converts a horizontal accuracy float value to the corresponding enum
 *
@@ -839,32 +1479,8 @@ ODID_Horizontal_accuracy_t createEnumHorizontalAccuracy(float Accuracy)
 {
     if (Accuracy >= 18520)
         return ODID_HOR_ACC_UNKNOWN;
-    else if (Accuracy > 7408)
-        return ODID_HOR_ACC_10NM;
-    else if (Accuracy > 3704)
-        return ODID_HOR_ACC_4NM;
-    else if (Accuracy > 1852)
-        return ODID_HOR_ACC_2NM;
-    else if (Accuracy > 926)
-        return ODID_HOR_ACC_1NM;
-    else if (Accuracy > 555.6f)
-        return ODID_HOR_ACC_0_5NM;
-    else if (Accuracy > 185.2f)
-        return ODID_HOR_ACC_0_3NM;
-    else if (Accuracy > 92.6f)
-        return ODID_HOR_ACC_0_1NM;
-    else if (Accuracy > 30)
-        return ODID_HOR_ACC_0_05NM;
-    else if (Accuracy > 10)
-        return ODID_HOR_ACC_30_METER;
-    else if (Accuracy > 3)
-        return ODID_HOR_ACC_10_METER;
-    else if (Accuracy > 1)
-        return ODID_HOR_ACC_3_METER;
-    else if (Accuracy > 0)
-        return ODID_HOR_ACC_1_METER;
-    else
-        return ODID_HOR_ACC_UNKNOWN;
+    return (ODID_Horizontal_accuracy_t) HORIZ_ACC_ENUMS[
+        countThresholdsBelow(HORIZ_ACC_THRESHOLDS, ARRAY_COUNT(HORIZ_ACC_THRESHOLDS), Accuracy)];
 }
 
 /**
@@ -877,20 +1493,8 @@ ODID_Vertical_accuracy_t createEnumVerticalAccuracy(float Accuracy)
 {
     if (Accuracy >= 150)
         return ODID_VER_ACC_UNKNOWN;
-    else if (Accuracy > 45)
-        return ODID_VER_ACC_150_METER;
-    else if (Accuracy > 25)
-        return ODID_VER_ACC_45_METER;
-    else if (Accuracy > 10)
-        return ODID_VER_ACC_25_METER;
-    else if (Accuracy > 3)
-        return ODID_VER_ACC_10_METER;
-    else if (Accuracy > 1)
-        return ODID_VER_ACC_3_METER;
-    else if (Accuracy > 0)
-        return ODID_VER_ACC_1_METER;
-    else
-        return ODID_VER_ACC_UNKNOWN;
+    return (ODID_Vertical_accuracy_t) VERT_ACC_ENUMS[
+        countThresholdsBelow(VERT_ACC_THRESHOLDS, ARRAY_COUNT(VERT_ACC_THRESHOLDS), Accuracy)];
 }
 
 /**
@@ -903,16 +1507,8 @@ ODID_Speed_accuracy_t createEnumSpeedAccuracy(float Accuracy)
 {
     if (Accuracy >= 10)
         return ODID_SPEED_ACC_UNKNOWN;
-    else if (Accuracy > 3)
-        return ODID_SPEED_ACC_10_METERS_PER_SECOND;
-    else if (Accuracy > 1)
-        return ODID_SPEED_ACC_3_METERS_PER_SECOND;
-    else if (Accuracy > 0.3f)
-        return ODID_SPEED_ACC_1_METERS_PER_SECOND;
-    else if (Accuracy > 0)
-        return ODID_SPEED_ACC_0_3_METERS_PER_SECOND;
-    else
-        return ODID_SPEED_ACC_UNKNOWN;
+    return (ODID_Speed_accuracy_t) SPEED_ACC_ENUMS[
+        countThresholdsBelow(SPEED_ACC_THRESHOLDS, ARRAY_COUNT(SPEED_ACC_THRESHOLDS), Accuracy)];
 }
 
 /**
@@ -923,42 +1519,19 @@ ODID_Speed_accuracy_t createEnumSpeedAccuracy(float Accuracy)
 */
 ODID_Timestamp_accuracy_t createEnumTimestampAccuracy(float Accuracy)
 {
-    if (Accuracy > 1.5f)
-        return ODID_TIME_ACC_UNKNOWN;
-    else if (Accuracy > 1.4f)
-        return ODID_TIME_ACC_1_5_SECOND;
-    else if (Accuracy > 1.3f)
-        return ODID_TIME_ACC_1_4_SECOND;
-    else if (Accuracy > 1.2f)
-        return ODID_TIME_ACC_1_3_SECOND;
-    else if (Accuracy > 1.1f)
-        return ODID_TIME_ACC_1_2_SECOND;
-    else if (Accuracy > 1.0f)
-        return ODID_TIME_ACC_1_1_SECOND;
-    else if (Accuracy > 0.9f)
-        return ODID_TIME_ACC_1_0_SECOND;
-    else if (Accuracy > 0.8f)
-        return ODID_TIME_ACC_0_9_SECOND;
-    else if (Accuracy > 0.7f)
-        return ODID_TIME_ACC_0_8_SECOND;
-    else if (Accuracy > 0.6f)
-        return ODID_TIME_ACC_0_7_SECOND;
-    else if (Accuracy > 0.5f)
-        return ODID_TIME_ACC_0_6_SECOND;
-    else if (Accuracy > 0.4f)
-        return ODID_TIME_ACC_0_5_SECOND;
-    else if (Accuracy > 0.3f)
-        return ODID_TIME_ACC_0_4_SECOND;
-    else if (Accuracy > 0.2f)
-        return ODID_TIME_ACC_0_3_SECOND;
-    else if (Accuracy > 0.1f)
-        return ODID_TIME_ACC_0_2_SECOND;
-    else if (Accuracy > 0.0f)
-        return ODID_TIME_ACC_0_1_SECOND;
-    else
-        return ODID_TIME_ACC_UNKNOWN;
+    int count = countThresholdsBelow(TIME_ACC_THRESHOLDS, ARRAY_COUNT(TIME_ACC_THRESHOLDS), Accuracy);
+    // 16 thresholds below means > 1.5 s, which maps to ODID_TIME_ACC_UNKNOWN
+    return (ODID_Timestamp_accuracy_t) (count & 0x0F);
 }
 
+// Maximum accuracy per enum value, indexed by the enum
+static const float HORIZ_ACC_VALUES[] = { 18520, 18520, 7808, 3704, 1852, 926, 555.6f,
+                                          185.2f, 92.6f, 30, 10, 3, 1 };
+static const float VERT_ACC_VALUES[] = { 150, 150, 45, 25, 10, 3, 1 };
+static const float SPEED_ACC_VALUES[] = { 10, 10, 3, 1, 0.3f };
+static const float TIME_ACC_VALUES[] = { 0.0f, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f,
+                                         0.8f, 0.9f, 1.0f, 1.1f, 1.2f, 1.3f, 1.4f, 1.5f };
+
 /**
 * This decodes a horizontal accuracy enum to the corresponding float value
 *
@@ -967,37 +1540,9 @@ ODID_Timestamp_accuracy_t createEnumTimestampAccuracy(float Accuracy)
 */
 float decodeHorizontalAccuracy(ODID_Horizontal_accuracy_t Accuracy)
 {
-    switch (Accuracy)
-    {
-    case ODID_HOR_ACC_UNKNOWN:
-        return 18520;
-    case ODID_HOR_ACC_10NM:
-        return 18520;
-    case ODID_HOR_ACC_4NM:
-        return 7808;
-    case ODID_HOR_ACC_2NM:
-        return 3704;
-    case ODID_HOR_ACC_1NM:
-        return 1852;
-    case ODID_HOR_ACC_0_5NM:
-        return 926;
-    case ODID_HOR_ACC_0_3NM:
-        return 555.6f;
-    case ODID_HOR_ACC_0_1NM:
-        return 185.2f;
-    case ODID_HOR_ACC_0_05NM:
-        return 92.6f;
-    case ODID_HOR_ACC_30_METER:
-        return 30;
-    case ODID_HOR_ACC_10_METER:
-        return 10;
-    case ODID_HOR_ACC_3_METER:
-        return 3;
-    case ODID_HOR_ACC_1_METER:
-        return 1;
-    default:
-        return 18520;
-    }
+    if ((unsigned int) Accuracy < (unsigned int) ARRAY_COUNT(HORIZ_ACC_VALUES))
+        return HORIZ_ACC_VALUES[Accuracy];
+    return 18520;
 }
 
 /**
@@ -1008,25 +1553,9 @@ float decodeHorizontalAccuracy(ODID_Horizontal_accuracy_t Accuracy)
 */
 float decodeVerticalAccuracy(ODID_Vertical_accuracy_t Accuracy)
 {
-    switch (Accuracy)
-    {
-    case ODID_VER_ACC_UNKNOWN:
-        return 150;
-    case ODID_VER_ACC_150_METER:
-        return 150;
-    case ODID_VER_ACC_45_METER:
-        return 45;
-    case ODID_VER_ACC_25_METER:
-        return 25;
-    case ODID_VER_ACC_10_METER:
-        return 10;
-    case ODID_VER_ACC_3_METER:
-        return 3;
-    case ODID_VER_ACC_1_METER:
-        return 1;
-    default:
-        return 150;
-    }
+    if ((unsigned int) Accuracy < (unsigned int) ARRAY_COUNT(VERT_ACC_VALUES))
+        return VERT_ACC_VALUES[Accuracy];
+    return 150;
 }
 
 /**
@@ -1037,21 +1566,9 @@ float decodeVerticalAccuracy(ODID_Vertical_accuracy_t Accuracy)
 */
 float decodeSpeedAccuracy(ODID_Speed_accuracy_t Accuracy)
 {
-    switch (Accuracy)
-    {
-    case ODID_SPEED_ACC_UNKNOWN:
-        return 10;
-    case ODID_SPEED_ACC_10_METERS_PER_SECOND:
-        return 10;
-    case ODID_SPEED_ACC_3_METERS_PER_SECOND:
-        return 3;
-    case ODID_SPEED_ACC_1_METERS_PER_SECOND:
-        return 1;
-    case ODID_SPEED_ACC_0_3_METERS_PER_SECOND:
-        return 0.3f;
-    default:
-        return 10;
-    }
+    if ((unsigned int) Accuracy < (unsigned int) ARRAY_COUNT(SPEED_ACC_VALUES))
+        return SPEED_ACC_VALUES[Accuracy];
+    return 10;
 }
 
 /**
@@ -1062,46 +1579,13 @@ float decodeSpeedAccuracy(ODID_Speed_accuracy_t Accuracy)
 */
 float decodeTimestampAccuracy(ODID_Timestamp_accuracy_t Accuracy)
 {
-    switch (Accuracy)
-    {
-    case ODID_TIME_ACC_UNKNOWN:
-        return 0.0f;
-    case ODID_TIME_ACC_0_1_SECOND:
-        return 0.1f;
-    case ODID_TIME_ACC_0_2_SECOND:
-        return 0.2f;
-    case ODID_TIME_ACC_0_3_SECOND:
-        return 0.3f;
-    case ODID_TIME_ACC_0_4_SECOND:
-        return 0.4f;
-    case ODID_TIME_ACC_0_5_SECOND:
-        return 0.5f;
-    case ODID_TIME_ACC_0_6_SECOND:
-        return 0.6f;
-    case ODID_TIME_ACC_0_7_SECOND:
-        return 0.7f;
-    case ODID_TIME_ACC_0_8_SECOND:
-        return 0.8f;
-    case ODID_TIME_ACC_0_9_SECOND:
-        return 0.9f;
-    case ODID_TIME_ACC_1_0_SECOND:
-        return 1.0f;
-    case ODID_TIME_ACC_1_1_SECOND:
-        return 1.1f;
-    case ODID_TIME_ACC_1_2_SECOND:
-        return 1.2f;
-    case ODID_TIME_ACC_1_3_SECOND:
-        return 1.3f;
-    case ODID_TIME_ACC_1_4_SECOND:
-        return 1.4f;
-    case ODID_TIME_ACC_1_5_SECOND:
-        return 1.5f;
-    default:
-        return 0.0f;
-    }
+    if ((unsigned int) Accuracy < (unsigned int) ARRAY_COUNT(TIME_ACC_VALUES))
+        return TIME_ACC_VALUES[Accuracy];
+    return 0.0f;
 }
+#endif // ODID_NO_FLOAT
 
-#ifndef ODID_DISABLE_PRINTF
+#if !defined(ODID_DISABLE_PRINTF) && !defined(ODID_NO_FLOAT)
 
 /**
 * Print array of bytes as a hex string
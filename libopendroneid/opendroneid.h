@@ -229,6 +229,56 @@ typedef struct {
     char OperatorId[ODID_ID_SIZE+1]; // Additional byte to allow for null term in normative form
 } ODID_OperatorID_data;
 
+/*
+ * Fixed-point versions of ODID_Location_data and ODID_System_data, for targets
+ * without an FPU. See encodeLocationMessageFixed() and friends
+ */
+typedef struct {
+    ODID_status_t Status;
+    uint16_t Direction;       // Degrees. 0 <= x < 360. Invalid, No Value, or Unknown: 361deg
+    uint16_t SpeedHorizontal; // cm/s. Invalid, No Value, or Unknown: 25500cm/s. If speed is >= 25425 cm/s: 25425cm/s
+    int16_t SpeedVertical;    // cm/s. Invalid, No Value, or Unknown: 6300cm/s. If speed is >= 6200cm/s: 6200cm/s
+    int32_t Latitude;         // degE7 (degrees * 10^7). Invalid, No Value, or Unknown: 0 (both Lat/Lon)
+    int32_t Longitude;        // degE7 (degrees * 10^7). Invalid, No Value, or Unknown: 0 (both Lat/Lon)
+    int32_t AltitudeBaro;     // dm (Ref 29.92 inHg, 1013.24 mb). Invalid, No Value, or Unknown: -10000dm
+    int32_t AltitudeGeo;      // dm (WGS84-HAE). Invalid, No Value, or Unknown: -10000dm
+    ODID_Height_reference_t HeightType;
+    int32_t Height;           // dm. Invalid, No Value, or Unknown: -10000dm
+    ODID_Horizontal_accuracy_t HorizAccuracy;
+    ODID_Vertical_accuracy_t VertAccuracy;
+    ODID_Vertical_accuracy_t BaroAccuracy;
+    ODID_Speed_accuracy_t SpeedAccuracy;
+    ODID_Timestamp_accuracy_t TSAccuracy;
+    uint16_t TimeStamp;       // Tenths of seconds after the full hour
+} ODID_Location_fixed;
+
+typedef struct {
+    ODID_location_source_t LocationSource;
+    int32_t OperatorLatitude;  // degE7 (degrees * 10^7). Invalid, No Value, or Unknown: 0 (both Lat/Lon)
+    int32_t OperatorLongitude; // degE7 (degrees * 10^7). Invalid, No Value, or Unknown: 0 (both Lat/Lon)
+    uint16_t AreaCount;        // Default 1
+    uint16_t AreaRadius;       // meter. Default 0
+    int32_t AreaCeiling;       // dm. Invalid, No Value, or Unknown: -10000dm
+    int32_t AreaFloor;         // dm. Invalid, No Value, or Unknown: -10000dm
+} ODID_System_fixed;
+
+// ODID_UAS_Data with the fixed-point Location and System, see decodeOpenDroneIDFixed()
+typedef struct {
+    ODID_BasicID_data BasicID;
+    ODID_Location_fixed Location;
+    ODID_Auth_data Auth[ODID_AUTH_MAX_PAGES];
+    ODID_SelfID_data SelfID;
+    ODID_System_fixed System;
+    ODID_OperatorID_data OperatorID;
+
+    uint8_t BasicIDValid;
+    uint8_t LocationValid;
+    uint8_t AuthValid[ODID_AUTH_MAX_PAGES];
+    uint8_t SelfIDValid;
+    uint8_t SystemValid;
+    uint8_t OperatorIDValid;
+} ODID_UAS_fixed;
+
 typedef struct {
     ODID_BasicID_data BasicID;
     ODID_Location_data Location;
@@ -427,25 +477,247 @@ typedef struct {
     ODID_Messages_encoded Messages[ODID_PACK_MAX_MESSAGES];
 } ODID_MessagePack_data;
 
-// API Calls
+/*
+ * Output arrays for decodeOpenDroneIDBatch(). Each non-NULL array must hold
+ * one element per message in the batch. Message i is decoded into element i
+ * of the array for its type.
+ */
+typedef struct {
+    ODID_BasicID_data *BasicID;
+    ODID_Location_data *Location;
+    ODID_Auth_data *Auth;
+    ODID_SelfID_data *SelfID;
+    ODID_System_data *System;
+    ODID_OperatorID_data *OperatorID;
+} ODID_Batch_data;
+
+/*
+ * Encoder session. Keeps the encoded bytes of every message type together with
+ * the data they were encoded from, so that odid_session_encode() only needs to
+ * re-encode the messages whose data changed since the previous call.
+ */
+#define ODID_SESSION_BASIC_ID       (1 << 0)
+#define ODID_SESSION_LOCATION       (1 << 1)
+#define ODID_SESSION_SELF_ID        (1 << 2)
+#define ODID_SESSION_SYSTEM         (1 << 3)
+#define ODID_SESSION_OPERATOR_ID    (1 << 4)
+#define ODID_SESSION_AUTH(page)     (1 << (8 + (page)))
+
+// Fields of ODID_Location_data, as tracked in ODID_Encoder_session.LocationFields
+#define ODID_LOC_FIELD_STATUS           (1 << 0)
+#define ODID_LOC_FIELD_DIRECTION        (1 << 1)
+#define ODID_LOC_FIELD_SPEED_HORIZONTAL (1 << 2)
+#define ODID_LOC_FIELD_SPEED_VERTICAL   (1 << 3)
+#define ODID_LOC_FIELD_LATITUDE         (1 << 4)
+#define ODID_LOC_FIELD_LONGITUDE        (1 << 5)
+#define ODID_LOC_FIELD_ALTITUDE_BARO    (1 << 6)
+#define ODID_LOC_FIELD_ALTITUDE_GEO     (1 << 7)
+#define ODID_LOC_FIELD_HEIGHT_TYPE      (1 << 8)
+#define ODID_LOC_FIELD_HEIGHT           (1 << 9)
+#define ODID_LOC_FIELD_HORIZ_ACCURACY   (1 << 10)
+#define ODID_LOC_FIELD_VERT_ACCURACY    (1 << 11)
+#define ODID_LOC_FIELD_BARO_ACCURACY    (1 << 12)
+#define ODID_LOC_FIELD_SPEED_ACCURACY   (1 << 13)
+#define ODID_LOC_FIELD_TS_ACCURACY      (1 << 14)
+#define ODID_LOC_FIELD_TIMESTAMP        (1 << 15)
+#define ODID_LOC_FIELD_ALL              0xFFFF
+
+typedef struct {
+    ODID_UAS_Data Data; // Data of the last successful encode of each message
+
+    ODID_BasicID_encoded BasicID;
+    ODID_Location_encoded Location;
+    ODID_Auth_encoded Auth[ODID_AUTH_MAX_PAGES];
+    ODID_SelfID_encoded SelfID;
+    ODID_System_encoded System;
+    ODID_OperatorID_encoded OperatorID;
+
+    uint32_t Encoded;        // ODID_SESSION_* bits of the messages above that hold valid bytes
+    uint32_t LocationFields; // ODID_LOC_FIELD_* bits that changed in the last odid_session_encode()
+} ODID_Encoder_session;
+
+/*
+ * Stream decoder for byte oriented transports. Bytes are pushed in chunks of
+ * any size with odid_stream_push(). Single messages and message packs are
+ * found in them by their header byte, decoded into Data and passed to the
+ * callback together with their encoded bytes. A frame is decoded once the
+ * byte after it has arrived, odid_stream_flush() decodes the last one when the
+ * input ends.
+ */
+typedef void (*ODID_Stream_callback)(void *user, ODID_messagetype_t type,
+                                     const uint8_t *msg, const ODID_UAS_Data *uasData);
+
+typedef struct {
+    ODID_Stream_callback Callback;
+    void *User;
+
+    ODID_UAS_Data Data; // Latest decoded data of each message type
+
+    uint8_t Buffer[sizeof(ODID_MessagePack_encoded) + 1]; // Last frame of the previous push and the byte after it
+    size_t Length;
+    uint8_t Aligned;    // The buffered frame directly follows a decoded one
+
+    uint32_t Messages;  // Number of single messages decoded
+    uint32_t Packs;     // Number of message packs decoded
+    uint64_t Discarded; // Number of bytes skipped to find the start of a frame
+} ODID_Stream_decoder;
+
+/*
+ * Authentication data split over Auth pages. odid_auth_segment() creates the
+ * pages for sending. On the receiving side, odid_auth_reassemble() collects
+ * the pages of each source in an ODID_Auth_set, in any order, until all pages
+ * given by the page count in page 0 are present.
+ */
+#define ODID_AUTH_MAX_DATA_SIZE (ODID_STR_SIZE - ODID_AUTH_PAGE_0_DATA_SIZE + \
+                                 (ODID_AUTH_MAX_PAGES - 1) * ODID_STR_SIZE)
+
+typedef struct {
+    uint64_t Source;        // Sender of the pages
+    uint32_t LastUpdate;    // Receive time of the latest page
+    uint32_t Timestamp;     // From page 0
+    ODID_authtype_t AuthType;
+    uint8_t PageCount;      // From page 0
+    uint8_t Length;         // From page 0. Bytes of AuthData that are in use
+    uint8_t Pages;          // Bit n is set when page n has been received
+    uint8_t InUse;
+    uint8_t Complete;       // All pages received and the set handed back
+    uint8_t AuthData[ODID_AUTH_MAX_DATA_SIZE];
+} ODID_Auth_set;
+
+typedef struct {
+    ODID_Auth_set *Sets;    // Table supplied by the caller
+    size_t Count;
+    uint32_t Timeout;       // Partial sets without new pages for longer are dropped
+} ODID_Auth_reassembly;
+
+/*
+ * JSON export of ODID_UAS_Data, see odid_json_write(). Documents are appended
+ * to the caller's buffer. With a sink, the full buffer is handed to the sink
+ * and reused, so any number of documents can go through a small buffer.
+ * odid_json_read() and odid_json_read_lines() parse the documents back.
+ */
+#define ODID_JSON_AUTH_PAGES    (1 << 0) // All auth pages and the page 0 fields
+#define ODID_JSON_OPERATOR_ID   (1 << 1) // Add the OperatorID message
+#define ODID_JSON_NEWLINE       (1 << 2) // End the document with a newline, for NDJSON
+
+#define ODID_JSON_MIN_SIZE      256     // Smallest buffer for a writer with a sink
+#define ODID_JSON_MAX_SIZE      4096    // Largest document, with all flags set
+
+typedef int (*ODID_Json_sink)(void *user, const char *data, size_t len); // 0 on success
+typedef int (*ODID_Json_callback)(void *user, const ODID_UAS_Data *uasData); // Non-zero stops
+
+typedef struct {
+    char *Buffer;
+    size_t Size;
+    size_t Length;          // Bytes in Buffer. Without a sink they are followed by a null
+    ODID_Json_sink Sink;
+    void *User;
+} ODID_Json_writer;
+
+/*
+ * Compact binary records of ODID_UAS_Data, see record.c for the layout. The
+ * present byte of a record has a bit for each message it carries.
+ */
+#define ODID_RECORD_VERSION     1
+
+#define ODID_RECORD_BASIC_ID    (1 << 0)
+#define ODID_RECORD_LOCATION    (1 << 1)
+#define ODID_RECORD_AUTH        (1 << 2)
+#define ODID_RECORD_SELF_ID     (1 << 3)
+#define ODID_RECORD_SYSTEM      (1 << 4)
+#define ODID_RECORD_OPERATOR_ID (1 << 5)
+#define ODID_RECORD_RAW         (1 << 6) // Encoded messages passed through unchanged
+
+#define ODID_RECORD_MAX_SIZE    250     // Largest record without raw messages
+#define ODID_RECORD_RAW_SIZE(count) (1 + (count) * ODID_MESSAGE_SIZE)
+
+/*
+ * API Calls
+ *
+ * With ODID_NO_FLOAT, only the integer and fixed-point calls are declared. The
+ * float Location and System codecs, decodeMessagePack(), decodeOpenDroneID()
+ * and the calls built on them are left out; receivers decode with
+ * decodeOpenDroneIDFixed() and decodeMessagePackFixed() instead.
+ */
 int encodeBasicIDMessage(ODID_BasicID_encoded *outEncoded, ODID_BasicID_data *inData);
-int encodeLocationMessage(ODID_Location_encoded *outEncoded, ODID_Location_data *inData);
 int encodeAuthMessage(ODID_Auth_encoded *outEncoded, ODID_Auth_data *inData);
 int encodeSelfIDMessage(ODID_SelfID_encoded *outEncoded, ODID_SelfID_data *inData);
-int encodeSystemMessage(ODID_System_encoded *outEncoded, ODID_System_data *inData);
 int encodeOperatorIDMessage(ODID_OperatorID_encoded *outEncoded, ODID_OperatorID_data *inData);
 int encodeMessagePack(ODID_MessagePack_encoded *outEncoded, ODID_MessagePack_data *inData);
 
 int decodeBasicIDMessage(ODID_BasicID_data *outData, ODID_BasicID_encoded *inEncoded);
-int decodeLocationMessage(ODID_Location_data *outData, ODID_Location_encoded *inEncoded);
 int decodeAuthMessage(ODID_Auth_data *outData, ODID_Auth_encoded *inEncoded);
 int decodeSelfIDMessage(ODID_SelfID_data *outData, ODID_SelfID_encoded *inEncoded);
-int decodeSystemMessage(ODID_System_data *outData, ODID_System_encoded *inEncoded);
 int decodeOperatorIDMessage(ODID_OperatorID_data *outData, ODID_OperatorID_encoded *inEncoded);
+
+#ifndef ODID_NO_FLOAT
+int encodeLocationMessage(ODID_Location_encoded *outEncoded, ODID_Location_data *inData);
+int encodeSystemMessage(ODID_System_encoded *outEncoded, ODID_System_data *inData);
+int decodeLocationMessage(ODID_Location_data *outData, ODID_Location_encoded *inEncoded);
+int decodeSystemMessage(ODID_System_data *outData, ODID_System_encoded *inEncoded);
 int decodeMessagePack(ODID_UAS_Data *uasData, ODID_MessagePack_encoded *pack);
 
+// Batch API Calls
+int encodeLocationMessageBatch(ODID_Location_encoded *outEncoded, const ODID_Location_data *inData, size_t n);
+int decodeOpenDroneIDBatch(ODID_Batch_data *outData, ODID_messagetype_t *status,
+                           const uint8_t *msgs, size_t count);
+
+// Encoder session API Calls
+void odid_session_init(ODID_Encoder_session *session);
+int odid_session_encode(ODID_Encoder_session *session, ODID_UAS_Data *uasData,
+                        uint32_t *dirty, uint32_t *changed);
+#endif // ODID_NO_FLOAT
+
+// Fixed-point API Calls, integer arithmetic only
+int encodeLocationMessageFixed(ODID_Location_encoded *outEncoded, ODID_Location_fixed *inData);
+int encodeSystemMessageFixed(ODID_System_encoded *outEncoded, ODID_System_fixed *inData);
+int decodeLocationMessageFixed(ODID_Location_fixed *outData, ODID_Location_encoded *inEncoded);
+int decodeSystemMessageFixed(ODID_System_fixed *outData, ODID_System_encoded *inEncoded);
+int decodeMessagePackFixed(ODID_UAS_fixed *uasData, ODID_MessagePack_encoded *pack);
+ODID_messagetype_t decodeOpenDroneIDFixed(ODID_UAS_fixed *uasData, uint8_t *msgData);
+
+// Validation API Calls. Check messages and packs without decoding them
+#define ODID_TYPE_BIT(type) (1u << (type))
+uint32_t odid_validate_message(const uint8_t *msg);
+uint32_t odid_validate_pack(const uint8_t *pack, size_t len);
+
+#ifndef ODID_NO_FLOAT
+// Stream decoder API Calls
+void odid_stream_init(ODID_Stream_decoder *stream, ODID_Stream_callback callback, void *user);
+int odid_stream_push(ODID_Stream_decoder *stream, const uint8_t *data, size_t len);
+int odid_stream_flush(ODID_Stream_decoder *stream);
+#endif // ODID_NO_FLOAT
+
+// Auth page segmentation and reassembly API Calls
+int odid_auth_segment(ODID_Auth_encoded *pages, ODID_authtype_t authType,
+                      uint32_t timestamp, const uint8_t *data, size_t len,
+                      int *pageCount);
+void odid_auth_reassembly_init(ODID_Auth_reassembly *ctx, ODID_Auth_set *sets,
+                               size_t count, uint32_t timeout);
+const ODID_Auth_set *odid_auth_reassemble(ODID_Auth_reassembly *ctx, uint64_t source,
+                                          const ODID_Auth_encoded *auth, uint32_t now);
+void odid_auth_expire(ODID_Auth_reassembly *ctx, uint32_t now);
+
+#ifndef ODID_NO_FLOAT
+// JSON export and import API Calls
+void odid_json_init(ODID_Json_writer *writer, char *buffer, size_t size,
+                    ODID_Json_sink sink, void *user);
+int odid_json_write(ODID_Json_writer *writer, const ODID_UAS_Data *uasData, int flags);
+int odid_json_flush(ODID_Json_writer *writer);
+int odid_json_read(ODID_UAS_Data *uasData, const char *json, size_t len, size_t *used);
+size_t odid_json_read_lines(const char *json, size_t len, ODID_Json_callback callback,
+                            void *user, size_t *errors);
+
+// Binary record API Calls
+size_t odid_record_encode(uint8_t *buf, size_t size, const ODID_UAS_Data *uasData,
+                          const uint8_t *raw, size_t rawCount);
+size_t odid_record_decode(ODID_UAS_Data *uasData, const uint8_t *buf, size_t len,
+                          const uint8_t **raw, size_t *rawCount);
+#endif // ODID_NO_FLOAT
+
 int getAuthPageNum(ODID_Auth_encoded *inEncoded, int *pageNum);
 ODID_messagetype_t decodeMessageType(uint8_t byte);
+#ifndef ODID_NO_FLOAT
 ODID_messagetype_t decodeOpenDroneID(ODID_UAS_Data *uas_data, uint8_t *msg_data);
 
 // Helper Functions
@@ -459,14 +731,68 @@ float decodeVerticalAccuracy(ODID_Vertical_accuracy_t Accuracy);
 float decodeSpeedAccuracy(ODID_Speed_accuracy_t Accuracy);
 float decodeTimestampAccuracy(ODID_Timestamp_accuracy_t Accuracy);
 
+/*
+ * Zero-copy views over encoded messages
+ *
+ * Each accessor decodes one field directly from the ODID_MESSAGE_SIZE wire
+ * bytes at @msg, giving the same value as the matching decode*Message()
+ * function but without decoding the rest of the message. The message type is
+ * not checked, use odid_view_message_type() for that. The string accessors
+ * return a pointer into @msg, which is not null terminated if the string fills
+ * the whole field. Its length is written to @len if that is not NULL.
+ */
+ODID_messagetype_t odid_view_message_type(const uint8_t *msg);
+
+ODID_uatype_t odid_basicid_view_uatype(const uint8_t *msg);
+ODID_idtype_t odid_basicid_view_idtype(const uint8_t *msg);
+const char *odid_basicid_view_uasid(const uint8_t *msg, size_t *len);
+
+ODID_status_t odid_loc_view_status(const uint8_t *msg);
+ODID_Height_reference_t odid_loc_view_height_type(const uint8_t *msg);
+float odid_loc_view_direction(const uint8_t *msg);
+float odid_loc_view_speed_horizontal(const uint8_t *msg);
+float odid_loc_view_speed_vertical(const uint8_t *msg);
+double odid_loc_view_lat(const uint8_t *msg);
+double odid_loc_view_lon(const uint8_t *msg);
+float odid_loc_view_alt_baro(const uint8_t *msg);
+float odid_loc_view_alt_geo(const uint8_t *msg);
+float odid_loc_view_height(const uint8_t *msg);
+ODID_Horizontal_accuracy_t odid_loc_view_horiz_accuracy(const uint8_t *msg);
+ODID_Vertical_accuracy_t odid_loc_view_vert_accuracy(const uint8_t *msg);
+ODID_Vertical_accuracy_t odid_loc_view_baro_accuracy(const uint8_t *msg);
+ODID_Speed_accuracy_t odid_loc_view_speed_accuracy(const uint8_t *msg);
+float odid_loc_view_timestamp(const uint8_t *msg);
+ODID_Timestamp_accuracy_t odid_loc_view_ts_accuracy(const uint8_t *msg);
+
+int odid_auth_view_page(const uint8_t *msg);
+ODID_authtype_t odid_auth_view_type(const uint8_t *msg);
+
+ODID_desctype_t odid_selfid_view_desc_type(const uint8_t *msg);
+const char *odid_selfid_view_desc(const uint8_t *msg, size_t *len);
+
+ODID_location_source_t odid_system_view_location_source(const uint8_t *msg);
+double odid_system_view_operator_lat(const uint8_t *msg);
+double odid_system_view_operator_lon(const uint8_t *msg);
+uint16_t odid_system_view_area_count(const uint8_t *msg);
+uint16_t odid_system_view_area_radius(const uint8_t *msg);
+float odid_system_view_area_ceiling(const uint8_t *msg);
+float odid_system_view_area_floor(const uint8_t *msg);
+
+ODID_operatorIdType_t odid_operatorid_view_type(const uint8_t *msg);
+const char *odid_operatorid_view_id(const uint8_t *msg, size_t *len);
+
 // OpenDroneID WiFi functions
 
 /**
- * drone_export_gps_data - prints drone information to json style string,
- * according to odid message specification
+ * drone_export_gps_data - prints drone information to a JSON string,
+ * in the format of odid_json_write()
  * @UAS_Data: general drone status information
  *
- * Returns pointer to gps_data string on success, otherwise returns NULL
+ * The document is a single line of valid JSON, where it used to be
+ * pretty-printed with unquoted strings. It has the keys of the old document,
+ * plus HeightType, BaroAccuracy, DescType and AreaFloor.
+ *
+ * Returns pointer to a malloc'ed gps_data string on success, otherwise returns NULL
  */
 char *drone_export_gps_data(ODID_UAS_Data *UAS_Data);
 
@@ -476,7 +802,12 @@ char *drone_export_gps_data(ODID_UAS_Data *UAS_Data);
  * @pack: buffer space to write to
  * @buflen: maximum length of buffer space
  *
- * Returns length on success, < 0 on failure. @buf only contains a valid message
+ * The pack holds each valid message of @UAS_Data: Basic ID, Location, the
+ * Authentication pages, Self ID, System and Operator ID, in this order. It is
+ * built with encodeMessagePack().
+ *
+ * Returns length on success, < 0 on failure, -EINVAL if no message is valid or
+ * a valid message cannot be encoded. @buf only contains a valid message
  * if the return code is >0
  */
 int odid_message_encode_pack(ODID_UAS_Data *UAS_Data, void *pack, size_t buflen);
@@ -500,6 +831,9 @@ int odid_wifi_build_message_pack_nan_action_frame(ODID_UAS_Data *UAS_Data, char
  * @pack: buffer space to read from
  * @buflen: length of buffer space
  *
+ * Packs with any content accepted by decodeMessagePack() are decoded by it,
+ * which sets the valid flag of each message decoded.
+ *
  * Returns 0 on success
  */
 int odid_message_decode_pack(ODID_UAS_Data *UAS_Data, uint8_t *pack, size_t buflen);
@@ -555,6 +889,147 @@ struct __attribute__((__packed__)) ODID_service_info {
 	ODID_MessagePack_encoded odid_message_pack[];
 };
 
+/* Length of a NAN action frame up to the message pack */
+#define ODID_NAN_HEADER_SIZE (sizeof(struct ieee80211_mgmt) + \
+			      sizeof(struct nan_service_discovery) + \
+			      sizeof(struct nan_service_descriptor_attribute) + \
+			      sizeof(struct ODID_service_info))
+
+/**
+ * struct odid_nan_frame - NAN action frame that is updated in place
+ * @buf: the frame, its headers only depend on the MAC address
+ * @len: length of the frame, 0 until the first update
+ * @slots: which messages the message pack holds, see odid_message_encode_pack()
+ */
+struct odid_nan_frame {
+	uint8_t buf[ODID_NAN_HEADER_SIZE + sizeof(ODID_MessagePack_encoded)];
+	int len;
+	uint32_t slots;
+};
+
+/* odid_wifi_prepare_message_pack_nan_action_frame - writes the parts of a NAN
+ * action frame that do not change between frames
+ * @frame: frame to prepare
+ * @mac: mac address of the wifi adapter where the NAN frame will be sent
+ *
+ * Writes the same headers as odid_wifi_build_message_pack_nan_action_frame()
+ * once, the messages are encoded by the first
+ * odid_wifi_update_message_pack_nan_action_frame().
+ *
+ * Returns 0 on success, or < 0 on error.
+ */
+int odid_wifi_prepare_message_pack_nan_action_frame(struct odid_nan_frame *frame, char *mac);
+
+/* odid_wifi_update_message_pack_nan_action_frame - brings a prepared frame up
+ * to date for the next send
+ * @frame: frame prepared by odid_wifi_prepare_message_pack_nan_action_frame()
+ * @UAS_Data: general drone status information
+ * @send_counter: sequence number, to be increase for each frame sent
+ * @changed: ODID_TYPE_BIT() of each message type whose data changed since the
+ *	     last update, e.g. ODID_TYPE_BIT(ODID_MESSAGETYPE_LOCATION)
+ *
+ * Only the messages in @changed are encoded again. All valid messages are
+ * encoded on the first update and when other messages are valid than in the
+ * last update. The counter and the length fields are always written.
+ * @frame->buf then holds the same frame as
+ * odid_wifi_build_message_pack_nan_action_frame() would build.
+ *
+ * Returns the packet length, or < 0 on error.
+ */
+int odid_wifi_update_message_pack_nan_action_frame(struct odid_nan_frame *frame,
+						   ODID_UAS_Data *UAS_Data,
+						   uint8_t send_counter, uint32_t changed);
+
+/**
+ * struct odid_nan_frame_view - messages of a received NAN action frame, in place
+ * @mac: sender MAC address, 6 bytes in the frame
+ * @message_counter: counter of the frame
+ * @pack: message pack in the frame, for decodeMessagePack()
+ * @pack_len: length of the frame from @pack on
+ * @count: number of messages in the pack
+ * @types: ODID_TYPE_BIT() of the message types in the pack, invalid types left out
+ * @messages: each message, ODID_MESSAGE_SIZE bytes in the frame
+ */
+struct odid_nan_frame_view {
+	const uint8_t *mac;
+	uint8_t message_counter;
+	const uint8_t *pack;
+	size_t pack_len;
+	int count;
+	uint32_t types;
+	const uint8_t *messages[ODID_PACK_MAX_MESSAGES];
+};
+
+/* odid_wifi_parse_message_pack_nan_action_frame - finds the messages of a
+ * received NAN action frame without copying or decoding them
+ * @view: output, points into @buf
+ * @buf: pointer to buffer space where the NAN is stored
+ * @buf_size: size of the frame
+ *
+ * The headers are checked as odid_wifi_receive_message_pack_nan_action_frame()
+ * does, with a single mask and compare of the constant bytes, and so are the
+ * length, type, message size and message count of the pack. The messages
+ * themselves are not checked: odid_validate_pack() or decodeMessagePack() on
+ * @view->pack, or the odid_*_view_*() accessors on @view->messages, can be used
+ * after filtering on @view->mac and @view->message_counter.
+ *
+ * Returns 0 on success, or < 0 on error.
+ */
+int odid_wifi_parse_message_pack_nan_action_frame(struct odid_nan_frame_view *view,
+						  const uint8_t *buf, size_t buf_size);
+
+/**
+ * struct odid_wifi_frame - received frame, starting at the IEEE 802.11 management header
+ * @buf: the frame
+ * @len: length of the frame
+ * @timestamp: receive time, in any unit, copied to the output
+ * @rssi: signal strength, copied to the output
+ */
+struct odid_wifi_frame {
+	const uint8_t *buf;
+	size_t len;
+	uint64_t timestamp;
+	int8_t rssi;
+};
+
+/**
+ * struct odid_wifi_batch - output arrays of odid_wifi_receive_nan_batch()
+ * @status: 0 for an ODID frame, -EINVAL if the frame is not one and -EBADMSG
+ *	    if its message pack does not decode. Required
+ * @mac: sender address
+ * @message_counter: counter of the frame
+ * @timestamp: receive time of the frame
+ * @rssi: signal strength of the frame
+ * @uas: decoded data, cleared first, so only the messages of the frame are
+ *	 valid. If NULL, the message packs are not decoded
+ *
+ * Each array other than @status may be NULL, otherwise it must hold one
+ * element per frame. Frame i goes to element i. For frames with a negative
+ * status, only @timestamp and @rssi are written.
+ */
+struct odid_wifi_batch {
+	int *status;
+	uint8_t (*mac)[6];
+	uint8_t *message_counter;
+	uint64_t *timestamp;
+	int8_t *rssi;
+	ODID_UAS_Data *uas;
+};
+
+/* odid_wifi_receive_nan_batch - parses and decodes a batch of received frames
+ * @out: output arrays
+ * @frames: the frames, e.g. from recvmmsg() or a packet ring
+ * @count: number of frames
+ *
+ * Gives each frame the result of odid_wifi_receive_message_pack_nan_action_frame().
+ * Each frame is parsed and, if it is an ODID frame, decoded, while the frames a
+ * few places ahead in @frames are prefetched.
+ *
+ * Returns the number of frames decoded, or parsed if @out->uas is NULL.
+ */
+int odid_wifi_receive_nan_batch(struct odid_wifi_batch *out,
+				const struct odid_wifi_frame *frames, size_t count);
+
 #ifndef ODID_DISABLE_PRINTF
 void printByteArray(uint8_t *byteArray, uint16_t asize, int spaced);
 void printBasicID_data(ODID_BasicID_data *BasicID);
@@ -564,5 +1039,6 @@ void printSelfID_data(ODID_SelfID_data *SelfID);
 void printOperatorID_data(ODID_OperatorID_data *OperatorID);
 void printSystem_data(ODID_System_data *System_data);
 #endif // ODID_DISABLE_PRINTF
+#endif // ODID_NO_FLOAT
 
 #endif // _OPENDRONEID_H_
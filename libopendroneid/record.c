@@ -0,0 +1,427 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include "opendroneid.h"
+#include "wire.h"
+#include <string.h>
+
+/*
+ * Compact binary records of ODID_UAS_Data, for shipping decoded state between
+ * machines. All values are little-endian, fixed-width integers in the units of
+ * ODID_Location_fixed and ODID_System_fixed, so values decoded from messages
+ * survive the round trip exactly. A record is:
+ *
+ *   u8 version, u8 present (ODID_RECORD_* bits), u8 auth pages (bit n: page n)
+ *
+ * followed by each present message, in the order of the bits:
+ *
+ *   BasicID     u8 [IDType][UAType], str UASID
+ *   Location    u8 [Status][HeightType], u16 Direction, u16 SpeedHorizontal,
+ *               i16 SpeedVertical, i32 Latitude, i32 Longitude,
+ *               i32 AltitudeBaro, i32 AltitudeGeo, i32 Height,
+ *               u8 [VertAccuracy][HorizAccuracy],
+ *               u8 [BaroAccuracy][SpeedAccuracy], u8 TSAccuracy, u16 TimeStamp
+ *   Auth page   u8 AuthType, then for page 0: u8 PageCount, u8 Length,
+ *               u32 Timestamp; str AuthData
+ *   SelfID      u8 DescType, str Desc
+ *   System      u8 LocationSource, i32 OperatorLatitude, i32 OperatorLongitude,
+ *               u16 AreaCount, u16 AreaRadius, i32 AreaCeiling, i32 AreaFloor
+ *   OperatorID  u8 OperatorIdType, str OperatorId
+ *   Raw         u8 count, count encoded messages of ODID_MESSAGE_SIZE bytes
+ *
+ * where str is a u8 length and that many bytes, without a terminating null.
+ */
+
+#define RECORD_HEADER_SIZE      3
+#define RECORD_LOCATION_SIZE    32
+#define RECORD_AUTH_PAGE_0_SIZE 7
+#define RECORD_SYSTEM_SIZE      21
+
+#define RECORD_PRESENT_ALL (ODID_RECORD_BASIC_ID | ODID_RECORD_LOCATION | ODID_RECORD_AUTH | \
+                            ODID_RECORD_SELF_ID | ODID_RECORD_SYSTEM | ODID_RECORD_OPERATOR_ID | \
+                            ODID_RECORD_RAW)
+
+// Round to the nearest integer in the given unit, saturating at the int32 range
+static int32_t toFixed(double value, double scale)
+{
+    value *= scale;
+    if (value != value)
+        return 0;
+    if (value >= INT32_MAX)
+        return INT32_MAX;
+    if (value <= INT32_MIN)
+        return INT32_MIN;
+    return (int32_t) (value < 0 ? value - 0.5 : value + 0.5);
+}
+
+static uint16_t toFixedU16(double value, double scale)
+{
+    int32_t fixed = toFixed(value, scale);
+    return (uint16_t) (fixed < 0 ? 0 : fixed > UINT16_MAX ? UINT16_MAX : fixed);
+}
+
+static int16_t toFixedI16(double value, double scale)
+{
+    int32_t fixed = toFixed(value, scale);
+    return (int16_t) (fixed < INT16_MIN ? INT16_MIN : fixed > INT16_MAX ? INT16_MAX : fixed);
+}
+
+/**
+* Reserve space in the output buffer
+*
+* @param p      Current write position, advanced by size on success
+* @param end    End of the output buffer
+* @param size   Number of bytes to reserve
+* @return       Start of the reserved space, NULL if it does not fit
+*/
+static uint8_t *reserve(uint8_t **p, const uint8_t *end, size_t size)
+{
+    uint8_t *start = *p;
+
+    if (start == NULL || (size_t) (end - start) < size) {
+        *p = NULL;
+        return NULL;
+    }
+    *p = start + size;
+    return start;
+}
+
+// Consume bytes from the input, like reserve()
+static const uint8_t *consume(const uint8_t **p, const uint8_t *end, size_t size)
+{
+    const uint8_t *start = *p;
+
+    if (start == NULL || (size_t) (end - start) < size) {
+        *p = NULL;
+        return NULL;
+    }
+    *p = start + size;
+    return start;
+}
+
+static void putString(uint8_t **p, const uint8_t *end, const char *str, size_t size)
+{
+    size_t len = 0;
+    uint8_t *out;
+
+    while (len < size && str[len])
+        len++;
+    out = reserve(p, end, 1 + len);
+    if (!out)
+        return;
+    out[0] = (uint8_t) len;
+    memcpy(&out[1], str, len);
+}
+
+// Read a string into a field of size + 1 bytes, null padded
+static void getString(const uint8_t **p, const uint8_t *end, char *str, size_t size)
+{
+    const uint8_t *in = consume(p, end, 1);
+
+    if (!in)
+        return;
+    if (in[0] > size) {
+        *p = NULL;
+        return;
+    }
+    in = consume(p, end, in[0]);
+    if (!in)
+        return;
+    memcpy(str, in, *p - in);
+    memset(str + (*p - in), 0, size + 1 - (size_t) (*p - in));
+}
+
+static void putLocation(uint8_t **p, const uint8_t *end, const ODID_Location_data *loc)
+{
+    uint8_t *out = reserve(p, end, RECORD_LOCATION_SIZE);
+
+    if (!out)
+        return;
+    out[0] = ODID_WIRE_NIBBLES(loc->Status, loc->HeightType);
+    odid_put_le16(&out[1], toFixedU16(loc->Direction, 1));
+    odid_put_le16(&out[3], toFixedU16(loc->SpeedHorizontal, 100));
+    odid_put_le16(&out[5], (uint16_t) toFixedI16(loc->SpeedVertical, 100));
+    odid_put_le32(&out[7], (uint32_t) toFixed(loc->Latitude, 1e7));
+    odid_put_le32(&out[11], (uint32_t) toFixed(loc->Longitude, 1e7));
+    odid_put_le32(&out[15], (uint32_t) toFixed(loc->AltitudeBaro, 10));
+    odid_put_le32(&out[19], (uint32_t) toFixed(loc->AltitudeGeo, 10));
+    odid_put_le32(&out[23], (uint32_t) toFixed(loc->Height, 10));
+    out[27] = ODID_WIRE_NIBBLES(loc->VertAccuracy, loc->HorizAccuracy);
+    out[28] = ODID_WIRE_NIBBLES(loc->BaroAccuracy, loc->SpeedAccuracy);
+    out[29] = (uint8_t) loc->TSAccuracy;
+    odid_put_le16(&out[30], toFixedU16(loc->TimeStamp, 10));
+}
+
+static void getLocation(const uint8_t **p, const uint8_t *end, ODID_Location_data *loc)
+{
+    const uint8_t *in = consume(p, end, RECORD_LOCATION_SIZE);
+
+    if (!in)
+        return;
+    loc->Status = (ODID_status_t) (in[0] >> 4);
+    loc->HeightType = (ODID_Height_reference_t) (in[0] & 0x0F);
+    loc->Direction = (float) odid_get_le16(&in[1]);
+    loc->SpeedHorizontal = (float) odid_get_le16(&in[3]) / 100;
+    loc->SpeedVertical = (float) (int16_t) odid_get_le16(&in[5]) / 100;
+    loc->Latitude = (double) (int32_t) odid_get_le32(&in[7]) / 10000000;
+    loc->Longitude = (double) (int32_t) odid_get_le32(&in[11]) / 10000000;
+    loc->AltitudeBaro = (float) (int32_t) odid_get_le32(&in[15]) / 10;
+    loc->AltitudeGeo = (float) (int32_t) odid_get_le32(&in[19]) / 10;
+    loc->Height = (float) (int32_t) odid_get_le32(&in[23]) / 10;
+    loc->VertAccuracy = (ODID_Vertical_accuracy_t) (in[27] >> 4);
+    loc->HorizAccuracy = (ODID_Horizontal_accuracy_t) (in[27] & 0x0F);
+    loc->BaroAccuracy = (ODID_Vertical_accuracy_t) (in[28] >> 4);
+    loc->SpeedAccuracy = (ODID_Speed_accuracy_t) (in[28] & 0x0F);
+    loc->TSAccuracy = (ODID_Timestamp_accuracy_t) in[29];
+    loc->TimeStamp = (float) odid_get_le16(&in[30]) / 10;
+}
+
+static void putAuth(uint8_t **p, const uint8_t *end, const ODID_Auth_data *auth, int page)
+{
+    uint8_t *out = reserve(p, end, page == 0 ? RECORD_AUTH_PAGE_0_SIZE : 1);
+
+    if (!out)
+        return;
+    out[0] = (uint8_t) auth->AuthType;
+    if (page == 0) {
+        out[1] = auth->PageCount;
+        out[2] = auth->Length;
+        odid_put_le32(&out[3], auth->Timestamp);
+        putString(p, end, auth->AuthData, ODID_STR_SIZE - ODID_AUTH_PAGE_0_DATA_SIZE);
+    } else {
+        putString(p, end, auth->AuthData, ODID_STR_SIZE);
+    }
+}
+
+static void getAuth(const uint8_t **p, const uint8_t *end, ODID_Auth_data *auth, int page)
+{
+    const uint8_t *in = consume(p, end, page == 0 ? RECORD_AUTH_PAGE_0_SIZE : 1);
+
+    if (!in)
+        return;
+    auth->DataPage = (uint8_t) page;
+    auth->AuthType = (ODID_authtype_t) in[0];
+    if (page == 0) {
+        auth->PageCount = in[1];
+        auth->Length = in[2];
+        auth->Timestamp = odid_get_le32(&in[3]);
+        getString(p, end, auth->AuthData, ODID_STR_SIZE - ODID_AUTH_PAGE_0_DATA_SIZE);
+    } else {
+        getString(p, end, auth->AuthData, ODID_STR_SIZE);
+    }
+}
+
+static void putSystem(uint8_t **p, const uint8_t *end, const ODID_System_data *sys)
+{
+    uint8_t *out = reserve(p, end, RECORD_SYSTEM_SIZE);
+
+    if (!out)
+        return;
+    out[0] = (uint8_t) sys->LocationSource;
+    odid_put_le32(&out[1], (uint32_t) toFixed(sys->OperatorLatitude, 1e7));
+    odid_put_le32(&out[5], (uint32_t) toFixed(sys->OperatorLongitude, 1e7));
+    odid_put_le16(&out[9], sys->AreaCount);
+    odid_put_le16(&out[11], sys->AreaRadius);
+    odid_put_le32(&out[13], (uint32_t) toFixed(sys->AreaCeiling, 10));
+    odid_put_le32(&out[17], (uint32_t) toFixed(sys->AreaFloor, 10));
+}
+
+static void getSystem(const uint8_t **p, const uint8_t *end, ODID_System_data *sys)
+{
+    const uint8_t *in = consume(p, end, RECORD_SYSTEM_SIZE);
+
+    if (!in)
+        return;
+    sys->LocationSource = (ODID_location_source_t) in[0];
+    sys->OperatorLatitude = (double) (int32_t) odid_get_le32(&in[1]) / 10000000;
+    sys->OperatorLongitude = (double) (int32_t) odid_get_le32(&in[5]) / 10000000;
+    sys->AreaCount = odid_get_le16(&in[9]);
+    sys->AreaRadius = odid_get_le16(&in[11]);
+    sys->AreaCeiling = (float) (int32_t) odid_get_le32(&in[13]) / 10;
+    sys->AreaFloor = (float) (int32_t) odid_get_le32(&in[17]) / 10;
+}
+
+/**
+* Encode the valid messages of an ODID_UAS_Data into a binary record
+*
+* @param buf        Output buffer
+* @param size       Size of the output buffer. ODID_RECORD_MAX_SIZE is enough
+*                   for any record without raw messages
+* @param uasData    Data to encode. Only messages with their Valid flag are used
+* @param raw        Encoded messages to pass through unchanged, may be NULL
+* @param rawCount   Number of raw messages, at most UINT8_MAX
+* @return           Size of the record in bytes, 0 on failure
+*/
+size_t odid_record_encode(uint8_t *buf, size_t size, const ODID_UAS_Data *uasData,
+                          const uint8_t *raw, size_t rawCount)
+{
+    if (!buf || !uasData || (!raw && rawCount) || rawCount > UINT8_MAX)
+        return 0;
+
+    const uint8_t *end = buf + size;
+    uint8_t *p = buf;
+    uint8_t *header = reserve(&p, end, RECORD_HEADER_SIZE);
+    uint8_t present = 0, pages = 0;
+
+    if (!header)
+        return 0;
+
+    if (uasData->BasicIDValid) {
+        uint8_t *out = reserve(&p, end, 1);
+        if (out)
+            out[0] = ODID_WIRE_NIBBLES(uasData->BasicID.IDType, uasData->BasicID.UAType);
+        putString(&p, end, uasData->BasicID.UASID, ODID_ID_SIZE);
+        present |= ODID_RECORD_BASIC_ID;
+    }
+    if (uasData->LocationValid) {
+        putLocation(&p, end, &uasData->Location);
+        present |= ODID_RECORD_LOCATION;
+    }
+    for (int page = 0; page < ODID_AUTH_MAX_PAGES; page++) {
+        if (!uasData->AuthValid[page])
+            continue;
+        putAuth(&p, end, &uasData->Auth[page], page);
+        pages |= (uint8_t) (1 << page);
+        present |= ODID_RECORD_AUTH;
+    }
+    if (uasData->SelfIDValid) {
+        uint8_t *out = reserve(&p, end, 1);
+        if (out)
+            out[0] = (uint8_t) uasData->SelfID.DescType;
+        putString(&p, end, uasData->SelfID.Desc, ODID_STR_SIZE);
+        present |= ODID_RECORD_SELF_ID;
+    }
+    if (uasData->SystemValid) {
+        putSystem(&p, end, &uasData->System);
+        present |= ODID_RECORD_SYSTEM;
+    }
+    if (uasData->OperatorIDValid) {
+        uint8_t *out = reserve(&p, end, 1);
+        if (out)
+            out[0] = (uint8_t) uasData->OperatorID.OperatorIdType;
+        putString(&p, end, uasData->OperatorID.OperatorId, ODID_ID_SIZE);
+        present |= ODID_RECORD_OPERATOR_ID;
+    }
+    if (rawCount > 0) {
+        uint8_t *out = reserve(&p, end, 1 + rawCount * ODID_MESSAGE_SIZE);
+        if (out) {
+            out[0] = (uint8_t) rawCount;
+            memcpy(&out[1], raw, rawCount * ODID_MESSAGE_SIZE);
+        }
+        present |= ODID_RECORD_RAW;
+    }
+
+    if (!p)
+        return 0;
+    header[0] = ODID_RECORD_VERSION;
+    header[1] = present;
+    header[2] = pages;
+    return (size_t) (p - buf);
+}
+
+/**
+* Decode a binary record into an ODID_UAS_Data
+*
+* The messages in the record are decoded and their Valid flag set. The Valid
+* flags of the other messages are cleared, without changing their data.
+* Nothing is changed if the record is invalid.
+*
+* @param uasData    Output: decoded data
+* @param buf        Start of the record
+* @param len        Number of bytes available, may be more than the record
+* @param raw        Output: raw messages inside buf, NULL if there are none.
+*                   May be NULL
+* @param rawCount   Output: number of raw messages. May be NULL
+* @return           Size of the record in bytes, 0 if it is invalid
+*/
+size_t odid_record_decode(ODID_UAS_Data *uasData, const uint8_t *buf, size_t len,
+                          const uint8_t **raw, size_t *rawCount)
+{
+    if (!uasData || !buf || len < RECORD_HEADER_SIZE)
+        return 0;
+
+    const uint8_t *end = buf + len;
+    const uint8_t *p = buf + RECORD_HEADER_SIZE;
+    uint8_t present = buf[1], pages = buf[2];
+    const uint8_t *rawStart = NULL;
+    size_t count = 0;
+    ODID_UAS_Data staging;
+
+    if (buf[0] != ODID_RECORD_VERSION || (present & ~RECORD_PRESENT_ALL) ||
+        (pages >> ODID_AUTH_MAX_PAGES) || !(present & ODID_RECORD_AUTH) != !pages)
+        return 0;
+
+    // Decode into a copy, so that a truncated record changes nothing
+    memcpy(&staging, uasData, sizeof(staging));
+    staging.BasicIDValid = 0;
+    staging.LocationValid = 0;
+    memset(staging.AuthValid, 0, sizeof(staging.AuthValid));
+    staging.SelfIDValid = 0;
+    staging.SystemValid = 0;
+    staging.OperatorIDValid = 0;
+
+    if (present & ODID_RECORD_BASIC_ID) {
+        const uint8_t *in = consume(&p, end, 1);
+        if (in) {
+            staging.BasicID.IDType = (ODID_idtype_t) (in[0] >> 4);
+            staging.BasicID.UAType = (ODID_uatype_t) (in[0] & 0x0F);
+        }
+        getString(&p, end, staging.BasicID.UASID, ODID_ID_SIZE);
+        staging.BasicIDValid = 1;
+    }
+    if (present & ODID_RECORD_LOCATION) {
+        getLocation(&p, end, &staging.Location);
+        staging.LocationValid = 1;
+    }
+    for (int page = 0; page < ODID_AUTH_MAX_PAGES; page++) {
+        if (!(pages & (1 << page)))
+            continue;
+        getAuth(&p, end, &staging.Auth[page], page);
+        staging.AuthValid[page] = 1;
+    }
+    if (present & ODID_RECORD_SELF_ID) {
+        const uint8_t *in = consume(&p, end, 1);
+        if (in)
+            staging.SelfID.DescType = (ODID_desctype_t) in[0];
+        getString(&p, end, staging.SelfID.Desc, ODID_STR_SIZE);
+        staging.SelfIDValid = 1;
+    }
+    if (present & ODID_RECORD_SYSTEM) {
+        getSystem(&p, end, &staging.System);
+        staging.SystemValid = 1;
+    }
+    if (present & ODID_RECORD_OPERATOR_ID) {
+        const uint8_t *in = consume(&p, end, 1);
+        if (in)
+            staging.OperatorID.OperatorIdType = (ODID_operatorIdType_t) in[0];
+        getString(&p, end, staging.OperatorID.OperatorId, ODID_ID_SIZE);
+        staging.OperatorIDValid = 1;
+    }
+    if (present & ODID_RECORD_RAW) {
+        const uint8_t *in = consume(&p, end, 1);
+        if (in && in[0] > 0) {
+            count = in[0];
+            rawStart = consume(&p, end, count * ODID_MESSAGE_SIZE);
+        } else {
+            p = NULL;
+        }
+    }
+
+    if (!p)
+        return 0;
+    memcpy(uasData, &staging, sizeof(staging));
+    if (raw)
+        *raw = rawStart;
+    if (rawCount)
+        *rawCount = count;
+    return (size_t) (p - buf);
+}
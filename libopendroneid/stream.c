@@ -0,0 +1,355 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include "opendroneid.h"
+#include "wire.h"
+#include <string.h>
+
+/*
+ * Push style decoder for byte streams without any framing of their own, e.g.
+ * serial links. Frames are single messages or message packs, recognized by
+ * their header byte: a known message type and a protocol version not newer
+ * than ours. Such bytes are common in other data, so a frame is only taken
+ * when it is accepted by the validation and the byte after it is the header
+ * of the next frame, or the input ends. Otherwise the frame is a false start:
+ * its first byte is dropped and the search for the next header continues from
+ * the byte after it.
+ *
+ * That check alone does not find the right alignment after a loss of it. Many
+ * messages end in reserved zero bytes, which look like a Basic ID header, so a
+ * header-like stray byte in front of them starts a chain of frames that are
+ * all one byte off. Hence the first frame after a loss of alignment is
+ * compared with the frames starting at the header bytes inside it, see
+ * alignFrame(). Bytes are never looked at again once they are behind the
+ * start of a decoded frame.
+ */
+
+// Bytes looked at ahead to find the alignment
+#define STREAM_ALIGN_WINDOW (2 * sizeof(ODID_MessagePack_encoded))
+
+#define STREAM_FRAME_TYPES (ODID_TYPE_BIT(ODID_MESSAGETYPE_BASIC_ID) | \
+                            ODID_TYPE_BIT(ODID_MESSAGETYPE_LOCATION) | \
+                            ODID_TYPE_BIT(ODID_MESSAGETYPE_AUTH) | \
+                            ODID_TYPE_BIT(ODID_MESSAGETYPE_SELF_ID) | \
+                            ODID_TYPE_BIT(ODID_MESSAGETYPE_SYSTEM) | \
+                            ODID_TYPE_BIT(ODID_MESSAGETYPE_OPERATOR_ID) | \
+                            ODID_TYPE_BIT(ODID_MESSAGETYPE_PACKED))
+
+static inline int isFrameHeader(uint8_t byte)
+{
+    return (byte & 0x0F) <= ODID_PROTOCOL_VERSION &&
+           (STREAM_FRAME_TYPES & ODID_TYPE_BIT(ODID_WIRE_TYPE(byte)));
+}
+
+static size_t findFrameHeader(const uint8_t *data, size_t len)
+{
+    size_t i = 0;
+
+    while (i < len && !isFrameHeader(data[i]))
+        i++;
+    return i;
+}
+
+/**
+* Get the size of the frame starting at a header byte
+*
+* @param frame  Pointer to the header byte of the frame
+* @param avail  Number of bytes of the frame that are available
+* @return       Size of the frame in bytes. ODID_PACK_MESSAGES if the header of
+*               a message pack is not complete yet, 0 if it is invalid
+*/
+static size_t frameSize(const uint8_t *frame, size_t avail)
+{
+    if (ODID_WIRE_TYPE(frame[0]) != ODID_MESSAGETYPE_PACKED)
+        return ODID_MESSAGE_SIZE;
+
+    if (avail < ODID_PACK_MESSAGES)
+        return ODID_PACK_MESSAGES;
+
+    uint8_t amount = frame[ODID_PACK_MSG_PACK_SIZE];
+    if (frame[ODID_PACK_SINGLE_MESSAGE_SIZE] != ODID_MESSAGE_SIZE ||
+        amount == 0 || amount > ODID_PACK_MAX_MESSAGES)
+        return 0;
+
+    return ODID_PACK_MESSAGES + (size_t) amount * ODID_MESSAGE_SIZE;
+}
+
+/**
+* Check whether a complete frame would be decoded, without decoding it
+*
+* @param frame  Pointer to the frame
+* @param size   Size of the frame, as given by frameSize()
+* @return       Nonzero if the frame is valid
+*/
+static int frameValid(const uint8_t *frame, size_t size)
+{
+    if (ODID_WIRE_TYPE(frame[0]) == ODID_MESSAGETYPE_PACKED)
+        return odid_validate_pack(frame, size) != 0;
+    return odid_validate_message(frame) != 0;
+}
+
+/**
+* Follow the chain of valid frames from a header byte, where each frame must be
+* directly followed by the header of the next one or by the end of the bytes
+*
+* The frame starts of every chain are marked. A chain that reaches the start
+* of a chain followed before covers less of the same frames from there on, so
+* it is not followed any further.
+*
+* @param data   Bytes at hand
+* @param start  Offset of the header byte of the first frame of the chain
+* @param len    Number of bytes at hand
+* @param starts Bit set of the frame starts of the chains followed before
+* @return       End of the last frame of the chain, 0 if it joins another one
+*/
+static size_t frameChain(const uint8_t *data, size_t start, size_t len, uint8_t *starts)
+{
+    size_t pos = start;
+
+    while (pos < len && isFrameHeader(data[pos])) {
+        if (starts[pos / 8] & (1 << (pos % 8)))
+            return 0;
+        starts[pos / 8] |= (uint8_t) (1 << (pos % 8));
+        size_t size = frameSize(&data[pos], len - pos);
+        if (size == 0 || size > len - pos ||
+            (size < len - pos && !isFrameHeader(data[pos + size])) ||
+            !frameValid(&data[pos], size))
+            break;
+        pos += size;
+    }
+    return pos;
+}
+
+/**
+* Find the alignment of the frames after a loss of it
+*
+* The frame may actually start at any header byte inside the first frame. The
+* start whose chain of frames covers the most of the bytes at hand is taken.
+* On a tie, a chain that ends exactly at the end of the received bytes wins,
+* as the sender most likely wrote whole frames, and then the earliest start.
+*
+* @param data   Pointer to the header byte of the first frame, which is valid
+* @param len    Number of bytes available at data
+* @param size   Size of the first frame, as given by frameSize()
+* @param last   Nonzero if data ends at the end of the received bytes
+* @return       Offset of the start of the first frame
+*/
+static size_t alignFrame(const uint8_t *data, size_t len, size_t size, int last)
+{
+    uint8_t starts[STREAM_ALIGN_WINDOW / 8];
+    size_t best = 0, bestCover = 0;
+    int bestExact = 0;
+
+    if (len > STREAM_ALIGN_WINDOW) {
+        len = STREAM_ALIGN_WINDOW;
+        last = 0;
+    }
+    for (size_t start = 1; start < size && start < len; start++) {
+        if (!isFrameHeader(data[start]))
+            continue;
+        // The chain of the first frame is only needed if there is another one
+        if (bestCover == 0) {
+            memset(starts, 0, sizeof(starts));
+            bestCover = frameChain(data, 0, len, starts);
+            bestExact = last && bestCover == len;
+        }
+        size_t end = frameChain(data, start, len, starts);
+        int exact = last && end == len;
+        if (end > start &&
+            (end - start > bestCover || (end - start == bestCover && exact > bestExact))) {
+            best = start;
+            bestCover = end - start;
+            bestExact = exact;
+        }
+    }
+    return best;
+}
+
+/**
+* Decode a complete frame into the stream data and pass it to the callback
+*
+* @param stream Stream decoder context
+* @param frame  Pointer to the frame
+* @param size   Size of the frame, as given by frameSize()
+* @return       ODID_SUCCESS or ODID_FAIL;
+*/
+static int emitFrame(ODID_Stream_decoder *stream, const uint8_t *frame, size_t size)
+{
+    ODID_messagetype_t type;
+
+    if (ODID_WIRE_TYPE(frame[0]) == ODID_MESSAGETYPE_PACKED) {
+        // Only complete packs, a pack with a bad message is most likely not one
+        if (!odid_validate_pack(frame, size) ||
+            decodeMessagePack(&stream->Data, (ODID_MessagePack_encoded *) frame) != ODID_SUCCESS)
+            return ODID_FAIL;
+        type = ODID_MESSAGETYPE_PACKED;
+        stream->Packs++;
+    } else {
+        type = decodeOpenDroneID(&stream->Data, (uint8_t *) frame);
+        if (type == ODID_MESSAGETYPE_INVALID)
+            return ODID_FAIL;
+        stream->Messages++;
+    }
+
+    if (stream->Callback)
+        stream->Callback(stream->User, type, frame, &stream->Data);
+    return ODID_SUCCESS;
+}
+
+/**
+* Consume the bytes at the start of the received data: skip the bytes up to the
+* next frame header, decode the frame that starts there or drop its first byte
+*
+* @param stream Stream decoder context
+* @param data   Received bytes
+* @param len    Number of bytes available at data
+* @param last   Nonzero if data ends at the end of the received bytes
+* @param flush  Nonzero if no more bytes will be received
+* @return       Number of bytes consumed, 0 if more bytes are needed
+*/
+static size_t consumeFrame(ODID_Stream_decoder *stream, const uint8_t *data, size_t len,
+                           int last, int flush)
+{
+    size_t skip = findFrameHeader(data, len);
+    if (skip > 0) {
+        stream->Discarded += skip;
+        stream->Aligned = 0;
+        return skip;
+    }
+
+    // The frame and the byte after it are needed, unless the input ends
+    size_t size = frameSize(data, len);
+    if (size != 0 && size >= len && !flush)
+        return 0;
+
+    if (size != 0 && size <= len && (size == len || isFrameHeader(data[size]))) {
+        if (!stream->Aligned && frameValid(data, size)) {
+            size_t start = alignFrame(data, len, size, last || flush);
+            stream->Aligned = 1;
+            if (start > 0) {
+                stream->Discarded += start;
+                return start;
+            }
+        }
+        if (emitFrame(stream, data, size) == ODID_SUCCESS)
+            return size;
+    }
+
+    stream->Discarded++;
+    stream->Aligned = 0;
+    return 1;
+}
+
+/**
+* Initialize a stream decoder
+*
+* @param stream     Stream decoder context
+* @param callback   Called for each decoded message or message pack, may be NULL
+* @param user       Passed to the callback
+*/
+void odid_stream_init(ODID_Stream_decoder *stream, ODID_Stream_callback callback, void *user)
+{
+    if (!stream)
+        return;
+
+    memset(stream, 0, sizeof(*stream));
+    stream->Callback = callback;
+    stream->User = user;
+}
+
+/**
+* Push received bytes into a stream decoder
+*
+* The bytes may split frames anywhere. A frame is only decoded once the byte
+* after it has been received, so the last frame and any partial frame at the
+* end are kept in the context and completed by the next call, or decoded by
+* odid_stream_flush(). Every decoded message or pack updates stream->Data and
+* is then passed to the callback, together with a pointer to its encoded
+* bytes, which is only valid during the callback.
+*
+* @param stream Stream decoder context
+* @param data   Received bytes
+* @param len    Number of received bytes
+* @return       Number of messages and message packs decoded by this call
+*/
+int odid_stream_push(ODID_Stream_decoder *stream, const uint8_t *data, size_t len)
+{
+    if (!stream || (!data && len))
+        return 0;
+
+    uint32_t decoded = stream->Messages + stream->Packs;
+    size_t copied = 0;
+
+    // Decide on the frame kept by the previous call first. Once the rest of
+    // the buffer is a copy of received bytes, go on with those directly
+    while (stream->Length > 0) {
+        size_t size = frameSize(stream->Buffer, stream->Length);
+        if (size != 0 && size + 1 > stream->Length && len > 0) {
+            size_t count = size + 1 - stream->Length < len ? size + 1 - stream->Length : len;
+            memcpy(stream->Buffer + stream->Length, data, count);
+            stream->Length += count;
+            copied += count;
+            data += count;
+            len -= count;
+            continue;
+        }
+
+        size_t used = consumeFrame(stream, stream->Buffer, stream->Length, 0, 0);
+        if (used == 0)
+            return (int) (stream->Messages + stream->Packs - decoded);
+        stream->Length -= used;
+        memmove(stream->Buffer, stream->Buffer + used, stream->Length);
+        if (stream->Length <= copied) {
+            data -= stream->Length;
+            len += stream->Length;
+            stream->Length = 0;
+        }
+    }
+
+    // Then decode directly from the received bytes
+    while (len > 0) {
+        size_t used = consumeFrame(stream, data, len, 1, 0);
+        if (used == 0) {
+            memcpy(stream->Buffer, data, len);
+            stream->Length = len;
+            break;
+        }
+        data += used;
+        len -= used;
+    }
+    return (int) (stream->Messages + stream->Packs - decoded);
+}
+
+/**
+* Decode the frame kept at the end of the input, e.g. when the link goes idle
+*
+* A partial frame is dropped. The bytes pushed after this call are taken as
+* the start of new input.
+*
+* @param stream Stream decoder context
+* @return       Number of messages and message packs decoded by this call
+*/
+int odid_stream_flush(ODID_Stream_decoder *stream)
+{
+    if (!stream)
+        return 0;
+
+    uint32_t decoded = stream->Messages + stream->Packs;
+
+    while (stream->Length > 0) {
+        size_t used = consumeFrame(stream, stream->Buffer, stream->Length, 1, 1);
+        stream->Length -= used;
+        memmove(stream->Buffer, stream->Buffer + used, stream->Length);
+    }
+    stream->Aligned = 0;
+    return (int) (stream->Messages + stream->Packs - decoded);
+}
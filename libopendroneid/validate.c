@@ -0,0 +1,96 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include "opendroneid.h"
+#include "wire.h"
+
+/*
+ * Validation without decoding. These functions accept exactly the messages
+ * and packs that the decoders accept, but only look at the few bytes that the
+ * decoders check. All other fields are 4 bit nibbles or whole bytes, for which
+ * every value is in range.
+ */
+
+/**
+* Check whether a single encoded message would be accepted by its decoder
+*
+* @param msg    Pointer to ODID_MESSAGE_SIZE bytes of an encoded message
+* @return       ODID_TYPE_BIT() of the message type, or 0 if the message is
+*               invalid. Message packs give 0, use odid_validate_pack() for them
+*/
+uint32_t odid_validate_message(const uint8_t *msg)
+{
+    if (!msg)
+        return 0;
+
+    uint8_t type = ODID_WIRE_TYPE(msg[0]);
+    switch (type) {
+    case ODID_MESSAGETYPE_AUTH:
+        if ((msg[ODID_AUTH_TYPE_PAGE] & 0x0F) >= ODID_AUTH_MAX_PAGES)
+            return 0;
+        return ODID_TYPE_BIT(type);
+    case ODID_MESSAGETYPE_BASIC_ID:
+    case ODID_MESSAGETYPE_LOCATION:
+    case ODID_MESSAGETYPE_SELF_ID:
+    case ODID_MESSAGETYPE_SYSTEM:
+    case ODID_MESSAGETYPE_OPERATOR_ID:
+        return ODID_TYPE_BIT(type);
+    default:
+        return 0;
+    }
+}
+
+/**
+* Check whether an encoded message pack would be decoded completely
+*
+* A pack is valid if decodeMessagePack() accepts it and every message in it is
+* accepted by its decoder: the header must have the packed message type and
+* SingleMessageSize ODID_MESSAGE_SIZE, there must be 1 to ODID_PACK_MAX_MESSAGES
+* valid messages, with at most one of each type except up to
+* ODID_AUTH_MAX_PAGES Auth pages.
+*
+* @param pack   Pointer to the encoded message pack
+* @param len    Number of bytes available at pack
+* @return       ODID_TYPE_BIT()s of the message types in the pack, or 0 if the
+*               pack is invalid
+*/
+uint32_t odid_validate_pack(const uint8_t *pack, size_t len)
+{
+    uint8_t count[ODID_MESSAGETYPE_OPERATOR_ID + 1] = { 0 };
+    uint32_t types = 0;
+
+    if (!pack || len < ODID_PACK_MESSAGES ||
+        ODID_WIRE_TYPE(pack[0]) != ODID_MESSAGETYPE_PACKED ||
+        pack[ODID_PACK_SINGLE_MESSAGE_SIZE] != ODID_MESSAGE_SIZE)
+        return 0;
+
+    uint8_t amount = pack[ODID_PACK_MSG_PACK_SIZE];
+    if (amount == 0 || amount > ODID_PACK_MAX_MESSAGES ||
+        len < ODID_PACK_MESSAGES + (size_t) amount * ODID_MESSAGE_SIZE)
+        return 0;
+
+    const uint8_t *msg = &pack[ODID_PACK_MESSAGES];
+    for (int i = 0; i < amount; i++, msg += ODID_MESSAGE_SIZE) {
+        uint32_t bit = odid_validate_message(msg);
+        if (!bit)
+            return 0;
+        types |= bit;
+        count[ODID_WIRE_TYPE(msg[0])]++;
+    }
+
+    if (count[ODID_MESSAGETYPE_BASIC_ID] > 1 || count[ODID_MESSAGETYPE_LOCATION] > 1 ||
+        count[ODID_MESSAGETYPE_AUTH] > ODID_AUTH_MAX_PAGES || count[ODID_MESSAGETYPE_SELF_ID] > 1 ||
+        count[ODID_MESSAGETYPE_SYSTEM] > 1 || count[ODID_MESSAGETYPE_OPERATOR_ID] > 1)
+        return 0;
+
+    return types;
+}
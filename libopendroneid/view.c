@@ -0,0 +1,224 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include "opendroneid.h"
+#include "wire.h"
+#include <string.h>
+
+/*
+ * Read-only views over encoded messages. Each accessor decodes a single field
+ * directly from the ODID_MESSAGE_SIZE wire bytes, using the same arithmetic as
+ * the corresponding decode*Message() function, so the results are identical.
+ *
+ * The accessors do not check the message type. Callers should check it first,
+ * e.g. with odid_view_message_type().
+ */
+
+static inline float view_altitude(const uint8_t *p)
+{
+    return (float) ((float) odid_get_le16(p) * 0.5f - 1000);
+}
+
+static inline double view_latlon(const uint8_t *p)
+{
+    return (double) (int32_t) odid_get_le32(p) / 10000000;
+}
+
+/**
+* Return a pointer to a string field inside an encoded message
+*
+* The string is not null terminated if it fills the whole field
+*
+* @param field   Start of the string field in the encoded message
+* @param size    Size of the string field
+* @param len     Output: length of the string, may be NULL
+* @return        Pointer to the first character of the string
+*/
+static const char *view_string(const uint8_t *field, size_t size, size_t *len)
+{
+    if (len) {
+        const uint8_t *end = memchr(field, 0, size);
+        *len = end ? (size_t) (end - field) : size;
+    }
+    return (const char *) field;
+}
+
+ODID_messagetype_t odid_view_message_type(const uint8_t *msg)
+{
+    return decodeMessageType(msg[0]);
+}
+
+ODID_uatype_t odid_basicid_view_uatype(const uint8_t *msg)
+{
+    return (ODID_uatype_t) (msg[ODID_BASICID_TYPES] & 0x0F);
+}
+
+ODID_idtype_t odid_basicid_view_idtype(const uint8_t *msg)
+{
+    return (ODID_idtype_t) (msg[ODID_BASICID_TYPES] >> 4);
+}
+
+const char *odid_basicid_view_uasid(const uint8_t *msg, size_t *len)
+{
+    return view_string(&msg[ODID_BASICID_UASID], ODID_ID_SIZE, len);
+}
+
+ODID_status_t odid_loc_view_status(const uint8_t *msg)
+{
+    return (ODID_status_t) (msg[ODID_LOC_FLAGS] >> 4);
+}
+
+ODID_Height_reference_t odid_loc_view_height_type(const uint8_t *msg)
+{
+    return (ODID_Height_reference_t) ((msg[ODID_LOC_FLAGS] & ODID_LOC_FLAG_HEIGHT_TYPE) != 0);
+}
+
+float odid_loc_view_direction(const uint8_t *msg)
+{
+    if (msg[ODID_LOC_FLAGS] & ODID_LOC_FLAG_EW_DIRECTION)
+        return msg[ODID_LOC_DIRECTION] + 180;
+    else
+        return msg[ODID_LOC_DIRECTION];
+}
+
+float odid_loc_view_speed_horizontal(const uint8_t *msg)
+{
+    if (msg[ODID_LOC_FLAGS] & ODID_LOC_FLAG_SPEED_MULT)
+        return ((float) msg[ODID_LOC_SPEED_HORIZONTAL] * 0.75f) + (UINT8_MAX * 0.25f);
+    else
+        return (float) msg[ODID_LOC_SPEED_HORIZONTAL] * 0.25f;
+}
+
+float odid_loc_view_speed_vertical(const uint8_t *msg)
+{
+    return (float) (int8_t) msg[ODID_LOC_SPEED_VERTICAL] * 0.5f;
+}
+
+double odid_loc_view_lat(const uint8_t *msg)
+{
+    return view_latlon(&msg[ODID_LOC_LATITUDE]);
+}
+
+double odid_loc_view_lon(const uint8_t *msg)
+{
+    return view_latlon(&msg[ODID_LOC_LONGITUDE]);
+}
+
+float odid_loc_view_alt_baro(const uint8_t *msg)
+{
+    return view_altitude(&msg[ODID_LOC_ALTITUDE_BARO]);
+}
+
+float odid_loc_view_alt_geo(const uint8_t *msg)
+{
+    return view_altitude(&msg[ODID_LOC_ALTITUDE_GEO]);
+}
+
+float odid_loc_view_height(const uint8_t *msg)
+{
+    return view_altitude(&msg[ODID_LOC_HEIGHT]);
+}
+
+ODID_Horizontal_accuracy_t odid_loc_view_horiz_accuracy(const uint8_t *msg)
+{
+    return (ODID_Horizontal_accuracy_t) (msg[ODID_LOC_HV_ACCURACY] & 0x0F);
+}
+
+ODID_Vertical_accuracy_t odid_loc_view_vert_accuracy(const uint8_t *msg)
+{
+    return (ODID_Vertical_accuracy_t) (msg[ODID_LOC_HV_ACCURACY] >> 4);
+}
+
+ODID_Speed_accuracy_t odid_loc_view_speed_accuracy(const uint8_t *msg)
+{
+    return (ODID_Speed_accuracy_t) (msg[ODID_LOC_BS_ACCURACY] & 0x0F);
+}
+
+ODID_Vertical_accuracy_t odid_loc_view_baro_accuracy(const uint8_t *msg)
+{
+    return (ODID_Vertical_accuracy_t) (msg[ODID_LOC_BS_ACCURACY] >> 4);
+}
+
+float odid_loc_view_timestamp(const uint8_t *msg)
+{
+    return (float) odid_get_le16(&msg[ODID_LOC_TIMESTAMP]) / 10;
+}
+
+ODID_Timestamp_accuracy_t odid_loc_view_ts_accuracy(const uint8_t *msg)
+{
+    return (ODID_Timestamp_accuracy_t) (msg[ODID_LOC_TS_ACCURACY] & 0x0F);
+}
+
+int odid_auth_view_page(const uint8_t *msg)
+{
+    return msg[ODID_AUTH_TYPE_PAGE] & 0x0F;
+}
+
+ODID_authtype_t odid_auth_view_type(const uint8_t *msg)
+{
+    return (ODID_authtype_t) (msg[ODID_AUTH_TYPE_PAGE] >> 4);
+}
+
+ODID_desctype_t odid_selfid_view_desc_type(const uint8_t *msg)
+{
+    return (ODID_desctype_t) msg[ODID_SELFID_DESC_TYPE];
+}
+
+const char *odid_selfid_view_desc(const uint8_t *msg, size_t *len)
+{
+    return view_string(&msg[ODID_SELFID_DESC], ODID_STR_SIZE, len);
+}
+
+ODID_location_source_t odid_system_view_location_source(const uint8_t *msg)
+{
+    return (ODID_location_source_t) ((msg[ODID_SYSTEM_FLAGS] & ODID_SYSTEM_LOCATION_SOURCE) != 0);
+}
+
+double odid_system_view_operator_lat(const uint8_t *msg)
+{
+    return view_latlon(&msg[ODID_SYSTEM_OPERATOR_LAT]);
+}
+
+double odid_system_view_operator_lon(const uint8_t *msg)
+{
+    return view_latlon(&msg[ODID_SYSTEM_OPERATOR_LON]);
+}
+
+uint16_t odid_system_view_area_count(const uint8_t *msg)
+{
+    return odid_get_le16(&msg[ODID_SYSTEM_AREA_COUNT]);
+}
+
+uint16_t odid_system_view_area_radius(const uint8_t *msg)
+{
+    return (uint16_t) msg[ODID_SYSTEM_AREA_RADIUS] * 10;
+}
+
+float odid_system_view_area_ceiling(const uint8_t *msg)
+{
+    return view_altitude(&msg[ODID_SYSTEM_AREA_CEILING]);
+}
+
+float odid_system_view_area_floor(const uint8_t *msg)
+{
+    return view_altitude(&msg[ODID_SYSTEM_AREA_FLOOR]);
+}
+
+ODID_operatorIdType_t odid_operatorid_view_type(const uint8_t *msg)
+{
+    return (ODID_operatorIdType_t) msg[ODID_OPERATORID_TYPE];
+}
+
+const char *odid_operatorid_view_id(const uint8_t *msg, size_t *len)
+{
+    return view_string(&msg[ODID_OPERATORID_ID], ODID_ID_SIZE, len);
+}
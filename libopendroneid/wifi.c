@@ -14,6 +14,7 @@ gabriel.c.cox@intel.com
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
+#include <stddef.h>
 #include <errno.h>
 #include <byteswap.h>
 
@@ -31,158 +32,168 @@ gabriel.c.cox@intel.com
 #define IEEE80211_FTYPE_MGMT            0x0000
 #define IEEE80211_STYPE_ACTION          0x00D0
 
+#if defined(__GNUC__)
+#define odid_prefetch(addr)	__builtin_prefetch(addr)
+#else
+#define odid_prefetch(addr)	((void)(addr))
+#endif
+
+/* frames ahead of the current one that are prefetched, up to the largest ODID frame */
+#define BATCH_PREFETCH_DISTANCE	4
+#define BATCH_PREFETCH_SIZE	(ODID_NAN_HEADER_SIZE + sizeof(ODID_MessagePack_encoded))
+
 
 char *drone_export_gps_data(ODID_UAS_Data *UAS_Data)
 {
-	int len = 0, total_len = 8192;
+	ODID_Json_writer writer;
 	char *drone_str;
 
-	drone_str = malloc(total_len);
+	drone_str = malloc(ODID_JSON_MAX_SIZE);
 	if (!drone_str)
 		return NULL;
 
-#define mprintf(...) {\
-	if (total_len - len < 2048) { \
-		total_len *= 2; \
-		drone_str = realloc(drone_str, total_len); \
-		if (!drone_str) \
-			return NULL; \
-	} \
-	len += snprintf(drone_str + len, total_len - len, __VA_ARGS__); \
-	if (len > total_len) { \
-		free(drone_str); \
-		return NULL; \
-	} \
-}
-	/* build json object from UAS_Data */
-	/*
-	{
-		"Version": "x.x",
-		"Response": {
-			"BasicID": {
-				"UAType": <>,
-				"IDType": <>,
-				"UASID": <>
-			},
-			"Location": {
-				"Status": <>,
-				"Direction": <>,
-				"SpeedHorizontal": <>,
-				"SpeedVertical": <>,
-				"Latitude": <>,
-				"Longitude": <>,
-				"AltitudeBaro": <>,
-				"AltitudeGeo": <>,
-				"Height": <>,
-				"HAccuracy": <>,
-				"VAccuracy": <>,
-				"SpAccuracy": <>,
-				"TSAccuracy": <>,
-				"TimeStamp": <>
-			},
-			"Authentication": {
-				"AuthType": <>,
-				"AuthToken": <>
-			},
-			"SelfID": {
-				"Name": <>,
-				"Description": <>
-			},
-			"Operator": {
-				"LocationSource": <>,
-				"Latitude": <>,
-				"Longitude": <>,
-				"AreaCount": <>,
-				"AreaRadius": <>,
-				"AreaCeiling": <>
-			}
-		}
+	odid_json_init(&writer, drone_str, ODID_JSON_MAX_SIZE, NULL, NULL);
+	if (odid_json_write(&writer, UAS_Data, 0) != ODID_SUCCESS) {
+		free(drone_str);
+		return NULL;
 	}
-	*/
-
-	mprintf("{\n\t\"Version\": \"0.0\",\n\t\"Response\": {\n");
-
-	mprintf("\t\t\"BasicID\": {\n");
-	mprintf("\t\t\t\"UAType\": %i,\n", UAS_Data->BasicID.UAType);
-	mprintf("\t\t\t\"IDType\": %i,\n", UAS_Data->BasicID.IDType);
-	mprintf("\t\t\t\"UASID\": %s\n", UAS_Data->BasicID.UASID);
-	mprintf("\t\t},\n");
-
-	mprintf("\t\t\"Location\": {\n");
-	mprintf("\t\t\t\"Status\": %d,\n", (int)UAS_Data->Location.Status);
-	mprintf("\t\t\t\"Direction\": %f,\n", UAS_Data->Location.Direction);
-	mprintf("\t\t\t\"SpeedHorizontal\": %f,\n", UAS_Data->Location.SpeedHorizontal);
-	mprintf("\t\t\t\"SpeedVertical\": %f,\n", UAS_Data->Location.SpeedVertical);
-	mprintf("\t\t\t\"Latitude\": %f,\n", UAS_Data->Location.Latitude);
-	mprintf("\t\t\t\"Longitude\": %f,\n", UAS_Data->Location.Longitude);
-	mprintf("\t\t\t\"AltitudeBaro\": %f,\n", UAS_Data->Location.AltitudeBaro);
-	mprintf("\t\t\t\"AltitudeGeo\": %f,\n", UAS_Data->Location.AltitudeGeo);
-	mprintf("\t\t\t\"Height\": %f,\n", UAS_Data->Location.Height);
-	mprintf("\t\t\t\"HorizAccuracy\": %d,\n", UAS_Data->Location.HorizAccuracy);
-	mprintf("\t\t\t\"VertAccuracy\": %d,\n", UAS_Data->Location.VertAccuracy);
-	mprintf("\t\t\t\"SpeedAccuracy\": %d,\n", UAS_Data->Location.SpeedAccuracy);
-	mprintf("\t\t\t\"TSAccuracy\": %d,\n", UAS_Data->Location.TSAccuracy);
-	mprintf("\t\t\t\"TimeStamp\": %f\n", UAS_Data->Location.TimeStamp);
-	mprintf("\t\t},\n");
-
-	mprintf("\t\t\"Authentication\": {\n");
-	mprintf("\t\t\t\"AuthType\": %i,\n", UAS_Data->Auth[0].AuthType);
-	mprintf("\t\t\t\"AuthToken\": %s\n", UAS_Data->Auth[0].AuthData);
-	mprintf("\t\t},\n");
-
-	mprintf("\t\t\"SelfID\": {\n");
-	mprintf("\t\t\t\"Name\": \"string\",\n");
-	mprintf("\t\t\t\"Description\": %s\n", UAS_Data->SelfID.Desc);
-	mprintf("\t\t},\n");
-
-	mprintf("\t\t\"Operator\": {\n");
-	mprintf("\t\t\t\"LocationSource\": %i,\n", UAS_Data->System.LocationSource);
-	mprintf("\t\t\t\"OperatorLatitude\": %f,\n", UAS_Data->System.OperatorLatitude);
-	mprintf("\t\t\t\"OperatorLongitude\": %f,\n", UAS_Data->System.OperatorLongitude);
-	mprintf("\t\t\t\"AreaCount\": %i,\n", UAS_Data->System.AreaCount);
-	mprintf("\t\t\t\"AreaRadius\": %i,\n", UAS_Data->System.AreaRadius);
-	mprintf("\t\t\t\"AreaCeiling\": %f\n", UAS_Data->System.AreaCeiling);
-	mprintf("\t\t}\n");
-
-	mprintf("\t}\n}");
 
 	return drone_str;
 }
 
-int odid_message_encode_pack(ODID_UAS_Data *UAS_Data, void *pack, size_t buflen)
+/*
+ * Message pack slots in the order the messages are put into a pack: Basic ID,
+ * Location, the Authentication pages, Self ID, System and Operator ID. A pack
+ * holds the valid ones, at most ODID_PACK_MAX_MESSAGES.
+ */
+#define PACK_SLOT_AUTH		2
+#define PACK_SLOT_SELF_ID	(PACK_SLOT_AUTH + ODID_AUTH_MAX_PAGES)
+#define PACK_SLOT_SYSTEM	(PACK_SLOT_SELF_ID + 1)
+#define PACK_SLOT_OPERATOR_ID	(PACK_SLOT_SYSTEM + 1)
+#define PACK_SLOTS		(PACK_SLOT_OPERATOR_ID + 1)
+
+/**
+ * pack_slots_valid - find the messages that go into a message pack
+ * @UAS_Data: general drone status information
+ *
+ * Return: bit mask of the slots with a valid message
+ */
+static uint32_t pack_slots_valid(const ODID_UAS_Data *UAS_Data)
 {
-	ODID_MessagePack_encoded *outPack;
-	size_t len = 0;
+	uint32_t slots = 0;
+	int page;
+
+	if (UAS_Data->BasicIDValid)
+		slots |= 1 << 0;
+	if (UAS_Data->LocationValid)
+		slots |= 1 << 1;
+	for (page = 0; page < ODID_AUTH_MAX_PAGES; page++) {
+		if (UAS_Data->AuthValid[page])
+			slots |= 1 << (PACK_SLOT_AUTH + page);
+	}
+	if (UAS_Data->SelfIDValid)
+		slots |= 1 << PACK_SLOT_SELF_ID;
+	if (UAS_Data->SystemValid)
+		slots |= 1 << PACK_SLOT_SYSTEM;
+	if (UAS_Data->OperatorIDValid)
+		slots |= 1 << PACK_SLOT_OPERATOR_ID;
+
+	return slots;
+}
 
-	/* check if there is enough space for the header. */
-	if (sizeof(*outPack) > buflen)
-		return -ENOMEM;
+static ODID_messagetype_t pack_slot_type(int slot)
+{
+	if (slot == 0)
+		return ODID_MESSAGETYPE_BASIC_ID;
+	if (slot == 1)
+		return ODID_MESSAGETYPE_LOCATION;
+	if (slot < PACK_SLOT_SELF_ID)
+		return ODID_MESSAGETYPE_AUTH;
+	if (slot == PACK_SLOT_SELF_ID)
+		return ODID_MESSAGETYPE_SELF_ID;
+	if (slot == PACK_SLOT_SYSTEM)
+		return ODID_MESSAGETYPE_SYSTEM;
+	return ODID_MESSAGETYPE_OPERATOR_ID;
+}
 
-	/* TODO: flexibly set optional fields as available */
+/**
+ * encode_pack_slot - encode the message of one message pack slot
+ * @UAS_Data: general drone status information
+ * @slot: slot of the message
+ * @msg: encoded message
+ *
+ * Return: ODID_SUCCESS or ODID_FAIL
+ */
+static int encode_pack_slot(ODID_UAS_Data *UAS_Data, int slot, ODID_Messages_encoded *msg)
+{
+	ODID_Auth_data auth;
+
+	/* the encoders do not write the reserved bytes */
+	memset(msg, 0, sizeof(*msg));
+
+	switch (pack_slot_type(slot)) {
+	case ODID_MESSAGETYPE_BASIC_ID:
+		return encodeBasicIDMessage(&msg->basicId, &UAS_Data->BasicID);
+	case ODID_MESSAGETYPE_LOCATION:
+		return encodeLocationMessage(&msg->location, &UAS_Data->Location);
+	case ODID_MESSAGETYPE_AUTH:
+		/* the page number follows the array index */
+		auth = UAS_Data->Auth[slot - PACK_SLOT_AUTH];
+		auth.DataPage = slot - PACK_SLOT_AUTH;
+		return encodeAuthMessage(&msg->auth, &auth);
+	case ODID_MESSAGETYPE_SELF_ID:
+		return encodeSelfIDMessage(&msg->selfId, &UAS_Data->SelfID);
+	case ODID_MESSAGETYPE_SYSTEM:
+		return encodeSystemMessage(&msg->system, &UAS_Data->System);
+	default:
+		return encodeOperatorIDMessage(&msg->operatorId, &UAS_Data->OperatorID);
+	}
+}
+
+int odid_message_encode_pack(ODID_UAS_Data *UAS_Data, void *pack, size_t buflen)
+{
+	ODID_MessagePack_data data;
+	uint32_t slots;
+	size_t len;
+	int slot;
+
+	slots = pack_slots_valid(UAS_Data);
+	data.SingleMessageSize = ODID_MESSAGE_SIZE;
+	data.MsgPackSize = 0;
+	for (slot = 0; slot < PACK_SLOTS; slot++) {
+		if (!(slots & (1 << slot)))
+			continue;
+		if (encode_pack_slot(UAS_Data, slot, &data.Messages[data.MsgPackSize]) != ODID_SUCCESS)
+			return -EINVAL;
+		data.MsgPackSize++;
+	}
 
-	outPack = (ODID_MessagePack_encoded *) pack;
-	outPack->ProtoVersion = 0;
-	outPack->MessageType = 0;
-	outPack->SingleMessageSize = ODID_MESSAGE_SIZE;
-	outPack->MsgPackSize = 5;
-	len += sizeof(*outPack);
+	if (data.MsgPackSize == 0)
+		return -EINVAL;
 
-	if (len + (outPack->MsgPackSize * ODID_MESSAGE_SIZE) > buflen)
+	len = offsetof(ODID_MessagePack_encoded, Messages) + data.MsgPackSize * ODID_MESSAGE_SIZE;
+	if (len > buflen)
 		return -ENOMEM;
 
-	encodeBasicIDMessage((void *)&outPack->Messages[0], &UAS_Data->BasicID);
-	encodeLocationMessage((void *)&outPack->Messages[1], &UAS_Data->Location);
-	encodeAuthMessage((void *)&outPack->Messages[2], &UAS_Data->Auth[0]);
-	encodeSelfIDMessage((void *)&outPack->Messages[3], &UAS_Data->SelfID);
-	encodeSystemMessage((void *)&outPack->Messages[4], &UAS_Data->System);
-	len += ODID_MESSAGE_SIZE * outPack->MsgPackSize;
+	if (encodeMessagePack((ODID_MessagePack_encoded *) pack, &data) != ODID_SUCCESS)
+		return -EINVAL;
 
 	return len;
 }
 
-int odid_wifi_build_message_pack_nan_action_frame(ODID_UAS_Data *UAS_Data, char *mac,
-						  uint8_t send_counter,
-				     		  uint8_t *buf, size_t buf_size)
+/**
+ * nan_frame_header - write the parts of a NAN action frame that only depend on the MAC
+ * @mac: mac address of the wifi adapter where the NAN frame will be sent
+ * @buf: frame buffer
+ * @buf_size: size of the frame buffer
+ *
+ * Writes the IEEE 802.11 management header, the NAN service discovery header,
+ * the service descriptor attribute without its lengths and the ODID service
+ * info attribute with a zero message counter.
+ *
+ * Return: offset of the message pack, -ENOMEM if the buffer is too small
+ */
+static int nan_frame_header(const char *mac, uint8_t *buf, size_t buf_size)
 {
 	/* Neighbor Awareness Networking Specification v3.0 in section 2.8.1
 	 * NAN Network ID calls for the destination mac to be 51-6F-9A-01-00-00 */
@@ -194,7 +205,7 @@ int odid_wifi_build_message_pack_nan_action_frame(ODID_UAS_Data *UAS_Data, char
 	struct nan_service_discovery *nsd;
 	struct nan_service_descriptor_attribute *nsda;
 	struct ODID_service_info *si;
-	int ret, len = 0;
+	int len = 0;
 
 	/* IEEE 802.11 Management Header */
 	if (len + sizeof(*mgmt) > buf_size)
@@ -242,101 +253,273 @@ int odid_wifi_build_message_pack_nan_action_frame(ODID_UAS_Data *UAS_Data, char
 
 	si = (struct ODID_service_info *)(buf + len);
 	memset(si, 0, sizeof(*si));
-	si->message_counter = send_counter;
 	len += sizeof(*si);
 
+	return len;
+}
+
+/**
+ * nan_frame_finish - set the counter and the lengths that depend on the message pack
+ * @buf: frame written by nan_frame_header()
+ * @send_counter: sequence number
+ * @pack_len: length of the message pack
+ */
+static void nan_frame_finish(uint8_t *buf, uint8_t send_counter, int pack_len)
+{
+	struct nan_service_descriptor_attribute *nsda;
+	struct ODID_service_info *si;
+
+	nsda = (struct nan_service_descriptor_attribute *)
+		(buf + sizeof(struct ieee80211_mgmt) + sizeof(struct nan_service_discovery));
+	si = (struct ODID_service_info *)(buf + ODID_NAN_HEADER_SIZE - sizeof(*si));
+
+	si->message_counter = send_counter;
+
+	/* set the lengths according to the message pack lengths */
+	nsda->service_info_length = sizeof(*si) + pack_len;
+	nsda->length = cpu_to_le16(sizeof(*nsda) - sizeof(struct nan_attribute_header) + nsda->service_info_length);
+}
+
+int odid_wifi_build_message_pack_nan_action_frame(ODID_UAS_Data *UAS_Data, char *mac,
+						  uint8_t send_counter,
+				     		  uint8_t *buf, size_t buf_size)
+{
+	int ret, len;
+
+	len = nan_frame_header(mac, buf, buf_size);
+	if (len < 0)
+		return len;
+
 	ret = odid_message_encode_pack(UAS_Data, buf + len, buf_size - len);
 	if (ret < 0)
 		return ret;
-	len += ret;
 
-	/* set the lengths according to the message pack lengths */
-	nsda->service_info_length = sizeof(*si) + ret;
-	nsda->length = cpu_to_le16(sizeof(*nsda) - sizeof(struct nan_attribute_header) + nsda->service_info_length);
+	nan_frame_finish(buf, send_counter, ret);
 
-	return len;
+	return len + ret;
+}
+
+int odid_wifi_prepare_message_pack_nan_action_frame(struct odid_nan_frame *frame, char *mac)
+{
+	int len;
+
+	memset(frame, 0, sizeof(*frame));
+
+	len = nan_frame_header(mac, frame->buf, sizeof(frame->buf));
+	if (len < 0)
+		return len;
+
+	return 0;
+}
+
+int odid_wifi_update_message_pack_nan_action_frame(struct odid_nan_frame *frame,
+						   ODID_UAS_Data *UAS_Data,
+						   uint8_t send_counter, uint32_t changed)
+{
+	ODID_MessagePack_encoded *pack;
+	ODID_Messages_encoded msg;
+	uint32_t slots;
+	int slot, index, pack_len;
+
+	pack = (ODID_MessagePack_encoded *)(frame->buf + ODID_NAN_HEADER_SIZE);
+	slots = pack_slots_valid(UAS_Data);
+
+	if (frame->len == 0 || slots != frame->slots) {
+		/* first update or other messages valid: encode the whole pack */
+		pack_len = odid_message_encode_pack(UAS_Data, pack,
+						    sizeof(frame->buf) - ODID_NAN_HEADER_SIZE);
+		if (pack_len < 0)
+			return pack_len;
+		frame->slots = slots;
+	} else {
+		/* same messages in the same places, encode the changed ones again */
+		for (slot = 0, index = 0; slot < PACK_SLOTS; slot++) {
+			if (!(slots & (1 << slot)))
+				continue;
+			if (changed & ODID_TYPE_BIT(pack_slot_type(slot))) {
+				if (encode_pack_slot(UAS_Data, slot, &msg) != ODID_SUCCESS) {
+					frame->len = 0;
+					return -EINVAL;
+				}
+				memcpy(&pack->Messages[index], &msg, ODID_MESSAGE_SIZE);
+			}
+			index++;
+		}
+		pack_len = offsetof(ODID_MessagePack_encoded, Messages) + index * ODID_MESSAGE_SIZE;
+	}
+
+	nan_frame_finish(frame->buf, send_counter, pack_len);
+	frame->len = ODID_NAN_HEADER_SIZE + pack_len;
+
+	return frame->len;
 }
 
 int odid_message_decode_pack(ODID_UAS_Data *UAS_Data, uint8_t *pack, size_t buflen)
 {
 	ODID_MessagePack_encoded *inPack;
 
-	if (sizeof(*inPack) > buflen)
+	if (offsetof(ODID_MessagePack_encoded, Messages) > buflen)
 		return -ENOMEM;
 
 	inPack = (ODID_MessagePack_encoded *) pack;
-	if (inPack->MsgPackSize != 5)
-		return -1;
+	if (inPack->MsgPackSize == 0 || inPack->MsgPackSize > ODID_PACK_MAX_MESSAGES)
+		return -EINVAL;
+
+	if (offsetof(ODID_MessagePack_encoded, Messages) + inPack->MsgPackSize * ODID_MESSAGE_SIZE > buflen)
+		return -ENOMEM;
 
-	decodeBasicIDMessage(&UAS_Data->BasicID, (void *)&inPack->Messages[0]);
-	decodeLocationMessage(&UAS_Data->Location, (void *)&inPack->Messages[1]);
-	decodeAuthMessage(&UAS_Data->Auth[0], (void *)&inPack->Messages[2]);
-	decodeSelfIDMessage(&UAS_Data->SelfID, (void *)&inPack->Messages[3]);
-	decodeSystemMessage(&UAS_Data->System, (void *)&inPack->Messages[4]);
+	if (decodeMessagePack(UAS_Data, inPack) != ODID_SUCCESS)
+		return -EINVAL;
 
 	return 0;
 }
 
-int odid_wifi_receive_message_pack_nan_action_frame(ODID_UAS_Data *UAS_Data,
-						    char *mac, uint8_t *buf, size_t buf_size)
+/*
+ * Mask and value of the frame prefix that is the same in every ODID NAN action
+ * frame: the frame type, the NAN service discovery header, the service
+ * descriptor attribute and the message pack header. Addresses, sequence
+ * control, lengths, the message counter and the message count vary.
+ */
+#define NAN_PREFIX_SIZE		48
+
+static const uint8_t nan_prefix_mask[NAN_PREFIX_SIZE] = {
+	[0] = 0xFC,			/* frame control: type and subtype */
+	[24] = 0xFF, 0xFF,		/* category, action code */
+	0xFF, 0xFF, 0xFF, 0xFF,		/* OUI, OUI type */
+	[30] = 0xFF,			/* attribute ID */
+	[33] = 0xFF, 0xFF, 0xFF,	/* service ID */
+	0xFF, 0xFF, 0xFF,
+	[39] = 0xFF,			/* instance ID */
+	[41] = 0xFF,			/* service control */
+	[44] = 0xF0,			/* message pack type */
+	[45] = 0xFF,			/* single message size */
+};
+
+static const uint8_t nan_prefix_value[NAN_PREFIX_SIZE] = {
+	[0] = IEEE80211_FTYPE_MGMT | IEEE80211_STYPE_ACTION,
+	[24] = 0x04, 0x09,
+	0x50, 0x6F, 0x9A, 0x13,
+	[30] = 0x03,
+	[33] = 0x88, 0x69, 0x19,
+	0x9D, 0x92, 0x09,
+	[39] = 0x01,
+	[41] = 0x10,
+	[44] = ODID_MESSAGETYPE_PACKED << 4,
+	[45] = ODID_MESSAGE_SIZE,
+};
+
+int odid_wifi_parse_message_pack_nan_action_frame(struct odid_nan_frame_view *view,
+						  const uint8_t *buf, size_t buf_size)
 {
-	struct ieee80211_mgmt *mgmt;
-	struct nan_service_discovery *nsd;
-	struct nan_service_descriptor_attribute *nsda;
-	struct ODID_service_info *si;
-	uint8_t wifi_alliance_oui[3] = { 0x50, 0x6F, 0x9A };
-	uint8_t service_id[6] = { 0x88, 0x69, 0x19, 0x9D, 0x92, 0x09 };
-	int ret, len;
+	const struct nan_service_descriptor_attribute *nsda;
+	const ODID_MessagePack_encoded *pack;
+	uint64_t word, mask, value, diff = 0;
+	size_t pack_len;
+	int i;
+
+	/* the smallest frame carries a pack of one message */
+	if (buf_size < ODID_NAN_HEADER_SIZE + offsetof(ODID_MessagePack_encoded, Messages) + ODID_MESSAGE_SIZE)
+		return -EINVAL;
 
-	/* basic header size check */
-	if (sizeof(*mgmt) + sizeof(*nsd) + sizeof(*nsda) + sizeof(*si) > buf_size)
+	for (i = 0; i < NAN_PREFIX_SIZE; i += sizeof(word)) {
+		memcpy(&word, buf + i, sizeof(word));
+		memcpy(&mask, nan_prefix_mask + i, sizeof(mask));
+		memcpy(&value, nan_prefix_value + i, sizeof(value));
+		diff |= (word ^ value) & mask;
+	}
+	if (diff)
 		return -EINVAL;
-	len = 0;
 
-	/* check for frame type and correct sender address */
-	mgmt = (struct ieee80211_mgmt *)(buf + len);
-	if ((mgmt->frame_control & cpu_to_le16(IEEE80211_FCTL_FTYPE | IEEE80211_FCTL_STYPE)) !=
-	    cpu_to_le16(IEEE80211_FTYPE_MGMT | IEEE80211_STYPE_ACTION))
+	nsda = (const struct nan_service_descriptor_attribute *)
+		(buf + sizeof(struct ieee80211_mgmt) + sizeof(struct nan_service_discovery));
+	if (ODID_NAN_HEADER_SIZE - sizeof(struct ODID_service_info) + nsda->service_info_length != buf_size)
 		return -EINVAL;
 
-	memcpy(mac, mgmt->sa, sizeof(mgmt->sa));
+	pack = (const ODID_MessagePack_encoded *)(buf + ODID_NAN_HEADER_SIZE);
+	pack_len = buf_size - ODID_NAN_HEADER_SIZE;
+	if (pack->MsgPackSize == 0 || pack->MsgPackSize > ODID_PACK_MAX_MESSAGES ||
+	    offsetof(ODID_MessagePack_encoded, Messages) + pack->MsgPackSize * ODID_MESSAGE_SIZE > pack_len)
+		return -EINVAL;
 
-	len += sizeof(*mgmt);
+	view->mac = ((const struct ieee80211_mgmt *)buf)->sa;
+	view->message_counter = buf[ODID_NAN_HEADER_SIZE - 1];
+	view->pack = (const uint8_t *)pack;
+	view->pack_len = pack_len;
+	view->count = pack->MsgPackSize;
+	view->types = 0;
+	for (i = 0; i < view->count; i++) {
+		ODID_messagetype_t type;
+
+		view->messages[i] = pack->Messages[i].rawData;
+		type = decodeMessageType(view->messages[i][0]);
+		if (type != ODID_MESSAGETYPE_INVALID)
+			view->types |= ODID_TYPE_BIT(type);
+	}
 
-	/* check NAN service discovery frame fields */
-	nsd = (struct nan_service_discovery *)(buf + len);
-	if (nsd->category != 0x04)
-		return -EINVAL;
-	if (nsd->action_code != 0x09)
-		return -EINVAL;
-	if (nsd->oui_type != 0x13)
-		return -EINVAL;
-	if (memcmp(nsd->oui, wifi_alliance_oui, sizeof(wifi_alliance_oui)) != 0)
-		return -EINVAL;
-	len += sizeof(*nsd);
+	return 0;
+}
 
-	/* check NAN service descriptor attribute fields */
-	nsda = (struct nan_service_descriptor_attribute *)(buf + len);
-	if (nsda->attribute_id != 0x3)
-		return -EINVAL;
-	if (memcmp(nsda->service_id, service_id, sizeof(service_id)) != 0)
-		return -EINVAL;
-	if (nsda->instance_id != 0x01)
-		return -EINVAL;
-	if (nsda->service_control != 0x10)
-		return -EINVAL;
-	if (len + sizeof(*nsda) + nsda->service_info_length != buf_size)
-		return -EINVAL;
+int odid_wifi_receive_message_pack_nan_action_frame(ODID_UAS_Data *UAS_Data,
+						    char *mac, uint8_t *buf, size_t buf_size)
+{
+	struct odid_nan_frame_view view;
+	int ret;
 
-	len += sizeof(*nsda);
+	ret = odid_wifi_parse_message_pack_nan_action_frame(&view, buf, buf_size);
+	if (ret < 0)
+		return ret;
 
-	si = (struct ODID_service_info *)(buf + len);
-	len += sizeof(*si);
+	memcpy(mac, view.mac, 6);
 
-	ret = odid_message_decode_pack(UAS_Data, buf + len, buf_size - len);
+	ret = odid_message_decode_pack(UAS_Data, (uint8_t *)view.pack, view.pack_len);
 	if (ret < 0) {
 		return -1;
 	}
 
 	return 0;
 }
+
+int odid_wifi_receive_nan_batch(struct odid_wifi_batch *out,
+				const struct odid_wifi_frame *frames, size_t count)
+{
+	struct odid_nan_frame_view view;
+	const struct odid_wifi_frame *ahead;
+	size_t i, offset;
+	int decoded = 0;
+
+	for (i = 0; i < count; i++) {
+		/* the frames are usually not in the cache yet */
+		if (i + BATCH_PREFETCH_DISTANCE < count) {
+			ahead = &frames[i + BATCH_PREFETCH_DISTANCE];
+			for (offset = 0; offset < ahead->len && offset < BATCH_PREFETCH_SIZE; offset += 64)
+				odid_prefetch(ahead->buf + offset);
+			if (out->uas)
+				odid_prefetch(&out->uas[i + BATCH_PREFETCH_DISTANCE]);
+		}
+
+		out->status[i] = odid_wifi_parse_message_pack_nan_action_frame(&view, frames[i].buf,
+									       frames[i].len);
+		if (out->timestamp)
+			out->timestamp[i] = frames[i].timestamp;
+		if (out->rssi)
+			out->rssi[i] = frames[i].rssi;
+		if (out->status[i] < 0)
+			continue;
+
+		if (out->mac)
+			memcpy(out->mac[i], view.mac, sizeof(out->mac[i]));
+		if (out->message_counter)
+			out->message_counter[i] = view.message_counter;
+
+		if (out->uas) {
+			memset(&out->uas[i], 0, sizeof(out->uas[i]));
+			if (decodeMessagePack(&out->uas[i], (ODID_MessagePack_encoded *)view.pack) != ODID_SUCCESS) {
+				out->status[i] = -EBADMSG;
+				continue;
+			}
+		}
+		decoded++;
+	}
+
+	return decoded;
+}
@@ -0,0 +1,111 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Internal helpers for accessing the encoded messages byte by byte, with
+ * explicit little-endian loads and stores. The offsets are those of the packed
+ * ODID_*_encoded structures in opendroneid.h. Not part of the public API.
+ */
+
+#ifndef _ODID_WIRE_H_
+#define _ODID_WIRE_H_
+
+#include <stdint.h>
+
+// Byte 0 of every message: [MessageType][ProtoVersion]
+#define ODID_WIRE_HEADER(type)          ((uint8_t) (((type) << 4) | (ODID_PROTOCOL_VERSION & 0x0F)))
+#define ODID_WIRE_TYPE(byte)            ((byte) >> 4)
+
+// Byte 1 packs two nibbles in most messages: [high][low]
+#define ODID_WIRE_NIBBLES(high, low)    ((uint8_t) ((((high) & 0x0F) << 4) | ((low) & 0x0F)))
+
+// Basic ID
+#define ODID_BASICID_TYPES              1   // [IDType][UAType]
+#define ODID_BASICID_UASID              2
+
+// Location
+#define ODID_LOC_FLAGS                  1   // [Status][Reserved][HeightType][EWDirection][SpeedMult]
+#define ODID_LOC_FLAG_SPEED_MULT        0x01
+#define ODID_LOC_FLAG_EW_DIRECTION      0x02
+#define ODID_LOC_FLAG_HEIGHT_TYPE       0x04
+#define ODID_LOC_DIRECTION              2
+#define ODID_LOC_SPEED_HORIZONTAL       3
+#define ODID_LOC_SPEED_VERTICAL         4
+#define ODID_LOC_LATITUDE               5
+#define ODID_LOC_LONGITUDE              9
+#define ODID_LOC_ALTITUDE_BARO          13
+#define ODID_LOC_ALTITUDE_GEO           15
+#define ODID_LOC_HEIGHT                 17
+#define ODID_LOC_HV_ACCURACY            19  // [VertAccuracy][HorizAccuracy]
+#define ODID_LOC_BS_ACCURACY            20  // [BaroAccuracy][SpeedAccuracy]
+#define ODID_LOC_TIMESTAMP              21
+#define ODID_LOC_TS_ACCURACY            23  // [Reserved2][TSAccuracy]
+#define ODID_LOC_RESERVED3              24
+
+// Authentication
+#define ODID_AUTH_TYPE_PAGE             1   // [AuthType][DataPage]
+#define ODID_AUTH_PAGE_COUNT            2   // Page 0 only
+#define ODID_AUTH_LENGTH                3   // Page 0 only
+#define ODID_AUTH_TIMESTAMP             4   // Page 0 only
+#define ODID_AUTH_DATA_PAGE_0           8
+#define ODID_AUTH_DATA_PAGE_1_4         2
+
+// Self ID
+#define ODID_SELFID_DESC_TYPE           1
+#define ODID_SELFID_DESC                2
+
+// System
+#define ODID_SYSTEM_FLAGS               1   // [LocationSource][Reserved]
+#define ODID_SYSTEM_LOCATION_SOURCE     0x80
+#define ODID_SYSTEM_OPERATOR_LAT        2
+#define ODID_SYSTEM_OPERATOR_LON        6
+#define ODID_SYSTEM_AREA_COUNT          10
+#define ODID_SYSTEM_AREA_RADIUS         12
+#define ODID_SYSTEM_AREA_CEILING        13
+#define ODID_SYSTEM_AREA_FLOOR          15
+#define ODID_SYSTEM_RESERVED2           17
+
+// Operator ID
+#define ODID_OPERATORID_TYPE            1
+#define ODID_OPERATORID_ID              2
+
+// Message pack
+#define ODID_PACK_SINGLE_MESSAGE_SIZE   1
+#define ODID_PACK_MSG_PACK_SIZE         2
+#define ODID_PACK_MESSAGES              3
+
+static inline uint16_t odid_get_le16(const uint8_t *p)
+{
+    return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static inline uint32_t odid_get_le32(const uint8_t *p)
+{
+    return (uint32_t) p[0] | ((uint32_t) p[1] << 8) |
+           ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static inline void odid_put_le16(uint8_t *p, uint16_t value)
+{
+    p[0] = (uint8_t) value;
+    p[1] = (uint8_t) (value >> 8);
+}
+
+static inline void odid_put_le32(uint8_t *p, uint32_t value)
+{
+    p[0] = (uint8_t) value;
+    p[1] = (uint8_t) (value >> 8);
+    p[2] = (uint8_t) (value >> 16);
+    p[3] = (uint8_t) (value >> 24);
+}
+
+#endif // _ODID_WIRE_H_
@@ -0,0 +1,49 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#ifndef _ODID_BENCH_H_
+#define _ODID_BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+#include "test_util.h"
+
+// Monotonic wall clock in seconds
+static inline double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+void bench_report(const char *name, size_t messages, double seconds);
+
+int bench_suite(int repeats, const char *jsonPath);
+
+void bench_location_batch(void);
+void bench_decode_batch(void);
+void bench_view(void);
+void bench_accuracy(void);
+void bench_decode_tables(void);
+void bench_codec(void);
+void bench_fixed(void);
+void bench_validate(void);
+void bench_decode_pack(void);
+void bench_stream(void);
+void bench_single(void);
+void bench_json(void);
+void bench_record(void);
+void bench_nan_frame(void);
+void bench_nan_batch(void);
+
+#endif // _ODID_BENCH_H_
@@ -0,0 +1,88 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "codec_ref.h"
+#include "bench.h"
+
+#define BENCH_VALUES 4096
+#define BENCH_ROUNDS 500
+
+#define BENCH_ACCURACY(name, func) do { \
+        double start_ = bench_now(); \
+        for (int r = 0; r < BENCH_ROUNDS; r++) \
+            for (int i = 0; i < BENCH_VALUES; i++) \
+                sink += func(values[i]); \
+        bench_report(name, (size_t) BENCH_ROUNDS * BENCH_VALUES, bench_now() - start_); \
+    } while (0)
+
+// GPS fixes usually report accuracies within a few meters and a few tenths of a second
+void bench_accuracy(void)
+{
+    float *values = malloc(BENCH_VALUES * sizeof(*values));
+    volatile int sink = 0;
+    uint32_t seed = 0xACC;
+
+    if (!values)
+        return;
+    for (int i = 0; i < BENCH_VALUES; i++)
+        values[i] = test_randf(&seed, 0, 2);
+
+    BENCH_ACCURACY("createEnumHorizontalAccuracy (if/else)", ref_createEnumHorizontalAccuracy);
+    BENCH_ACCURACY("createEnumHorizontalAccuracy", createEnumHorizontalAccuracy);
+    BENCH_ACCURACY("createEnumVerticalAccuracy (if/else)", ref_createEnumVerticalAccuracy);
+    BENCH_ACCURACY("createEnumVerticalAccuracy", createEnumVerticalAccuracy);
+    BENCH_ACCURACY("createEnumSpeedAccuracy (if/else)", ref_createEnumSpeedAccuracy);
+    BENCH_ACCURACY("createEnumSpeedAccuracy", createEnumSpeedAccuracy);
+    BENCH_ACCURACY("createEnumTimestampAccuracy (if/else)", ref_createEnumTimestampAccuracy);
+    BENCH_ACCURACY("createEnumTimestampAccuracy", createEnumTimestampAccuracy);
+
+    free(values);
+}
+
+// Decoding of Location messages with random direction and speed bytes
+void bench_decode_tables(void)
+{
+    ODID_Location_encoded *msgs = calloc(BENCH_VALUES, sizeof(*msgs));
+    ODID_Location_data loc;
+    uint32_t seed = 0x7AB1E;
+    double start;
+
+    if (!msgs)
+        return;
+    for (int i = 0; i < BENCH_VALUES; i++) {
+        msgs[i].MessageType = ODID_MESSAGETYPE_LOCATION;
+        msgs[i].Direction = (uint8_t) test_rand(&seed);
+        msgs[i].EWDirection = test_rand(&seed) & 1;
+        msgs[i].SpeedHorizontal = (uint8_t) test_rand(&seed);
+        msgs[i].SpeedMult = test_rand(&seed) & 1;
+        msgs[i].SpeedVertical = (int8_t) test_rand(&seed);
+    }
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_VALUES; i++)
+            ref_decodeLocationMessage(&loc, &msgs[i]);
+    bench_report("decodeLocationMessage (arithmetic)", (size_t) BENCH_ROUNDS * BENCH_VALUES,
+                 bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_VALUES; i++)
+            decodeLocationMessage(&loc, &msgs[i]);
+    bench_report("decodeLocationMessage", (size_t) BENCH_ROUNDS * BENCH_VALUES,
+                 bench_now() - start);
+
+    free(msgs);
+}
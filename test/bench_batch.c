@@ -0,0 +1,152 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "bench.h"
+
+#define BENCH_MESSAGES 4096
+#define BENCH_ROUNDS 200
+
+static void fillLocations(ODID_Location_data *in, size_t n)
+{
+    uint32_t seed = 0x0D1D;
+    for (size_t i = 0; i < n; i++) {
+        memset(&in[i], 0, sizeof(in[i]));
+        in[i].Status = ODID_STATUS_AIRBORNE;
+        in[i].Direction = test_randf(&seed, 0, 360);
+        in[i].SpeedHorizontal = test_randf(&seed, 0, 120);
+        in[i].SpeedVertical = test_randf(&seed, -20, 20);
+        in[i].Latitude = test_randf(&seed, -90, 90);
+        in[i].Longitude = test_randf(&seed, -180, 180);
+        in[i].AltitudeBaro = test_randf(&seed, -100, 3000);
+        in[i].AltitudeGeo = test_randf(&seed, -100, 3000);
+        in[i].HeightType = ODID_HEIGHT_REF_OVER_GROUND;
+        in[i].Height = test_randf(&seed, 0, 500);
+        in[i].HorizAccuracy = createEnumHorizontalAccuracy(2.5f);
+        in[i].VertAccuracy = createEnumVerticalAccuracy(2.5f);
+        in[i].BaroAccuracy = createEnumVerticalAccuracy(3.5f);
+        in[i].SpeedAccuracy = createEnumSpeedAccuracy(0.5f);
+        in[i].TSAccuracy = createEnumTimestampAccuracy(0.2f);
+        in[i].TimeStamp = test_randf(&seed, 0, 3600);
+    }
+}
+
+void bench_location_batch(void)
+{
+    ODID_Location_data *in = calloc(BENCH_MESSAGES, sizeof(*in));
+    ODID_Location_encoded *out = calloc(BENCH_MESSAGES, sizeof(*out));
+    double start;
+
+    if (!in || !out)
+        goto out;
+    fillLocations(in, BENCH_MESSAGES);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_MESSAGES; i++)
+            encodeLocationMessage(&out[i], &in[i]);
+    bench_report("encodeLocationMessage", (size_t) BENCH_ROUNDS * BENCH_MESSAGES,
+                 bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        encodeLocationMessageBatch(out, in, BENCH_MESSAGES);
+    bench_report("encodeLocationMessageBatch", (size_t) BENCH_ROUNDS * BENCH_MESSAGES,
+                 bench_now() - start);
+
+out:
+    free(in);
+    free(out);
+}
+
+// A stream of the message types a receiver typically sees, Location being the most frequent
+static void fillMessages(uint8_t *msgs, size_t n)
+{
+    ODID_BasicID_data basicID = { ODID_UATYPE_ROTORCRAFT, ODID_IDTYPE_SERIAL_NUMBER, "INTCE123456789012345" };
+    ODID_Location_data location;
+    ODID_Auth_data auth = { 0, ODID_AUTH_UAS_ID_SIGNATURE, 1, 12, 23000000, "030a0cd033a3" };
+    ODID_SelfID_data selfID = { ODID_DESC_TYPE_TEXT, "Real Estate Photos" };
+    ODID_System_data system = { ODID_LOCATION_SRC_TAKEOFF, 45.5393082, -122.9663884, 35, 75, 176.9f, 41.7f };
+    ODID_OperatorID_data operatorID = { ODID_OPERATOR_ID, "98765432100123456789" };
+
+    for (size_t i = 0; i < n; i++) {
+        uint8_t *msg = &msgs[i * ODID_MESSAGE_SIZE];
+        switch (i % 8) {
+        case 0:
+            encodeBasicIDMessage((ODID_BasicID_encoded *) msg, &basicID);
+            break;
+        case 2:
+            encodeAuthMessage((ODID_Auth_encoded *) msg, &auth);
+            break;
+        case 4:
+            encodeSelfIDMessage((ODID_SelfID_encoded *) msg, &selfID);
+            break;
+        case 5:
+            encodeSystemMessage((ODID_System_encoded *) msg, &system);
+            break;
+        case 6:
+            encodeOperatorIDMessage((ODID_OperatorID_encoded *) msg, &operatorID);
+            break;
+        default:
+            fillLocations(&location, 1);
+            encodeLocationMessage((ODID_Location_encoded *) msg, &location);
+            break;
+        }
+    }
+}
+
+void bench_decode_batch(void)
+{
+    uint8_t *msgs = calloc(BENCH_MESSAGES, ODID_MESSAGE_SIZE);
+    ODID_messagetype_t *status = calloc(BENCH_MESSAGES, sizeof(*status));
+    ODID_UAS_Data *uas = calloc(1, sizeof(*uas));
+    ODID_Batch_data out = { 0 };
+    double start;
+
+    out.BasicID = calloc(BENCH_MESSAGES, sizeof(*out.BasicID));
+    out.Location = calloc(BENCH_MESSAGES, sizeof(*out.Location));
+    out.Auth = calloc(BENCH_MESSAGES, sizeof(*out.Auth));
+    out.SelfID = calloc(BENCH_MESSAGES, sizeof(*out.SelfID));
+    out.System = calloc(BENCH_MESSAGES, sizeof(*out.System));
+    out.OperatorID = calloc(BENCH_MESSAGES, sizeof(*out.OperatorID));
+    if (!msgs || !status || !uas || !out.BasicID || !out.Location || !out.Auth ||
+        !out.SelfID || !out.System || !out.OperatorID)
+        goto out;
+    fillMessages(msgs, BENCH_MESSAGES);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_MESSAGES; i++)
+            decodeOpenDroneID(uas, &msgs[i * ODID_MESSAGE_SIZE]);
+    bench_report("decodeOpenDroneID", (size_t) BENCH_ROUNDS * BENCH_MESSAGES,
+                 bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        decodeOpenDroneIDBatch(&out, status, msgs, BENCH_MESSAGES);
+    bench_report("decodeOpenDroneIDBatch", (size_t) BENCH_ROUNDS * BENCH_MESSAGES,
+                 bench_now() - start);
+
+out:
+    free(out.BasicID);
+    free(out.Location);
+    free(out.Auth);
+    free(out.SelfID);
+    free(out.System);
+    free(out.OperatorID);
+    free(uas);
+    free(status);
+    free(msgs);
+}
@@ -0,0 +1,101 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "bench.h"
+
+#define BENCH_MESSAGES 4096
+#define BENCH_ROUNDS 200
+
+#ifdef ODID_BYTE_CODEC
+#define CODEC_NAME "byte codec"
+#else
+#define CODEC_NAME "struct codec"
+#endif
+
+#define BENCH_CODEC(name, body) do { \
+        double start_ = bench_now(); \
+        for (int r = 0; r < BENCH_ROUNDS; r++) \
+            for (int i = 0; i < BENCH_MESSAGES; i++) \
+                body; \
+        bench_report(name " (" CODEC_NAME ")", (size_t) BENCH_ROUNDS * BENCH_MESSAGES, \
+                     bench_now() - start_); \
+    } while (0)
+
+// Encode and decode the Location, System and Auth messages with the wire codec
+// the library was built with. Compare the output of odidbench and odidbench_bytecodec.
+void bench_codec(void)
+{
+    ODID_Location_data *loc = calloc(BENCH_MESSAGES, sizeof(*loc));
+    ODID_System_data *sys = calloc(BENCH_MESSAGES, sizeof(*sys));
+    ODID_Auth_data *auth = calloc(BENCH_MESSAGES, sizeof(*auth));
+    ODID_Location_encoded *locEnc = calloc(BENCH_MESSAGES, sizeof(*locEnc));
+    ODID_System_encoded *sysEnc = calloc(BENCH_MESSAGES, sizeof(*sysEnc));
+    ODID_Auth_encoded *authEnc = calloc(BENCH_MESSAGES, sizeof(*authEnc));
+    uint32_t seed = 0xC0DEC;
+
+    if (!loc || !sys || !auth || !locEnc || !sysEnc || !authEnc)
+        goto out;
+
+    for (int i = 0; i < BENCH_MESSAGES; i++) {
+        loc[i].Status = (ODID_status_t) (test_rand(&seed) % 4);
+        loc[i].Direction = test_randf(&seed, 0, 359);
+        loc[i].SpeedHorizontal = test_randf(&seed, 0, 100);
+        loc[i].SpeedVertical = test_randf(&seed, -20, 20);
+        loc[i].Latitude = test_randf(&seed, -90, 90);
+        loc[i].Longitude = test_randf(&seed, -180, 180);
+        loc[i].AltitudeBaro = test_randf(&seed, 0, 3000);
+        loc[i].AltitudeGeo = test_randf(&seed, 0, 3000);
+        loc[i].HeightType = (ODID_Height_reference_t) (test_rand(&seed) & 1);
+        loc[i].Height = test_randf(&seed, 0, 500);
+        loc[i].HorizAccuracy = (ODID_Horizontal_accuracy_t) (test_rand(&seed) % 13);
+        loc[i].VertAccuracy = (ODID_Vertical_accuracy_t) (test_rand(&seed) % 7);
+        loc[i].BaroAccuracy = (ODID_Vertical_accuracy_t) (test_rand(&seed) % 7);
+        loc[i].SpeedAccuracy = (ODID_Speed_accuracy_t) (test_rand(&seed) % 5);
+        loc[i].TSAccuracy = (ODID_Timestamp_accuracy_t) (test_rand(&seed) % 16);
+        loc[i].TimeStamp = test_randf(&seed, 0, 3600);
+
+        sys[i].LocationSource = (ODID_location_source_t) (test_rand(&seed) & 1);
+        sys[i].OperatorLatitude = test_randf(&seed, -90, 90);
+        sys[i].OperatorLongitude = test_randf(&seed, -180, 180);
+        sys[i].AreaCount = (uint16_t) test_rand(&seed);
+        sys[i].AreaRadius = (uint16_t) (test_rand(&seed) % 2550);
+        sys[i].AreaCeiling = test_randf(&seed, 0, 3000);
+        sys[i].AreaFloor = test_randf(&seed, -100, 0);
+
+        auth[i].AuthType = ODID_AUTH_UAS_ID_SIGNATURE;
+        auth[i].DataPage = (uint8_t) (i % ODID_AUTH_MAX_PAGES);
+        auth[i].PageCount = ODID_AUTH_MAX_PAGES;
+        auth[i].Length = 100;
+        auth[i].Timestamp = test_rand(&seed);
+        for (int j = 0; j < ODID_STR_SIZE; j++)
+            auth[i].AuthData[j] = (char) ('a' + test_rand(&seed) % 26);
+    }
+
+    BENCH_CODEC("encodeLocationMessage", encodeLocationMessage(&locEnc[i], &loc[i]));
+    BENCH_CODEC("decodeLocationMessage", decodeLocationMessage(&loc[i], &locEnc[i]));
+    BENCH_CODEC("encodeSystemMessage", encodeSystemMessage(&sysEnc[i], &sys[i]));
+    BENCH_CODEC("decodeSystemMessage", decodeSystemMessage(&sys[i], &sysEnc[i]));
+    BENCH_CODEC("encodeAuthMessage", encodeAuthMessage(&authEnc[i], &auth[i]));
+    BENCH_CODEC("decodeAuthMessage", decodeAuthMessage(&auth[i], &authEnc[i]));
+
+out:
+    free(loc);
+    free(sys);
+    free(auth);
+    free(locEnc);
+    free(sysEnc);
+    free(authEnc);
+}
@@ -0,0 +1,63 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "bench.h"
+
+#define BENCH_MESSAGES 4096
+#define BENCH_ROUNDS 200
+
+#define BENCH_FIXED(name, body) do { \
+        double start_ = bench_now(); \
+        for (int r = 0; r < BENCH_ROUNDS; r++) \
+            for (int i = 0; i < BENCH_MESSAGES; i++) \
+                body; \
+        bench_report(name, (size_t) BENCH_ROUNDS * BENCH_MESSAGES, bench_now() - start_); \
+    } while (0)
+
+// Location messages through the float and the fixed-point codec
+void bench_fixed(void)
+{
+    ODID_Location_data *loc = calloc(BENCH_MESSAGES, sizeof(*loc));
+    ODID_Location_fixed *fixed = calloc(BENCH_MESSAGES, sizeof(*fixed));
+    ODID_Location_encoded *encoded = calloc(BENCH_MESSAGES, sizeof(*encoded));
+    uint32_t seed = 0xF12ED;
+
+    if (!loc || !fixed || !encoded)
+        goto out;
+
+    for (int i = 0; i < BENCH_MESSAGES; i++) {
+        loc[i].Direction = test_randf(&seed, 0, 359);
+        loc[i].SpeedHorizontal = test_randf(&seed, 0, 100);
+        loc[i].SpeedVertical = test_randf(&seed, -20, 20);
+        loc[i].Latitude = test_randf(&seed, -90, 90);
+        loc[i].Longitude = test_randf(&seed, -180, 180);
+        loc[i].AltitudeBaro = test_randf(&seed, 0, 3000);
+        loc[i].AltitudeGeo = test_randf(&seed, 0, 3000);
+        loc[i].Height = test_randf(&seed, 0, 500);
+        loc[i].TimeStamp = test_randf(&seed, 0, 3600);
+        encodeLocationMessage(&encoded[i], &loc[i]);
+        decodeLocationMessageFixed(&fixed[i], &encoded[i]);
+    }
+
+    BENCH_FIXED("encodeLocationMessage", encodeLocationMessage(&encoded[i], &loc[i]));
+    BENCH_FIXED("encodeLocationMessageFixed", encodeLocationMessageFixed(&encoded[i], &fixed[i]));
+    BENCH_FIXED("decodeLocationMessage", decodeLocationMessage(&loc[i], &encoded[i]));
+    BENCH_FIXED("decodeLocationMessageFixed", decodeLocationMessageFixed(&fixed[i], &encoded[i]));
+
+out:
+    free(loc);
+    free(fixed);
+    free(encoded);
+}
@@ -0,0 +1,139 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "bench.h"
+#include "codec_ref.h"
+
+#define BENCH_DRONES 256
+#define BENCH_ROUNDS 100
+#define BENCH_SINK_SIZE 65536
+
+// Sink that drops the output, only counting the bytes
+static int countBytes(void *user, const char *data, size_t len)
+{
+    (void) data;
+    *(size_t *) user += len;
+    return 0;
+}
+
+static void randomDrone(ODID_UAS_Data *uas, uint32_t *seed)
+{
+    memset(uas, 0, sizeof(*uas));
+    uas->BasicID.UAType = (ODID_uatype_t) (test_rand(seed) % 16);
+    uas->BasicID.IDType = (ODID_idtype_t) (test_rand(seed) % 4);
+    snprintf(uas->BasicID.UASID, sizeof(uas->BasicID.UASID), "SN%08X", test_rand(seed));
+    uas->Location.Status = ODID_STATUS_AIRBORNE;
+    uas->Location.Direction = (float) (test_rand(seed) % 360);
+    uas->Location.SpeedHorizontal = (float) (test_rand(seed) % 400) * 0.25f;
+    uas->Location.SpeedVertical = (float) (test_rand(seed) % 80) * 0.5f - 20;
+    uas->Location.Latitude = (double) (int32_t) (test_rand(seed) % 1800000000 - 900000000) / 1e7;
+    uas->Location.Longitude = (double) (int32_t) (test_rand(seed) % 3600000000u - 1800000000) / 1e7;
+    uas->Location.AltitudeBaro = (float) (test_rand(seed) % 6000) * 0.5f;
+    uas->Location.AltitudeGeo = (float) (test_rand(seed) % 6000) * 0.5f;
+    uas->Location.Height = (float) (test_rand(seed) % 1000) * 0.5f;
+    uas->Location.TimeStamp = (float) (test_rand(seed) % 36000) / 10;
+    uas->Auth[0].AuthType = ODID_AUTH_UAS_ID_SIGNATURE;
+    strcpy(uas->Auth[0].AuthData, "12345678901234567");
+    strcpy(uas->SelfID.Desc, "Real estate survey");
+    uas->System.OperatorLatitude = uas->Location.Latitude;
+    uas->System.OperatorLongitude = uas->Location.Longitude;
+    uas->System.AreaCount = 1;
+    uas->System.AreaCeiling = -1000;
+    uas->System.AreaFloor = -1000;
+    uas->BasicIDValid = uas->LocationValid = uas->AuthValid[0] = 1;
+    uas->SelfIDValid = uas->SystemValid = uas->OperatorIDValid = 1;
+}
+
+static int countDocument(void *user, const ODID_UAS_Data *uasData)
+{
+    (void) uasData;
+    (*(size_t *) user)++;
+    return 0;
+}
+
+// JSON export of received drones: the snprintf based exporter against the writer
+void bench_json(void)
+{
+    ODID_UAS_Data *drones = calloc(BENCH_DRONES, sizeof(*drones));
+    char *sinkBuffer = malloc(BENCH_SINK_SIZE);
+    char *lines = malloc(BENCH_DRONES * ODID_JSON_MAX_SIZE);
+    char buffer[ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    volatile size_t bytes = 0;
+    size_t sinkBytes = 0, documents = 0;
+    uint32_t seed = 0x750E;
+    double start;
+
+    if (!drones || !sinkBuffer || !lines)
+        goto out;
+
+    for (int i = 0; i < BENCH_DRONES; i++)
+        randomDrone(&drones[i], &seed);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_DRONES; i++) {
+            char *str = ref_drone_export_gps_data(&drones[i]);
+            bytes += str ? strlen(str) : 0;
+            free(str);
+        }
+    }
+    bench_report("drone_export_gps_data (snprintf)", (size_t) BENCH_ROUNDS * BENCH_DRONES, bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_DRONES; i++) {
+            char *str = drone_export_gps_data(&drones[i]);
+            bytes += str ? strlen(str) : 0;
+            free(str);
+        }
+    }
+    bench_report("drone_export_gps_data", (size_t) BENCH_ROUNDS * BENCH_DRONES, bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_DRONES; i++) {
+            odid_json_init(&writer, buffer, sizeof(buffer), NULL, NULL);
+            odid_json_write(&writer, &drones[i], 0);
+            bytes += writer.Length;
+        }
+    }
+    bench_report("odid_json_write", (size_t) BENCH_ROUNDS * BENCH_DRONES, bench_now() - start);
+
+    // NDJSON through a sink, with all pages and the OperatorID
+    odid_json_init(&writer, sinkBuffer, BENCH_SINK_SIZE, countBytes, &sinkBytes);
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_DRONES; i++)
+            odid_json_write(&writer, &drones[i], ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID | ODID_JSON_NEWLINE);
+    odid_json_flush(&writer);
+    bench_report("odid_json_write (NDJSON sink)", (size_t) BENCH_ROUNDS * BENCH_DRONES, bench_now() - start);
+    bytes += sinkBytes;
+
+    // Import of the same NDJSON, in place
+    odid_json_init(&writer, lines, BENCH_DRONES * ODID_JSON_MAX_SIZE, NULL, NULL);
+    for (int i = 0; i < BENCH_DRONES; i++)
+        odid_json_write(&writer, &drones[i], ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID | ODID_JSON_NEWLINE);
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        odid_json_read_lines(lines, writer.Length, countDocument, &documents, NULL);
+    bench_report("odid_json_read_lines", documents, bench_now() - start);
+
+out:
+    free(drones);
+    free(sinkBuffer);
+    free(lines);
+}
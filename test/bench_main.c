@@ -0,0 +1,80 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+
+#define BENCH_DEFAULT_REPEATS 101
+
+void bench_report(const char *name, size_t messages, double seconds)
+{
+    printf("%-40s %12.0f msg/s %10.1f ns/msg\n", name,
+           messages / seconds, seconds * 1e9 / messages);
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [--suite] [--repeats N] [--json FILE]\n"
+            "  --suite      Only run the benchmark of all encode/decode functions\n"
+            "  --repeats N  Timed batches per function (default %d)\n"
+            "  --json FILE  Write the results of that benchmark to FILE as JSON\n",
+            name, BENCH_DEFAULT_REPEATS);
+}
+
+int main(int argc, char const *argv[])
+{
+    const char *jsonPath = NULL;
+    int repeats = BENCH_DEFAULT_REPEATS;
+    int suiteOnly = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--suite") == 0) {
+            suiteOnly = 1;
+        } else if (strcmp(argv[i], "--repeats") == 0 && i + 1 < argc) {
+            repeats = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (repeats <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (bench_suite(repeats, jsonPath) != 0)
+        return 1;
+    if (suiteOnly)
+        return 0;
+
+    printf("\n");
+    bench_location_batch();
+    bench_decode_batch();
+    bench_view();
+    bench_accuracy();
+    bench_decode_tables();
+    bench_codec();
+    bench_fixed();
+    bench_validate();
+    bench_decode_pack();
+    bench_stream();
+    bench_single();
+    bench_json();
+    bench_record();
+    bench_nan_frame();
+    bench_nan_batch();
+    return 0;
+}
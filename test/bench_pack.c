@@ -0,0 +1,69 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "bench.h"
+#include "codec_ref.h"
+
+#define BENCH_PACKS 1024
+#define BENCH_ROUNDS 200
+
+// Full packs with all ten messages: Basic ID, Location, five Authentication
+// pages, Self ID, System and Operator ID
+void bench_decode_pack(void)
+{
+    static const uint8_t types[ODID_PACK_MAX_MESSAGES] = { 0, 1, 2, 2, 2, 2, 2, 3, 4, 5 };
+    ODID_MessagePack_encoded *packs = calloc(BENCH_PACKS, sizeof(*packs));
+    ODID_UAS_Data *uas = malloc(sizeof(*uas));
+    volatile int sink = 0;
+    uint32_t seed = 0xFAC4;
+    double start;
+
+    if (!packs || !uas)
+        goto out;
+
+    for (int i = 0; i < BENCH_PACKS; i++) {
+        int page = 0;
+        packs[i].MessageType = ODID_MESSAGETYPE_PACKED;
+        packs[i].ProtoVersion = ODID_PROTOCOL_VERSION;
+        packs[i].SingleMessageSize = ODID_MESSAGE_SIZE;
+        packs[i].MsgPackSize = ODID_PACK_MAX_MESSAGES;
+        for (int j = 0; j < ODID_PACK_MAX_MESSAGES; j++) {
+            uint8_t *msg = packs[i].Messages[j].rawData;
+            for (int k = 1; k < ODID_MESSAGE_SIZE; k++)
+                msg[k] = (uint8_t) test_rand(&seed);
+            msg[0] = (uint8_t) (types[j] << 4);
+            if (types[j] == ODID_MESSAGETYPE_AUTH)
+                msg[1] = (msg[1] & 0xF0) | page++;
+        }
+    }
+    memset(uas, 0, sizeof(*uas));
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_PACKS; i++)
+            sink += ref_decodeMessagePack(uas, &packs[i]);
+    bench_report("decodeMessagePack (two pass)", (size_t) BENCH_ROUNDS * BENCH_PACKS, bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_PACKS; i++)
+            sink += decodeMessagePack(uas, &packs[i]);
+    bench_report("decodeMessagePack (single pass)", (size_t) BENCH_ROUNDS * BENCH_PACKS, bench_now() - start);
+
+out:
+    free(packs);
+    free(uas);
+}
@@ -0,0 +1,108 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "bench.h"
+
+#define BENCH_DRONES 256
+#define BENCH_ROUNDS 1000
+
+// Drones with the messages a receiver typically has, at wire resolution
+static void randomDrone(ODID_UAS_Data *uas, uint32_t *seed)
+{
+    memset(uas, 0, sizeof(*uas));
+    uas->BasicID.UAType = (ODID_uatype_t) (test_rand(seed) % 16);
+    uas->BasicID.IDType = (ODID_idtype_t) (test_rand(seed) % 4);
+    snprintf(uas->BasicID.UASID, sizeof(uas->BasicID.UASID), "SN%08X", test_rand(seed));
+    uas->Location.Status = ODID_STATUS_AIRBORNE;
+    uas->Location.Direction = (float) (test_rand(seed) % 360);
+    uas->Location.SpeedHorizontal = (float) (test_rand(seed) % 400) * 0.25f;
+    uas->Location.SpeedVertical = (float) (test_rand(seed) % 80) * 0.5f - 20;
+    uas->Location.Latitude = (double) (int32_t) (test_rand(seed) % 1800000000 - 900000000) / 1e7;
+    uas->Location.Longitude = (double) (int32_t) (test_rand(seed) % 3600000000u - 1800000000) / 1e7;
+    uas->Location.AltitudeBaro = (float) (test_rand(seed) % 6000) * 0.5f;
+    uas->Location.AltitudeGeo = (float) (test_rand(seed) % 6000) * 0.5f;
+    uas->Location.Height = (float) (test_rand(seed) % 1000) * 0.5f;
+    uas->Location.TimeStamp = (float) (test_rand(seed) % 36000) / 10;
+    uas->Auth[0].AuthType = ODID_AUTH_UAS_ID_SIGNATURE;
+    strcpy(uas->Auth[0].AuthData, "12345678901234567");
+    strcpy(uas->SelfID.Desc, "Real estate survey");
+    uas->System.OperatorLatitude = uas->Location.Latitude;
+    uas->System.OperatorLongitude = uas->Location.Longitude;
+    uas->System.AreaCount = 1;
+    uas->System.AreaCeiling = -1000;
+    uas->System.AreaFloor = -1000;
+    uas->BasicIDValid = uas->LocationValid = uas->SelfIDValid = uas->SystemValid = 1;
+    uas->AuthValid[0] = 1;
+}
+
+// Binary records of received drones against the JSON export of the same data
+void bench_record(void)
+{
+    ODID_UAS_Data *drones = calloc(BENCH_DRONES, sizeof(*drones));
+    uint8_t *records = malloc(BENCH_DRONES * ODID_RECORD_MAX_SIZE);
+    size_t *sizes = calloc(BENCH_DRONES, sizeof(*sizes));
+    char json[ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    ODID_UAS_Data decoded;
+    volatile size_t bytes = 0;
+    size_t recordBytes = 0, jsonBytes = 0;
+    uint32_t seed = 0x2EC0;
+    double start;
+
+    if (!drones || !records || !sizes)
+        goto out;
+
+    for (int i = 0; i < BENCH_DRONES; i++) {
+        randomDrone(&drones[i], &seed);
+        sizes[i] = odid_record_encode(&records[i * ODID_RECORD_MAX_SIZE], ODID_RECORD_MAX_SIZE,
+                                      &drones[i], NULL, 0);
+        recordBytes += sizes[i];
+        odid_json_init(&writer, json, sizeof(json), NULL, NULL);
+        odid_json_write(&writer, &drones[i], 0);
+        jsonBytes += writer.Length;
+    }
+    printf("%-40s %12.1f bytes per record\n", "record size", (double) recordBytes / BENCH_DRONES);
+    printf("%-40s %12.1f bytes per record\n", "JSON size", (double) jsonBytes / BENCH_DRONES);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_DRONES; i++)
+            bytes += odid_record_encode(&records[i * ODID_RECORD_MAX_SIZE], ODID_RECORD_MAX_SIZE,
+                                        &drones[i], NULL, 0);
+    bench_report("odid_record_encode", (size_t) BENCH_ROUNDS * BENCH_DRONES, bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_DRONES; i++)
+            bytes += odid_record_decode(&decoded, &records[i * ODID_RECORD_MAX_SIZE], sizes[i],
+                                        NULL, NULL);
+    bench_report("odid_record_decode", (size_t) BENCH_ROUNDS * BENCH_DRONES, bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_DRONES; i++) {
+            odid_json_init(&writer, json, sizeof(json), NULL, NULL);
+            odid_json_write(&writer, &drones[i], 0);
+            bytes += writer.Length;
+        }
+    }
+    bench_report("odid_json_write", (size_t) BENCH_ROUNDS * BENCH_DRONES, bench_now() - start);
+
+out:
+    free(drones);
+    free(records);
+    free(sizes);
+}
@@ -0,0 +1,122 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <opendroneid.h>
+#include "bench.h"
+
+#define BENCH_MESSAGES 4096
+#define BENCH_ROUNDS 200
+
+// In bench_single_inline.c, with the encoders inlined from opendroneid_single.h
+int bench_inline_encode_location(ODID_Location_encoded *out, ODID_Location_data *in, int count);
+int bench_inline_encode_system(ODID_System_encoded *out, ODID_System_data *in, int count);
+int bench_inline_encode_basic_id(ODID_BasicID_encoded *out, ODID_BasicID_data *in, int count);
+
+// The same loops, calling the shared library
+static int encodeLocationLinked(ODID_Location_encoded *out, ODID_Location_data *in, int count)
+{
+    int fails = 0;
+
+    for (int i = 0; i < count; i++)
+        fails += encodeLocationMessage(&out[i], &in[i]);
+    return fails;
+}
+
+static int encodeSystemLinked(ODID_System_encoded *out, ODID_System_data *in, int count)
+{
+    int fails = 0;
+
+    for (int i = 0; i < count; i++)
+        fails += encodeSystemMessage(&out[i], &in[i]);
+    return fails;
+}
+
+static int encodeBasicIDLinked(ODID_BasicID_encoded *out, ODID_BasicID_data *in, int count)
+{
+    int fails = 0;
+
+    for (int i = 0; i < count; i++)
+        fails += encodeBasicIDMessage(&out[i], &in[i]);
+    return fails;
+}
+
+#define BENCH_SINGLE(name, loop, out, in) do { \
+        int fails_ = 0; \
+        double start_ = bench_now(); \
+        for (int r = 0; r < BENCH_ROUNDS; r++) \
+            fails_ += loop(out, in, BENCH_MESSAGES); \
+        bench_report(name, (size_t) BENCH_ROUNDS * BENCH_MESSAGES, bench_now() - start_); \
+        if (fails_) \
+            printf("  %d messages failed to encode\n", fails_); \
+    } while (0)
+
+// Encoders inlined into the caller from the single header, against the library
+void bench_single(void)
+{
+    ODID_Location_data *loc = calloc(BENCH_MESSAGES, sizeof(*loc));
+    ODID_System_data *sys = calloc(BENCH_MESSAGES, sizeof(*sys));
+    ODID_BasicID_data *basicID = calloc(BENCH_MESSAGES, sizeof(*basicID));
+    ODID_Location_encoded *locEnc = calloc(BENCH_MESSAGES, sizeof(*locEnc));
+    ODID_Location_encoded *locInline = calloc(BENCH_MESSAGES, sizeof(*locInline));
+    ODID_System_encoded *sysEnc = calloc(BENCH_MESSAGES, sizeof(*sysEnc));
+    ODID_BasicID_encoded *basicIDEnc = calloc(BENCH_MESSAGES, sizeof(*basicIDEnc));
+    uint32_t seed = 0x51A6E;
+
+    if (!loc || !sys || !basicID || !locEnc || !locInline || !sysEnc || !basicIDEnc)
+        goto out;
+
+    for (int i = 0; i < BENCH_MESSAGES; i++) {
+        loc[i].Direction = test_randf(&seed, 0, 359);
+        loc[i].SpeedHorizontal = test_randf(&seed, 0, 100);
+        loc[i].SpeedVertical = test_randf(&seed, -20, 20);
+        loc[i].Latitude = test_randf(&seed, -90, 90);
+        loc[i].Longitude = test_randf(&seed, -180, 180);
+        loc[i].AltitudeBaro = test_randf(&seed, 0, 3000);
+        loc[i].AltitudeGeo = test_randf(&seed, 0, 3000);
+        loc[i].Height = test_randf(&seed, 0, 500);
+        loc[i].TimeStamp = test_randf(&seed, 0, 3600);
+        sys[i].OperatorLatitude = test_randf(&seed, -90, 90);
+        sys[i].OperatorLongitude = test_randf(&seed, -180, 180);
+        sys[i].AreaCount = (uint16_t) test_rand(&seed);
+        sys[i].AreaRadius = (uint16_t) (test_rand(&seed) % 2550);
+        sys[i].AreaCeiling = test_randf(&seed, 0, 3000);
+        sys[i].AreaFloor = test_randf(&seed, 0, 3000);
+        basicID[i].UAType = (ODID_uatype_t) (test_rand(&seed) % 16);
+        basicID[i].IDType = (ODID_idtype_t) (test_rand(&seed) % 4);
+        snprintf(basicID[i].UASID, sizeof(basicID[i].UASID), "UAS%08X", test_rand(&seed));
+    }
+
+    // Both builds must produce the same bytes
+    encodeLocationLinked(locEnc, loc, BENCH_MESSAGES);
+    bench_inline_encode_location(locInline, loc, BENCH_MESSAGES);
+    if (memcmp(locEnc, locInline, BENCH_MESSAGES * sizeof(*locEnc)) != 0)
+        printf("Inlined encodeLocationMessage differs from the library\n");
+
+    BENCH_SINGLE("encodeLocationMessage (library)", encodeLocationLinked, locEnc, loc);
+    BENCH_SINGLE("encodeLocationMessage (inlined)", bench_inline_encode_location, locEnc, loc);
+    BENCH_SINGLE("encodeSystemMessage (library)", encodeSystemLinked, sysEnc, sys);
+    BENCH_SINGLE("encodeSystemMessage (inlined)", bench_inline_encode_system, sysEnc, sys);
+    BENCH_SINGLE("encodeBasicIDMessage (library)", encodeBasicIDLinked, basicIDEnc, basicID);
+    BENCH_SINGLE("encodeBasicIDMessage (inlined)", bench_inline_encode_basic_id, basicIDEnc, basicID);
+
+out:
+    free(loc);
+    free(sys);
+    free(basicID);
+    free(locEnc);
+    free(locInline);
+    free(sysEnc);
+    free(basicIDEnc);
+}
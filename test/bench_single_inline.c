@@ -0,0 +1,46 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * The encode loops of bench_single.c, built with a private static inline copy
+ * of the library from the generated opendroneid_single.h
+ */
+
+#define ODID_STATIC
+#include "opendroneid_single.h"
+
+int bench_inline_encode_location(ODID_Location_encoded *out, ODID_Location_data *in, int count)
+{
+    int fails = 0;
+
+    for (int i = 0; i < count; i++)
+        fails += encodeLocationMessage(&out[i], &in[i]);
+    return fails;
+}
+
+int bench_inline_encode_system(ODID_System_encoded *out, ODID_System_data *in, int count)
+{
+    int fails = 0;
+
+    for (int i = 0; i < count; i++)
+        fails += encodeSystemMessage(&out[i], &in[i]);
+    return fails;
+}
+
+int bench_inline_encode_basic_id(ODID_BasicID_encoded *out, ODID_BasicID_data *in, int count)
+{
+    int fails = 0;
+
+    for (int i = 0; i < count; i++)
+        fails += encodeBasicIDMessage(&out[i], &in[i]);
+    return fails;
+}
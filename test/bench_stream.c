@@ -0,0 +1,76 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "bench.h"
+
+#define BENCH_FRAMES 40000
+#define BENCH_ROUNDS 10
+#define BENCH_CHUNK 64
+
+// Serial link mix: single messages, one full pack in every ten frames and a
+// few garbage bytes in front of every eighth frame
+void bench_stream(void)
+{
+    static const uint8_t types[ODID_PACK_MAX_MESSAGES] = { 0, 1, 2, 2, 2, 2, 2, 3, 4, 5 };
+    size_t size = (size_t) BENCH_FRAMES * (sizeof(ODID_MessagePack_encoded) + 4);
+    uint8_t *stream = malloc(size);
+    ODID_Stream_decoder *decoder = malloc(sizeof(*decoder));
+    volatile int sink = 0;
+    uint32_t seed = 0x5713;
+    size_t len = 0;
+    double start, seconds;
+
+    if (!stream || !decoder)
+        goto out;
+
+    for (int i = 0; i < BENCH_FRAMES; i++) {
+        uint32_t garbage = i % 8 ? 0 : 1 + test_rand(&seed) % 4;
+        for (uint32_t j = 0; j < garbage; j++)
+            stream[len++] = (uint8_t) test_rand(&seed);
+
+        int count = i % 10 ? 1 : ODID_PACK_MAX_MESSAGES;
+        if (count > 1) {
+            stream[len++] = ODID_MESSAGETYPE_PACKED << 4;
+            stream[len++] = ODID_MESSAGE_SIZE;
+            stream[len++] = ODID_PACK_MAX_MESSAGES;
+        }
+        for (int j = 0, page = 0; j < count; j++) {
+            uint8_t type = count > 1 ? types[j] : types[test_rand(&seed) % ODID_PACK_MAX_MESSAGES];
+            for (int k = 1; k < ODID_MESSAGE_SIZE; k++)
+                stream[len + k] = (uint8_t) test_rand(&seed);
+            stream[len] = (uint8_t) (type << 4);
+            if (type == ODID_MESSAGETYPE_AUTH)
+                stream[len + 1] = (stream[len + 1] & 0xF0) | (count > 1 ? page++ : 0);
+            len += ODID_MESSAGE_SIZE;
+        }
+    }
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        odid_stream_init(decoder, NULL, NULL);
+        for (size_t pos = 0; pos < len; pos += BENCH_CHUNK)
+            sink += odid_stream_push(decoder, &stream[pos], len - pos < BENCH_CHUNK ? len - pos : BENCH_CHUNK);
+        sink += odid_stream_flush(decoder);
+    }
+    seconds = bench_now() - start;
+    bench_report("odid_stream_push (frames)", (size_t) BENCH_ROUNDS * BENCH_FRAMES, seconds);
+    printf("%-40s %12.1f MB/s\n", "odid_stream_push (input)",
+           (double) BENCH_ROUNDS * len / seconds / 1e6);
+
+out:
+    free(stream);
+    free(decoder);
+}
@@ -0,0 +1,308 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Benchmark of every encode and decode function of the public API, with
+ * inputs from the simulator in opendroneid_sim.c, varied by a seeded PRNG so
+ * that every run measures the same data. Each function is run for a number of
+ * warm-up batches and then timed per batch. The per operation times of the
+ * batches give the median and the percentiles. The results can also be
+ * written as JSON, to compare library versions.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "bench.h"
+
+#define BENCH_POOL 256      // Inputs per function, a power of two
+#define BENCH_BATCH 1024    // Operations per timed batch
+#define BENCH_WARMUP 16     // Untimed batches before the timed ones
+#define BENCH_NAN_FRAME_SIZE 512
+
+#ifdef ODID_BYTE_CODEC
+#define CODEC_NAME "byte"
+#else
+#define CODEC_NAME "struct"
+#endif
+
+// Simulator, in opendroneid_sim.c
+void ODID_getSimData(uint8_t *message, uint8_t msgType);
+extern ODID_BasicID_data basicID_data;
+extern ODID_Location_data location_data;
+extern ODID_Auth_data auth_data;
+extern ODID_SelfID_data selfID_data;
+extern ODID_System_data system_data;
+extern ODID_OperatorID_data operatorID_data;
+
+static ODID_BasicID_data basicIDs[BENCH_POOL];
+static ODID_Location_data locations[BENCH_POOL];
+static ODID_Auth_data auths[BENCH_POOL];
+static ODID_SelfID_data selfIDs[BENCH_POOL];
+static ODID_System_data systems[BENCH_POOL];
+static ODID_OperatorID_data operatorIDs[BENCH_POOL];
+static ODID_UAS_Data uasData[BENCH_POOL];
+
+static ODID_BasicID_encoded basicIDsEnc[BENCH_POOL];
+static ODID_Location_encoded locationsEnc[BENCH_POOL];
+static ODID_Auth_encoded authsEnc[BENCH_POOL];
+static ODID_SelfID_encoded selfIDsEnc[BENCH_POOL];
+static ODID_System_encoded systemsEnc[BENCH_POOL];
+static ODID_OperatorID_encoded operatorIDsEnc[BENCH_POOL];
+static ODID_MessagePack_data packsData[BENCH_POOL];
+static ODID_MessagePack_encoded packsEnc[BENCH_POOL];
+static uint8_t *mixedEnc[BENCH_POOL];
+static uint8_t nanFrames[BENCH_POOL][BENCH_NAN_FRAME_SIZE];
+static size_t nanFrameSizes[BENCH_POOL];
+
+// Outputs, separate from the inputs so that these stay the same
+static union {
+    ODID_BasicID_encoded basicID;
+    ODID_Location_encoded location;
+    ODID_Auth_encoded auth;
+    ODID_SelfID_encoded selfID;
+    ODID_System_encoded system;
+    ODID_OperatorID_encoded operatorID;
+    ODID_MessagePack_encoded pack;
+    uint8_t nanFrame[BENCH_NAN_FRAME_SIZE];
+} encodedOut[BENCH_POOL];
+static ODID_UAS_Data decodedOut[BENCH_POOL];
+
+static char mac[6] = { 0x02, 0x00, 0x00, 0x0D, 0x1D, 0x00 };
+
+static void setupInputs(void)
+{
+    uint32_t seed = 0x0D1DBE;
+    uint8_t msg[ODID_MESSAGE_SIZE];
+
+    for (int i = 0; i < BENCH_POOL; i++) {
+        for (uint8_t type = 0; type <= ODID_MESSAGETYPE_OPERATOR_ID; type++)
+            ODID_getSimData(msg, type);
+
+        basicIDs[i] = basicID_data;
+        for (int j = ODID_ID_SIZE - 4; j < ODID_ID_SIZE; j++)
+            basicIDs[i].UASID[j] = (char) ('0' + test_rand(&seed) % 10);
+
+        locations[i] = location_data;
+        locations[i].SpeedVertical = test_randf(&seed, -10, 10);
+        locations[i].AltitudeBaro = test_randf(&seed, 50, 150);
+        locations[i].AltitudeGeo = locations[i].AltitudeBaro + test_randf(&seed, -5, 5);
+        locations[i].Height = test_randf(&seed, 0, 100);
+        locations[i].TimeStamp = test_randf(&seed, 0, 3600);
+
+        auths[i] = auth_data;
+        auths[i].Timestamp += test_rand(&seed) % 100000;
+
+        selfIDs[i] = selfID_data;
+
+        systems[i] = system_data;
+        systems[i].AreaCount = (uint16_t) (1 + test_rand(&seed) % 100);
+        systems[i].AreaRadius = (uint16_t) (test_rand(&seed) % 2000);
+
+        operatorIDs[i] = operatorID_data;
+
+        encodeBasicIDMessage(&basicIDsEnc[i], &basicIDs[i]);
+        encodeLocationMessage(&locationsEnc[i], &locations[i]);
+        encodeAuthMessage(&authsEnc[i], &auths[i]);
+        encodeSelfIDMessage(&selfIDsEnc[i], &selfIDs[i]);
+        encodeSystemMessage(&systemsEnc[i], &systems[i]);
+        encodeOperatorIDMessage(&operatorIDsEnc[i], &operatorIDs[i]);
+
+        uint8_t *encoded[] = { (uint8_t *) &basicIDsEnc[i], (uint8_t *) &locationsEnc[i],
+                               (uint8_t *) &authsEnc[i], (uint8_t *) &selfIDsEnc[i],
+                               (uint8_t *) &systemsEnc[i], (uint8_t *) &operatorIDsEnc[i] };
+        packsData[i].SingleMessageSize = ODID_MESSAGE_SIZE;
+        packsData[i].MsgPackSize = sizeof(encoded) / sizeof(encoded[0]);
+        for (int j = 0; j < packsData[i].MsgPackSize; j++)
+            memcpy(packsData[i].Messages[j].rawData, encoded[j], ODID_MESSAGE_SIZE);
+        encodeMessagePack(&packsEnc[i], &packsData[i]);
+        mixedEnc[i] = encoded[test_rand(&seed) % packsData[i].MsgPackSize];
+
+        memset(&uasData[i], 0, sizeof(uasData[i]));
+        uasData[i].BasicID = basicIDs[i];
+        uasData[i].Location = locations[i];
+        uasData[i].Auth[0] = auths[i];
+        uasData[i].SelfID = selfIDs[i];
+        uasData[i].System = systems[i];
+        uasData[i].OperatorID = operatorIDs[i];
+        uasData[i].BasicIDValid = uasData[i].LocationValid = uasData[i].AuthValid[0] = 1;
+        uasData[i].SelfIDValid = uasData[i].SystemValid = uasData[i].OperatorIDValid = 1;
+
+        int len = odid_wifi_build_message_pack_nan_action_frame(&uasData[i], mac, (uint8_t) i,
+                                                                nanFrames[i], sizeof(nanFrames[i]));
+        nanFrameSizes[i] = len > 0 ? (size_t) len : 0;
+    }
+}
+
+static int opEncodeBasicID(int i) { return encodeBasicIDMessage(&encodedOut[i].basicID, &basicIDs[i]); }
+static int opEncodeLocation(int i) { return encodeLocationMessage(&encodedOut[i].location, &locations[i]); }
+static int opEncodeAuth(int i) { return encodeAuthMessage(&encodedOut[i].auth, &auths[i]); }
+static int opEncodeSelfID(int i) { return encodeSelfIDMessage(&encodedOut[i].selfID, &selfIDs[i]); }
+static int opEncodeSystem(int i) { return encodeSystemMessage(&encodedOut[i].system, &systems[i]); }
+static int opEncodeOperatorID(int i) { return encodeOperatorIDMessage(&encodedOut[i].operatorID, &operatorIDs[i]); }
+static int opEncodePack(int i) { return encodeMessagePack(&encodedOut[i].pack, &packsData[i]); }
+
+static int opDecodeBasicID(int i) { return decodeBasicIDMessage(&decodedOut[i].BasicID, &basicIDsEnc[i]); }
+static int opDecodeLocation(int i) { return decodeLocationMessage(&decodedOut[i].Location, &locationsEnc[i]); }
+static int opDecodeAuth(int i) { return decodeAuthMessage(&decodedOut[i].Auth[0], &authsEnc[i]); }
+static int opDecodeSelfID(int i) { return decodeSelfIDMessage(&decodedOut[i].SelfID, &selfIDsEnc[i]); }
+static int opDecodeSystem(int i) { return decodeSystemMessage(&decodedOut[i].System, &systemsEnc[i]); }
+static int opDecodeOperatorID(int i) { return decodeOperatorIDMessage(&decodedOut[i].OperatorID, &operatorIDsEnc[i]); }
+static int opDecodePack(int i) { return decodeMessagePack(&decodedOut[i], &packsEnc[i]); }
+static int opDecodeOpenDroneID(int i) { return decodeOpenDroneID(&decodedOut[i], mixedEnc[i]) == ODID_MESSAGETYPE_INVALID; }
+
+static int opBuildNan(int i)
+{
+    return odid_wifi_build_message_pack_nan_action_frame(&uasData[i], mac, (uint8_t) i,
+                                                         encodedOut[i].nanFrame,
+                                                         sizeof(encodedOut[i].nanFrame)) < 0;
+}
+
+static int opReceiveNan(int i)
+{
+    char srcMac[6];
+    return odid_wifi_receive_message_pack_nan_action_frame(&decodedOut[i], srcMac, nanFrames[i],
+                                                           nanFrameSizes[i]);
+}
+
+struct benchCase {
+    const char *name;
+    int (*op)(int i);       // Returns 0 on success
+    int messages;           // Messages handled by one operation
+};
+
+static const struct benchCase benchCases[] = {
+    { "encodeBasicIDMessage", opEncodeBasicID, 1 },
+    { "encodeLocationMessage", opEncodeLocation, 1 },
+    { "encodeAuthMessage", opEncodeAuth, 1 },
+    { "encodeSelfIDMessage", opEncodeSelfID, 1 },
+    { "encodeSystemMessage", opEncodeSystem, 1 },
+    { "encodeOperatorIDMessage", opEncodeOperatorID, 1 },
+    { "encodeMessagePack", opEncodePack, 6 },
+    { "decodeBasicIDMessage", opDecodeBasicID, 1 },
+    { "decodeLocationMessage", opDecodeLocation, 1 },
+    { "decodeAuthMessage", opDecodeAuth, 1 },
+    { "decodeSelfIDMessage", opDecodeSelfID, 1 },
+    { "decodeSystemMessage", opDecodeSystem, 1 },
+    { "decodeOperatorIDMessage", opDecodeOperatorID, 1 },
+    { "decodeMessagePack", opDecodePack, 6 },
+    { "decodeOpenDroneID", opDecodeOpenDroneID, 1 },
+    { "odid_wifi_build_message_pack_nan_action_frame", opBuildNan, 6 },
+    { "odid_wifi_receive_message_pack_nan_action_frame", opReceiveNan, 6 },
+};
+
+#define BENCH_CASES (sizeof(benchCases) / sizeof(benchCases[0]))
+
+struct benchResult {
+    double min, p50, p90, p99; // ns per operation
+};
+
+static int compareDouble(const void *a, const void *b)
+{
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+// Nearest rank percentile of sorted samples
+static double percentile(const double *sorted, int count, int percent)
+{
+    int rank = (percent * count + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static void runCase(const struct benchCase *c, struct benchResult *result,
+                    double *samples, int repeats)
+{
+    volatile int sink = 0;
+
+    for (int w = 0; w < BENCH_WARMUP; w++)
+        for (int i = 0; i < BENCH_BATCH; i++)
+            sink += c->op(i & (BENCH_POOL - 1));
+
+    for (int r = 0; r < repeats; r++) {
+        double start = bench_now();
+        for (int i = 0; i < BENCH_BATCH; i++)
+            sink += c->op(i & (BENCH_POOL - 1));
+        samples[r] = (bench_now() - start) * 1e9 / BENCH_BATCH;
+    }
+
+    qsort(samples, (size_t) repeats, sizeof(*samples), compareDouble);
+    result->min = samples[0];
+    result->p50 = percentile(samples, repeats, 50);
+    result->p90 = percentile(samples, repeats, 90);
+    result->p99 = percentile(samples, repeats, 99);
+}
+
+static int writeJson(const char *path, const struct benchResult *results, int repeats)
+{
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        perror(path);
+        return -1;
+    }
+
+    fprintf(f, "{\n  \"codec\": \"%s\",\n  \"repeats\": %d,\n  \"batch\": %d,\n  \"results\": [\n",
+            CODEC_NAME, repeats, BENCH_BATCH);
+    for (size_t c = 0; c < BENCH_CASES; c++) {
+        const struct benchResult *r = &results[c];
+        fprintf(f, "    { \"name\": \"%s\", \"messages_per_op\": %d, \"ns_per_op\": %.2f, "
+                "\"messages_per_s\": %.0f, \"min_ns\": %.2f, \"p50_ns\": %.2f, "
+                "\"p90_ns\": %.2f, \"p99_ns\": %.2f }%s\n",
+                benchCases[c].name, benchCases[c].messages, r->p50,
+                benchCases[c].messages * 1e9 / r->p50, r->min, r->p50, r->p90, r->p99,
+                c + 1 < BENCH_CASES ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+/**
+* Benchmark all encode and decode functions
+*
+* @param repeats    Number of timed batches per function
+* @param jsonPath   File to write the results to as JSON, or NULL
+* @return           0 on success, -1 if a function fails on the inputs or the
+*                   JSON file could not be written
+*/
+int bench_suite(int repeats, const char *jsonPath)
+{
+    struct benchResult results[BENCH_CASES];
+    double *samples = malloc((size_t) repeats * sizeof(*samples));
+
+    if (!samples)
+        return -1;
+
+    setupInputs();
+    // Timing the error paths would give meaningless results
+    for (size_t c = 0; c < BENCH_CASES; c++) {
+        for (int i = 0; i < BENCH_POOL; i++) {
+            if (benchCases[c].op(i) != 0) {
+                fprintf(stderr, "%s fails on input %d\n", benchCases[c].name, i);
+                free(samples);
+                return -1;
+            }
+        }
+    }
+    printf("%-48s %10s %12s %10s %10s (%s codec)\n",
+           "Function", "ns/op", "msg/s", "p90 ns", "p99 ns", CODEC_NAME);
+    for (size_t c = 0; c < BENCH_CASES; c++) {
+        runCase(&benchCases[c], &results[c], samples, repeats);
+        printf("%-48s %10.1f %12.0f %10.1f %10.1f\n", benchCases[c].name, results[c].p50,
+               benchCases[c].messages * 1e9 / results[c].p50, results[c].p90, results[c].p99);
+    }
+    free(samples);
+
+    if (jsonPath)
+        return writeJson(jsonPath, results, repeats);
+    return 0;
+}
@@ -0,0 +1,65 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "bench.h"
+
+#define BENCH_PACKS 1024
+#define BENCH_ROUNDS 200
+
+// Receiver mix: half of the packs are valid, the rest have one bad message
+void bench_validate(void)
+{
+    ODID_MessagePack_encoded *packs = calloc(BENCH_PACKS, sizeof(*packs));
+    ODID_UAS_Data *uas = malloc(sizeof(*uas));
+    volatile uint32_t sink = 0;
+    uint32_t seed = 0x7A11D;
+    double start;
+
+    if (!packs || !uas)
+        goto out;
+
+    for (int i = 0; i < BENCH_PACKS; i++) {
+        static const uint8_t types[] = { 0, 1, 2, 3, 4, 5 };
+        packs[i].MessageType = ODID_MESSAGETYPE_PACKED;
+        packs[i].ProtoVersion = ODID_PROTOCOL_VERSION;
+        packs[i].SingleMessageSize = ODID_MESSAGE_SIZE;
+        packs[i].MsgPackSize = sizeof(types);
+        for (int j = 0; j < (int) sizeof(types); j++) {
+            for (int k = 1; k < ODID_MESSAGE_SIZE; k++)
+                packs[i].Messages[j].rawData[k] = (uint8_t) test_rand(&seed);
+            packs[i].Messages[j].rawData[0] = (uint8_t) (types[j] << 4);
+        }
+        packs[i].Messages[2].rawData[1] &= 0xF0;
+        if (i & 1)
+            packs[i].Messages[test_rand(&seed) % sizeof(types)].rawData[0] = 0x70;
+    }
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_PACKS; i++)
+            sink += decodeMessagePack(uas, &packs[i]);
+    bench_report("decodeMessagePack", (size_t) BENCH_ROUNDS * BENCH_PACKS, bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+        for (int i = 0; i < BENCH_PACKS; i++)
+            sink += odid_validate_pack((const uint8_t *) &packs[i], sizeof(packs[i]));
+    bench_report("odid_validate_pack", (size_t) BENCH_ROUNDS * BENCH_PACKS, bench_now() - start);
+
+out:
+    free(packs);
+    free(uas);
+}
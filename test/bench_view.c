@@ -0,0 +1,63 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "bench.h"
+
+#define BENCH_MESSAGES 4096
+#define BENCH_ROUNDS 200
+
+// Filter-and-forward: only latitude, longitude and geodetic altitude are used
+void bench_view(void)
+{
+    ODID_Location_encoded *msgs = calloc(BENCH_MESSAGES, sizeof(*msgs));
+    ODID_Location_data loc;
+    uint32_t seed = 0x71E3;
+    volatile double sink = 0;
+    double start;
+
+    if (!msgs)
+        return;
+
+    memset(&loc, 0, sizeof(loc));
+    for (int i = 0; i < BENCH_MESSAGES; i++) {
+        loc.Latitude = test_randf(&seed, -90, 90);
+        loc.Longitude = test_randf(&seed, -180, 180);
+        loc.AltitudeGeo = test_randf(&seed, 0, 3000);
+        encodeLocationMessage(&msgs[i], &loc);
+    }
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_MESSAGES; i++) {
+            decodeLocationMessage(&loc, &msgs[i]);
+            sink += loc.Latitude + loc.Longitude + loc.AltitudeGeo;
+        }
+    }
+    bench_report("decodeLocationMessage (lat/lon/alt)", (size_t) BENCH_ROUNDS * BENCH_MESSAGES,
+                 bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_MESSAGES; i++) {
+            const uint8_t *msg = (const uint8_t *) &msgs[i];
+            sink += odid_loc_view_lat(msg) + odid_loc_view_lon(msg) + odid_loc_view_alt_geo(msg);
+        }
+    }
+    bench_report("odid_loc_view_* (lat/lon/alt)", (size_t) BENCH_ROUNDS * BENCH_MESSAGES,
+                 bench_now() - start);
+
+    free(msgs);
+}
@@ -0,0 +1,218 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "bench.h"
+
+#define BENCH_TICKS 4096
+#define BENCH_ROUNDS 200
+
+// Frames in 2 kB slots like a packet ring, more than the caches hold
+#define BENCH_RING_FRAMES 8192
+#define BENCH_RING_SLOT 2048
+#define BENCH_BATCH 256
+#define BENCH_RING_ROUNDS 20
+
+// A sender tick: the location follows the GPS, the other messages stay the same.
+// Then the receive side of the same frame
+void bench_nan_frame(void)
+{
+    char mac[6] = { 0x02, 0x00, 0x00, 0x0D, 0x1D, 0x00 };
+    ODID_Location_data *locations = malloc(BENCH_TICKS * sizeof(*locations));
+    struct odid_nan_frame frame;
+    ODID_UAS_Data uas;
+    uint8_t buf[1024];
+    volatile int sink = 0;
+    uint32_t seed = 0x4A4F;
+    double start;
+
+    if (!locations)
+        return;
+
+    memset(&uas, 0, sizeof(uas));
+    uas.BasicID.UAType = ODID_UATYPE_ROTORCRAFT;
+    uas.BasicID.IDType = ODID_IDTYPE_SERIAL_NUMBER;
+    strcpy(uas.BasicID.UASID, "112624150A90E3AE1EC0");
+    uas.Auth[0].AuthType = ODID_AUTH_UAS_ID_SIGNATURE;
+    strcpy(uas.Auth[0].AuthData, "12345678901234567");
+    uas.SelfID.DescType = ODID_DESC_TYPE_TEXT;
+    strcpy(uas.SelfID.Desc, "DronesRUS: Real Estate");
+    uas.System.OperatorLatitude = 51.4791;
+    uas.System.OperatorLongitude = -0.0013;
+    uas.System.AreaCount = 1;
+    uas.System.AreaRadius = 0;
+    uas.BasicIDValid = uas.LocationValid = uas.AuthValid[0] = 1;
+    uas.SelfIDValid = uas.SystemValid = 1;
+    for (int i = 0; i < BENCH_TICKS; i++) {
+        memset(&locations[i], 0, sizeof(locations[i]));
+        locations[i].Status = ODID_STATUS_AIRBORNE;
+        locations[i].Direction = test_randf(&seed, 0, 359);
+        locations[i].SpeedHorizontal = test_randf(&seed, 0, 50);
+        locations[i].SpeedVertical = test_randf(&seed, -10, 10);
+        locations[i].Latitude = 51.4791 + test_randf(&seed, -0.01f, 0.01f);
+        locations[i].Longitude = -0.0013 + test_randf(&seed, -0.01f, 0.01f);
+        locations[i].AltitudeGeo = test_randf(&seed, 0, 500);
+        locations[i].TimeStamp = test_randf(&seed, 0, 3600);
+    }
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_TICKS; i++) {
+            uas.Location = locations[i];
+            sink += odid_wifi_build_message_pack_nan_action_frame(&uas, mac, (uint8_t) i,
+                                                                  buf, sizeof(buf));
+        }
+    }
+    bench_report("NAN frame build", (size_t) BENCH_ROUNDS * BENCH_TICKS, bench_now() - start);
+
+    odid_wifi_prepare_message_pack_nan_action_frame(&frame, mac);
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_TICKS; i++) {
+            uas.Location = locations[i];
+            sink += odid_wifi_update_message_pack_nan_action_frame(&frame, &uas, (uint8_t) i, ~0u);
+        }
+    }
+    bench_report("NAN frame update (all messages)", (size_t) BENCH_ROUNDS * BENCH_TICKS, bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int i = 0; i < BENCH_TICKS; i++) {
+            uas.Location = locations[i];
+            sink += odid_wifi_update_message_pack_nan_action_frame(&frame, &uas, (uint8_t) i,
+                                                                   ODID_TYPE_BIT(ODID_MESSAGETYPE_LOCATION));
+        }
+    }
+    bench_report("NAN frame update (Location)", (size_t) BENCH_ROUNDS * BENCH_TICKS, bench_now() - start);
+
+    // Receivers: the frame of each tick, decoded or only parsed for filtering
+    int len = odid_wifi_build_message_pack_nan_action_frame(&uas, mac, 0, buf, sizeof(buf));
+    struct odid_nan_frame_view view;
+    ODID_UAS_Data received;
+    char source[6];
+
+    memset(&received, 0, sizeof(received));
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS * BENCH_TICKS; r++)
+        sink += odid_wifi_receive_message_pack_nan_action_frame(&received, source, buf, (size_t) len);
+    bench_report("NAN frame receive", (size_t) BENCH_ROUNDS * BENCH_TICKS, bench_now() - start);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_ROUNDS * BENCH_TICKS; r++) {
+        sink += odid_wifi_parse_message_pack_nan_action_frame(&view, buf, (size_t) len);
+        sink += view.message_counter;
+    }
+    bench_report("NAN frame parse", (size_t) BENCH_ROUNDS * BENCH_TICKS, bench_now() - start);
+
+    free(locations);
+}
+
+// Fill the ring with ODID frames and, for the rest, beacons, probe responses,
+// data frames and other public action frames, in random order
+static void fillRing(uint8_t *ring, struct odid_wifi_frame *frames, int odidPercent, uint32_t *seed)
+{
+    static const uint16_t others[] = { 0x0080, 0x0050, 0x0008, 0x00D0 };
+    char mac[6] = { 0x02, 0x00, 0x00, 0x0D, 0x1D, 0x00 };
+    ODID_UAS_Data uas;
+
+    memset(&uas, 0, sizeof(uas));
+    uas.BasicIDValid = uas.LocationValid = uas.SystemValid = 1;
+    uas.BasicID.UAType = ODID_UATYPE_ROTORCRAFT;
+    uas.BasicID.IDType = ODID_IDTYPE_SERIAL_NUMBER;
+    uas.Location.Status = ODID_STATUS_AIRBORNE;
+    uas.System.AreaCount = 1;
+
+    for (int i = 0; i < BENCH_RING_FRAMES; i++) {
+        uint8_t *buf = ring + (size_t) i * BENCH_RING_SLOT;
+        int len;
+
+        if ((int) (test_rand(seed) % 100) < odidPercent) {
+            mac[5] = (char) test_rand(seed);
+            snprintf(uas.BasicID.UASID, sizeof(uas.BasicID.UASID), "SN%08X", test_rand(seed));
+            uas.Location.Latitude = test_randf(seed, -90, 90);
+            uas.Location.Longitude = test_randf(seed, -180, 180);
+            uas.Location.AltitudeGeo = test_randf(seed, 0, 500);
+            uas.Location.TimeStamp = test_randf(seed, 0, 3600);
+            len = odid_wifi_build_message_pack_nan_action_frame(&uas, mac, (uint8_t) i, buf, BENCH_RING_SLOT);
+        } else {
+            uint16_t fc = others[test_rand(seed) % 4];
+            len = 60 + (int) (test_rand(seed) % 300);
+            for (int j = 0; j < len; j++)
+                buf[j] = (uint8_t) test_rand(seed);
+            buf[0] = (uint8_t) fc;
+            buf[1] = 0;
+            // Public action frames from other vendors and services
+            if (fc == 0x00D0) {
+                buf[24] = 0x04;
+                buf[25] = 0x09;
+            }
+        }
+        frames[i].buf = buf;
+        frames[i].len = (size_t) len;
+        frames[i].timestamp = (uint64_t) i;
+        frames[i].rssi = -60;
+    }
+}
+
+// Frames per second of the single frame receive function and of batches
+void bench_nan_batch(void)
+{
+    static const int mixes[] = { 5, 50, 100 };
+    uint8_t *ring = malloc((size_t) BENCH_RING_FRAMES * BENCH_RING_SLOT);
+    struct odid_wifi_frame *frames = malloc(BENCH_RING_FRAMES * sizeof(*frames));
+    ODID_UAS_Data *uas = malloc(BENCH_BATCH * sizeof(*uas));
+    int status[BENCH_BATCH];
+    uint8_t macs[BENCH_BATCH][6];
+    uint8_t counters[BENCH_BATCH];
+    struct odid_wifi_batch out = { status, macs, counters, NULL, NULL, uas };
+    volatile int sink = 0;
+    uint32_t seed = 0xBA7C;
+    char name[64];
+    double start;
+
+    if (!ring || !frames || !uas)
+        goto out;
+
+    for (size_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); m++) {
+        fillRing(ring, frames, mixes[m], &seed);
+
+        start = bench_now();
+        for (int r = 0; r < BENCH_RING_ROUNDS; r++) {
+            for (int i = 0; i < BENCH_RING_FRAMES; i++) {
+                int index = i % BENCH_BATCH;
+                char mac[6];
+
+                memset(&uas[index], 0, sizeof(uas[index]));
+                sink += odid_wifi_receive_message_pack_nan_action_frame(&uas[index], mac,
+                                                                        (uint8_t *) frames[i].buf,
+                                                                        frames[i].len);
+            }
+        }
+        snprintf(name, sizeof(name), "NAN receive, %d%% ODID frames", mixes[m]);
+        bench_report(name, (size_t) BENCH_RING_ROUNDS * BENCH_RING_FRAMES, bench_now() - start);
+
+        start = bench_now();
+        for (int r = 0; r < BENCH_RING_ROUNDS; r++)
+            for (int i = 0; i < BENCH_RING_FRAMES; i += BENCH_BATCH)
+                sink += odid_wifi_receive_nan_batch(&out, &frames[i], BENCH_BATCH);
+        snprintf(name, sizeof(name), "NAN batch, %d%% ODID frames", mixes[m]);
+        bench_report(name, (size_t) BENCH_RING_ROUNDS * BENCH_RING_FRAMES, bench_now() - start);
+    }
+
+out:
+    free(ring);
+    free(frames);
+    free(uas);
+}
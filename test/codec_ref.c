@@ -0,0 +1,478 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Reference copies of the original codec functions that the library has
+ * replaced with table based versions: the if/else based accuracy conversions
+ * the arithmetic Location decoder and the two pass message pack decoder. They
+ * are kept to check that both give the same results and to compare their speed.
+ * The snprintf based JSON export is only kept for its speed, as its output is
+ * not valid JSON.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "codec_ref.h"
+
+/**
+* This converts a horizontal accuracy float value to the corresponding enum
+*
+* @param Accuracy The horizontal accuracy in meters
+* @return Enum value representing the accuracy
+*/
+ODID_Horizontal_accuracy_t ref_createEnumHorizontalAccuracy(float Accuracy)
+{
+    if (Accuracy >= 18520)
+        return ODID_HOR_ACC_UNKNOWN;
+    else if (Accuracy > 7408)
+        return ODID_HOR_ACC_10NM;
+    else if (Accuracy > 3704)
+        return ODID_HOR_ACC_4NM;
+    else if (Accuracy > 1852)
+        return ODID_HOR_ACC_2NM;
+    else if (Accuracy > 926)
+        return ODID_HOR_ACC_1NM;
+    else if (Accuracy > 555.6f)
+        return ODID_HOR_ACC_0_5NM;
+    else if (Accuracy > 185.2f)
+        return ODID_HOR_ACC_0_3NM;
+    else if (Accuracy > 92.6f)
+        return ODID_HOR_ACC_0_1NM;
+    else if (Accuracy > 30)
+        return ODID_HOR_ACC_0_05NM;
+    else if (Accuracy > 10)
+        return ODID_HOR_ACC_30_METER;
+    else if (Accuracy > 3)
+        return ODID_HOR_ACC_10_METER;
+    else if (Accuracy > 1)
+        return ODID_HOR_ACC_3_METER;
+    else if (Accuracy > 0)
+        return ODID_HOR_ACC_1_METER;
+    else
+        return ODID_HOR_ACC_UNKNOWN;
+}
+
+/**
+* This converts a vertical accuracy float value to the corresponding enum
+*
+* @param Accuracy The vertical accuracy in meters
+* @return Enum value representing the accuracy
+*/
+ODID_Vertical_accuracy_t ref_createEnumVerticalAccuracy(float Accuracy)
+{
+    if (Accuracy >= 150)
+        return ODID_VER_ACC_UNKNOWN;
+    else if (Accuracy > 45)
+        return ODID_VER_ACC_150_METER;
+    else if (Accuracy > 25)
+        return ODID_VER_ACC_45_METER;
+    else if (Accuracy > 10)
+        return ODID_VER_ACC_25_METER;
+    else if (Accuracy > 3)
+        return ODID_VER_ACC_10_METER;
+    else if (Accuracy > 1)
+        return ODID_VER_ACC_3_METER;
+    else if (Accuracy > 0)
+        return ODID_VER_ACC_1_METER;
+    else
+        return ODID_VER_ACC_UNKNOWN;
+}
+
+/**
+* This converts a speed accuracy float value to the corresponding enum
+*
+* @param Accuracy The speed accuracy in m/s
+* @return Enum value representing the accuracy
+*/
+ODID_Speed_accuracy_t ref_createEnumSpeedAccuracy(float Accuracy)
+{
+    if (Accuracy >= 10)
+        return ODID_SPEED_ACC_UNKNOWN;
+    else if (Accuracy > 3)
+        return ODID_SPEED_ACC_10_METERS_PER_SECOND;
+    else if (Accuracy > 1)
+        return ODID_SPEED_ACC_3_METERS_PER_SECOND;
+    else if (Accuracy > 0.3f)
+        return ODID_SPEED_ACC_1_METERS_PER_SECOND;
+    else if (Accuracy > 0)
+        return ODID_SPEED_ACC_0_3_METERS_PER_SECOND;
+    else
+        return ODID_SPEED_ACC_UNKNOWN;
+}
+
+/**
+* This converts a timestamp accuracy float value to the corresponding enum
+*
+* @param Accuracy The timestamp accuracy in seconds
+* @return Enum value representing the accuracy
+*/
+ODID_Timestamp_accuracy_t ref_createEnumTimestampAccuracy(float Accuracy)
+{
+    if (Accuracy > 1.5f)
+        return ODID_TIME_ACC_UNKNOWN;
+    else if (Accuracy > 1.4f)
+        return ODID_TIME_ACC_1_5_SECOND;
+    else if (Accuracy > 1.3f)
+        return ODID_TIME_ACC_1_4_SECOND;
+    else if (Accuracy > 1.2f)
+        return ODID_TIME_ACC_1_3_SECOND;
+    else if (Accuracy > 1.1f)
+        return ODID_TIME_ACC_1_2_SECOND;
+    else if (Accuracy > 1.0f)
+        return ODID_TIME_ACC_1_1_SECOND;
+    else if (Accuracy > 0.9f)
+        return ODID_TIME_ACC_1_0_SECOND;
+    else if (Accuracy > 0.8f)
+        return ODID_TIME_ACC_0_9_SECOND;
+    else if (Accuracy > 0.7f)
+        return ODID_TIME_ACC_0_8_SECOND;
+    else if (Accuracy > 0.6f)
+        return ODID_TIME_ACC_0_7_SECOND;
+    else if (Accuracy > 0.5f)
+        return ODID_TIME_ACC_0_6_SECOND;
+    else if (Accuracy > 0.4f)
+        return ODID_TIME_ACC_0_5_SECOND;
+    else if (Accuracy > 0.3f)
+        return ODID_TIME_ACC_0_4_SECOND;
+    else if (Accuracy > 0.2f)
+        return ODID_TIME_ACC_0_3_SECOND;
+    else if (Accuracy > 0.1f)
+        return ODID_TIME_ACC_0_2_SECOND;
+    else if (Accuracy > 0.0f)
+        return ODID_TIME_ACC_0_1_SECOND;
+    else
+        return ODID_TIME_ACC_UNKNOWN;
+}
+
+/**
+* This decodes a horizontal accuracy enum to the corresponding float value
+*
+* @param Accuracy Enum value representing the accuracy
+* @return The maximum horizontal accuracy in meters
+*/
+float ref_decodeHorizontalAccuracy(ODID_Horizontal_accuracy_t Accuracy)
+{
+    switch (Accuracy)
+    {
+    case ODID_HOR_ACC_UNKNOWN:
+        return 18520;
+    case ODID_HOR_ACC_10NM:
+        return 18520;
+    case ODID_HOR_ACC_4NM:
+        return 7808;
+    case ODID_HOR_ACC_2NM:
+        return 3704;
+    case ODID_HOR_ACC_1NM:
+        return 1852;
+    case ODID_HOR_ACC_0_5NM:
+        return 926;
+    case ODID_HOR_ACC_0_3NM:
+        return 555.6f;
+    case ODID_HOR_ACC_0_1NM:
+        return 185.2f;
+    case ODID_HOR_ACC_0_05NM:
+        return 92.6f;
+    case ODID_HOR_ACC_30_METER:
+        return 30;
+    case ODID_HOR_ACC_10_METER:
+        return 10;
+    case ODID_HOR_ACC_3_METER:
+        return 3;
+    case ODID_HOR_ACC_1_METER:
+        return 1;
+    default:
+        return 18520;
+    }
+}
+
+/**
+* This decodes a vertical accuracy enum to the corresponding float value
+*
+* @param Accuracy Enum value representing the accuracy
+* @return The maximum vertical accuracy in meters
+*/
+float ref_decodeVerticalAccuracy(ODID_Vertical_accuracy_t Accuracy)
+{
+    switch (Accuracy)
+    {
+    case ODID_VER_ACC_UNKNOWN:
+        return 150;
+    case ODID_VER_ACC_150_METER:
+        return 150;
+    case ODID_VER_ACC_45_METER:
+        return 45;
+    case ODID_VER_ACC_25_METER:
+        return 25;
+    case ODID_VER_ACC_10_METER:
+        return 10;
+    case ODID_VER_ACC_3_METER:
+        return 3;
+    case ODID_VER_ACC_1_METER:
+        return 1;
+    default:
+        return 150;
+    }
+}
+
+/**
+* This decodes a speed accuracy enum to the corresponding float value
+*
+* @param Accuracy Enum value representing the accuracy
+* @return The maximum speed accuracy in m/s
+*/
+float ref_decodeSpeedAccuracy(ODID_Speed_accuracy_t Accuracy)
+{
+    switch (Accuracy)
+    {
+    case ODID_SPEED_ACC_UNKNOWN:
+        return 10;
+    case ODID_SPEED_ACC_10_METERS_PER_SECOND:
+        return 10;
+    case ODID_SPEED_ACC_3_METERS_PER_SECOND:
+        return 3;
+    case ODID_SPEED_ACC_1_METERS_PER_SECOND:
+        return 1;
+    case ODID_SPEED_ACC_0_3_METERS_PER_SECOND:
+        return 0.3f;
+    default:
+        return 10;
+    }
+}
+
+/**
+* This decodes a timestamp accuracy enum to the corresponding float value
+*
+* @param Accuracy Enum value representing the accuracy
+* @return The maximum timestamp accuracy in seconds
+*/
+float ref_decodeTimestampAccuracy(ODID_Timestamp_accuracy_t Accuracy)
+{
+    switch (Accuracy)
+    {
+    case ODID_TIME_ACC_UNKNOWN:
+        return 0.0f;
+    case ODID_TIME_ACC_0_1_SECOND:
+        return 0.1f;
+    case ODID_TIME_ACC_0_2_SECOND:
+        return 0.2f;
+    case ODID_TIME_ACC_0_3_SECOND:
+        return 0.3f;
+    case ODID_TIME_ACC_0_4_SECOND:
+        return 0.4f;
+    case ODID_TIME_ACC_0_5_SECOND:
+        return 0.5f;
+    case ODID_TIME_ACC_0_6_SECOND:
+        return 0.6f;
+    case ODID_TIME_ACC_0_7_SECOND:
+        return 0.7f;
+    case ODID_TIME_ACC_0_8_SECOND:
+        return 0.8f;
+    case ODID_TIME_ACC_0_9_SECOND:
+        return 0.9f;
+    case ODID_TIME_ACC_1_0_SECOND:
+        return 1.0f;
+    case ODID_TIME_ACC_1_1_SECOND:
+        return 1.1f;
+    case ODID_TIME_ACC_1_2_SECOND:
+        return 1.2f;
+    case ODID_TIME_ACC_1_3_SECOND:
+        return 1.3f;
+    case ODID_TIME_ACC_1_4_SECOND:
+        return 1.4f;
+    case ODID_TIME_ACC_1_5_SECOND:
+        return 1.5f;
+    default:
+        return 0.0f;
+    }
+}
+
+/**
+* Decode Location data from packed message, computing every field arithmetically
+*
+* @param outData   Output: decoded message
+* @param inEncoded Input message (encoded/packed) structure
+* @return          ODID_SUCCESS or ODID_FAIL;
+*/
+int ref_decodeLocationMessage(ODID_Location_data *outData, ODID_Location_encoded *inEncoded)
+{
+    if (!outData || !inEncoded ||
+        inEncoded->MessageType != ODID_MESSAGETYPE_LOCATION)
+        return ODID_FAIL;
+
+    outData->Status = (ODID_status_t) inEncoded->Status;
+    if (inEncoded->EWDirection)
+        outData->Direction = inEncoded->Direction + 180;
+    else
+        outData->Direction = inEncoded->Direction;
+    if (inEncoded->SpeedMult)
+        outData->SpeedHorizontal = ((float) inEncoded->SpeedHorizontal * 0.75f) + (UINT8_MAX * 0.25f);
+    else
+        outData->SpeedHorizontal = (float) inEncoded->SpeedHorizontal * 0.25f;
+    outData->SpeedVertical = (float) inEncoded->SpeedVertical * 0.5f;
+    outData->Latitude = (double) inEncoded->Latitude / 10000000;
+    outData->Longitude = (double) inEncoded->Longitude / 10000000;
+    outData->AltitudeBaro = (float) ((float) inEncoded->AltitudeBaro * 0.5f - 1000);
+    outData->AltitudeGeo = (float) ((float) inEncoded->AltitudeGeo * 0.5f - 1000);
+    outData->HeightType = (ODID_Height_reference_t) inEncoded->HeightType;
+    outData->Height = (float) ((float) inEncoded->Height * 0.5f - 1000);
+    outData->HorizAccuracy = (ODID_Horizontal_accuracy_t) inEncoded->HorizAccuracy;
+    outData->VertAccuracy = (ODID_Vertical_accuracy_t) inEncoded->VertAccuracy;
+    outData->BaroAccuracy = (ODID_Vertical_accuracy_t) inEncoded->BaroAccuracy;
+    outData->SpeedAccuracy = (ODID_Speed_accuracy_t) inEncoded->SpeedAccuracy;
+    outData->TSAccuracy = (ODID_Timestamp_accuracy_t) inEncoded->TSAccuracy;
+    outData->TimeStamp = (float) inEncoded->TimeStamp / 10;
+    return ODID_SUCCESS;
+}
+
+/**
+* Decode the area radius of a System message arithmetically
+*
+* @param inEncoded Input message (encoded/packed) structure
+* @return          The radius of the drone area/swarm in meters
+*/
+uint16_t ref_decodeAreaRadius(ODID_System_encoded *inEncoded)
+{
+    return (uint16_t) inEncoded->AreaRadius * 10;
+}
+
+/**
+* Check the message types of a pack before decoding it
+*
+* @param msgs   Pointer to the encoded messages of the pack
+* @param amount Number of messages in the pack
+* @return       ODID_SUCCESS or ODID_FAIL;
+*/
+static int ref_checkPackContent(ODID_Messages_encoded *msgs, int amount)
+{
+    if (amount == 0 || amount > ODID_PACK_MAX_MESSAGES)
+        return ODID_FAIL;
+
+    int numMessages[6] = { 0 };
+    for (int i = 0; i < amount; i++) {
+        uint8_t MessageType = decodeMessageType(msgs[i].rawData[0]);
+
+        if (MessageType == ODID_MESSAGETYPE_PACKED ||
+            MessageType == ODID_MESSAGETYPE_INVALID)
+            return ODID_FAIL;
+
+        numMessages[MessageType]++;
+    }
+
+    if (numMessages[0] > 1 || numMessages[1] > 1 || numMessages[2] > 5 ||
+        numMessages[3] > 1 || numMessages[4] > 1 || numMessages[5] > 1)
+        return ODID_FAIL;
+
+    return ODID_SUCCESS;
+}
+
+/**
+* Decode Message Pack by checking the whole pack first and then decoding each
+* message directly into uasData
+*
+* @param uasData Output: Structure containing buffers for all message data
+* @param pack    Pointer to an encoded packed message
+* @return        ODID_SUCCESS or ODID_FAIL;
+*/
+int ref_decodeMessagePack(ODID_UAS_Data *uasData, ODID_MessagePack_encoded *pack)
+{
+    if (!uasData || !pack || pack->MessageType != ODID_MESSAGETYPE_PACKED)
+        return ODID_FAIL;
+
+    if (pack->SingleMessageSize != ODID_MESSAGE_SIZE)
+        return ODID_FAIL;
+
+    if (ref_checkPackContent(pack->Messages, pack->MsgPackSize) != ODID_SUCCESS)
+        return ODID_FAIL;
+
+    for (int i = 0; i < pack->MsgPackSize; i++) {
+        decodeOpenDroneID(uasData, pack->Messages[i].rawData);
+    }
+    return ODID_SUCCESS;
+}
+
+/**
+* Print drone information to a JSON style string with snprintf, growing the
+* buffer with realloc
+*
+* @param UAS_Data   General drone status information
+* @return           Malloc'ed string, NULL on failure
+*/
+char *ref_drone_export_gps_data(ODID_UAS_Data *UAS_Data)
+{
+    int len = 0, total_len = 8192;
+    char *drone_str;
+
+    drone_str = malloc(total_len);
+    if (!drone_str)
+        return NULL;
+
+#define mprintf(...) {\
+    if (total_len - len < 2048) { \
+        total_len *= 2; \
+        drone_str = realloc(drone_str, total_len); \
+        if (!drone_str) \
+            return NULL; \
+    } \
+    len += snprintf(drone_str + len, total_len - len, __VA_ARGS__); \
+    if (len > total_len) { \
+        free(drone_str); \
+        return NULL; \
+    } \
+}
+    mprintf("{\n\t\"Version\": \"0.0\",\n\t\"Response\": {\n");
+
+    mprintf("\t\t\"BasicID\": {\n");
+    mprintf("\t\t\t\"UAType\": %i,\n", UAS_Data->BasicID.UAType);
+    mprintf("\t\t\t\"IDType\": %i,\n", UAS_Data->BasicID.IDType);
+    mprintf("\t\t\t\"UASID\": %s\n", UAS_Data->BasicID.UASID);
+    mprintf("\t\t},\n");
+
+    mprintf("\t\t\"Location\": {\n");
+    mprintf("\t\t\t\"Status\": %d,\n", (int)UAS_Data->Location.Status);
+    mprintf("\t\t\t\"Direction\": %f,\n", UAS_Data->Location.Direction);
+    mprintf("\t\t\t\"SpeedHorizontal\": %f,\n", UAS_Data->Location.SpeedHorizontal);
+    mprintf("\t\t\t\"SpeedVertical\": %f,\n", UAS_Data->Location.SpeedVertical);
+    mprintf("\t\t\t\"Latitude\": %f,\n", UAS_Data->Location.Latitude);
+    mprintf("\t\t\t\"Longitude\": %f,\n", UAS_Data->Location.Longitude);
+    mprintf("\t\t\t\"AltitudeBaro\": %f,\n", UAS_Data->Location.AltitudeBaro);
+    mprintf("\t\t\t\"AltitudeGeo\": %f,\n", UAS_Data->Location.AltitudeGeo);
+    mprintf("\t\t\t\"Height\": %f,\n", UAS_Data->Location.Height);
+    mprintf("\t\t\t\"HorizAccuracy\": %d,\n", UAS_Data->Location.HorizAccuracy);
+    mprintf("\t\t\t\"VertAccuracy\": %d,\n", UAS_Data->Location.VertAccuracy);
+    mprintf("\t\t\t\"SpeedAccuracy\": %d,\n", UAS_Data->Location.SpeedAccuracy);
+    mprintf("\t\t\t\"TSAccuracy\": %d,\n", UAS_Data->Location.TSAccuracy);
+    mprintf("\t\t\t\"TimeStamp\": %f\n", UAS_Data->Location.TimeStamp);
+    mprintf("\t\t},\n");
+
+    mprintf("\t\t\"Authentication\": {\n");
+    mprintf("\t\t\t\"AuthType\": %i,\n", UAS_Data->Auth[0].AuthType);
+    mprintf("\t\t\t\"AuthToken\": %s\n", UAS_Data->Auth[0].AuthData);
+    mprintf("\t\t},\n");
+
+    mprintf("\t\t\"SelfID\": {\n");
+    mprintf("\t\t\t\"Name\": \"string\",\n");
+    mprintf("\t\t\t\"Description\": %s\n", UAS_Data->SelfID.Desc);
+    mprintf("\t\t},\n");
+
+    mprintf("\t\t\"Operator\": {\n");
+    mprintf("\t\t\t\"LocationSource\": %i,\n", UAS_Data->System.LocationSource);
+    mprintf("\t\t\t\"OperatorLatitude\": %f,\n", UAS_Data->System.OperatorLatitude);
+    mprintf("\t\t\t\"OperatorLongitude\": %f,\n", UAS_Data->System.OperatorLongitude);
+    mprintf("\t\t\t\"AreaCount\": %i,\n", UAS_Data->System.AreaCount);
+    mprintf("\t\t\t\"AreaRadius\": %i,\n", UAS_Data->System.AreaRadius);
+    mprintf("\t\t\t\"AreaCeiling\": %f\n", UAS_Data->System.AreaCeiling);
+    mprintf("\t\t}\n");
+
+    mprintf("\t}\n}");
+
+    return drone_str;
+}
@@ -0,0 +1,33 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#ifndef _CODEC_REF_H_
+#define _CODEC_REF_H_
+
+#include <opendroneid.h>
+
+ODID_Horizontal_accuracy_t ref_createEnumHorizontalAccuracy(float Accuracy);
+ODID_Vertical_accuracy_t ref_createEnumVerticalAccuracy(float Accuracy);
+ODID_Speed_accuracy_t ref_createEnumSpeedAccuracy(float Accuracy);
+ODID_Timestamp_accuracy_t ref_createEnumTimestampAccuracy(float Accuracy);
+
+float ref_decodeHorizontalAccuracy(ODID_Horizontal_accuracy_t Accuracy);
+float ref_decodeVerticalAccuracy(ODID_Vertical_accuracy_t Accuracy);
+float ref_decodeSpeedAccuracy(ODID_Speed_accuracy_t Accuracy);
+float ref_decodeTimestampAccuracy(ODID_Timestamp_accuracy_t Accuracy);
+
+int ref_decodeLocationMessage(ODID_Location_data *outData, ODID_Location_encoded *inEncoded);
+uint16_t ref_decodeAreaRadius(ODID_System_encoded *inEncoded);
+int ref_decodeMessagePack(ODID_UAS_Data *uasData, ODID_MessagePack_encoded *pack);
+char *ref_drone_export_gps_data(ODID_UAS_Data *UAS_Data);
+
+#endif // _CODEC_REF_H_
@@ -0,0 +1,168 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+/*
+ * Load test replay of recorded observations:
+ *
+ *   odid_json_replay [-r ROUNDS] FILE...
+ *
+ * Each file holds NDJSON documents as written by odid_json_write() with
+ * ODID_JSON_NEWLINE. The files are memory mapped and every document is parsed
+ * in place and encoded into a NAN action frame with
+ * odid_wifi_build_message_pack_nan_action_frame(). The throughput of parsing
+ * alone and of parsing and building frames is reported.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <opendroneid.h>
+
+struct replayStats {
+    size_t documents;
+    size_t frames;
+    size_t frameBytes;
+    size_t failures;
+    uint8_t counter;
+};
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static int countDocument(void *user, const ODID_UAS_Data *uasData)
+{
+    struct replayStats *stats = user;
+
+    (void) uasData;
+    stats->documents++;
+    return 0;
+}
+
+static int buildFrame(void *user, const ODID_UAS_Data *uasData)
+{
+    struct replayStats *stats = user;
+    char mac[6] = { 0x02, 0x00, 0x00, 0x0D, 0x1D, 0x00 };
+    uint8_t frame[1024];
+    ODID_UAS_Data uas = *uasData;
+
+    int len = odid_wifi_build_message_pack_nan_action_frame(&uas, mac, stats->counter++,
+                                                            frame, sizeof(frame));
+    if (len > 0) {
+        stats->frames++;
+        stats->frameBytes += (size_t) len;
+    } else {
+        stats->failures++;
+    }
+    return 0;
+}
+
+static void report(const char *name, size_t documents, double seconds)
+{
+    printf("%-32s %10zu documents %12.0f docs/s %8.1f ns/doc\n", name, documents,
+           documents / seconds, seconds * 1e9 / documents);
+}
+
+static int replayFile(const char *path, int rounds)
+{
+    struct replayStats parse, build;
+    size_t invalid = 0;
+    struct stat st;
+    const char *data;
+    double start, seconds;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        perror(path);
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    if (st.st_size == 0) {
+        printf("%s: empty\n", path);
+        close(fd);
+        return 0;
+    }
+    data = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror(path);
+        return -1;
+    }
+    madvise((void *) data, (size_t) st.st_size, MADV_SEQUENTIAL);
+
+    memset(&parse, 0, sizeof(parse));
+    memset(&build, 0, sizeof(build));
+
+    start = now();
+    for (int r = 0; r < rounds; r++)
+        odid_json_read_lines(data, (size_t) st.st_size, countDocument, &parse, &invalid);
+    seconds = now() - start;
+    printf("%s: %lld bytes, %zu invalid lines\n", path, (long long) st.st_size, invalid);
+    if (parse.documents == 0) {
+        munmap((void *) data, (size_t) st.st_size);
+        return 0;
+    }
+    report("odid_json_read_lines", parse.documents, seconds);
+
+    start = now();
+    for (int r = 0; r < rounds; r++)
+        odid_json_read_lines(data, (size_t) st.st_size, buildFrame, &build, NULL);
+    seconds = now() - start;
+    report("  + NAN action frame", build.frames + build.failures, seconds);
+    printf("%zu frames, %zu bytes, %zu failed\n", build.frames, build.frameBytes, build.failures);
+
+    munmap((void *) data, (size_t) st.st_size);
+    return build.failures ? -1 : 0;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr, "Usage: %s [-r ROUNDS] FILE...\n"
+            "  -r ROUNDS  replay each file this many times (default 1)\n", name);
+}
+
+int main(int argc, char *argv[])
+{
+    int rounds = 1;
+    int ret = 0;
+    int i;
+
+    for (i = 1; i < argc && argv[i][0] == '-' && argv[i][1] != '\0'; i++) {
+        if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            rounds = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (i == argc || rounds < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    for (; i < argc; i++) {
+        if (replayFile(argv[i], rounds) != 0)
+            ret = 1;
+    }
+    return ret;
+}
@@ -15,6 +15,20 @@ gabriel.c.cox@intel.com
 #include <mav2odid.h>
 
 void test_InOut(void);
+void test_batch(void);
+void test_view(void);
+void test_accuracy(void);
+void test_decode_tables(void);
+void test_codec(void);
+void test_session(void);
+void test_fixed(void);
+void test_validate(void);
+void test_decode_pack(void);
+void test_stream(void);
+void test_auth(void);
+void test_json(void);
+void test_record(void);
+void test_wifi(void);
 void ODID_getSimData(uint8_t *message, uint8_t msgType);
 void test_sim(void);
 void test_mav2odid();
@@ -25,6 +39,46 @@ int main(int argc, char const *argv[]) {
     // encodes them, decodes them, displays result
     test_InOut();
 
+    // Check that the batch encoders match the single message encoders
+    test_batch();
+
+    // Check the zero-copy field views against the decoders
+    test_view();
+
+    // Check the accuracy conversions at and around every boundary
+    test_accuracy();
+    test_decode_tables();
+
+    // Check the wire codec against known message bytes
+    test_codec();
+
+    // Check the incremental encoder session against full encodes
+    test_session();
+
+    // Check the fixed-point codec against the float codec
+    test_fixed();
+
+    // Check the validation functions against the decoders
+    test_validate();
+
+    // Check the single pass pack decoder against the two pass reference
+    test_decode_pack();
+
+    // Decode messages from a byte stream with garbage and random chunks
+    test_stream();
+
+    // Split authentication data into pages and reassemble them
+    test_auth();
+
+    // Check the JSON export against known documents
+    test_json();
+
+    // Round trip decoded data through binary records
+    test_record();
+
+    // Update a prepared NAN action frame in place
+    test_wifi();
+
     // Test the Mavlink to OpenDroneID conversion functionality
     printf("\nPress enter to run the Mavlink to Open Drone ID test");
     getchar();
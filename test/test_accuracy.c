@@ -0,0 +1,119 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <opendroneid.h>
+#include "codec_ref.h"
+
+// Every threshold used by the accuracy conversions
+static const float accuracyBoundaries[] = {
+    0, 0.1f, 0.2f, 0.3f, 0.4f, 0.5f, 0.6f, 0.7f, 0.8f, 0.9f, 1.0f, 1.1f, 1.2f, 1.3f,
+    1.4f, 1.5f, 3, 10, 25, 30, 45, 92.6f, 150, 185.2f, 555.6f, 926, 1852, 3704, 7408,
+    18520 };
+
+static int compareAccuracy(float value)
+{
+    int errors = 0;
+
+    errors += createEnumHorizontalAccuracy(value) != ref_createEnumHorizontalAccuracy(value);
+    errors += createEnumVerticalAccuracy(value) != ref_createEnumVerticalAccuracy(value);
+    errors += createEnumSpeedAccuracy(value) != ref_createEnumSpeedAccuracy(value);
+    errors += createEnumTimestampAccuracy(value) != ref_createEnumTimestampAccuracy(value);
+    if (errors)
+        printf("Accuracy mismatch for %.9g\n", value);
+    return errors;
+}
+
+void test_accuracy()
+{
+    const float special[] = { -0.0f, INFINITY, -INFINITY, NAN, -NAN, 1e-45f, -1e-45f, 3.4e38f };
+    int errors = 0;
+    long tested = 0;
+
+    printf("\n-------------------------------------Accuracy---------------------------------------\n");
+
+    // The boundaries themselves, both signs, and the 8 floats on either side
+    for (int i = 0; i < (int) (sizeof(accuracyBoundaries) / sizeof(accuracyBoundaries[0])); i++) {
+        for (int sign = -1; sign <= 1; sign += 2) {
+            float up = sign * accuracyBoundaries[i];
+            float down = up;
+            for (int step = 0; step <= 8; step++) {
+                errors += compareAccuracy(up) + compareAccuracy(down);
+                up = nextafterf(up, INFINITY);
+                down = nextafterf(down, -INFINITY);
+                tested += 2;
+            }
+        }
+    }
+
+    for (int i = 0; i < (int) (sizeof(special) / sizeof(special[0])); i++, tested++)
+        errors += compareAccuracy(special[i]);
+
+    // A sweep through all float bit patterns, including NaNs and denormals
+    for (uint64_t bits = 0; bits <= UINT32_MAX; bits += 257, tested++) {
+        uint32_t pattern = (uint32_t) bits;
+        float value;
+        memcpy(&value, &pattern, sizeof(value));
+        errors += compareAccuracy(value);
+    }
+
+    // All enum values, including the reserved and out of range ones
+    for (int i = -2; i < 20; i++, tested++) {
+        errors += decodeHorizontalAccuracy(i) != ref_decodeHorizontalAccuracy(i);
+        errors += decodeVerticalAccuracy(i) != ref_decodeVerticalAccuracy(i);
+        errors += decodeSpeedAccuracy(i) != ref_decodeSpeedAccuracy(i);
+        errors += decodeTimestampAccuracy(i) != ref_decodeTimestampAccuracy(i);
+    }
+
+    printf("Compared %ld accuracy values with the reference: %s\n", tested,
+           errors ? "FAILED" : "PASSED");
+}
+
+// Exhaustively compare the table based single byte field decoders with the arithmetic ones
+void test_decode_tables()
+{
+    ODID_Location_encoded location;
+    ODID_Location_data decoded, expected;
+    ODID_System_encoded system;
+    ODID_System_data system_decoded;
+    int errors = 0;
+
+    printf("\n-------------------------------------Decode Tables----------------------------------\n");
+    memset(&location, 0, sizeof(location));
+    memset(&system, 0, sizeof(system));
+    location.MessageType = ODID_MESSAGETYPE_LOCATION;
+    system.MessageType = ODID_MESSAGETYPE_SYSTEM;
+
+    for (int value = 0; value < 256; value++) {
+        for (int flags = 0; flags < 4; flags++) {
+            location.Direction = (uint8_t) value;
+            location.SpeedHorizontal = (uint8_t) value;
+            location.SpeedVertical = (int8_t) value;
+            location.EWDirection = flags & 1;
+            location.SpeedMult = flags >> 1;
+            memset(&decoded, 0, sizeof(decoded));
+            memset(&expected, 0, sizeof(expected));
+            decodeLocationMessage(&decoded, &location);
+            ref_decodeLocationMessage(&expected, &location);
+            errors += memcmp(&decoded, &expected, sizeof(decoded)) != 0;
+        }
+
+        system.AreaRadius = (uint8_t) value;
+        decodeSystemMessage(&system_decoded, &system);
+        errors += system_decoded.AreaRadius != ref_decodeAreaRadius(&system);
+    }
+
+    printf("Compared all single byte field values with the arithmetic decoders: %s\n",
+           errors ? "FAILED" : "PASSED");
+}
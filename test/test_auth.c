@@ -0,0 +1,149 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "test_util.h"
+
+#define AUTH_SOURCES 300
+#define AUTH_SETS 1024
+#define AUTH_TIMEOUT 1000
+
+static uint32_t authSeed = 0xA07B;
+
+struct authSource {
+    uint8_t data[ODID_AUTH_MAX_DATA_SIZE];
+    size_t len;
+    uint32_t timestamp;
+    ODID_Auth_encoded pages[ODID_AUTH_MAX_PAGES];
+    int pageCount;
+    int completed;
+};
+
+static int newAuthData(struct authSource *src)
+{
+    src->len = 1 + test_random(&authSeed, ODID_AUTH_MAX_DATA_SIZE);
+    for (size_t i = 0; i < src->len; i++)
+        src->data[i] = (uint8_t) test_random(&authSeed, 256);
+    src->timestamp = test_random(&authSeed, 0xFFFFFFFF);
+    src->completed = 0;
+    return odid_auth_segment(src->pages, ODID_AUTH_MESSAGE_SET_SIGNATURE, src->timestamp,
+                             src->data, src->len, &src->pageCount) != ODID_SUCCESS;
+}
+
+// The segmented pages decode to the right header fields and contain the data
+static int testSegment(struct authSource *src)
+{
+    ODID_Auth_data auth;
+    int errors = 0;
+
+    for (int page = 0; page < src->pageCount; page++) {
+        uint8_t *msg = (uint8_t *) &src->pages[page];
+        errors += decodeAuthMessage(&auth, &src->pages[page]) != ODID_SUCCESS;
+        errors += auth.DataPage != page;
+        errors += auth.AuthType != ODID_AUTH_MESSAGE_SET_SIGNATURE;
+        if (page == 0) {
+            errors += auth.PageCount != src->pageCount;
+            errors += auth.Length != src->len;
+            errors += auth.Timestamp != src->timestamp;
+            errors += memcmp(&msg[8], src->data, src->len < 17 ? src->len : 17) != 0;
+        } else {
+            size_t offset = 17 + (size_t) (page - 1) * ODID_STR_SIZE;
+            size_t size = src->len - offset < ODID_STR_SIZE ? src->len - offset : ODID_STR_SIZE;
+            errors += offset >= src->len;
+            errors += memcmp(&msg[2], &src->data[offset], size) != 0;
+        }
+    }
+    return errors;
+}
+
+// Send every page of every source twice, in random order
+static int sendAll(ODID_Auth_reassembly *ctx, struct authSource *sources, uint32_t now)
+{
+    static uint16_t order[AUTH_SOURCES * ODID_AUTH_MAX_PAGES * 2];
+    int count = 0, errors = 0;
+
+    for (int i = 0; i < AUTH_SOURCES; i++) {
+        for (int page = 0; page < sources[i].pageCount; page++) {
+            order[count++] = (uint16_t) (i * ODID_AUTH_MAX_PAGES + page);
+            order[count++] = (uint16_t) (i * ODID_AUTH_MAX_PAGES + page);
+        }
+    }
+    for (int i = count - 1; i > 0; i--) {
+        int j = (int) test_random(&authSeed, (uint32_t) i + 1);
+        uint16_t tmp = order[i];
+        order[i] = order[j];
+        order[j] = tmp;
+    }
+
+    for (int i = 0; i < count; i++) {
+        struct authSource *src = &sources[order[i] / ODID_AUTH_MAX_PAGES];
+        const ODID_Auth_set *set = odid_auth_reassemble(ctx, 0x0200000000ULL + order[i] / ODID_AUTH_MAX_PAGES,
+                                                        &src->pages[order[i] % ODID_AUTH_MAX_PAGES], now);
+        if (set) {
+            src->completed++;
+            errors += set->Length != src->len;
+            errors += set->Timestamp != src->timestamp;
+            errors += set->PageCount != src->pageCount;
+            errors += set->AuthType != ODID_AUTH_MESSAGE_SET_SIGNATURE;
+            errors += memcmp(set->AuthData, src->data, src->len) != 0;
+        }
+    }
+    for (int i = 0; i < AUTH_SOURCES; i++)
+        errors += sources[i].completed != 1;
+    return errors;
+}
+
+// A partial set that times out does not complete with late pages
+static int testExpiry(ODID_Auth_reassembly *ctx, struct authSource *src)
+{
+    int errors = 0;
+
+    while (src->pageCount < 2)
+        errors += newAuthData(src);
+    for (int page = 1; page < src->pageCount; page++)
+        errors += odid_auth_reassemble(ctx, 1, &src->pages[page], 0) != NULL;
+    errors += odid_auth_reassemble(ctx, 1, &src->pages[0], AUTH_TIMEOUT + 1) != NULL;
+    for (int page = 1; page < src->pageCount; page++)
+        errors += (odid_auth_reassemble(ctx, 1, &src->pages[page], AUTH_TIMEOUT + 2) != NULL) !=
+                  (page == src->pageCount - 1);
+    return errors;
+}
+
+void test_auth()
+{
+    static struct authSource sources[AUTH_SOURCES];
+    static ODID_Auth_set sets[AUTH_SETS];
+    ODID_Auth_reassembly ctx;
+    uint8_t data[ODID_AUTH_MAX_DATA_SIZE + 1] = { 0 };
+    int pageCount, errors = 0;
+
+    printf("\n-------------------------------------Auth pages------------------------------------\n");
+    errors += odid_auth_segment(sources[0].pages, ODID_AUTH_NONE, 0, data, 0, &pageCount) != ODID_FAIL;
+    errors += odid_auth_segment(sources[0].pages, ODID_AUTH_NONE, 0, data, sizeof(data), &pageCount) != ODID_FAIL;
+
+    odid_auth_reassembly_init(&ctx, sets, AUTH_SETS, AUTH_TIMEOUT);
+    for (int round = 0; round < 20; round++) {
+        for (int i = 0; i < AUTH_SOURCES; i++) {
+            errors += newAuthData(&sources[i]);
+            errors += testSegment(&sources[i]);
+        }
+        // New data from the same sources replaces their complete sets
+        errors += sendAll(&ctx, sources, (uint32_t) round);
+    }
+
+    odid_auth_reassembly_init(&ctx, sets, AUTH_SETS, AUTH_TIMEOUT);
+    errors += testExpiry(&ctx, &sources[0]);
+
+    printf("Auth page segmentation and reassembly: %s (%d errors)\n",
+           errors ? "FAILED" : "PASSED", errors);
+}
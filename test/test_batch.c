@@ -0,0 +1,238 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <opendroneid.h>
+#include "test_util.h"
+
+#define TEST_BATCH_SIZE 1003
+
+static uint32_t testSeed = 0xBA7C4;
+
+// Mix of random values, exact quantization boundaries and out of range values
+static float pickFloat(float min, float max, float step)
+{
+    const float special[] = { 0, -0.0f, 0.5f, -0.5f, 179.5f, 180, 359.5f, 361, 362,
+                              63.75f, 63.76f, 254.25f, 255, 256, -63, 63, 64, -1000,
+                              -1001, 31767.5f, 40000, 3599.95f, 3600, 1e20f, -1e20f,
+                              INFINITY, -INFINITY, NAN };
+    int pick = (int) test_randf(&testSeed, 0, 4);
+
+    if (pick == 0)
+        return special[(int) test_randf(&testSeed, 0, sizeof(special) / sizeof(special[0]) - 1)];
+    if (pick == 1)
+        return step * (int) test_randf(&testSeed, min / step, max / step) + step / 2;
+    return test_randf(&testSeed, min, max);
+}
+
+static void fillRandomLocation(ODID_Location_data *loc)
+{
+    memset(loc, 0, sizeof(*loc));
+    loc->Status = (ODID_status_t) test_randf(&testSeed, 0, 16.5f);
+    loc->Direction = pickFloat(-10, 370, 1);
+    loc->SpeedHorizontal = pickFloat(-10, 300, 0.25f);
+    loc->SpeedVertical = pickFloat(-70, 70, 0.5f);
+    loc->Latitude = pickFloat(-200, 200, 1e-7f) + test_randf(&testSeed, 0, 1) * 1e-7;
+    loc->Longitude = pickFloat(-200, 200, 1e-7f);
+    loc->AltitudeBaro = pickFloat(-1100, 33000, 0.5f);
+    loc->AltitudeGeo = pickFloat(-1100, 33000, 0.5f);
+    loc->HeightType = (ODID_Height_reference_t) test_randf(&testSeed, 0, 2);
+    loc->Height = pickFloat(-1100, 33000, 0.5f);
+    loc->HorizAccuracy = (ODID_Horizontal_accuracy_t) test_randf(&testSeed, 0, 16.2f);
+    loc->VertAccuracy = (ODID_Vertical_accuracy_t) test_randf(&testSeed, 0, 16);
+    loc->BaroAccuracy = (ODID_Vertical_accuracy_t) test_randf(&testSeed, 0, 16);
+    loc->SpeedAccuracy = (ODID_Speed_accuracy_t) test_randf(&testSeed, 0, 16);
+    loc->TSAccuracy = (ODID_Timestamp_accuracy_t) test_randf(&testSeed, 0, 16);
+    loc->TimeStamp = pickFloat(-10, 3700, 0.1f);
+}
+
+// Encoded messages of every type, with some random garbage in between
+static void fillRandomMessage(uint8_t *msg)
+{
+    ODID_BasicID_data basicID = { ODID_UATYPE_ROTORCRAFT, ODID_IDTYPE_SERIAL_NUMBER, "INTCE123456789012345" };
+    ODID_Location_data location;
+    ODID_Auth_data auth = { 0, ODID_AUTH_UAS_ID_SIGNATURE, 2, 40, 23000000, "030a0cd033a3" };
+    ODID_SelfID_data selfID = { ODID_DESC_TYPE_TEXT, "Real Estate Photos" };
+    ODID_System_data system = { ODID_LOCATION_SRC_TAKEOFF, 45.5393082, -122.9663884, 35, 75, 176.9f, 41.7f };
+    ODID_OperatorID_data operatorID = { ODID_OPERATOR_ID, "98765432100123456789" };
+
+    memset(msg, 0, ODID_MESSAGE_SIZE);
+    switch ((int) test_randf(&testSeed, 0, 7.99f)) {
+    case 0:
+        encodeBasicIDMessage((ODID_BasicID_encoded *) msg, &basicID);
+        break;
+    case 1:
+        fillRandomLocation(&location);
+        if (encodeLocationMessage((ODID_Location_encoded *) msg, &location) == ODID_SUCCESS)
+            break;
+        // fall through
+    case 2:
+        auth.DataPage = (uint8_t) test_randf(&testSeed, 0, 5.99f);
+        encodeAuthMessage((ODID_Auth_encoded *) msg, &auth);
+        break;
+    case 3:
+        encodeSelfIDMessage((ODID_SelfID_encoded *) msg, &selfID);
+        break;
+    case 4:
+        encodeSystemMessage((ODID_System_encoded *) msg, &system);
+        break;
+    case 5:
+        encodeOperatorIDMessage((ODID_OperatorID_encoded *) msg, &operatorID);
+        break;
+    default:
+        for (int i = 0; i < ODID_MESSAGE_SIZE; i++)
+            msg[i] = (uint8_t) test_rand(&testSeed);
+        break;
+    }
+}
+
+// Decode a single message the same way decodeOpenDroneID() does, into the batch arrays
+static ODID_messagetype_t decodeSingle(ODID_Batch_data *out, int i, uint8_t *msg)
+{
+    ODID_messagetype_t type = decodeMessageType(msg[0]);
+    int ret = ODID_FAIL;
+
+    switch (type) {
+    case ODID_MESSAGETYPE_BASIC_ID:
+        ret = decodeBasicIDMessage(&out->BasicID[i], (ODID_BasicID_encoded *) msg);
+        break;
+    case ODID_MESSAGETYPE_LOCATION:
+        ret = decodeLocationMessage(&out->Location[i], (ODID_Location_encoded *) msg);
+        break;
+    case ODID_MESSAGETYPE_AUTH:
+        ret = decodeAuthMessage(&out->Auth[i], (ODID_Auth_encoded *) msg);
+        break;
+    case ODID_MESSAGETYPE_SELF_ID:
+        ret = decodeSelfIDMessage(&out->SelfID[i], (ODID_SelfID_encoded *) msg);
+        break;
+    case ODID_MESSAGETYPE_SYSTEM:
+        ret = decodeSystemMessage(&out->System[i], (ODID_System_encoded *) msg);
+        break;
+    case ODID_MESSAGETYPE_OPERATOR_ID:
+        ret = decodeOperatorIDMessage(&out->OperatorID[i], (ODID_OperatorID_encoded *) msg);
+        break;
+    default:
+        break;
+    }
+    return ret == ODID_SUCCESS ? type : ODID_MESSAGETYPE_INVALID;
+}
+
+static int allocBatch(ODID_Batch_data *out, int count)
+{
+    out->BasicID = calloc(count, sizeof(*out->BasicID));
+    out->Location = calloc(count, sizeof(*out->Location));
+    out->Auth = calloc(count, sizeof(*out->Auth));
+    out->SelfID = calloc(count, sizeof(*out->SelfID));
+    out->System = calloc(count, sizeof(*out->System));
+    out->OperatorID = calloc(count, sizeof(*out->OperatorID));
+    return out->BasicID && out->Location && out->Auth && out->SelfID &&
+           out->System && out->OperatorID;
+}
+
+static void freeBatch(ODID_Batch_data *out)
+{
+    free(out->BasicID);
+    free(out->Location);
+    free(out->Auth);
+    free(out->SelfID);
+    free(out->System);
+    free(out->OperatorID);
+}
+
+static void test_batch_decode()
+{
+    uint8_t *msgs = calloc(TEST_BATCH_SIZE, ODID_MESSAGE_SIZE);
+    ODID_messagetype_t status[TEST_BATCH_SIZE];
+    ODID_Batch_data single = { 0 }, batch = { 0 };
+    int mismatches = 0, decoded = 0, expected = 0;
+
+    if (!msgs || !allocBatch(&single, TEST_BATCH_SIZE) || !allocBatch(&batch, TEST_BATCH_SIZE))
+        goto out;
+
+    for (int i = 0; i < TEST_BATCH_SIZE; i++)
+        fillRandomMessage(&msgs[i * ODID_MESSAGE_SIZE]);
+
+    decoded = decodeOpenDroneIDBatch(&batch, status, msgs, TEST_BATCH_SIZE);
+    for (int i = 0; i < TEST_BATCH_SIZE; i++) {
+        ODID_messagetype_t type = decodeSingle(&single, i, &msgs[i * ODID_MESSAGE_SIZE]);
+        if (type != ODID_MESSAGETYPE_INVALID)
+            expected++;
+        if (type != status[i])
+            mismatches++;
+    }
+
+#define COMPARE_BATCH_ARRAY(array) \
+    if (memcmp(single.array, batch.array, TEST_BATCH_SIZE * sizeof(*single.array)) != 0) \
+        mismatches++;
+    COMPARE_BATCH_ARRAY(BasicID);
+    COMPARE_BATCH_ARRAY(Location);
+    COMPARE_BATCH_ARRAY(Auth);
+    COMPARE_BATCH_ARRAY(SelfID);
+    COMPARE_BATCH_ARRAY(System);
+    COMPARE_BATCH_ARRAY(OperatorID);
+#undef COMPARE_BATCH_ARRAY
+
+    printf("Batch decoded %d of %d messages, expected %d: %s\n", decoded,
+           TEST_BATCH_SIZE, expected,
+           (mismatches || decoded != expected) ? "FAILED" : "PASSED");
+
+out:
+    freeBatch(&single);
+    freeBatch(&batch);
+    free(msgs);
+}
+
+void test_batch()
+{
+    ODID_Location_data *in = calloc(TEST_BATCH_SIZE, sizeof(*in));
+    ODID_Location_encoded *single = calloc(TEST_BATCH_SIZE, sizeof(*single));
+    ODID_Location_encoded *batch = calloc(TEST_BATCH_SIZE, sizeof(*batch));
+    int mismatches = 0, failed = 0;
+
+    printf("\n-------------------------------------Batch Encode-----------------------------------\n");
+    if (!in || !single || !batch)
+        goto out;
+
+    for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < TEST_BATCH_SIZE; i++)
+            fillRandomLocation(&in[i]);
+
+        for (int i = 0; i < TEST_BATCH_SIZE; i++) {
+            if (encodeLocationMessage(&single[i], &in[i]) != ODID_SUCCESS)
+                failed++;
+        }
+        encodeLocationMessageBatch(batch, in, TEST_BATCH_SIZE);
+
+        for (int i = 0; i < TEST_BATCH_SIZE; i++) {
+            if (memcmp(&single[i], &batch[i], sizeof(single[i])) != 0) {
+                if (mismatches++ < 10) {
+                    printf("Mismatch at %d:\n", i);
+                    printLocation_data(&in[i]);
+                    printByteArray((uint8_t *) &single[i], ODID_MESSAGE_SIZE, 1);
+                    printByteArray((uint8_t *) &batch[i], ODID_MESSAGE_SIZE, 1);
+                }
+            }
+        }
+    }
+
+    printf("Compared %d messages (%d rejected by both): %s\n",
+           100 * TEST_BATCH_SIZE, failed, mismatches ? "FAILED" : "PASSED");
+
+out:
+    free(in);
+    free(single);
+    free(batch);
+
+    test_batch_decode();
+}
@@ -0,0 +1,210 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+
+/*
+ * Known wire bytes of a few messages, as produced by the packed struct codec on
+ * x86. Both the struct codec and the byte codec (ODID_BYTE_CODEC) must produce
+ * and accept exactly these bytes.
+ */
+static const uint8_t locationWire[ODID_MESSAGE_SIZE] = {
+    0x10, 0x27, 0x24, 0x41, 0xF7, 0x58, 0x16, 0xAF, 0x1E, 0x38, 0xCD, 0xFF,
+    0xFF, 0xC1, 0x08, 0xAC, 0x08, 0x70, 0x08, 0x5A, 0x43, 0x15, 0x0E, 0x02,
+    0x00
+};
+
+static const uint8_t systemWire[ODID_MESSAGE_SIZE] = {
+    0x40, 0x80, 0xC0, 0xDC, 0xD1, 0xEB, 0xA8, 0x9F, 0x21, 0x5A, 0x23, 0x00,
+    0x1A, 0x54, 0x0B, 0xA8, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00
+};
+
+static const uint8_t authPage0Wire[ODID_MESSAGE_SIZE] = {
+    0x20, 0x10, 0x03, 0x33, 0x78, 0x56, 0x34, 0x12, 0x30, 0x31, 0x32, 0x33,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46,
+    0x00
+};
+
+static const uint8_t authPage2Wire[ODID_MESSAGE_SIZE] = {
+    0x20, 0x12, 0x67, 0x68, 0x69, 0x6A, 0x6B, 0x6C, 0x6D, 0x6E, 0x6F, 0x70,
+    0x71, 0x72, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x30, 0x31,
+    0x32
+};
+
+static ODID_Location_data locationData = {
+    .Status = ODID_STATUS_AIRBORNE,
+    .Direction = 215.7f,
+    .SpeedHorizontal = 112.5f,
+    .SpeedVertical = -4.5f,
+    .Latitude = 51.4791,
+    .Longitude = -0.0013,
+    .AltitudeBaro = 120.5f,
+    .AltitudeGeo = 110,
+    .HeightType = ODID_HEIGHT_REF_OVER_GROUND,
+    .Height = 80,
+    .HorizAccuracy = ODID_HOR_ACC_10_METER,
+    .VertAccuracy = ODID_VER_ACC_3_METER,
+    .BaroAccuracy = ODID_VER_ACC_10_METER,
+    .SpeedAccuracy = ODID_SPEED_ACC_1_METERS_PER_SECOND,
+    .TSAccuracy = ODID_TIME_ACC_0_2_SECOND,
+    .TimeStamp = 360.5f,
+};
+
+static ODID_System_data systemData = {
+    .LocationSource = ODID_LOCATION_SRC_LIVE_GNSS,
+    .OperatorLatitude = -33.8568,
+    .OperatorLongitude = 151.2153,
+    .AreaCount = 35,
+    .AreaRadius = 260,
+    .AreaCeiling = 450,
+    .AreaFloor = -20,
+};
+
+static ODID_Auth_data authPage0Data = {
+    .DataPage = 0,
+    .AuthType = ODID_AUTH_UAS_ID_SIGNATURE,
+    .PageCount = 3,
+    .Length = 51,
+    .Timestamp = 0x12345678,
+    .AuthData = "0123456789ABCDEF",
+};
+
+static ODID_Auth_data authPage2Data = {
+    .DataPage = 2,
+    .AuthType = ODID_AUTH_UAS_ID_SIGNATURE,
+    .AuthData = "ghijklmnopqrstuvwxyz012",
+};
+
+static int checkEncoded(const char *name, const void *encoded, const uint8_t *expected)
+{
+    if (memcmp(encoded, expected, ODID_MESSAGE_SIZE) == 0)
+        return 0;
+    printf("%s: encoded bytes differ from the reference\n", name);
+    return 1;
+}
+
+static int checkAuth(ODID_Auth_data *decoded, ODID_Auth_data *expected)
+{
+    return decoded->DataPage != expected->DataPage ||
+           decoded->AuthType != expected->AuthType ||
+           decoded->PageCount != expected->PageCount ||
+           decoded->Length != expected->Length ||
+           decoded->Timestamp != expected->Timestamp ||
+           strcmp(decoded->AuthData, expected->AuthData) != 0;
+}
+
+void test_codec()
+{
+    ODID_Location_encoded location;
+    ODID_System_encoded system;
+    ODID_Auth_encoded auth;
+    ODID_Location_data loc;
+    ODID_System_data sys;
+    ODID_Auth_data authData;
+    int errors = 0;
+
+    printf("\n-------------------------------------Wire codec------------------------------------\n");
+    // Start from garbage to make sure every byte is written
+    memset(&location, 0xFF, sizeof(location));
+    memset(&system, 0xFF, sizeof(system));
+    errors += encodeLocationMessage(&location, &locationData) != ODID_SUCCESS;
+    errors += checkEncoded("Location", &location, locationWire);
+    errors += encodeSystemMessage(&system, &systemData) != ODID_SUCCESS;
+    errors += checkEncoded("System", &system, systemWire);
+    memset(&auth, 0, sizeof(auth));
+    errors += encodeAuthMessage(&auth, &authPage0Data) != ODID_SUCCESS;
+    errors += checkEncoded("Auth page 0", &auth, authPage0Wire);
+    memset(&auth, 0, sizeof(auth));
+    errors += encodeAuthMessage(&auth, &authPage2Data) != ODID_SUCCESS;
+    errors += checkEncoded("Auth page 2", &auth, authPage2Wire);
+
+    memcpy(&location, locationWire, ODID_MESSAGE_SIZE);
+    errors += decodeLocationMessage(&loc, &location) != ODID_SUCCESS;
+    errors += loc.Status != locationData.Status;
+    errors += loc.Direction != 216;
+    errors += loc.SpeedHorizontal != 112.5f;
+    errors += loc.SpeedVertical != -4.5f;
+    errors += loc.Latitude != 51.4791;
+    errors += loc.Longitude != -0.0013;
+    errors += loc.AltitudeBaro != 120.5f;
+    errors += loc.AltitudeGeo != 110;
+    errors += loc.HeightType != locationData.HeightType;
+    errors += loc.Height != 80;
+    errors += loc.HorizAccuracy != locationData.HorizAccuracy;
+    errors += loc.VertAccuracy != locationData.VertAccuracy;
+    errors += loc.BaroAccuracy != locationData.BaroAccuracy;
+    errors += loc.SpeedAccuracy != locationData.SpeedAccuracy;
+    errors += loc.TSAccuracy != locationData.TSAccuracy;
+    errors += loc.TimeStamp != 360.5f;
+
+    memcpy(&system, systemWire, ODID_MESSAGE_SIZE);
+    errors += decodeSystemMessage(&sys, &system) != ODID_SUCCESS;
+    errors += sys.LocationSource != systemData.LocationSource;
+    errors += sys.OperatorLatitude != systemData.OperatorLatitude;
+    errors += sys.OperatorLongitude != systemData.OperatorLongitude;
+    errors += sys.AreaCount != systemData.AreaCount;
+    errors += sys.AreaRadius != systemData.AreaRadius;
+    errors += sys.AreaCeiling != systemData.AreaCeiling;
+    errors += sys.AreaFloor != systemData.AreaFloor;
+
+    memcpy(&auth, authPage0Wire, ODID_MESSAGE_SIZE);
+    errors += decodeAuthMessage(&authData, &auth) != ODID_SUCCESS;
+    errors += checkAuth(&authData, &authPage0Data);
+    // Page 1 - 4 do not carry PageCount, Length and Timestamp
+    memset(&authData, 0, sizeof(authData));
+    memcpy(&auth, authPage2Wire, ODID_MESSAGE_SIZE);
+    errors += decodeAuthMessage(&authData, &auth) != ODID_SUCCESS;
+    errors += checkAuth(&authData, &authPage2Data);
+
+    // Pages beyond 4 would alias page 0 - 15 in the nibble. Both codecs must
+    // reject them rather than write a page 0 header with another page's body
+    static const uint8_t pages[] = { 0, 1, 2, 3, 4, 5, 15, 16, 20, 255 };
+    for (size_t i = 0; i < sizeof(pages); i++) {
+        ODID_Auth_data page = authPage2Data;
+        int expected = pages[i] <= 4 ? ODID_SUCCESS : ODID_FAIL;
+
+        page.DataPage = pages[i];
+        memset(&auth, 0, sizeof(auth));
+        if (encodeAuthMessage(&auth, &page) != expected) {
+            printf("Auth page %d: encode should %s\n", pages[i],
+                   expected == ODID_SUCCESS ? "succeed" : "fail");
+            errors++;
+            continue;
+        }
+        if (expected != ODID_SUCCESS)
+            continue;
+        memset(&authData, 0, sizeof(authData));
+        errors += decodeAuthMessage(&authData, &auth) != ODID_SUCCESS;
+        errors += authData.DataPage != pages[i];
+    }
+
+    // HeightType is one bit on the wire. Other values are rejected by every
+    // Location encoder instead of being truncated
+    static const int heightTypes[] = { 0, 1, 2, 3, 255, -1 };
+    for (size_t i = 0; i < sizeof(heightTypes) / sizeof(heightTypes[0]); i++) {
+        ODID_Location_data heightLoc = locationData;
+        ODID_Location_fixed heightFixed;
+        int expected = heightTypes[i] == 0 || heightTypes[i] == 1 ? ODID_SUCCESS : ODID_FAIL;
+
+        heightLoc.HeightType = (ODID_Height_reference_t) heightTypes[i];
+        errors += encodeLocationMessage(&location, &heightLoc) != expected;
+        errors += encodeLocationMessageBatch(&location, &heightLoc, 1) != expected;
+        memset(&heightFixed, 0, sizeof(heightFixed));
+        heightFixed.HeightType = heightLoc.HeightType;
+        errors += encodeLocationMessageFixed(&location, &heightFixed) != expected;
+    }
+
+    printf("Wire codec reference messages: %s (%d errors)\n",
+           errors ? "FAILED" : "PASSED", errors);
+}
@@ -0,0 +1,272 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <math.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "test_util.h"
+
+static uint32_t fixedSeed = 0xF1CED;
+
+// Compare a fixed-point value with the float decoder result in the same unit
+static int differs(long fixed, double value, double scale)
+{
+    return fixed != lround(value * scale);
+}
+
+static int compareLocation(ODID_Location_fixed *fixed, ODID_Location_data *loc)
+{
+    return fixed->Status != loc->Status ||
+           differs(fixed->Direction, loc->Direction, 1) ||
+           differs(fixed->SpeedHorizontal, loc->SpeedHorizontal, 100) ||
+           differs(fixed->SpeedVertical, loc->SpeedVertical, 100) ||
+           differs(fixed->Latitude, loc->Latitude, 1e7) ||
+           differs(fixed->Longitude, loc->Longitude, 1e7) ||
+           differs(fixed->AltitudeBaro, loc->AltitudeBaro, 10) ||
+           differs(fixed->AltitudeGeo, loc->AltitudeGeo, 10) ||
+           fixed->HeightType != loc->HeightType ||
+           differs(fixed->Height, loc->Height, 10) ||
+           fixed->HorizAccuracy != loc->HorizAccuracy ||
+           fixed->VertAccuracy != loc->VertAccuracy ||
+           fixed->BaroAccuracy != loc->BaroAccuracy ||
+           fixed->SpeedAccuracy != loc->SpeedAccuracy ||
+           fixed->TSAccuracy != loc->TSAccuracy ||
+           differs(fixed->TimeStamp, loc->TimeStamp, 10);
+}
+
+static int compareSystem(ODID_System_fixed *fixed, ODID_System_data *sys)
+{
+    return fixed->LocationSource != sys->LocationSource ||
+           differs(fixed->OperatorLatitude, sys->OperatorLatitude, 1e7) ||
+           differs(fixed->OperatorLongitude, sys->OperatorLongitude, 1e7) ||
+           fixed->AreaCount != sys->AreaCount ||
+           fixed->AreaRadius != sys->AreaRadius ||
+           differs(fixed->AreaCeiling, sys->AreaCeiling, 10) ||
+           differs(fixed->AreaFloor, sys->AreaFloor, 10);
+}
+
+static void randomLocation(ODID_Location_data *loc)
+{
+    loc->Status = (ODID_status_t) test_random(&fixedSeed, 16);
+    loc->Direction = test_randf(&fixedSeed, -10, 370);
+    loc->SpeedHorizontal = test_randf(&fixedSeed, -10, 270);
+    loc->SpeedVertical = test_randf(&fixedSeed, -70, 70);
+    loc->Latitude = test_randf(&fixedSeed, -90, 90);
+    loc->Longitude = test_randf(&fixedSeed, -180, 180);
+    loc->AltitudeBaro = test_randf(&fixedSeed, -1100, 32000);
+    loc->AltitudeGeo = test_randf(&fixedSeed, -1100, 32000);
+    loc->HeightType = (ODID_Height_reference_t) test_random(&fixedSeed, 2);
+    loc->Height = test_randf(&fixedSeed, -1100, 32000);
+    loc->HorizAccuracy = (ODID_Horizontal_accuracy_t) test_random(&fixedSeed, 16);
+    loc->VertAccuracy = (ODID_Vertical_accuracy_t) test_random(&fixedSeed, 16);
+    loc->BaroAccuracy = (ODID_Vertical_accuracy_t) test_random(&fixedSeed, 16);
+    loc->SpeedAccuracy = (ODID_Speed_accuracy_t) test_random(&fixedSeed, 16);
+    loc->TSAccuracy = (ODID_Timestamp_accuracy_t) test_random(&fixedSeed, 16);
+    loc->TimeStamp = test_randf(&fixedSeed, 0, 3700);
+}
+
+static void randomSystem(ODID_System_data *sys)
+{
+    sys->LocationSource = (ODID_location_source_t) test_random(&fixedSeed, 2);
+    sys->OperatorLatitude = test_randf(&fixedSeed, -90, 90);
+    sys->OperatorLongitude = test_randf(&fixedSeed, -180, 180);
+    sys->AreaCount = (uint16_t) test_random(&fixedSeed, 65536);
+    sys->AreaRadius = (uint16_t) test_random(&fixedSeed, 65536);
+    sys->AreaCeiling = test_randf(&fixedSeed, -1100, 32000);
+    sys->AreaFloor = test_randf(&fixedSeed, -1100, 32000);
+}
+
+// Random fixed-point value that is not on a quantization step boundary
+static int32_t offGrid(int32_t min, int32_t max, int32_t step)
+{
+    int32_t value = min + (int32_t) test_random(&fixedSeed, (uint32_t) (max - min));
+    return value - value % step + 1 + (int32_t) test_random(&fixedSeed, (uint32_t) step - 1);
+}
+
+// The fixed-point encoder quantizes like the float encoder
+static int testFixedEncode(void)
+{
+    ODID_Location_encoded fromFloat, fromFixed;
+    ODID_Location_data loc;
+    ODID_Location_fixed fixed;
+
+    memset(&fixed, 0, sizeof(fixed));
+    fixed.Direction = (uint16_t) test_random(&fixedSeed, 361);
+    if (test_random(&fixedSeed, 2))
+        fixed.SpeedHorizontal = (uint16_t) offGrid(0, 6350, 25);
+    else
+        fixed.SpeedHorizontal = (uint16_t) (6375 + offGrid(0, 19050, 75));
+    fixed.SpeedVertical = (int16_t) offGrid(0, 6250, 50) * (test_random(&fixedSeed, 2) ? 1 : -1);
+    fixed.Latitude = (int32_t) test_random(&fixedSeed, 1800000000) - 900000000;
+    fixed.Longitude = (int32_t) test_random(&fixedSeed, 2000000000) - 1000000000;
+    fixed.AltitudeBaro = offGrid(-10000, 300000, 5);
+    fixed.AltitudeGeo = offGrid(-10000, 300000, 5);
+    fixed.Height = offGrid(-10000, 300000, 5);
+    fixed.TimeStamp = (uint16_t) test_random(&fixedSeed, 36001);
+
+    memset(&loc, 0, sizeof(loc));
+    loc.Direction = fixed.Direction;
+    loc.SpeedHorizontal = (float) fixed.SpeedHorizontal / 100;
+    loc.SpeedVertical = (float) fixed.SpeedVertical / 100;
+    // Half a step away from zero, as the float encoder truncates
+    loc.Latitude = (fixed.Latitude + (fixed.Latitude < 0 ? -0.5 : 0.5)) / 1e7;
+    loc.Longitude = (fixed.Longitude + (fixed.Longitude < 0 ? -0.5 : 0.5)) / 1e7;
+    loc.AltitudeBaro = (float) fixed.AltitudeBaro / 10;
+    loc.AltitudeGeo = (float) fixed.AltitudeGeo / 10;
+    loc.Height = (float) fixed.Height / 10;
+    loc.TimeStamp = (float) fixed.TimeStamp / 10;
+
+    encodeLocationMessage(&fromFloat, &loc);
+    encodeLocationMessageFixed(&fromFixed, &fixed);
+    return memcmp(&fromFloat, &fromFixed, ODID_MESSAGE_SIZE) != 0;
+}
+
+// Out of range values that are exact in both representations
+static int testFixedClamping(void)
+{
+    ODID_Location_encoded fromFloat, fromFixed;
+    ODID_Location_data loc;
+    ODID_Location_fixed fixed;
+    int errors = 0;
+
+    memset(&loc, 0, sizeof(loc));
+    memset(&fixed, 0, sizeof(fixed));
+    loc.Direction = 400;
+    fixed.Direction = 4000 / 10;
+    loc.SpeedHorizontal = 300;
+    fixed.SpeedHorizontal = 30000;
+    loc.SpeedVertical = -100;
+    fixed.SpeedVertical = -10000;
+    loc.Latitude = 200;
+    fixed.Latitude = 2000000000;
+    loc.Longitude = -200;
+    fixed.Longitude = -2000000000;
+    loc.AltitudeBaro = -2000;
+    fixed.AltitudeBaro = -20000;
+    loc.AltitudeGeo = 40000;
+    fixed.AltitudeGeo = 400000;
+    loc.Height = 31767.5f;
+    fixed.Height = 317675;
+    loc.TimeStamp = 3700;
+    fixed.TimeStamp = 37000;
+    errors += encodeLocationMessage(&fromFloat, &loc) != ODID_SUCCESS;
+    errors += encodeLocationMessageFixed(&fromFixed, &fixed) != ODID_SUCCESS;
+    errors += memcmp(&fromFloat, &fromFixed, ODID_MESSAGE_SIZE) != 0;
+
+    fixed.VertAccuracy = (ODID_Vertical_accuracy_t) 16;
+    errors += encodeLocationMessageFixed(&fromFixed, &fixed) != ODID_FAIL;
+    return errors;
+}
+
+// A pack of random messages, sometimes with a type twice or an invalid page
+static void randomPack(uint8_t *pack)
+{
+    static const ODID_messagetype_t types[] = {
+        ODID_MESSAGETYPE_BASIC_ID, ODID_MESSAGETYPE_LOCATION, ODID_MESSAGETYPE_AUTH,
+        ODID_MESSAGETYPE_SELF_ID, ODID_MESSAGETYPE_SYSTEM, ODID_MESSAGETYPE_OPERATOR_ID,
+    };
+    int count = 1 + (int) test_random(&fixedSeed, ODID_PACK_MAX_MESSAGES);
+
+    pack[0] = (uint8_t) (ODID_MESSAGETYPE_PACKED << 4) | ODID_PROTOCOL_VERSION;
+    pack[1] = ODID_MESSAGE_SIZE;
+    pack[2] = (uint8_t) count;
+    for (int i = 0; i < count; i++) {
+        uint8_t *msg = &pack[3 + i * ODID_MESSAGE_SIZE];
+
+        test_fill_wire(&fixedSeed, msg, types[test_random(&fixedSeed, 6)],
+                       (uint8_t) test_random(&fixedSeed, 6));
+    }
+}
+
+// The fixed-point dispatch accepts the same packs as the float one
+static int testFixedPack(void)
+{
+    uint8_t pack[sizeof(ODID_MessagePack_encoded)];
+    ODID_UAS_Data uas;
+    ODID_UAS_fixed fixed;
+    int errors = 0;
+
+    memset(&uas, 0, sizeof(uas));
+    memset(&fixed, 0, sizeof(fixed));
+    randomPack(pack);
+    errors += decodeOpenDroneID(&uas, pack) != decodeOpenDroneIDFixed(&fixed, pack);
+
+    errors += uas.BasicIDValid != fixed.BasicIDValid ||
+              memcmp(&uas.BasicID, &fixed.BasicID, sizeof(uas.BasicID)) != 0;
+    errors += uas.LocationValid != fixed.LocationValid ||
+              (uas.LocationValid && compareLocation(&fixed.Location, &uas.Location));
+    errors += memcmp(uas.AuthValid, fixed.AuthValid, sizeof(uas.AuthValid)) != 0 ||
+              memcmp(uas.Auth, fixed.Auth, sizeof(uas.Auth)) != 0;
+    errors += uas.SelfIDValid != fixed.SelfIDValid ||
+              memcmp(&uas.SelfID, &fixed.SelfID, sizeof(uas.SelfID)) != 0;
+    errors += uas.SystemValid != fixed.SystemValid ||
+              (uas.SystemValid && compareSystem(&fixed.System, &uas.System));
+    errors += uas.OperatorIDValid != fixed.OperatorIDValid ||
+              memcmp(&uas.OperatorID, &fixed.OperatorID, sizeof(uas.OperatorID)) != 0;
+    return errors;
+}
+
+void test_fixed()
+{
+    uint8_t msg[ODID_MESSAGE_SIZE];
+    int errors = 0;
+
+    printf("\n-------------------------------------Fixed-point-----------------------------------\n");
+    for (int round = 0; round < 100000; round++) {
+        ODID_Location_encoded locEnc, locFixedEnc;
+        ODID_Location_data loc;
+        ODID_Location_fixed locFixed;
+
+        // Decoding any wire bytes gives the float values in fixed-point units
+        test_fill_wire(&fixedSeed, msg, ODID_MESSAGETYPE_LOCATION, 0);
+        errors += decodeLocationMessage(&loc, (ODID_Location_encoded *) msg) != ODID_SUCCESS;
+        errors += decodeLocationMessageFixed(&locFixed, (ODID_Location_encoded *) msg) != ODID_SUCCESS;
+        errors += compareLocation(&locFixed, &loc);
+
+        // Float encode, fixed decode and fixed encode give back the same bytes
+        randomLocation(&loc);
+        if (encodeLocationMessage(&locEnc, &loc) == ODID_SUCCESS) {
+            // Speeds just above 63.75 m/s encode as 0 with the multiplier set,
+            // which decodes to 63.75 m/s and encodes back without multiplier
+            if (locEnc.SpeedMult && locEnc.SpeedHorizontal == 0) {
+                locEnc.SpeedMult = 0;
+                locEnc.SpeedHorizontal = UINT8_MAX;
+            }
+            errors += decodeLocationMessageFixed(&locFixed, &locEnc) != ODID_SUCCESS;
+            errors += encodeLocationMessageFixed(&locFixedEnc, &locFixed) != ODID_SUCCESS;
+            errors += memcmp(&locEnc, &locFixedEnc, ODID_MESSAGE_SIZE) != 0;
+        }
+
+        errors += testFixedEncode();
+
+        ODID_System_encoded sysEnc, sysFixedEnc;
+        ODID_System_data sys;
+        ODID_System_fixed sysFixed;
+
+        test_fill_wire(&fixedSeed, msg, ODID_MESSAGETYPE_SYSTEM, 0);
+        errors += decodeSystemMessage(&sys, (ODID_System_encoded *) msg) != ODID_SUCCESS;
+        errors += decodeSystemMessageFixed(&sysFixed, (ODID_System_encoded *) msg) != ODID_SUCCESS;
+        errors += compareSystem(&sysFixed, &sys);
+
+        randomSystem(&sys);
+        errors += encodeSystemMessage(&sysEnc, &sys) != ODID_SUCCESS;
+        errors += decodeSystemMessageFixed(&sysFixed, &sysEnc) != ODID_SUCCESS;
+        errors += encodeSystemMessageFixed(&sysFixedEnc, &sysFixed) != ODID_SUCCESS;
+        errors += memcmp(&sysEnc, &sysFixedEnc, ODID_MESSAGE_SIZE) != 0;
+
+        errors += testFixedPack();
+    }
+    errors += testFixedClamping();
+
+    printf("Fixed-point codec compared with the float codec: %s (%d errors)\n",
+           errors ? "FAILED" : "PASSED", errors);
+}
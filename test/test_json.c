@@ -0,0 +1,536 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "test_util.h"
+
+static uint32_t jsonSeed = 0x7501;
+
+static void fillUasData(ODID_UAS_Data *uas)
+{
+    memset(uas, 0, sizeof(*uas));
+    uas->BasicID.UAType = ODID_UATYPE_ROTORCRAFT;
+    uas->BasicID.IDType = ODID_IDTYPE_SERIAL_NUMBER;
+    strcpy(uas->BasicID.UASID, "12345678901234567890");
+    uas->Location.Status = ODID_STATUS_AIRBORNE;
+    uas->Location.Direction = 215.5f;
+    uas->Location.SpeedHorizontal = 5.25f;
+    uas->Location.SpeedVertical = -1.5f;
+    uas->Location.Latitude = 45.539309;
+    uas->Location.Longitude = -122.966389;
+    uas->Location.AltitudeBaro = 100;
+    uas->Location.AltitudeGeo = 110.5f;
+    uas->Location.HeightType = ODID_HEIGHT_REF_OVER_GROUND;
+    uas->Location.Height = 80;
+    uas->Location.HorizAccuracy = ODID_HOR_ACC_10_METER;
+    uas->Location.VertAccuracy = ODID_VER_ACC_10_METER;
+    uas->Location.BaroAccuracy = ODID_VER_ACC_3_METER;
+    uas->Location.SpeedAccuracy = ODID_SPEED_ACC_1_METERS_PER_SECOND;
+    uas->Location.TSAccuracy = ODID_TIME_ACC_0_2_SECOND;
+    uas->Location.TimeStamp = 360.52f;
+    uas->Auth[0].AuthType = ODID_AUTH_UAS_ID_SIGNATURE;
+    uas->Auth[0].PageCount = 2;
+    uas->Auth[0].Length = 40;
+    uas->Auth[0].Timestamp = 28000000;
+    strcpy(uas->Auth[0].AuthData, "12345678901234567");
+    uas->Auth[1].DataPage = 1;
+    uas->Auth[1].AuthType = ODID_AUTH_UAS_ID_SIGNATURE;
+    strcpy(uas->Auth[1].AuthData, "a\"b\\c\x01\n\xc3\x7f");
+    uas->SelfID.DescType = ODID_DESC_TYPE_TEXT;
+    strcpy(uas->SelfID.Desc, "DronesRUS: Real estate");
+    uas->System.LocationSource = ODID_LOCATION_SRC_TAKEOFF;
+    uas->System.OperatorLatitude = 45.5393;
+    uas->System.OperatorLongitude = -122.9663;
+    uas->System.AreaCount = 1;
+    uas->System.AreaRadius = 0;
+    uas->System.AreaCeiling = -1000;
+    uas->System.AreaFloor = -1000;
+    uas->OperatorID.OperatorIdType = ODID_OPERATOR_ID;
+    strcpy(uas->OperatorID.OperatorId, "98765432100123456789");
+    uas->BasicIDValid = uas->LocationValid = uas->SelfIDValid = 1;
+    uas->SystemValid = uas->OperatorIDValid = 1;
+    uas->AuthValid[0] = uas->AuthValid[1] = 1;
+}
+
+static const char *expectedJson =
+    "{\"Version\":\"0.0\",\"Response\":{"
+    "\"BasicID\":{\"UAType\":2,\"IDType\":1,\"UASID\":\"12345678901234567890\"},"
+    "\"Location\":{\"Status\":2,\"Direction\":215.5,\"SpeedHorizontal\":5.25,\"SpeedVertical\":-1.5,"
+    "\"Latitude\":45.539309,\"Longitude\":-122.966389,\"AltitudeBaro\":100,\"AltitudeGeo\":110.5,"
+    "\"HeightType\":1,\"Height\":80,\"HorizAccuracy\":10,\"VertAccuracy\":4,\"BaroAccuracy\":5,"
+    "\"SpeedAccuracy\":3,\"TSAccuracy\":2,\"TimeStamp\":360.52},"
+    "\"Authentication\":{\"AuthType\":1,\"AuthToken\":\"12345678901234567\"},"
+    "\"SelfID\":{\"Name\":\"string\",\"DescType\":0,\"Description\":\"DronesRUS: Real estate\"},"
+    "\"Operator\":{\"LocationSource\":0,\"OperatorLatitude\":45.5393,\"OperatorLongitude\":-122.9663,"
+    "\"AreaCount\":1,\"AreaRadius\":0,\"AreaCeiling\":-1000,\"AreaFloor\":-1000}}}";
+
+static const char *expectedAuthPages =
+    "\"Authentication\":{\"AuthType\":1,\"PageCount\":2,\"Length\":40,\"Timestamp\":28000000,"
+    "\"AuthToken\":\"12345678901234567\",\"Pages\":[\"a\\\"b\\\\c\\u0001\\n\\u00c3\x7f\"]}";
+
+static const char *expectedOperatorID =
+    ",\"OperatorID\":{\"OperatorIdType\":0,\"OperatorId\":\"98765432100123456789\"}}}\n";
+
+// Known data gives exactly the expected documents
+static int testKnownDocument(void)
+{
+    char buf[ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    ODID_UAS_Data uas;
+    char *exported;
+    int errors = 0;
+
+    fillUasData(&uas);
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, 0) != ODID_SUCCESS;
+    errors += strcmp(buf, expectedJson) != 0;
+    errors += writer.Length != strlen(expectedJson);
+
+    exported = drone_export_gps_data(&uas);
+    errors += !exported || strcmp(exported, expectedJson) != 0;
+    free(exported);
+
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID |
+                              ODID_JSON_NEWLINE) != ODID_SUCCESS;
+    errors += strstr(buf, expectedAuthPages) == NULL;
+    errors += strlen(buf) < strlen(expectedOperatorID) ||
+              strcmp(buf + strlen(buf) - strlen(expectedOperatorID), expectedOperatorID) != 0;
+    return errors;
+}
+
+// Find the value of a key in a document and convert it
+static double jsonNumber(const char *doc, const char *key)
+{
+    char pattern[64];
+    const char *p;
+
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    p = strstr(doc, pattern);
+    if (!p)
+        return NAN;
+    p += strlen(pattern);
+    if (strncmp(p, "null", 4) == 0)
+        return INFINITY;
+    return strtod(p, NULL);
+}
+
+// Numbers read back within half a unit of their last decimal
+static int testNumbers(void)
+{
+    char buf[ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    ODID_UAS_Data uas;
+    int errors = 0;
+
+    fillUasData(&uas);
+    for (int round = 0; round < 100000; round++) {
+        uas.Location.Latitude = ((double) test_random(&jsonSeed, 2000000001) - 1000000000) / 5555555.0;
+        uas.Location.Longitude = ((double) test_random(&jsonSeed, 2000000001) - 1000000000) * 1e-9;
+        uas.Location.Height = ((float) test_random(&jsonSeed, 2000001) - 1000000) / (1 + test_random(&jsonSeed, 1000));
+        uas.Location.TimeStamp = (float) test_random(&jsonSeed, 36000) / 10;
+        uas.System.AreaCount = (uint16_t) test_random(&jsonSeed, 65536);
+
+        odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+        errors += odid_json_write(&writer, &uas, 0) != ODID_SUCCESS;
+        errors += fabs(jsonNumber(buf, "Latitude") - uas.Location.Latitude) > 0.5e-7 + 1e-12;
+        errors += fabs(jsonNumber(buf, "Longitude") - uas.Location.Longitude) > 0.5e-7 + 1e-12;
+        errors += fabs(jsonNumber(buf, "Height") - uas.Location.Height) > 0.5e-2 + 1e-9;
+        errors += fabs(jsonNumber(buf, "TimeStamp") - uas.Location.TimeStamp) > 1e-9 + 1e-4;
+        errors += jsonNumber(buf, "AreaCount") != uas.System.AreaCount;
+    }
+
+    // Out of the integer range and not a number
+    uas.Location.Latitude = -1.5e300;
+    uas.Location.Longitude = NAN;
+    uas.Location.Height = -INFINITY;
+    uas.Location.AltitudeBaro = 1e30f;
+    uas.Location.Direction = -0.001f;
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, 0) != ODID_SUCCESS;
+    errors += jsonNumber(buf, "Latitude") != -1.5e300;
+    errors += !isinf(jsonNumber(buf, "Longitude"));
+    errors += !isinf(jsonNumber(buf, "Height"));
+    errors += jsonNumber(buf, "AltitudeBaro") != (double) 1e30f;
+    errors += strstr(buf, "\"Direction\":0,") == NULL;
+    return errors;
+}
+
+// Only the messages with their Valid flag are written
+static int testValidOnly(void)
+{
+    char buf[ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    ODID_UAS_Data uas;
+    int flags = ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID;
+    size_t location = strstr(expectedJson, ",\"Authentication\"") - expectedJson;
+    int errors = 0;
+
+    // A frame with only the Basic ID and Location messages
+    fillUasData(&uas);
+    uas.SelfIDValid = uas.SystemValid = uas.OperatorIDValid = 0;
+    uas.AuthValid[0] = uas.AuthValid[1] = 0;
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, flags) != ODID_SUCCESS;
+    errors += strncmp(buf, expectedJson, location) != 0 || strcmp(buf + location, "}}") != 0;
+
+    // A missing Auth page in the middle of the Pages array
+    fillUasData(&uas);
+    uas.Auth[0].PageCount = 3;
+    uas.AuthValid[1] = 0;
+    uas.AuthValid[2] = 1;
+    strcpy(uas.Auth[2].AuthData, "page 2");
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, flags) != ODID_SUCCESS;
+    errors += strstr(buf, "\"Pages\":[null,\"page 2\"]") == NULL;
+
+    // Nothing valid at all
+    memset(&uas, 0, sizeof(uas));
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, flags) != ODID_SUCCESS;
+    errors += strcmp(buf, "{\"Version\":\"0.0\",\"Response\":{}}") != 0;
+    return errors;
+}
+
+// Without a sink, a document that does not fit is not written at all
+static int testBufferFull(void)
+{
+    char buf[1024];
+    ODID_Json_writer writer;
+    ODID_UAS_Data uas;
+    size_t first;
+    int errors = 0;
+
+    fillUasData(&uas);
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, 0) != ODID_SUCCESS;
+    first = writer.Length;
+    errors += odid_json_write(&writer, &uas, 0) != ODID_FAIL;
+    errors += writer.Length != first || strlen(buf) != first;
+    errors += strcmp(buf, expectedJson) != 0;
+
+    odid_json_init(&writer, buf, 16, NULL, NULL);
+    errors += odid_json_write(&writer, &uas, 0) != ODID_FAIL;
+    errors += writer.Length != 0 || buf[0] != 0;
+    return errors;
+}
+
+struct jsonCollect {
+    char data[16 * ODID_JSON_MAX_SIZE];
+    size_t length;
+    int calls;
+};
+
+static int collect(void *user, const char *data, size_t len)
+{
+    struct jsonCollect *out = user;
+
+    if (out->length + len > sizeof(out->data))
+        return -1;
+    memcpy(out->data + out->length, data, len);
+    out->length += len;
+    out->calls++;
+    return 0;
+}
+
+static int failingSink(void *user, const char *data, size_t len)
+{
+    int *calls = user;
+
+    (void) data;
+    (void) len;
+    (*calls)++;
+    return -1;
+}
+
+// A small buffer with a sink gives the same bytes as one large buffer
+static int testSink(void)
+{
+    static char whole[16 * ODID_JSON_MAX_SIZE];
+    static struct jsonCollect out;
+    char small[ODID_JSON_MIN_SIZE];
+    ODID_Json_writer writer, wholeWriter;
+    ODID_UAS_Data uas;
+    int flags = ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID | ODID_JSON_NEWLINE;
+    int failedCalls = 0;
+    int errors = 0;
+
+    fillUasData(&uas);
+    memset(&out, 0, sizeof(out));
+    odid_json_init(&writer, small, sizeof(small), collect, &out);
+    odid_json_init(&wholeWriter, whole, sizeof(whole), NULL, NULL);
+    for (int i = 0; i < 10; i++) {
+        uas.Location.Latitude = i * 1.25;
+        errors += odid_json_write(&writer, &uas, flags) != ODID_SUCCESS;
+        errors += odid_json_write(&wholeWriter, &uas, flags) != ODID_SUCCESS;
+    }
+    errors += odid_json_flush(&writer) != ODID_SUCCESS;
+    errors += writer.Length != 0 || out.calls < 2;
+    errors += out.length != wholeWriter.Length || memcmp(out.data, whole, out.length) != 0;
+
+    // Sink failures and writers without a sink are reported. Writing stops at
+    // the first failure, so the rest of the document is not sent after a gap
+    odid_json_init(&writer, small, sizeof(small), failingSink, &failedCalls);
+    errors += odid_json_write(&writer, &uas, flags) != ODID_FAIL;
+    errors += failedCalls != 1;
+    errors += odid_json_flush(&wholeWriter) != ODID_FAIL;
+    return errors;
+}
+
+// The largest possible document fits in ODID_JSON_MAX_SIZE
+static int testMaxSize(void)
+{
+    char buf[ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    ODID_UAS_Data uas;
+    int errors = 0;
+
+    memset(&uas, 0x01, sizeof(uas));
+    uas.BasicID.UAType = (ODID_uatype_t) -2147483647;
+    uas.Location.Latitude = -1.7976931348623157e308;
+    uas.Location.Longitude = -2.2250738585072014e-308;
+    uas.Location.Height = -3.4028235e38f;
+    uas.Auth[0].PageCount = ODID_AUTH_MAX_PAGES;
+    uas.Auth[0].Timestamp = UINT32_MAX;
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID |
+                              ODID_JSON_NEWLINE) != ODID_SUCCESS;
+    return errors;
+}
+
+// The known document reads back into the data it was written from
+static int testImportKnown(void)
+{
+    char buf[ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    ODID_UAS_Data uas, imported;
+    size_t used = 0;
+    int errors = 0;
+
+    fillUasData(&uas);
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID |
+                              ODID_JSON_NEWLINE) != ODID_SUCCESS;
+    errors += odid_json_read(&imported, buf, writer.Length, &used) != ODID_SUCCESS;
+    errors += used != writer.Length - 1;
+
+    errors += memcmp(&imported.BasicID, &uas.BasicID, sizeof(uas.BasicID)) != 0;
+    errors += memcmp(&imported.Location, &uas.Location, sizeof(uas.Location)) != 0;
+    errors += memcmp(&imported.Auth[0], &uas.Auth[0], sizeof(uas.Auth[0])) != 0;
+    errors += memcmp(&imported.Auth[1], &uas.Auth[1], sizeof(uas.Auth[1])) != 0;
+    errors += memcmp(&imported.SelfID, &uas.SelfID, sizeof(uas.SelfID)) != 0;
+    errors += memcmp(&imported.System, &uas.System, sizeof(uas.System)) != 0;
+    errors += memcmp(&imported.OperatorID, &uas.OperatorID, sizeof(uas.OperatorID)) != 0;
+    errors += !imported.BasicIDValid || !imported.LocationValid || !imported.SelfIDValid ||
+              !imported.SystemValid || !imported.OperatorIDValid;
+    errors += !imported.AuthValid[0] || !imported.AuthValid[1] || imported.AuthValid[2];
+    return errors;
+}
+
+// Messages decoded from random wire bytes survive export and import exactly
+static int testImportRoundTrip(void)
+{
+    char buf[ODID_JSON_MAX_SIZE], again[ODID_JSON_MAX_SIZE];
+    uint8_t msg[ODID_MESSAGE_SIZE];
+    ODID_Json_writer writer;
+    ODID_UAS_Data uas, imported;
+    int flags = ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID;
+    int errors = 0;
+
+    for (int round = 0; round < 100000; round++) {
+        memset(&uas, 0, sizeof(uas));
+        for (int i = 0; i < 8; i++) {
+            for (int j = 0; j < ODID_MESSAGE_SIZE; j++)
+                msg[j] = (uint8_t) test_random(&jsonSeed, 256);
+            msg[0] = (uint8_t) (test_random(&jsonSeed, ODID_MESSAGETYPE_OPERATOR_ID + 1) << 4) | ODID_PROTOCOL_VERSION;
+            decodeOpenDroneID(&uas, msg);
+        }
+
+        odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+        errors += odid_json_write(&writer, &uas, flags) != ODID_SUCCESS;
+        errors += odid_json_read(&imported, buf, writer.Length, NULL) != ODID_SUCCESS;
+        odid_json_init(&writer, again, sizeof(again), NULL, NULL);
+        errors += odid_json_write(&writer, &imported, flags) != ODID_SUCCESS;
+        errors += strcmp(buf, again) != 0;
+
+        // Only the messages that were valid, Auth pages up to the page count
+        int pageCount = uas.Auth[0].PageCount < ODID_AUTH_MAX_PAGES ? uas.Auth[0].PageCount : ODID_AUTH_MAX_PAGES;
+        errors += imported.BasicIDValid != uas.BasicIDValid;
+        errors += imported.LocationValid != uas.LocationValid;
+        errors += imported.SelfIDValid != uas.SelfIDValid;
+        errors += imported.SystemValid != uas.SystemValid;
+        errors += imported.OperatorIDValid != uas.OperatorIDValid;
+        errors += imported.AuthValid[0] != uas.AuthValid[0];
+        for (int page = 1; page < ODID_AUTH_MAX_PAGES; page++)
+            errors += imported.AuthValid[page] != (uas.AuthValid[0] && page < pageCount && uas.AuthValid[page]);
+
+        errors += imported.Location.Direction != uas.Location.Direction;
+        errors += imported.Location.SpeedHorizontal != uas.Location.SpeedHorizontal;
+        errors += imported.Location.SpeedVertical != uas.Location.SpeedVertical;
+        errors += imported.Location.Latitude != uas.Location.Latitude;
+        errors += imported.Location.Longitude != uas.Location.Longitude;
+        errors += imported.Location.AltitudeGeo != uas.Location.AltitudeGeo;
+        errors += imported.Location.TimeStamp != uas.Location.TimeStamp;
+        errors += imported.System.OperatorLatitude != uas.System.OperatorLatitude;
+        errors += imported.System.AreaCeiling != uas.System.AreaCeiling;
+    }
+    return errors;
+}
+
+// Messages that were not valid are not written and stay invalid when read back
+static int testImportValid(void)
+{
+    char buf[ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    ODID_UAS_Data uas, imported;
+    int flags = ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID;
+    int errors = 0;
+
+    // A frame with only the Basic ID and Location messages
+    fillUasData(&uas);
+    uas.SelfIDValid = uas.SystemValid = uas.OperatorIDValid = 0;
+    uas.AuthValid[0] = uas.AuthValid[1] = 0;
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, flags) != ODID_SUCCESS;
+    errors += odid_json_read(&imported, buf, writer.Length, NULL) != ODID_SUCCESS;
+    errors += !imported.BasicIDValid || !imported.LocationValid || imported.SelfIDValid ||
+              imported.SystemValid || imported.OperatorIDValid || imported.AuthValid[0];
+
+    // A missing Auth page in the middle of the Pages array
+    fillUasData(&uas);
+    uas.Auth[0].PageCount = 3;
+    uas.AuthValid[1] = 0;
+    uas.AuthValid[2] = 1;
+    strcpy(uas.Auth[2].AuthData, "page 2");
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, flags) != ODID_SUCCESS;
+    errors += odid_json_read(&imported, buf, writer.Length, NULL) != ODID_SUCCESS;
+    errors += !imported.AuthValid[0] || imported.AuthValid[1] || !imported.AuthValid[2];
+    errors += strcmp(imported.Auth[2].AuthData, "page 2") != 0;
+
+    // Nothing valid at all
+    memset(&uas, 0, sizeof(uas));
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, flags) != ODID_SUCCESS;
+    errors += odid_json_read(&imported, buf, writer.Length, NULL) != ODID_SUCCESS;
+    errors += imported.BasicIDValid || imported.LocationValid || imported.SystemValid;
+    return errors;
+}
+
+struct jsonLines {
+    int count;
+    int stopAt;
+    char lastID[ODID_ID_SIZE + 1];
+};
+
+static int countLine(void *user, const ODID_UAS_Data *uasData)
+{
+    struct jsonLines *lines = user;
+
+    strcpy(lines->lastID, uasData->BasicID.UASID);
+    return ++lines->count == lines->stopAt;
+}
+
+// Unknown keys, escapes, invalid documents and NDJSON
+static int testImportSyntax(void)
+{
+    static const char *invalid[] = {
+        "", "{", "[]", "{\"Response\":{\"BasicID\":{\"UAType\":-1}}}",
+        "{\"Response\":{\"BasicID\":{\"UAType\":1.5}}}",
+        "{\"Response\":{\"BasicID\":{\"UASID\":\"123456789012345678901\"}}}",
+        "{\"Response\":{\"BasicID\":{\"UASID\":\"\\ud800\"}}}",
+        "{\"Response\":{\"BasicID\":{\"UASID\":\"a\nb\"}}}",
+        "{\"Response\":{\"Location\":{\"Latitude\":01}}}",
+        "{\"Response\":{\"Location\":{\"Latitude\":1.}}}",
+        "{\"Response\":{\"Authentication\":{\"Pages\":[\"1\",\"2\",\"3\",\"4\",\"5\"]}}}",
+        "{\"a\":[[[[[[[[[[[[[[[[[[[[1]]]]]]]]]]]]]]]]]]]}",
+        "{\"Response\":{},}",
+    };
+    const char *extra =
+        " {\"Extra\":[1,{\"a\":null},true,false,-2.5e-3],\"Response\":{\"BasicID\":"
+        "{\"UASID\":\"\\u20ac\\ud83d\\ude00\\u00ff\",\"Latitude\":5},\"Location\":{\"Latitude\":"
+        "1.000000000000000000001,\"Longitude\":-1e2,\"Height\":null}}} ";
+    char buf[4 * ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    ODID_UAS_Data uas;
+    struct jsonLines lines;
+    size_t used, bad;
+    int errors = 0;
+
+    errors += odid_json_read(&uas, extra, strlen(extra), &used) != ODID_SUCCESS;
+    errors += used != strlen(extra) - 1;
+    errors += strcmp(uas.BasicID.UASID, "\xe2\x82\xac\xf0\x9f\x98\x80\xff") != 0;
+    errors += !uas.BasicIDValid || !uas.LocationValid || uas.SystemValid;
+    errors += uas.Location.Latitude != 1 || uas.Location.Longitude != -100;
+    errors += !isnan(uas.Location.Height);
+
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+        errors += odid_json_read(&uas, invalid[i], strlen(invalid[i]), NULL) != ODID_FAIL;
+
+    // Every truncation of a document fails, also without a null terminator
+    fillUasData(&uas);
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, ODID_JSON_AUTH_PAGES | ODID_JSON_OPERATOR_ID) != ODID_SUCCESS;
+    for (size_t len = 0; len < writer.Length; len++) {
+        char *copy = malloc(len + 1);
+        memcpy(copy, buf, len);
+        errors += odid_json_read(&uas, copy, len, NULL) != ODID_FAIL;
+        free(copy);
+    }
+
+    // Three documents and an invalid line in between
+    odid_json_init(&writer, buf, sizeof(buf), NULL, NULL);
+    strcpy(uas.BasicID.UASID, "first");
+    errors += odid_json_write(&writer, &uas, ODID_JSON_NEWLINE) != ODID_SUCCESS;
+    errors += odid_json_write(&writer, &uas, ODID_JSON_NEWLINE) != ODID_SUCCESS;
+    strcat(buf, "{\"Response\":{\"BasicID\":{\"UAType\":\"x\"}}}\r\n\n");
+    writer.Length = strlen(buf);
+    strcpy(uas.BasicID.UASID, "last");
+    errors += odid_json_write(&writer, &uas, 0) != ODID_SUCCESS;
+
+    memset(&lines, 0, sizeof(lines));
+    errors += odid_json_read_lines(buf, writer.Length, countLine, &lines, &bad) != 3;
+    errors += lines.count != 3 || bad != 1 || strcmp(lines.lastID, "last") != 0;
+    memset(&lines, 0, sizeof(lines));
+    lines.stopAt = 2;
+    errors += odid_json_read_lines(buf, writer.Length, countLine, &lines, &bad) != 2;
+    errors += bad != 0 || strcmp(lines.lastID, "first") != 0;
+    return errors;
+}
+
+void test_json()
+{
+    int errors = 0;
+
+    printf("\n-------------------------------------JSON export-----------------------------------\n");
+    errors += testKnownDocument();
+    errors += testNumbers();
+    errors += testValidOnly();
+    errors += testBufferFull();
+    errors += testSink();
+    errors += testMaxSize();
+
+    printf("JSON writer output, escaping, number formatting and sinks: %s (%d errors)\n",
+           errors ? "FAILED" : "PASSED", errors);
+
+    errors = 0;
+    errors += testImportKnown();
+    errors += testImportRoundTrip();
+    errors += testImportValid();
+    errors += testImportSyntax();
+
+    printf("JSON import of written documents, round trip and NDJSON: %s (%d errors)\n",
+           errors ? "FAILED" : "PASSED", errors);
+}
@@ -0,0 +1,77 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "codec_ref.h"
+#include "test_util.h"
+
+static uint32_t packSeed = 0x9AC4;
+
+// Random pack built from a shuffled set of all message types, which is
+// accepted most of the time. Some packs get a duplicate or an illegal type
+static void fillRandomPack(ODID_MessagePack_encoded *pack)
+{
+    uint8_t types[ODID_PACK_MAX_MESSAGES] = { 0, 1, 2, 2, 2, 2, 2, 3, 4, 5 };
+    uint8_t pages[ODID_PACK_MAX_MESSAGES] = { 0 };
+    int page = 0;
+
+    for (int i = ODID_PACK_MAX_MESSAGES - 1; i > 0; i--) {
+        int j = (int) test_random(&packSeed, (uint32_t) i + 1);
+        uint8_t tmp = types[i];
+        types[i] = types[j];
+        types[j] = tmp;
+    }
+    for (int i = 0; i < ODID_PACK_MAX_MESSAGES; i++) {
+        if (types[i] == ODID_MESSAGETYPE_AUTH)
+            pages[i] = (uint8_t) page++;
+    }
+    if (!test_random(&packSeed, 10))
+        types[test_random(&packSeed, ODID_PACK_MAX_MESSAGES)] = (uint8_t) test_random(&packSeed, 16);
+
+    memset(pack, 0, sizeof(*pack));
+    pack->MessageType = ODID_MESSAGETYPE_PACKED;
+    pack->ProtoVersion = ODID_PROTOCOL_VERSION;
+    pack->SingleMessageSize = test_random(&packSeed, 50) ? ODID_MESSAGE_SIZE : (uint8_t) test_random(&packSeed, 256);
+    pack->MsgPackSize = (uint8_t) test_random(&packSeed, ODID_PACK_MAX_MESSAGES + 2);
+    for (int i = 0; i < ODID_PACK_MAX_MESSAGES; i++) {
+        // Mostly in range Authentication pages, otherwise the decoder skips them
+        uint8_t page = test_random(&packSeed, 8) ? pages[i] : (uint8_t) test_random(&packSeed, 16);
+
+        test_fill_wire(&packSeed, pack->Messages[i].rawData, (ODID_messagetype_t) types[i], page);
+    }
+}
+
+void test_decode_pack()
+{
+    ODID_MessagePack_encoded pack;
+    ODID_UAS_Data uas, uasRef;
+    int errors = 0, acceptedPacks = 0;
+
+    printf("\n-------------------------------------Message pack----------------------------------\n");
+    for (int round = 0; round < 100000; round++) {
+        fillRandomPack(&pack);
+
+        // Same starting contents, so that untouched fields compare equal too
+        memset(&uas, 0xA5, sizeof(uas));
+        memset(&uasRef, 0xA5, sizeof(uasRef));
+        int ret = decodeMessagePack(&uas, &pack);
+        errors += ret != ref_decodeMessagePack(&uasRef, &pack);
+        errors += memcmp(&uas, &uasRef, sizeof(uas)) != 0;
+        acceptedPacks += ret == ODID_SUCCESS;
+    }
+    // Make sure both outcomes were covered
+    errors += acceptedPacks == 0 || acceptedPacks == 100000;
+
+    printf("Single pass pack decoding compared with the reference: %s (%d errors, %d accepted packs)\n",
+           errors ? "FAILED" : "PASSED", errors, acceptedPacks);
+}
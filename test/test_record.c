@@ -0,0 +1,180 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "test_util.h"
+
+static uint32_t recordSeed = 0x2EC0;
+
+// Zero the bytes after the end of a string, which a record does not carry
+static void clearTail(char *str, size_t size)
+{
+    size_t len = strnlen(str, size);
+    memset(str + len, 0, size - len);
+}
+
+static void clearTails(ODID_UAS_Data *uas)
+{
+    clearTail(uas->BasicID.UASID, sizeof(uas->BasicID.UASID));
+    for (int page = 0; page < ODID_AUTH_MAX_PAGES; page++)
+        clearTail(uas->Auth[page].AuthData, sizeof(uas->Auth[page].AuthData));
+    clearTail(uas->SelfID.Desc, sizeof(uas->SelfID.Desc));
+    clearTail(uas->OperatorID.OperatorId, sizeof(uas->OperatorID.OperatorId));
+}
+
+/**
+* Decode random wire bytes of random message types, as a receiver would
+*
+* @param uas    Output, zeroed first
+* @param raw    Output: the messages, ODID_MESSAGE_SIZE bytes each
+* @return       Number of messages
+*/
+static int randomUasData(ODID_UAS_Data *uas, uint8_t *raw)
+{
+    int count = 1 + (int) test_random(&recordSeed, 8);
+
+    memset(uas, 0, sizeof(*uas));
+    for (int i = 0; i < count; i++) {
+        uint8_t *msg = &raw[i * ODID_MESSAGE_SIZE];
+        uint32_t type = test_random(&recordSeed, ODID_MESSAGETYPE_OPERATOR_ID + 1);
+
+        test_fill_wire(&recordSeed, msg, i == 0 ? ODID_MESSAGETYPE_LOCATION : (ODID_messagetype_t) type,
+                       (uint8_t) test_random(&recordSeed, 16));
+        decodeOpenDroneID(uas, msg);
+    }
+    return count;
+}
+
+static int testRoundTrip(void)
+{
+    uint8_t raw[8 * ODID_MESSAGE_SIZE];
+    uint8_t record[ODID_RECORD_MAX_SIZE + ODID_RECORD_RAW_SIZE(8)];
+    ODID_UAS_Data uas, decoded;
+    const uint8_t *rawOut;
+    size_t rawCount;
+    int count = randomUasData(&uas, raw);
+    int passRaw = (int) test_random(&recordSeed, 2);
+    int errors = 0;
+
+    size_t size = odid_record_encode(record, sizeof(record), &uas, passRaw ? raw : NULL,
+                                     passRaw ? (size_t) count : 0);
+    if (size == 0 || size > ODID_RECORD_MAX_SIZE + (passRaw ? ODID_RECORD_RAW_SIZE((size_t) count) : 0))
+        return 1;
+
+    // Every decoded value comes back exactly
+    memset(&decoded, 0, sizeof(decoded));
+    errors += odid_record_decode(&decoded, record, sizeof(record), &rawOut, &rawCount) != size;
+    clearTails(&uas);
+    errors += memcmp(&uas, &decoded, sizeof(uas)) != 0;
+    if (passRaw)
+        errors += rawCount != (size_t) count || memcmp(rawOut, raw, rawCount * ODID_MESSAGE_SIZE) != 0;
+    else
+        errors += rawCount != 0 || rawOut != NULL;
+
+    // Encoding the decoded data gives the same record
+    uint8_t again[sizeof(record)];
+    errors += odid_record_encode(again, sizeof(again), &decoded, rawOut, rawCount) != size;
+    errors += memcmp(record, again, size) != 0;
+
+    // Truncated records and too small buffers fail without changing anything
+    for (size_t len = 0; len < size; len++) {
+        ODID_UAS_Data copy = decoded;
+
+        errors += odid_record_decode(&decoded, record, len, NULL, NULL) != 0;
+        errors += memcmp(&copy, &decoded, sizeof(copy)) != 0;
+        errors += odid_record_encode(again, len, &uas, passRaw ? raw : NULL,
+                                     passRaw ? (size_t) count : 0) != 0;
+    }
+    return errors;
+}
+
+static int testInvalid(void)
+{
+    uint8_t record[ODID_RECORD_MAX_SIZE];
+    ODID_UAS_Data uas;
+    int errors = 0;
+
+    memset(&uas, 0, sizeof(uas));
+    uas.SelfIDValid = 1;
+    strcpy(uas.SelfID.Desc, "Recreational");
+    size_t size = odid_record_encode(record, sizeof(record), &uas, NULL, 0);
+    errors += size != 3 + 2 + strlen("Recreational");
+
+    // Messages that are not in the record are no longer valid, their data is kept
+    uas.LocationValid = 1;
+    uas.Location.Direction = 90;
+    errors += odid_record_decode(&uas, record, size, NULL, NULL) != size;
+    errors += !uas.SelfIDValid || uas.LocationValid || uas.Location.Direction != 90;
+
+    record[0] = ODID_RECORD_VERSION + 1;
+    errors += odid_record_decode(&uas, record, size, NULL, NULL) != 0;
+    record[0] = ODID_RECORD_VERSION;
+    record[1] |= 1 << 7;
+    errors += odid_record_decode(&uas, record, size, NULL, NULL) != 0;
+    record[1] &= ~(1 << 7);
+
+    // Auth pages without the auth bit, and a string longer than its field
+    record[2] = 1;
+    errors += odid_record_decode(&uas, record, size, NULL, NULL) != 0;
+    record[2] = 0;
+    record[4] = ODID_STR_SIZE + 1;
+    errors += odid_record_decode(&uas, record, sizeof(record), NULL, NULL) != 0;
+
+    errors += odid_record_encode(record, sizeof(record), &uas, NULL, 1) != 0;
+    return errors;
+}
+
+// A record of the messages drone_export_gps_data() writes, compared with its JSON
+static int testSize(void)
+{
+    uint8_t raw[8 * ODID_MESSAGE_SIZE];
+    uint8_t record[ODID_RECORD_MAX_SIZE];
+    char json[ODID_JSON_MAX_SIZE];
+    ODID_Json_writer writer;
+    ODID_UAS_Data uas;
+    int errors = 0;
+
+    randomUasData(&uas, raw);
+    uas.BasicIDValid = uas.LocationValid = uas.SelfIDValid = uas.SystemValid = 1;
+    uas.AuthValid[0] = 1;
+    memset(uas.BasicID.UASID, 'U', ODID_ID_SIZE);
+    memset(uas.SelfID.Desc, 'S', ODID_STR_SIZE);
+    memset(uas.Auth[0].AuthData, 'A', ODID_STR_SIZE - ODID_AUTH_PAGE_0_DATA_SIZE);
+
+    size_t size = odid_record_encode(record, sizeof(record), &uas, NULL, 0);
+    odid_json_init(&writer, json, sizeof(json), NULL, NULL);
+    errors += odid_json_write(&writer, &uas, 0) != ODID_SUCCESS;
+    errors += size == 0 || size * 5 > writer.Length;
+
+    // The largest record without raw messages
+    uas.OperatorIDValid = 1;
+    memset(uas.AuthValid, 1, sizeof(uas.AuthValid));
+    memset(uas.OperatorID.OperatorId, 'O', ODID_ID_SIZE);
+    for (int page = 1; page < ODID_AUTH_MAX_PAGES; page++)
+        memset(uas.Auth[page].AuthData, 'A', ODID_STR_SIZE);
+    errors += odid_record_encode(record, sizeof(record), &uas, NULL, 0) != ODID_RECORD_MAX_SIZE;
+    return errors;
+}
+
+void test_record()
+{
+    int errors = 0;
+
+    printf("\n-------------------------------------Record----------------------------------------\n");
+    for (int round = 0; round < 10000; round++)
+        errors += testRoundTrip();
+    errors += testInvalid();
+    errors += testSize();
+
+    printf("Binary record round trip: %s (%d errors)\n", errors ? "FAILED" : "PASSED", errors);
+}
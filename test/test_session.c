@@ -0,0 +1,172 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "test_util.h"
+
+static uint32_t sessionSeed = 0x5E55;
+
+// Change a random subset of the data, as a sender tick would
+static void updateUasData(ODID_UAS_Data *uas)
+{
+    ODID_Location_data *loc = &uas->Location;
+    uint32_t change = test_random(&sessionSeed, 8);
+
+    if (change != 1)
+        loc->TimeStamp = test_randf(&sessionSeed, 0, 3600);
+    switch (change) {
+    case 0:
+        loc->Latitude += test_randf(&sessionSeed, -0.001f, 0.001f);
+        loc->Longitude += test_randf(&sessionSeed, -0.001f, 0.001f);
+        loc->AltitudeGeo = test_randf(&sessionSeed, 0, 500);
+        loc->Direction = test_randf(&sessionSeed, 0, 360);
+        loc->SpeedHorizontal = test_randf(&sessionSeed, 0, 255);
+        loc->SpeedVertical = test_randf(&sessionSeed, -63, 63);
+        break;
+    case 1:
+        // Below the resolution of the encoded value
+        loc->Latitude += 1e-9;
+        break;
+    case 2:
+        loc->Status = (ODID_status_t) test_random(&sessionSeed, 4);
+        loc->HorizAccuracy = (ODID_Horizontal_accuracy_t) test_random(&sessionSeed, 13);
+        loc->TSAccuracy = (ODID_Timestamp_accuracy_t) test_random(&sessionSeed, 16);
+        break;
+    case 3:
+        loc->HeightType = (ODID_Height_reference_t) test_random(&sessionSeed, 2);
+        loc->Height = test_randf(&sessionSeed, -1000, 1000);
+        loc->AltitudeBaro = test_randf(&sessionSeed, -1000, 1000);
+        break;
+    case 4:
+        uas->System.OperatorLatitude = test_randf(&sessionSeed, -90, 90);
+        uas->System.AreaRadius = (uint16_t) test_random(&sessionSeed, 3000);
+        break;
+    case 5:
+        uas->BasicID.UASID[test_random(&sessionSeed, ODID_ID_SIZE)] = (char) ('A' + test_random(&sessionSeed, 26));
+        uas->SelfID.DescType = (ODID_desctype_t) test_random(&sessionSeed, 2);
+        break;
+    case 6:
+        uas->Auth[1].AuthData[test_random(&sessionSeed, ODID_STR_SIZE)] = (char) ('a' + test_random(&sessionSeed, 26));
+        uas->AuthValid[1] = (uint8_t) test_random(&sessionSeed, 2);
+        break;
+    default:
+        // Invalid enum, must fail like encodeLocationMessage()
+        loc->VertAccuracy = (ODID_Vertical_accuracy_t) (test_random(&sessionSeed, 2) ? 16 : 3);
+        break;
+    }
+}
+
+static int checkMessage(const char *name, uint32_t bit, uint8_t valid, int result,
+                        const void *encoded, const void *sessionBytes, uint8_t *previous,
+                        uint32_t dirty, uint32_t changed, ODID_Encoder_session *session)
+{
+    int errors = 0;
+
+    if (!valid || result != ODID_SUCCESS) {
+        // Invalid messages are not encoded, failed ones keep their old bytes
+        if (!valid && (session->Encoded & bit))
+            errors++;
+        if (changed & bit)
+            errors++;
+        return errors;
+    }
+    if (memcmp(encoded, sessionBytes, ODID_MESSAGE_SIZE) != 0)
+        errors++;
+    if (!!(changed & bit) != (memcmp(previous, encoded, ODID_MESSAGE_SIZE) != 0))
+        errors++;
+    if ((changed & bit) && !(dirty & bit))
+        errors++;
+    if (errors)
+        printf("Session %s message mismatch\n", name);
+    memcpy(previous, encoded, ODID_MESSAGE_SIZE);
+    return errors;
+}
+
+void test_session()
+{
+    ODID_Encoder_session session;
+    ODID_UAS_Data uas;
+    uint8_t previous[6 + ODID_AUTH_MAX_PAGES][ODID_MESSAGE_SIZE];
+    uint32_t dirty, changed;
+    int errors = 0, belowResolution = 0;
+
+    printf("\n-------------------------------------Encoder session-------------------------------\n");
+    memset(&uas, 0, sizeof(uas));
+    memset(previous, 0, sizeof(previous));
+    strcpy(uas.BasicID.UASID, "12345678901234567890");
+    uas.BasicID.IDType = ODID_IDTYPE_SERIAL_NUMBER;
+    uas.Location.Latitude = 45.539309;
+    uas.Location.Longitude = -122.966389;
+    uas.Auth[0].AuthType = ODID_AUTH_UAS_ID_SIGNATURE;
+    uas.Auth[0].PageCount = 2;
+    uas.Auth[1].DataPage = 1;
+    strcpy(uas.Auth[1].AuthData, "abcdefghijklmnopqrstuvw");
+    strcpy(uas.SelfID.Desc, "DronesRUS: Real Estate");
+    strcpy(uas.OperatorID.OperatorId, "98765432100123456789");
+    uas.BasicIDValid = uas.LocationValid = uas.SelfIDValid = 1;
+    uas.SystemValid = uas.OperatorIDValid = uas.AuthValid[0] = uas.AuthValid[1] = 1;
+
+    odid_session_init(&session);
+    for (int tick = 0; tick < 20000; tick++) {
+        if (tick > 0)
+            updateUasData(&uas);
+        int ret = odid_session_encode(&session, &uas, &dirty, &changed);
+
+        ODID_BasicID_encoded basicID;
+        ODID_Location_encoded location;
+        ODID_Auth_encoded auth;
+        ODID_SelfID_encoded selfID;
+        ODID_System_encoded system;
+        ODID_OperatorID_encoded operatorID;
+        // The reserved bytes of some messages are left untouched by the encoders
+        memset(&basicID, 0, sizeof(basicID));
+        memset(&operatorID, 0, sizeof(operatorID));
+        int locResult = encodeLocationMessage(&location, &uas.Location);
+        int allResult = locResult;
+
+        errors += checkMessage("Location", ODID_SESSION_LOCATION, uas.LocationValid, locResult,
+                               &location, &session.Location, previous[0], dirty, changed, &session);
+        encodeBasicIDMessage(&basicID, &uas.BasicID);
+        errors += checkMessage("BasicID", ODID_SESSION_BASIC_ID, uas.BasicIDValid, ODID_SUCCESS,
+                               &basicID, &session.BasicID, previous[1], dirty, changed, &session);
+        encodeSelfIDMessage(&selfID, &uas.SelfID);
+        errors += checkMessage("SelfID", ODID_SESSION_SELF_ID, uas.SelfIDValid, ODID_SUCCESS,
+                               &selfID, &session.SelfID, previous[2], dirty, changed, &session);
+        encodeSystemMessage(&system, &uas.System);
+        errors += checkMessage("System", ODID_SESSION_SYSTEM, uas.SystemValid, ODID_SUCCESS,
+                               &system, &session.System, previous[3], dirty, changed, &session);
+        encodeOperatorIDMessage(&operatorID, &uas.OperatorID);
+        errors += checkMessage("OperatorID", ODID_SESSION_OPERATOR_ID, uas.OperatorIDValid, ODID_SUCCESS,
+                               &operatorID, &session.OperatorID, previous[4], dirty, changed, &session);
+        for (int i = 0; i < ODID_AUTH_MAX_PAGES; i++) {
+            // An invalidated message is encoded from scratch when it is valid again
+            if (!uas.AuthValid[i])
+                memset(previous[5 + i], 0, ODID_MESSAGE_SIZE);
+            encodeAuthMessage(&auth, &uas.Auth[i]);
+            errors += checkMessage("Auth", ODID_SESSION_AUTH(i), uas.AuthValid[i], ODID_SUCCESS,
+                                   &auth, &session.Auth[i], previous[5 + i], dirty, changed, &session);
+        }
+        errors += ret != (uas.LocationValid ? allResult : ODID_SUCCESS);
+
+        // A change below the encoded resolution is dirty but usually not
+        // changed on the wire. checkMessage() verified the changed bit
+        if (locResult == ODID_SUCCESS && session.LocationFields == ODID_LOC_FIELD_LATITUDE) {
+            errors += !(dirty & ODID_SESSION_LOCATION);
+            belowResolution += !(changed & ODID_SESSION_LOCATION);
+        }
+    }
+
+    errors += belowResolution == 0;
+    printf("Encoder session compared with full encodes: %s (%d errors)\n",
+           errors ? "FAILED" : "PASSED", errors);
+}
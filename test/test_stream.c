@@ -0,0 +1,202 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "test_util.h"
+
+#define STREAM_FRAMES 500
+
+static uint32_t streamSeed = 0x57AE;
+
+// Random pack with a random subset of the message types
+static size_t fillRandomPack(uint8_t *out)
+{
+    uint8_t types[ODID_PACK_MAX_MESSAGES] = { 0, 1, 2, 2, 2, 2, 2, 3, 4, 5 };
+    ODID_MessagePack_data packData;
+    int page = 0;
+
+    for (int i = ODID_PACK_MAX_MESSAGES - 1; i > 0; i--) {
+        int j = (int) test_random(&streamSeed, (uint32_t) i + 1);
+        uint8_t tmp = types[i];
+        types[i] = types[j];
+        types[j] = tmp;
+    }
+    packData.SingleMessageSize = ODID_MESSAGE_SIZE;
+    packData.MsgPackSize = (uint8_t) (1 + test_random(&streamSeed, ODID_PACK_MAX_MESSAGES));
+    for (int i = 0; i < packData.MsgPackSize; i++) {
+        uint8_t pageNum = types[i] == ODID_MESSAGETYPE_AUTH ? (uint8_t) page++ : 0;
+        test_fill_wire(&streamSeed, packData.Messages[i].rawData, types[i], pageNum);
+    }
+    encodeMessagePack((ODID_MessagePack_encoded *) out, &packData);
+    return offsetof(ODID_MessagePack_encoded, Messages) + (size_t) packData.MsgPackSize * ODID_MESSAGE_SIZE;
+}
+
+struct streamCheck {
+    const uint8_t *frames[STREAM_FRAMES];
+    size_t sizes[STREAM_FRAMES];
+    uint8_t adjacent[STREAM_FRAMES]; // Directly follows the frame before it
+    uint8_t found[STREAM_FRAMES];
+    int total;
+    int next;
+    int count;
+    int fakes;
+    int errors;
+};
+
+// Each decoded frame must be one of the frames that were put into the stream,
+// in order, or a message of a pack whose header was dropped. Frames next to
+// garbage may be missed, and rarely a false frame is made up of garbage and
+// the start of a real frame
+static void checkFrame(void *user, ODID_messagetype_t type,
+                       const uint8_t *msg, const ODID_UAS_Data *uasData)
+{
+    struct streamCheck *check = user;
+
+    for (int i = check->next; i < check->total; i++) {
+        if (memcmp(msg, check->frames[i], check->sizes[i]) != 0)
+            continue;
+        check->errors += type != decodeMessageType(check->frames[i][0]);
+        if (type == ODID_MESSAGETYPE_LOCATION)
+            check->errors += !uasData->LocationValid;
+        check->found[i] = 1;
+        check->next = i + 1;
+        check->count++;
+        return;
+    }
+    for (int i = check->next; i < check->total && i < check->next + 3; i++) {
+        if (check->sizes[i] == ODID_MESSAGE_SIZE)
+            continue;
+        for (size_t pos = offsetof(ODID_MessagePack_encoded, Messages); pos < check->sizes[i]; pos += ODID_MESSAGE_SIZE) {
+            if (memcmp(msg, &check->frames[i][pos], ODID_MESSAGE_SIZE) == 0)
+                return;
+        }
+    }
+    check->fakes++;
+}
+
+// A stray byte that looks like a frame header in front of whole messages
+static int testStrayHeader(void)
+{
+    static const uint8_t types[] = { ODID_MESSAGETYPE_BASIC_ID, ODID_MESSAGETYPE_BASIC_ID,
+                                     ODID_MESSAGETYPE_LOCATION, ODID_MESSAGETYPE_SELF_ID };
+    uint8_t stream[1 + sizeof(types) * ODID_MESSAGE_SIZE];
+    static ODID_Stream_decoder decoder;
+    static struct streamCheck check;
+    int errors = 0;
+
+    check.total = (int) sizeof(types);
+    for (int i = 0; i < (int) sizeof(types); i++) {
+        test_fill_wire(&streamSeed, &stream[1 + i * ODID_MESSAGE_SIZE], types[i], 0);
+        // Reserved bytes, which look like a Basic ID header
+        stream[(i + 1) * ODID_MESSAGE_SIZE] = 0;
+        check.frames[i] = &stream[1 + i * ODID_MESSAGE_SIZE];
+        check.sizes[i] = ODID_MESSAGE_SIZE;
+    }
+    for (int stray = 0; stray < 256; stray++) {
+        stream[0] = (uint8_t) stray;
+        check.next = check.count = check.fakes = check.errors = 0;
+        odid_stream_init(&decoder, checkFrame, &check);
+        odid_stream_push(&decoder, stream, sizeof(stream));
+        odid_stream_flush(&decoder);
+        errors += check.errors + check.fakes;
+        errors += check.count != check.total;
+        errors += decoder.Discarded != 1;
+    }
+    return errors;
+}
+
+void test_stream()
+{
+    static uint8_t stream[STREAM_FRAMES * (sizeof(ODID_MessagePack_encoded) + 32)];
+    static ODID_Stream_decoder decoder;
+    static struct streamCheck check;
+    int errors = 0, fakes = 0;
+
+    printf("\n-------------------------------------Stream decoder--------------------------------\n");
+    check.total = STREAM_FRAMES;
+    for (int round = 0; round < 200; round++) {
+        // No garbage in every fourth round, then every frame must be found
+        int clean = round % 4 == 0;
+        size_t len = 0;
+
+        for (int i = 0; i < STREAM_FRAMES; i++) {
+            // Garbage and corrupt frames between the real ones
+            switch (clean ? 20 : test_random(&streamSeed, 20)) {
+            case 0:
+                // Authentication page out of range
+                stream[len++] = (ODID_MESSAGETYPE_AUTH << 4) | ODID_PROTOCOL_VERSION;
+                stream[len++] = ODID_AUTH_MAX_PAGES | 0x08;
+                break;
+            case 1:
+                // Pack header with too many messages
+                stream[len++] = (ODID_MESSAGETYPE_PACKED << 4) | ODID_PROTOCOL_VERSION;
+                stream[len++] = ODID_MESSAGE_SIZE;
+                stream[len++] = ODID_PACK_MAX_MESSAGES + 1;
+                break;
+            case 2:
+                // Full size pack with a nested pack as first message
+                stream[len++] = (ODID_MESSAGETYPE_PACKED << 4) | ODID_PROTOCOL_VERSION;
+                stream[len++] = ODID_MESSAGE_SIZE;
+                stream[len++] = ODID_PACK_MAX_MESSAGES;
+                stream[len++] = (ODID_MESSAGETYPE_PACKED << 4) | 0x08;
+                break;
+            case 3:
+            case 4:
+            case 5:
+                // Any bytes, also ones that look like frame headers
+                for (uint32_t n = 1 + test_random(&streamSeed, 19); n > 0; n--)
+                    stream[len++] = (uint8_t) test_random(&streamSeed, 256);
+                break;
+            }
+
+            check.adjacent[i] = i > 0 && check.frames[i - 1] + check.sizes[i - 1] == &stream[len];
+            check.frames[i] = &stream[len];
+            if (test_random(&streamSeed, 4)) {
+                uint8_t type = (uint8_t) test_random(&streamSeed, ODID_MESSAGETYPE_OPERATOR_ID + 1);
+                test_fill_wire(&streamSeed, &stream[len], type, (uint8_t) test_random(&streamSeed, ODID_AUTH_MAX_PAGES));
+                check.sizes[i] = ODID_MESSAGE_SIZE;
+            } else {
+                check.sizes[i] = fillRandomPack(&stream[len]);
+            }
+            len += check.sizes[i];
+        }
+
+        memset(check.found, 0, sizeof(check.found));
+        check.next = check.count = check.fakes = check.errors = 0;
+        odid_stream_init(&decoder, checkFrame, &check);
+        // Chunks of any size, from single bytes to several packs
+        for (size_t pos = 0; pos < len;) {
+            size_t chunk = 1 + test_random(&streamSeed, round & 1 ? 8 : 600);
+            if (chunk > len - pos)
+                chunk = len - pos;
+            odid_stream_push(&decoder, &stream[pos], chunk);
+            pos += chunk;
+        }
+        odid_stream_flush(&decoder);
+        errors += check.errors;
+        errors += decoder.Length != 0;
+        if (clean)
+            errors += check.count != STREAM_FRAMES || check.fakes || decoder.Discarded;
+        // A frame with frames directly before and after it is always found
+        for (int i = 2; i < STREAM_FRAMES - 1; i++)
+            errors += check.adjacent[i - 1] && check.adjacent[i] && check.adjacent[i + 1] && !check.found[i];
+        fakes += check.fakes;
+    }
+    // False frames need a header-like byte at just the right place
+    errors += fakes > 200 * STREAM_FRAMES / 100;
+    errors += testStrayHeader();
+
+    printf("Stream decoder with random chunks and garbage: %s (%d errors)\n",
+           errors ? "FAILED" : "PASSED", errors);
+}
@@ -0,0 +1,51 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+
+#ifndef _ODID_TEST_UTIL_H_
+#define _ODID_TEST_UTIL_H_
+
+#include <stdint.h>
+#include <opendroneid.h>
+
+// Small deterministic PRNG (xorshift32). Each test keeps its own state, so its
+// inputs are the same on every run and do not depend on the other tests.
+static inline uint32_t test_rand(uint32_t *state)
+{
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// Random value from 0 to max - 1
+static inline uint32_t test_random(uint32_t *state, uint32_t max)
+{
+    return test_rand(state) % max;
+}
+
+static inline float test_randf(uint32_t *state, float min, float max)
+{
+    return min + (max - min) * (float) (test_rand(state) & 0xFFFFFF) / (float) 0xFFFFFF;
+}
+
+// Random wire bytes with a message header of the given type. For Auth
+// messages, the low nibble of the second byte is set to the page number.
+static inline void test_fill_wire(uint32_t *state, uint8_t *msg, ODID_messagetype_t type, uint8_t page)
+{
+    for (int i = 0; i < ODID_MESSAGE_SIZE; i++)
+        msg[i] = (uint8_t) test_rand(state);
+    msg[0] = (uint8_t) (type << 4) | ODID_PROTOCOL_VERSION;
+    if (type == ODID_MESSAGETYPE_AUTH)
+        msg[1] = (uint8_t) ((msg[1] & 0xF0) | (page & 0x0F));
+}
+
+#endif // _ODID_TEST_UTIL_H_
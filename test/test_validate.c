@@ -0,0 +1,87 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "test_util.h"
+
+static uint32_t validateSeed = 0xDA7A;
+
+// Random message that is valid most of the time
+static void fillRandomMessage(uint8_t *msg)
+{
+    static const uint8_t types[] = { 0, 1, 2, 2, 2, 3, 4, 5, 6, 0xF };
+    ODID_messagetype_t type = (ODID_messagetype_t) types[test_random(&validateSeed, sizeof(types))];
+    uint32_t pages = test_random(&validateSeed, 4) ? ODID_AUTH_MAX_PAGES : 16;
+
+    test_fill_wire(&validateSeed, msg, type, (uint8_t) test_random(&validateSeed, pages));
+}
+
+// What the decoders make of the pack: the types of its messages, or 0 if the
+// pack or any message in it is rejected
+static uint32_t decodePackTypes(ODID_MessagePack_encoded *pack)
+{
+    ODID_UAS_Data uas;
+    uint32_t types = 0;
+
+    if (decodeMessagePack(&uas, pack) != ODID_SUCCESS)
+        return 0;
+    for (int i = 0; i < pack->MsgPackSize; i++) {
+        ODID_messagetype_t type = decodeOpenDroneID(&uas, pack->Messages[i].rawData);
+        if (type == ODID_MESSAGETYPE_INVALID)
+            return 0;
+        types |= ODID_TYPE_BIT(type);
+    }
+    return types;
+}
+
+void test_validate()
+{
+    ODID_MessagePack_encoded pack;
+    ODID_UAS_Data uas;
+    int errors = 0, validPacks = 0;
+
+    printf("\n-------------------------------------Validation------------------------------------\n");
+    for (int round = 0; round < 200000; round++) {
+        uint8_t msg[ODID_MESSAGE_SIZE];
+        fillRandomMessage(msg);
+        ODID_messagetype_t type = decodeMessageType(msg[0]);
+        if (type != ODID_MESSAGETYPE_PACKED) {
+            type = decodeOpenDroneID(&uas, msg);
+            uint32_t expected = type == ODID_MESSAGETYPE_INVALID ? 0 : ODID_TYPE_BIT(type);
+            errors += odid_validate_message(msg) != expected;
+        }
+
+        memset(&pack, 0, sizeof(pack));
+        pack.MessageType = ODID_MESSAGETYPE_PACKED;
+        pack.ProtoVersion = ODID_PROTOCOL_VERSION;
+        pack.SingleMessageSize = test_random(&validateSeed, 50) ? ODID_MESSAGE_SIZE : (uint8_t) test_random(&validateSeed, 256);
+        pack.MsgPackSize = (uint8_t) test_random(&validateSeed, ODID_PACK_MAX_MESSAGES + 2);
+        if (!test_random(&validateSeed, 50))
+            pack.MessageType = (uint8_t) test_random(&validateSeed, 16);
+        for (int i = 0; i < ODID_PACK_MAX_MESSAGES; i++)
+            fillRandomMessage(pack.Messages[i].rawData);
+
+        uint32_t expected = decodePackTypes(&pack);
+        size_t len = 3 + (size_t) pack.MsgPackSize * ODID_MESSAGE_SIZE;
+        errors += odid_validate_pack((uint8_t *) &pack, len) != expected;
+        // Packs that do not fit in the buffer are rejected
+        if (expected)
+            errors += odid_validate_pack((uint8_t *) &pack, len - 1) != 0;
+        validPacks += expected != 0;
+    }
+    // Make sure both outcomes were covered
+    errors += validPacks == 0;
+
+    printf("Validation compared with the decoders: %s (%d errors, %d valid packs)\n",
+           errors ? "FAILED" : "PASSED", errors, validPacks);
+}
@@ -0,0 +1,108 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <opendroneid.h>
+#include "test_util.h"
+
+static uint32_t viewSeed = 0x5EED;
+
+// Random wire bytes with the given message type, which the decoders all accept
+static void fillRandomWire(uint8_t *msg, ODID_messagetype_t type)
+{
+    // Keep the auth page number in the range accepted by decodeAuthMessage()
+    test_fill_wire(&viewSeed, msg, type, (uint8_t) test_random(&viewSeed, ODID_AUTH_MAX_PAGES));
+    // Make some strings shorter than their field
+    if (msg[24] & 1)
+        msg[2 + msg[23] % ODID_ID_SIZE] = 0;
+}
+
+static int viewString(const char *view, size_t len, const char *decoded)
+{
+    return len == strlen(decoded) && memcmp(view, decoded, len) == 0;
+}
+
+void test_view()
+{
+    uint8_t msg[ODID_MESSAGE_SIZE];
+    int errors = 0;
+    size_t len;
+    const char *str;
+
+    printf("\n-------------------------------------Views-----------------------------------------\n");
+    for (int round = 0; round < 100000; round++) {
+        ODID_Location_data loc;
+        fillRandomWire(msg, ODID_MESSAGETYPE_LOCATION);
+        if (decodeLocationMessage(&loc, (ODID_Location_encoded *) msg) != ODID_SUCCESS ||
+            odid_view_message_type(msg) != ODID_MESSAGETYPE_LOCATION)
+            errors++;
+        errors += odid_loc_view_status(msg) != loc.Status;
+        errors += odid_loc_view_height_type(msg) != loc.HeightType;
+        errors += odid_loc_view_direction(msg) != loc.Direction;
+        errors += odid_loc_view_speed_horizontal(msg) != loc.SpeedHorizontal;
+        errors += odid_loc_view_speed_vertical(msg) != loc.SpeedVertical;
+        errors += odid_loc_view_lat(msg) != loc.Latitude;
+        errors += odid_loc_view_lon(msg) != loc.Longitude;
+        errors += odid_loc_view_alt_baro(msg) != loc.AltitudeBaro;
+        errors += odid_loc_view_alt_geo(msg) != loc.AltitudeGeo;
+        errors += odid_loc_view_height(msg) != loc.Height;
+        errors += odid_loc_view_horiz_accuracy(msg) != loc.HorizAccuracy;
+        errors += odid_loc_view_vert_accuracy(msg) != loc.VertAccuracy;
+        errors += odid_loc_view_baro_accuracy(msg) != loc.BaroAccuracy;
+        errors += odid_loc_view_speed_accuracy(msg) != loc.SpeedAccuracy;
+        errors += odid_loc_view_timestamp(msg) != loc.TimeStamp;
+        errors += odid_loc_view_ts_accuracy(msg) != loc.TSAccuracy;
+
+        ODID_BasicID_data basicID;
+        fillRandomWire(msg, ODID_MESSAGETYPE_BASIC_ID);
+        decodeBasicIDMessage(&basicID, (ODID_BasicID_encoded *) msg);
+        errors += odid_basicid_view_uatype(msg) != basicID.UAType;
+        errors += odid_basicid_view_idtype(msg) != basicID.IDType;
+        str = odid_basicid_view_uasid(msg, &len);
+        errors += !viewString(str, len, basicID.UASID);
+
+        ODID_Auth_data auth;
+        fillRandomWire(msg, ODID_MESSAGETYPE_AUTH);
+        errors += decodeAuthMessage(&auth, (ODID_Auth_encoded *) msg) != ODID_SUCCESS;
+        errors += odid_auth_view_page(msg) != auth.DataPage;
+        errors += odid_auth_view_type(msg) != auth.AuthType;
+
+        ODID_SelfID_data selfID;
+        fillRandomWire(msg, ODID_MESSAGETYPE_SELF_ID);
+        decodeSelfIDMessage(&selfID, (ODID_SelfID_encoded *) msg);
+        errors += odid_selfid_view_desc_type(msg) != selfID.DescType;
+        str = odid_selfid_view_desc(msg, &len);
+        errors += !viewString(str, len, selfID.Desc);
+
+        ODID_System_data system;
+        fillRandomWire(msg, ODID_MESSAGETYPE_SYSTEM);
+        decodeSystemMessage(&system, (ODID_System_encoded *) msg);
+        errors += odid_system_view_location_source(msg) != system.LocationSource;
+        errors += odid_system_view_operator_lat(msg) != system.OperatorLatitude;
+        errors += odid_system_view_operator_lon(msg) != system.OperatorLongitude;
+        errors += odid_system_view_area_count(msg) != system.AreaCount;
+        errors += odid_system_view_area_radius(msg) != system.AreaRadius;
+        errors += odid_system_view_area_ceiling(msg) != system.AreaCeiling;
+        errors += odid_system_view_area_floor(msg) != system.AreaFloor;
+
+        ODID_OperatorID_data operatorID;
+        fillRandomWire(msg, ODID_MESSAGETYPE_OPERATOR_ID);
+        decodeOperatorIDMessage(&operatorID, (ODID_OperatorID_encoded *) msg);
+        errors += odid_operatorid_view_type(msg) != operatorID.OperatorIdType;
+        str = odid_operatorid_view_id(msg, &len);
+        errors += !viewString(str, len, operatorID.OperatorId);
+    }
+
+    printf("Views compared with the decoders: %s (%d errors)\n",
+           errors ? "FAILED" : "PASSED", errors);
+}
@@ -0,0 +1,364 @@
+/*
+Copyright (C) 2019 Intel Corporation
+
+SPDX-License-Identifier: Apache-2.0
+
+Open Drone ID C Library
+
+Maintainer:
+Gabriel Cox
+gabriel.c.cox@intel.com
+*/
+#include <string.h>
+#include <stdio.h>
+#include <stddef.h>
+#include <errno.h>
+#include <opendroneid.h>
+#include "test_util.h"
+
+static uint32_t wifiSeed = 0x11A4;
+
+// Decoded random wire bytes of a message, as a receiver would have them
+static void randomMessage(ODID_UAS_Data *uas, ODID_messagetype_t type, int page)
+{
+    uint8_t msg[ODID_MESSAGE_SIZE];
+
+    test_fill_wire(&wifiSeed, msg, type, (uint8_t) page);
+    decodeOpenDroneID(uas, msg);
+}
+
+// Random data of every message, of which a random selection is valid. The
+// Location message always is
+static void randomUasData(ODID_UAS_Data *uas)
+{
+    memset(uas, 0, sizeof(*uas));
+    for (int type = ODID_MESSAGETYPE_BASIC_ID; type <= ODID_MESSAGETYPE_OPERATOR_ID; type++)
+        randomMessage(uas, (ODID_messagetype_t) type, 0);
+    for (int page = 1; page < ODID_AUTH_MAX_PAGES; page++)
+        randomMessage(uas, ODID_MESSAGETYPE_AUTH, page);
+
+    uas->BasicIDValid = test_random(&wifiSeed, 2);
+    for (int page = 0; page < ODID_AUTH_MAX_PAGES; page++)
+        uas->AuthValid[page] = test_random(&wifiSeed, 2);
+    uas->SelfIDValid = test_random(&wifiSeed, 2);
+    uas->SystemValid = test_random(&wifiSeed, 2);
+    uas->OperatorIDValid = test_random(&wifiSeed, 2);
+}
+
+static int countValid(const ODID_UAS_Data *uas)
+{
+    int count = uas->BasicIDValid + uas->LocationValid + uas->SelfIDValid +
+                uas->SystemValid + uas->OperatorIDValid;
+
+    for (int page = 0; page < ODID_AUTH_MAX_PAGES; page++)
+        count += uas->AuthValid[page];
+    return count;
+}
+
+static int sameValid(const ODID_UAS_Data *a, const ODID_UAS_Data *b)
+{
+    return a->BasicIDValid == b->BasicIDValid && a->LocationValid == b->LocationValid &&
+           memcmp(a->AuthValid, b->AuthValid, sizeof(a->AuthValid)) == 0 &&
+           a->SelfIDValid == b->SelfIDValid && a->SystemValid == b->SystemValid &&
+           a->OperatorIDValid == b->OperatorIDValid;
+}
+
+// A pack holds every valid message and decodes to the same messages
+static int testPackContent(void)
+{
+    uint8_t pack[sizeof(ODID_MessagePack_encoded)];
+    uint8_t again[sizeof(ODID_MessagePack_encoded)];
+    ODID_UAS_Data uas, decoded;
+    int errors = 0;
+
+    randomUasData(&uas);
+    int count = countValid(&uas);
+    int len = odid_message_encode_pack(&uas, pack, sizeof(pack));
+    errors += len != (int) offsetof(ODID_MessagePack_encoded, Messages) + count * ODID_MESSAGE_SIZE;
+    if (len <= 0)
+        return errors + 1;
+    errors += decodeMessageType(pack[0]) != ODID_MESSAGETYPE_PACKED;
+    errors += (pack[0] & 0x0F) != ODID_PROTOCOL_VERSION;
+    errors += odid_validate_pack(pack, (size_t) len) == 0;
+
+    // In the order Basic ID, Location, Auth pages, Self ID, System, Operator ID
+    const uint8_t *msgs = pack + offsetof(ODID_MessagePack_encoded, Messages);
+    int previous = -1;
+    for (int i = 0; i < count; i++) {
+        const uint8_t *msg = msgs + i * ODID_MESSAGE_SIZE;
+        int order = decodeMessageType(msg[0]);
+        if (order > ODID_MESSAGETYPE_AUTH)
+            order += ODID_AUTH_MAX_PAGES;
+        else if (order == ODID_MESSAGETYPE_AUTH)
+            order += msg[1] & 0x0F;
+        errors += order <= previous;
+        previous = order;
+    }
+
+    // Decoded like each message on its own
+    ODID_UAS_Data single;
+    memset(&decoded, 0, sizeof(decoded));
+    memset(&single, 0, sizeof(single));
+    errors += odid_message_decode_pack(&decoded, pack, (size_t) len) != 0;
+    for (int i = 0; i < count; i++)
+        decodeOpenDroneID(&single, (uint8_t *) msgs + i * ODID_MESSAGE_SIZE);
+    errors += !sameValid(&uas, &decoded);
+    errors += memcmp(&decoded, &single, sizeof(single)) != 0;
+
+    // Short buffers on both sides
+    errors += odid_message_encode_pack(&uas, again, (size_t) len - 1) != -ENOMEM;
+    errors += odid_message_decode_pack(&decoded, pack, (size_t) len - 1) != -ENOMEM;
+    return errors;
+}
+
+static int testPackInvalid(void)
+{
+    uint8_t pack[sizeof(ODID_MessagePack_encoded)];
+    ODID_UAS_Data uas;
+    int errors = 0;
+
+    // Nothing to send
+    memset(&uas, 0, sizeof(uas));
+    errors += odid_message_encode_pack(&uas, pack, sizeof(pack)) != -EINVAL;
+
+    // A valid message that cannot be encoded
+    uas.LocationValid = 1;
+    uas.Location.Status = (ODID_status_t) 16;
+    errors += odid_message_encode_pack(&uas, pack, sizeof(pack)) != -EINVAL;
+    uas.Location.Status = ODID_STATUS_AIRBORNE;
+    int len = odid_message_encode_pack(&uas, pack, sizeof(pack));
+    errors += len != (int) offsetof(ODID_MessagePack_encoded, Messages) + ODID_MESSAGE_SIZE;
+
+    // Message counts that do not fit a pack, and a pack that is not one
+    pack[2] = 0;
+    errors += odid_message_decode_pack(&uas, pack, sizeof(pack)) != -EINVAL;
+    pack[2] = ODID_PACK_MAX_MESSAGES + 1;
+    errors += odid_message_decode_pack(&uas, pack, sizeof(pack)) != -EINVAL;
+    pack[2] = 1;
+    pack[0] = (uint8_t) (ODID_MESSAGETYPE_LOCATION << 4) | ODID_PROTOCOL_VERSION;
+    errors += odid_message_decode_pack(&uas, pack, sizeof(pack)) != -EINVAL;
+    return errors;
+}
+
+// The prepared frame is always the frame odid_wifi_build_message_pack_nan_action_frame()
+// builds, when the changed messages are passed to each update
+static int testPreparedFrame(void)
+{
+    char mac[6] = { 0x02, 0x00, 0x00, 0x0D, 0x1D, 0x00 };
+    uint8_t built[1024];
+    struct odid_nan_frame frame;
+    ODID_UAS_Data uas;
+    int errors = 0;
+
+    mac[5] = (char) test_random(&wifiSeed, 256);
+    randomUasData(&uas);
+    errors += odid_wifi_prepare_message_pack_nan_action_frame(&frame, mac) != 0;
+    errors += frame.len != 0;
+
+    for (int tick = 0; tick < 100; tick++) {
+        uint32_t changed = 0;
+        uint8_t counter = (uint8_t) tick;
+
+        // Mostly a new location, sometimes another message as well, and
+        // sometimes a message that is no longer or again valid
+        if (test_random(&wifiSeed, 4)) {
+            randomMessage(&uas, ODID_MESSAGETYPE_LOCATION, 0);
+            changed |= ODID_TYPE_BIT(ODID_MESSAGETYPE_LOCATION);
+        }
+        if (!test_random(&wifiSeed, 10)) {
+            ODID_messagetype_t type = (ODID_messagetype_t) test_random(&wifiSeed, ODID_MESSAGETYPE_OPERATOR_ID + 1);
+            randomMessage(&uas, type, (int) test_random(&wifiSeed, ODID_AUTH_MAX_PAGES));
+            changed |= ODID_TYPE_BIT(type);
+        }
+        if (!test_random(&wifiSeed, 20))
+            uas.AuthValid[test_random(&wifiSeed, ODID_AUTH_MAX_PAGES)] ^= 1;
+        if (!test_random(&wifiSeed, 20))
+            uas.OperatorIDValid ^= 1;
+
+        int len = odid_wifi_update_message_pack_nan_action_frame(&frame, &uas, counter, changed);
+        int builtLen = odid_wifi_build_message_pack_nan_action_frame(&uas, mac, counter,
+                                                                     built, sizeof(built));
+        errors += builtLen <= 0 || len != builtLen || frame.len != len;
+        errors += memcmp(frame.buf, built, (size_t) builtLen) != 0;
+        errors += frame.buf[ODID_NAN_HEADER_SIZE - 1] != counter;
+    }
+
+    // Messages left out of the changed types keep their last encoding
+    ODID_UAS_Data before = uas;
+    randomMessage(&uas, ODID_MESSAGETYPE_SELF_ID, 0);
+    uas.SelfIDValid = before.SelfIDValid;
+    odid_wifi_update_message_pack_nan_action_frame(&frame, &uas, 0, 0);
+    odid_wifi_build_message_pack_nan_action_frame(&before, mac, 0, built, sizeof(built));
+    errors += memcmp(frame.buf, built, (size_t) frame.len) != 0;
+
+    // And the frame is received like a built one
+    ODID_UAS_Data received;
+    char source[6];
+    memset(&received, 0, sizeof(received));
+    errors += odid_wifi_receive_message_pack_nan_action_frame(&received, source, frame.buf,
+                                                              (size_t) frame.len) != 0;
+    errors += memcmp(source, mac, sizeof(mac)) != 0;
+    errors += !sameValid(&received, &uas);
+    return errors;
+}
+
+// The parser accepts the frames the receive function accepts and points at
+// their messages
+static int testParseFrame(void)
+{
+    char mac[6] = { 0x02, 0x00, 0x00, 0x0D, 0x1D, 0x00 };
+    uint8_t frame[1024];
+    struct odid_nan_frame_view view;
+    ODID_UAS_Data uas, received;
+    char source[6];
+    int errors = 0;
+
+    mac[5] = (char) test_random(&wifiSeed, 256);
+    randomUasData(&uas);
+    uint8_t counter = (uint8_t) test_random(&wifiSeed, 256);
+    int len = odid_wifi_build_message_pack_nan_action_frame(&uas, mac, counter, frame, sizeof(frame));
+    if (len <= 0)
+        return 1;
+
+    if (odid_wifi_parse_message_pack_nan_action_frame(&view, frame, (size_t) len) != 0)
+        return 1;
+    errors += memcmp(view.mac, mac, sizeof(mac)) != 0 || view.message_counter != counter;
+    errors += view.pack != frame + ODID_NAN_HEADER_SIZE || view.pack_len != (size_t) len - ODID_NAN_HEADER_SIZE;
+    errors += view.count != countValid(&uas);
+    errors += view.types != odid_validate_pack(view.pack, view.pack_len);
+    for (int i = 0; i < view.count; i++)
+        errors += view.messages[i] != view.pack + offsetof(ODID_MessagePack_encoded, Messages) + i * ODID_MESSAGE_SIZE;
+
+    // Only the addresses, duration, sequence control, attribute length,
+    // requestor instance ID, counter and messages may change
+    for (int offset = 0; offset < (int) ODID_NAN_HEADER_SIZE + 3; offset++) {
+        int variable = (offset >= 1 && offset <= 23) || offset == 31 || offset == 32 ||
+                       offset == 40 || offset == 43;
+        frame[offset] ^= 0xFF;
+        errors += (odid_wifi_parse_message_pack_nan_action_frame(&view, frame, (size_t) len) == 0) != variable;
+        frame[offset] ^= 0xFF;
+    }
+
+    // With a changed byte or length both accept the same frames
+    size_t size = (size_t) len;
+    if (test_random(&wifiSeed, 2))
+        frame[test_random(&wifiSeed, (uint32_t) len)] ^= (uint8_t) (1 << test_random(&wifiSeed, 8));
+    else
+        size = test_random(&wifiSeed, (uint32_t) len + 1);
+    memset(&received, 0, sizeof(received));
+    int parsed = odid_wifi_parse_message_pack_nan_action_frame(&view, frame, size) == 0;
+    int decoded = odid_wifi_receive_message_pack_nan_action_frame(&received, source, frame, size) == 0;
+    errors += decoded && !parsed;
+    if (parsed)
+        errors += decoded != (decodeMessagePack(&received, (ODID_MessagePack_encoded *) view.pack) == ODID_SUCCESS);
+    return errors;
+}
+
+#define BATCH_FRAMES 64
+
+// Each frame of a batch gets the result of the single frame functions
+static int testBatch(void)
+{
+    static uint8_t frames[BATCH_FRAMES][1024];
+    static ODID_UAS_Data uas[BATCH_FRAMES];
+    struct odid_wifi_frame in[BATCH_FRAMES] = { 0 };
+    int status[BATCH_FRAMES];
+    uint8_t macs[BATCH_FRAMES][6];
+    uint8_t counters[BATCH_FRAMES];
+    uint64_t timestamps[BATCH_FRAMES];
+    int8_t rssi[BATCH_FRAMES];
+    struct odid_wifi_batch out = { status, macs, counters, timestamps, rssi, uas };
+    size_t count = test_random(&wifiSeed, BATCH_FRAMES + 1);
+    int errors = 0, expected = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        char mac[6] = { 0x02, 0x00, 0x00, 0x0D, 0x1D, (char) i };
+        ODID_UAS_Data data;
+        int len;
+
+        // ODID frames, some of them damaged, and other frames
+        randomUasData(&data);
+        len = odid_wifi_build_message_pack_nan_action_frame(&data, mac, (uint8_t) test_random(&wifiSeed, 256),
+                                                            frames[i], sizeof(frames[i]));
+        switch (test_random(&wifiSeed, 4)) {
+        case 0:
+            len = 24 + (int) test_random(&wifiSeed, 300);
+            for (int j = 0; j < len; j++)
+                frames[i][j] = (uint8_t) test_random(&wifiSeed, 256);
+            break;
+        case 1:
+            frames[i][test_random(&wifiSeed, (uint32_t) len)] ^= (uint8_t) (1 << test_random(&wifiSeed, 8));
+            break;
+        default:
+            break;
+        }
+        in[i].buf = frames[i];
+        in[i].len = (size_t) len;
+        in[i].timestamp = test_random(&wifiSeed, 1000000);
+        in[i].rssi = (int8_t) -test_random(&wifiSeed, 100);
+    }
+
+    int decoded = odid_wifi_receive_nan_batch(&out, in, count);
+    for (size_t i = 0; i < count; i++) {
+        struct odid_nan_frame_view view;
+        ODID_UAS_Data single;
+        char source[6];
+
+        memset(&single, 0, sizeof(single));
+        int ret = odid_wifi_receive_message_pack_nan_action_frame(&single, source, frames[i], in[i].len);
+        int parsed = odid_wifi_parse_message_pack_nan_action_frame(&view, frames[i], in[i].len) == 0;
+        errors += (status[i] == 0) != (ret == 0);
+        errors += status[i] != (parsed ? (ret == 0 ? 0 : -EBADMSG) : -EINVAL);
+        errors += timestamps[i] != in[i].timestamp || rssi[i] != in[i].rssi;
+        if (ret == 0) {
+            expected++;
+            errors += memcmp(macs[i], source, sizeof(source)) != 0;
+            errors += counters[i] != view.message_counter;
+            errors += memcmp(&uas[i], &single, sizeof(single)) != 0;
+        }
+    }
+    errors += decoded != expected;
+
+    // Without decoding, every frame that parses counts
+    out.uas = NULL;
+    expected = 0;
+    decoded = odid_wifi_receive_nan_batch(&out, in, count);
+    for (size_t i = 0; i < count; i++) {
+        struct odid_nan_frame_view view;
+        int ret = odid_wifi_parse_message_pack_nan_action_frame(&view, frames[i], in[i].len);
+        errors += status[i] != ret;
+        expected += ret == 0;
+    }
+    errors += decoded != expected;
+    return errors;
+}
+
+void test_wifi()
+{
+    int errors = 0;
+
+    printf("\n-------------------------------------WiFi------------------------------------------\n");
+    for (int round = 0; round < 10000; round++)
+        errors += testPackContent();
+    errors += testPackInvalid();
+
+    printf("Message packs of the valid messages: %s (%d errors)\n", errors ? "FAILED" : "PASSED", errors);
+
+    errors = 0;
+    for (int round = 0; round < 1000; round++)
+        errors += testPreparedFrame();
+
+    printf("Prepared NAN action frame: %s (%d errors)\n", errors ? "FAILED" : "PASSED", errors);
+
+    errors = 0;
+    for (int round = 0; round < 10000; round++)
+        errors += testParseFrame();
+
+    printf("NAN action frame parser: %s (%d errors)\n", errors ? "FAILED" : "PASSED", errors);
+
+    errors = 0;
+    for (int round = 0; round < 1000; round++)
+        errors += testBatch();
+
+    printf("NAN action frame batches: %s (%d errors)\n", errors ? "FAILED" : "PASSED", errors);
+}
@@ -0,0 +1,176 @@
+#include <errno.h>
+#include <string.h>
+
+#include "capture.h"
+
+#define RADIOTAP_TSFT		0
+#define RADIOTAP_FLAGS		1
+#define RADIOTAP_RATE		2
+#define RADIOTAP_CHANNEL	3
+#define RADIOTAP_FHSS		4
+#define RADIOTAP_DBM_ANTSIGNAL	5
+#define RADIOTAP_EXT		31
+
+/* largest 802.11 MPDU, VHT */
+#define IEEE80211_MAX_FRAME_LEN	11454
+
+#define RADIOTAP_F_FCS		0x10
+#define RADIOTAP_F_BADFCS	0x40
+
+/* alignment and size of the fields up to the antenna signal */
+static const struct {
+	uint8_t align;
+	uint8_t size;
+} radiotap_fields[] = {
+	[RADIOTAP_TSFT] = { 8, 8 },
+	[RADIOTAP_FLAGS] = { 1, 1 },
+	[RADIOTAP_RATE] = { 1, 1 },
+	[RADIOTAP_CHANNEL] = { 2, 4 },
+	[RADIOTAP_FHSS] = { 1, 2 },
+	[RADIOTAP_DBM_ANTSIGNAL] = { 1, 1 },
+};
+
+static uint32_t get_le32(const uint8_t *p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * radiotap_parse - read the header length, flags and signal of a radiotap header
+ * @buf: captured data, starting with the radiotap header
+ * @len: length of the captured data
+ * @info: output
+ *
+ * Only the fields of the first presence word are looked at. Their data comes
+ * first, so the words of extended and vendor namespaces do not matter.
+ *
+ * Return: 0 on success, -EINVAL if the header is malformed
+ */
+int radiotap_parse(const uint8_t *buf, size_t len, struct radiotap_info *info)
+{
+	size_t header_len, offset;
+	uint32_t present;
+	unsigned int bit;
+
+	memset(info, 0, sizeof(*info));
+
+	if (len < 8 || buf[0] != 0)
+		return -EINVAL;
+
+	header_len = buf[2] | (buf[3] << 8);
+	if (header_len < 8 || header_len > len)
+		return -EINVAL;
+
+	/* skip the presence words, the last one has the extension bit clear */
+	present = get_le32(buf + 4);
+	offset = 8;
+	for (uint32_t word = present; word & (1u << RADIOTAP_EXT); offset += 4) {
+		if (offset + 4 > header_len)
+			return -EINVAL;
+		word = get_le32(buf + offset);
+	}
+
+	for (bit = 0; bit <= RADIOTAP_DBM_ANTSIGNAL; bit++) {
+		if (!(present & (1u << bit)))
+			continue;
+
+		offset = (offset + radiotap_fields[bit].align - 1) &
+			 ~(size_t)(radiotap_fields[bit].align - 1);
+		if (offset + radiotap_fields[bit].size > header_len)
+			return -EINVAL;
+
+		if (bit == RADIOTAP_FLAGS) {
+			info->fcs = !!(buf[offset] & RADIOTAP_F_FCS);
+			info->bad_fcs = !!(buf[offset] & RADIOTAP_F_BADFCS);
+		} else if (bit == RADIOTAP_DBM_ANTSIGNAL) {
+			info->rssi = (int8_t)buf[offset];
+		}
+		offset += radiotap_fields[bit].size;
+	}
+
+	info->header_len = header_len;
+	return 0;
+}
+
+/**
+ * capture_frame - find the 802.11 frame in captured data
+ * @linktype: LINKTYPE_IEEE802_11 or LINKTYPE_IEEE802_11_RADIOTAP
+ * @data: captured data
+ * @len: length of the captured data
+ * @frame: output, @frame->buf points into @data. The timestamp is left alone
+ *
+ * Strips the radiotap header and the FCS, and takes the signal strength from
+ * the radiotap header.
+ *
+ * Return: 0 on success, -EINVAL for malformed data or frames with a bad FCS,
+ * -EPROTONOSUPPORT for other link types
+ */
+int capture_frame(uint32_t linktype, const uint8_t *data, size_t len,
+		  struct odid_wifi_frame *frame)
+{
+	struct radiotap_info info;
+	int ret;
+
+	switch (linktype) {
+	case LINKTYPE_IEEE802_11:
+		frame->buf = data;
+		frame->len = len;
+		frame->rssi = 0;
+		return 0;
+	case LINKTYPE_IEEE802_11_RADIOTAP:
+		ret = radiotap_parse(data, len, &info);
+		if (ret < 0)
+			return ret;
+		if (info.bad_fcs)
+			return -EINVAL;
+
+		frame->buf = data + info.header_len;
+		frame->len = len - info.header_len;
+		frame->rssi = info.rssi;
+		if (info.fcs) {
+			if (frame->len < 4)
+				return -EINVAL;
+			frame->len -= 4;
+		}
+		return 0;
+	default:
+		return -EPROTONOSUPPORT;
+	}
+}
+
+/**
+ * capture_write_frame - add an 802.11 frame to a capture file
+ * @writer: writer of link type LINKTYPE_IEEE802_11 or LINKTYPE_IEEE802_11_RADIOTAP
+ * @frame: frame, its timestamp in nanoseconds since the epoch
+ *
+ * For radiotap, the frame gets a header with the antenna signal, or an empty
+ * header if @frame->rssi is 0.
+ *
+ * Return: 0 on success, negative errno on failure, -EPROTONOSUPPORT for other
+ * link types
+ */
+int capture_write_frame(struct pcap_writer *writer, const struct odid_wifi_frame *frame)
+{
+	uint8_t buf[9 + IEEE80211_MAX_FRAME_LEN];
+	size_t header_len;
+
+	switch (writer->linktype) {
+	case LINKTYPE_IEEE802_11:
+		return pcap_writer_write(writer, frame->buf, frame->len, frame->timestamp);
+	case LINKTYPE_IEEE802_11_RADIOTAP:
+		header_len = frame->rssi ? 9 : 8;
+		if (frame->len > sizeof(buf) - header_len)
+			return -EMSGSIZE;
+
+		memset(buf, 0, 8);
+		buf[2] = header_len;
+		if (frame->rssi) {
+			buf[4] = 1 << RADIOTAP_DBM_ANTSIGNAL;
+			buf[8] = (uint8_t)frame->rssi;
+		}
+		memcpy(buf + header_len, frame->buf, frame->len);
+		return pcap_writer_write(writer, buf, header_len + frame->len, frame->timestamp);
+	default:
+		return -EPROTONOSUPPORT;
+	}
+}
@@ -0,0 +1,34 @@
+#ifndef _CAPTURE_H_
+#define _CAPTURE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <opendroneid.h>
+
+#include "pcap.h"
+
+/* link types of captured 802.11 frames, as in pcap files */
+#define LINKTYPE_IEEE802_11		105
+#define LINKTYPE_IEEE802_11_RADIOTAP	127
+
+/**
+ * struct radiotap_info - fields of a radiotap header used by the receivers
+ * @header_len: length of the radiotap header, the 802.11 frame follows
+ * @rssi: antenna signal in dBm, 0 if not present
+ * @fcs: the frame ends with its 4 byte FCS
+ * @bad_fcs: the frame failed the FCS check
+ */
+struct radiotap_info {
+	size_t header_len;
+	int8_t rssi;
+	int fcs;
+	int bad_fcs;
+};
+
+int radiotap_parse(const uint8_t *buf, size_t len, struct radiotap_info *info);
+int capture_frame(uint32_t linktype, const uint8_t *data, size_t len,
+		  struct odid_wifi_frame *frame);
+int capture_write_frame(struct pcap_writer *writer, const struct odid_wifi_frame *frame);
+
+#endif /* _CAPTURE_H_ */
@@ -0,0 +1,572 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "pcap.h"
+
+#define PCAP_FILE_HEADER_SIZE	24
+#define PCAP_RECORD_HEADER_SIZE	16
+
+#define PCAPNG_BLOCK_SHB	0x0a0d0d0a
+#define PCAPNG_BLOCK_IDB	0x00000001
+#define PCAPNG_BLOCK_SPB	0x00000003
+#define PCAPNG_BLOCK_EPB	0x00000006
+
+#define PCAPNG_OPT_END		0
+#define PCAPNG_OPT_IF_TSRESOL	9
+#define PCAPNG_TSRESOL_USEC	6
+#define PCAPNG_TSRESOL_NSEC	9
+
+static uint16_t pcap_get16(const struct pcap_reader *reader, const uint8_t *p)
+{
+	uint16_t value;
+
+	memcpy(&value, p, sizeof(value));
+	return reader->swapped ? __builtin_bswap16(value) : value;
+}
+
+static uint32_t pcap_get32(const struct pcap_reader *reader, const uint8_t *p)
+{
+	uint32_t value;
+
+	memcpy(&value, p, sizeof(value));
+	return reader->swapped ? __builtin_bswap32(value) : value;
+}
+
+/**
+ * pcap_path_format - choose the file format by the file name
+ * @path: file name
+ *
+ * Return: PCAP_FORMAT_PCAPNG for names ending in .pcapng, otherwise
+ * PCAP_FORMAT_PCAP
+ */
+enum pcap_format pcap_path_format(const char *path)
+{
+	size_t len = strlen(path);
+
+	if (len >= 7 && strcmp(path + len - 7, ".pcapng") == 0)
+		return PCAP_FORMAT_PCAPNG;
+
+	return PCAP_FORMAT_PCAP;
+}
+
+/**
+ * pcapng_timestamp - convert a timestamp to nanoseconds
+ * @tsresol: if_tsresol of the interface, a negative power of 10, or of 2 if
+ *	     the top bit is set
+ * @units: timestamp in units of @tsresol
+ */
+static uint64_t pcapng_timestamp(uint8_t tsresol, uint64_t units)
+{
+	unsigned int exp = tsresol & 0x7f;
+	uint64_t scale = 1;
+	unsigned int i;
+
+	if (tsresol & 0x80) {
+		if (exp >= 64)
+			return 0;
+		return (units >> exp) * 1000000000ULL +
+		       (uint64_t)((double)(units & ((1ULL << exp) - 1)) * 1e9 / (double)(1ULL << exp));
+	}
+
+	if (exp <= 9) {
+		for (i = exp; i < 9; i++)
+			scale *= 10;
+		return units * scale;
+	}
+
+	for (i = 9; i < exp && scale <= UINT64_MAX / 10; i++)
+		scale *= 10;
+	return units / scale;
+}
+
+/**
+ * pcapng_section - start a section at a section header block
+ * @reader: reader
+ * @block: the block
+ *
+ * The byte order magic sets the byte order of the section, including the
+ * length of the block itself. The interfaces of the previous section end.
+ */
+static int pcapng_section(struct pcap_reader *reader, const uint8_t *block)
+{
+	uint32_t magic;
+
+	if (reader->size - reader->offset < 28)
+		return -EINVAL;
+
+	memcpy(&magic, block + 8, sizeof(magic));
+	if (magic == PCAPNG_BYTE_ORDER_MAGIC)
+		reader->swapped = 0;
+	else if (__builtin_bswap32(magic) == PCAPNG_BYTE_ORDER_MAGIC)
+		reader->swapped = 1;
+	else
+		return -EINVAL;
+
+	reader->interface_count = 0;
+	return 0;
+}
+
+/**
+ * pcapng_interface - add the interface of an interface description block
+ * @reader: reader
+ * @block: the block
+ * @len: length of the block
+ *
+ * Interfaces beyond PCAPNG_MAX_INTERFACES are counted but not described,
+ * their packets are skipped.
+ */
+static int pcapng_interface(struct pcap_reader *reader, const uint8_t *block, uint32_t len)
+{
+	unsigned int index = reader->interface_count;
+	uint32_t offset = 16;
+
+	if (len < 20)
+		return -EINVAL;
+
+	reader->interface_count++;
+	if (index >= PCAPNG_MAX_INTERFACES)
+		return 0;
+
+	reader->interfaces[index].linktype = pcap_get16(reader, block + 8);
+	reader->interfaces[index].tsresol = PCAPNG_TSRESOL_USEC;
+
+	/* options up to the trailing block length */
+	while (offset + 4 <= len - 4) {
+		uint16_t code = pcap_get16(reader, block + offset);
+		uint16_t olen = pcap_get16(reader, block + offset + 2);
+
+		if (code == PCAPNG_OPT_END || olen > len - 4 - offset - 4)
+			break;
+		if (code == PCAPNG_OPT_IF_TSRESOL && olen >= 1)
+			reader->interfaces[index].tsresol = block[offset + 4];
+		offset += 4 + ((olen + 3) & ~3u);
+	}
+
+	return 0;
+}
+
+static int pcapng_next(struct pcap_reader *reader, struct pcap_packet *packet)
+{
+	const uint8_t *block;
+	uint32_t type, len, interface, caplen;
+	uint64_t units;
+	int ret;
+
+	for (;;) {
+		if (reader->offset == reader->size)
+			return 0;
+		if (reader->size - reader->offset < 12)
+			return -EINVAL;
+
+		block = reader->map + reader->offset;
+
+		/* the section header block type reads the same in both byte orders */
+		memcpy(&type, block, sizeof(type));
+		if (type == PCAPNG_BLOCK_SHB) {
+			ret = pcapng_section(reader, block);
+			if (ret < 0)
+				return ret;
+		} else if (reader->offset == 0) {
+			return -EINVAL;
+		}
+
+		type = pcap_get32(reader, block);
+		len = pcap_get32(reader, block + 4);
+		if (len < 12 || len % 4 != 0 || len > reader->size - reader->offset)
+			return -EINVAL;
+		reader->offset += len;
+
+		switch (type) {
+		case PCAPNG_BLOCK_IDB:
+			ret = pcapng_interface(reader, block, len);
+			if (ret < 0)
+				return ret;
+			break;
+		case PCAPNG_BLOCK_EPB:
+			if (len < 32)
+				return -EINVAL;
+			interface = pcap_get32(reader, block + 8);
+			caplen = pcap_get32(reader, block + 20);
+			if (caplen > len - 32)
+				return -EINVAL;
+			if (interface >= reader->interface_count ||
+			    interface >= PCAPNG_MAX_INTERFACES)
+				break;
+
+			units = (uint64_t)pcap_get32(reader, block + 12) << 32 |
+				pcap_get32(reader, block + 16);
+			packet->data = block + 28;
+			packet->len = caplen;
+			packet->orig_len = pcap_get32(reader, block + 24);
+			packet->timestamp = pcapng_timestamp(reader->interfaces[interface].tsresol, units);
+			packet->linktype = reader->interfaces[interface].linktype;
+			return 1;
+		case PCAPNG_BLOCK_SPB:
+			/* no timestamp, always from the first interface */
+			if (len < 16)
+				return -EINVAL;
+			if (reader->interface_count == 0)
+				break;
+
+			packet->data = block + 12;
+			packet->orig_len = pcap_get32(reader, block + 8);
+			packet->len = packet->orig_len < len - 16 ? packet->orig_len : len - 16;
+			packet->timestamp = 0;
+			packet->linktype = reader->interfaces[0].linktype;
+			return 1;
+		default:
+			break;
+		}
+	}
+}
+
+static int pcap_next_record(struct pcap_reader *reader, struct pcap_packet *packet)
+{
+	const uint8_t *record;
+	uint32_t len;
+
+	if (reader->offset == reader->size)
+		return 0;
+	if (reader->size - reader->offset < PCAP_RECORD_HEADER_SIZE)
+		return -EINVAL;
+
+	record = reader->map + reader->offset;
+	len = pcap_get32(reader, record + 8);
+	if (len > reader->size - reader->offset - PCAP_RECORD_HEADER_SIZE)
+		return -EINVAL;
+
+	packet->data = record + PCAP_RECORD_HEADER_SIZE;
+	packet->len = len;
+	packet->orig_len = pcap_get32(reader, record + 12);
+	packet->timestamp = pcap_get32(reader, record) * 1000000000ULL +
+			    (uint64_t)pcap_get32(reader, record + 4) * reader->ts_scale;
+	packet->linktype = reader->linktype;
+
+	reader->offset += PCAP_RECORD_HEADER_SIZE + len;
+	return 1;
+}
+
+/**
+ * pcap_reader_open - map a pcap or pcapng file and read its header
+ * @reader: reader to initialize
+ * @path: file to read
+ *
+ * For pcapng files, the blocks up to the first packet are read to find the
+ * link type of the first interface.
+ *
+ * Return: 0 on success, negative errno on failure, -EINVAL if the file is not
+ * a pcap or pcapng file
+ */
+int pcap_reader_open(struct pcap_reader *reader, const char *path)
+{
+	struct pcap_reader peek;
+	struct pcap_packet packet;
+	struct stat st;
+	uint32_t magic;
+	void *map;
+	int ret = 0;
+	int fd;
+
+	memset(reader, 0, sizeof(*reader));
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		return -errno;
+
+	if (fstat(fd, &st) < 0) {
+		ret = -errno;
+		goto out;
+	}
+	if (st.st_size < PCAP_FILE_HEADER_SIZE) {
+		ret = -EINVAL;
+		goto out;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		ret = -errno;
+		goto out;
+	}
+	madvise(map, st.st_size, MADV_SEQUENTIAL);
+	reader->map = map;
+	reader->size = st.st_size;
+
+	memcpy(&magic, reader->map, sizeof(magic));
+	if (magic == PCAPNG_BLOCK_SHB) {
+		reader->format = PCAP_FORMAT_PCAPNG;
+		peek = *reader;
+		ret = pcapng_next(&peek, &packet);
+		if (ret < 0) {
+			pcap_reader_close(reader);
+			goto out;
+		}
+		reader->linktype = peek.interface_count ? peek.interfaces[0].linktype : 0;
+		ret = 0;
+		goto out;
+	}
+
+	reader->format = PCAP_FORMAT_PCAP;
+	if (magic == PCAP_MAGIC_USEC || magic == PCAP_MAGIC_NSEC) {
+		reader->swapped = 0;
+	} else if (__builtin_bswap32(magic) == PCAP_MAGIC_USEC ||
+		   __builtin_bswap32(magic) == PCAP_MAGIC_NSEC) {
+		reader->swapped = 1;
+		magic = __builtin_bswap32(magic);
+	} else {
+		pcap_reader_close(reader);
+		ret = -EINVAL;
+		goto out;
+	}
+
+	reader->ts_scale = magic == PCAP_MAGIC_NSEC ? 1 : 1000;
+	reader->linktype = pcap_get32(reader, reader->map + 20) & 0xffff;
+	reader->offset = PCAP_FILE_HEADER_SIZE;
+
+out:
+	close(fd);
+	return ret;
+}
+
+/**
+ * pcap_reader_next - return the next packet of the file
+ * @reader: reader
+ * @packet: output, @packet->data points into the mapped file
+ *
+ * Packets of pcapng simple packet blocks have no timestamp, it is 0.
+ *
+ * Return: 1 if a packet was returned, 0 at the end of the file, -EINVAL if the
+ * file is truncated or a record is malformed
+ */
+int pcap_reader_next(struct pcap_reader *reader, struct pcap_packet *packet)
+{
+	if (reader->format == PCAP_FORMAT_PCAPNG)
+		return pcapng_next(reader, packet);
+
+	return pcap_next_record(reader, packet);
+}
+
+/**
+ * pcap_reader_rewind - go back to the first packet
+ * @reader: reader
+ */
+void pcap_reader_rewind(struct pcap_reader *reader)
+{
+	if (reader->format == PCAP_FORMAT_PCAPNG) {
+		reader->offset = 0;
+		reader->interface_count = 0;
+	} else {
+		reader->offset = PCAP_FILE_HEADER_SIZE;
+	}
+}
+
+/**
+ * pcap_reader_close - unmap the file
+ * @reader: reader
+ */
+void pcap_reader_close(struct pcap_reader *reader)
+{
+	if (reader->map)
+		munmap((void *)reader->map, reader->size);
+	reader->map = NULL;
+	reader->size = 0;
+}
+
+static void pcap_put(struct pcap_writer *writer, const void *data, size_t len)
+{
+	memcpy(writer->buf + writer->len, data, len);
+	writer->len += len;
+}
+
+static void pcap_put16(struct pcap_writer *writer, uint16_t value)
+{
+	pcap_put(writer, &value, sizeof(value));
+}
+
+static void pcap_put32(struct pcap_writer *writer, uint32_t value)
+{
+	pcap_put(writer, &value, sizeof(value));
+}
+
+/**
+ * pcap_writer_open - create a capture file and write its header
+ * @writer: writer to initialize
+ * @path: file to create, an existing file is overwritten
+ * @format: PCAP_FORMAT_PCAP or PCAP_FORMAT_PCAPNG
+ * @linktype: link type of all packets, e.g. LINKTYPE_IEEE802_11
+ *
+ * pcap files get the nanosecond magic, pcapng files one section with one
+ * interface of nanosecond resolution. Both in host byte order.
+ *
+ * Return: 0 on success, negative errno on failure
+ */
+int pcap_writer_open(struct pcap_writer *writer, const char *path,
+		     enum pcap_format format, uint32_t linktype)
+{
+	static const uint8_t padding[3];
+	int ret;
+
+	memset(writer, 0, sizeof(*writer));
+	writer->fd = -1;
+	writer->format = format;
+	writer->linktype = linktype;
+
+	writer->buf = malloc(PCAP_WRITER_BUFFER_SIZE);
+	if (!writer->buf)
+		return -ENOMEM;
+
+	writer->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (writer->fd < 0) {
+		ret = -errno;
+		free(writer->buf);
+		writer->buf = NULL;
+		return ret;
+	}
+
+	if (format == PCAP_FORMAT_PCAP) {
+		pcap_put32(writer, PCAP_MAGIC_NSEC);
+		pcap_put16(writer, 2);
+		pcap_put16(writer, 4);
+		pcap_put32(writer, 0);		/* thiszone */
+		pcap_put32(writer, 0);		/* sigfigs */
+		pcap_put32(writer, PCAP_SNAPLEN);
+		pcap_put32(writer, linktype);
+		return 0;
+	}
+
+	pcap_put32(writer, PCAPNG_BLOCK_SHB);
+	pcap_put32(writer, 28);
+	pcap_put32(writer, PCAPNG_BYTE_ORDER_MAGIC);
+	pcap_put16(writer, 1);
+	pcap_put16(writer, 0);
+	pcap_put32(writer, 0xffffffff);	/* section length unknown */
+	pcap_put32(writer, 0xffffffff);
+	pcap_put32(writer, 28);
+
+	pcap_put32(writer, PCAPNG_BLOCK_IDB);
+	pcap_put32(writer, 32);
+	pcap_put16(writer, linktype);
+	pcap_put16(writer, 0);
+	pcap_put32(writer, PCAP_SNAPLEN);
+	pcap_put16(writer, PCAPNG_OPT_IF_TSRESOL);
+	pcap_put16(writer, 1);
+	pcap_put(writer, &(uint8_t){ PCAPNG_TSRESOL_NSEC }, 1);
+	pcap_put(writer, padding, 3);
+	pcap_put16(writer, PCAPNG_OPT_END);
+	pcap_put16(writer, 0);
+	pcap_put32(writer, 32);
+
+	return 0;
+}
+
+/**
+ * pcap_writer_write - add a packet
+ * @writer: writer
+ * @data: packet, starting with the header of the writer's link type
+ * @len: length of the packet, at most PCAP_SNAPLEN
+ * @timestamp: receive or send time in nanoseconds since the epoch
+ *
+ * The packet is copied to the buffer, which is written to the file first if
+ * the packet does not fit.
+ *
+ * Return: 0 on success, -EMSGSIZE if the packet is too long, negative errno if
+ * writing the buffer failed
+ */
+int pcap_writer_write(struct pcap_writer *writer, const uint8_t *data, size_t len,
+		      uint64_t timestamp)
+{
+	static const uint8_t padding[3];
+	size_t pad = (4 - len % 4) % 4;
+	size_t record;
+	int ret;
+
+	if (len > PCAP_SNAPLEN)
+		return -EMSGSIZE;
+
+	if (writer->format == PCAP_FORMAT_PCAP)
+		record = PCAP_RECORD_HEADER_SIZE + len;
+	else
+		record = 32 + len + pad;
+
+	if (writer->len + record > PCAP_WRITER_BUFFER_SIZE) {
+		ret = pcap_writer_flush(writer);
+		if (ret < 0)
+			return ret;
+	}
+
+	if (writer->format == PCAP_FORMAT_PCAP) {
+		pcap_put32(writer, timestamp / 1000000000ULL);
+		pcap_put32(writer, timestamp % 1000000000ULL);
+		pcap_put32(writer, len);
+		pcap_put32(writer, len);
+		pcap_put(writer, data, len);
+	} else {
+		pcap_put32(writer, PCAPNG_BLOCK_EPB);
+		pcap_put32(writer, record);
+		pcap_put32(writer, 0);		/* interface */
+		pcap_put32(writer, timestamp >> 32);
+		pcap_put32(writer, timestamp);
+		pcap_put32(writer, len);
+		pcap_put32(writer, len);
+		pcap_put(writer, data, len);
+		pcap_put(writer, padding, pad);
+		pcap_put32(writer, record);
+	}
+	writer->packets++;
+
+	return 0;
+}
+
+/**
+ * pcap_writer_flush - write the buffered packets to the file
+ * @writer: writer
+ *
+ * Return: 0 on success, negative errno on failure. The buffer is emptied
+ * either way
+ */
+int pcap_writer_flush(struct pcap_writer *writer)
+{
+	size_t done = 0;
+	ssize_t ret;
+
+	while (done < writer->len) {
+		ret = write(writer->fd, writer->buf + done, writer->len - done);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			writer->len = 0;
+			return -errno;
+		}
+		done += ret;
+	}
+	writer->len = 0;
+
+	return 0;
+}
+
+/**
+ * pcap_writer_close - write the remaining packets and close the file
+ * @writer: writer, may be one that was never opened
+ *
+ * Return: 0 on success, negative errno if writing or closing failed
+ */
+int pcap_writer_close(struct pcap_writer *writer)
+{
+	int ret;
+
+	if (!writer->buf)
+		return 0;
+
+	ret = pcap_writer_flush(writer);
+	if (close(writer->fd) < 0 && ret == 0)
+		ret = -errno;
+	writer->fd = -1;
+	free(writer->buf);
+	writer->buf = NULL;
+
+	return ret;
+}
@@ -0,0 +1,89 @@
+#ifndef _PCAP_H_
+#define _PCAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define PCAP_MAGIC_USEC		0xa1b2c3d4
+#define PCAP_MAGIC_NSEC		0xa1b23c4d
+#define PCAPNG_BYTE_ORDER_MAGIC	0x1a2b3c4d
+
+#define PCAPNG_MAX_INTERFACES	16
+#define PCAP_WRITER_BUFFER_SIZE	(256 * 1024)
+#define PCAP_SNAPLEN		65535
+
+enum pcap_format {
+	PCAP_FORMAT_PCAP,
+	PCAP_FORMAT_PCAPNG,
+};
+
+/**
+ * struct pcap_packet - a packet of a capture file
+ * @data: captured data, in the mapped file
+ * @len: length of the captured data
+ * @orig_len: length of the packet on the wire
+ * @timestamp: receive time in nanoseconds since the epoch
+ * @linktype: link type of the packet, e.g. LINKTYPE_IEEE802_11_RADIOTAP
+ */
+struct pcap_packet {
+	const uint8_t *data;
+	size_t len;
+	size_t orig_len;
+	uint64_t timestamp;
+	uint32_t linktype;
+};
+
+/*
+ * Reader of pcap and pcapng files. The file is memory mapped and the packets
+ * are returned in place, without copying. In pcapng files, each interface has
+ * its own link type and timestamp resolution, and each section its own byte
+ * order.
+ */
+struct pcap_reader {
+	const uint8_t *map;
+	size_t size;
+	size_t offset;		/* of the next record or block */
+	enum pcap_format format;
+	int swapped;		/* written on a host of the other byte order */
+	uint32_t linktype;	/* of the file, or of the first pcapng interface */
+
+	/* pcap */
+	uint32_t ts_scale;	/* nanoseconds per unit of the fraction field */
+
+	/* pcapng, interfaces of the current section */
+	unsigned int interface_count;
+	struct {
+		uint32_t linktype;
+		uint8_t tsresol;	/* if_tsresol option, 6 if absent */
+	} interfaces[PCAPNG_MAX_INTERFACES];
+};
+
+/*
+ * Writer of pcap and pcapng files with one link type and nanosecond
+ * timestamps. Packets are collected in a buffer, which is written to the file
+ * when it is full and on close.
+ */
+struct pcap_writer {
+	int fd;
+	enum pcap_format format;
+	uint32_t linktype;
+	uint8_t *buf;
+	size_t len;
+	uint64_t packets;
+};
+
+enum pcap_format pcap_path_format(const char *path);
+
+int pcap_reader_open(struct pcap_reader *reader, const char *path);
+int pcap_reader_next(struct pcap_reader *reader, struct pcap_packet *packet);
+void pcap_reader_rewind(struct pcap_reader *reader);
+void pcap_reader_close(struct pcap_reader *reader);
+
+int pcap_writer_open(struct pcap_writer *writer, const char *path,
+		     enum pcap_format format, uint32_t linktype);
+int pcap_writer_write(struct pcap_writer *writer, const uint8_t *data, size_t len,
+		      uint64_t timestamp);
+int pcap_writer_flush(struct pcap_writer *writer);
+int pcap_writer_close(struct pcap_writer *writer);
+
+#endif /* _PCAP_H_ */
@@ -0,0 +1,298 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+
+#include <opendroneid.h>
+
+#include "capture.h"
+#include "pcap.h"
+
+#define DEFAULT_BATCH	256
+#define MAX_BATCH	4096
+
+struct global {
+	const char *pcap_path;
+	const char *out_path;
+	double speed;		/* 0: as fast as possible */
+	int loops;
+	int batch_size;
+
+	struct pcap_writer out;
+
+	/* the batch */
+	struct odid_wifi_frame *frames;
+	int *status;
+	ODID_UAS_Data *uas;
+	struct odid_wifi_batch batch;
+	int count;
+
+	/* statistics */
+	uint64_t packets;
+	uint64_t frames_80211;
+	uint64_t odid_frames;
+	uint64_t decode_errors;
+	uint64_t write_errors;
+	uint64_t max_lag;	/* nanoseconds behind the paced schedule */
+};
+
+static volatile sig_atomic_t stop;
+
+static void handle_signal(int sig)
+{
+	stop = 1;
+}
+
+void usage(char *name)
+{
+	fprintf(stderr,"%s [options] FILE\n", name);
+	fprintf(stderr,"\tFILE\tpcap or pcapng file with radiotap or 802.11 frames\n");
+	fprintf(stderr,"\t-s\treplay at this multiple of real time, 0 for as fast as possible (default: 0)\n");
+	fprintf(stderr,"\t-l\treplay the file this many times (default: 1)\n");
+	fprintf(stderr,"\t-b\tframes per batch (default: %d)\n", DEFAULT_BATCH);
+	fprintf(stderr,"\t-o\twrite the ODID frames to a radiotap capture, pcapng if the name ends in .pcapng\n");
+}
+
+int read_arguments(int argc, char *argv[], struct global *global)
+{
+	int opt;
+
+	global->loops = 1;
+	global->batch_size = DEFAULT_BATCH;
+
+	while((opt = getopt(argc, argv, "hs:l:b:o:")) != -1) {
+		switch (opt) {
+		case 'h':
+			usage(argv[0]);
+			exit(0);
+			break;
+		case 's':
+			global->speed = atof(optarg);
+			break;
+		case 'l':
+			global->loops = atoi(optarg);
+			break;
+		case 'b':
+			global->batch_size = atoi(optarg);
+			break;
+		case 'o':
+			global->out_path = optarg;
+			break;
+		default:
+			return -1;
+		}
+	}
+
+	if (optind != argc - 1 || global->speed < 0 || global->loops < 1 ||
+	    global->batch_size < 1 || global->batch_size > MAX_BATCH)
+		return -1;
+	global->pcap_path = argv[optind];
+
+	return 0;
+}
+
+static uint64_t clock_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t deadline)
+{
+	struct timespec ts;
+
+	ts.tv_sec = deadline / 1000000000ULL;
+	ts.tv_nsec = deadline % 1000000000ULL;
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR && !stop)
+		;
+}
+
+/**
+ * replay_flush - decode the collected frames
+ * @global: the batch
+ *
+ * All frames go through odid_wifi_receive_nan_batch(), which parses and
+ * decodes them as a receiver would. The ODID frames are then written to the
+ * output file, if any.
+ */
+static void replay_flush(struct global *global)
+{
+	int i;
+
+	if (global->count == 0)
+		return;
+
+	global->odid_frames += odid_wifi_receive_nan_batch(&global->batch, global->frames,
+							   global->count);
+
+	for (i = 0; i < global->count; i++) {
+		if (global->status[i] == -EBADMSG)
+			global->decode_errors++;
+		if (global->out_path && global->status[i] == 0 &&
+		    capture_write_frame(&global->out, &global->frames[i]) < 0)
+			global->write_errors++;
+	}
+	global->count = 0;
+}
+
+/**
+ * replay_file - feed the packets of the file through the decoder
+ * @global: global state
+ * @reader: the file, rewound to the first packet
+ *
+ * When pacing, a frame due later than now ends the batch: the frames before it
+ * are decoded and the replay sleeps until the frame is due. The gap between
+ * two packets is divided by the speed.
+ *
+ * Return: 0 at the end of the file, -EINVAL if it is truncated or malformed
+ */
+static int replay_file(struct global *global, struct pcap_reader *reader)
+{
+	struct odid_wifi_frame *frame;
+	struct pcap_packet packet;
+	uint64_t start = 0, first = 0, due, now;
+	int ret = 0;
+
+	while (!stop && (ret = pcap_reader_next(reader, &packet)) > 0) {
+		global->packets++;
+
+		if (global->speed > 0) {
+			if (start == 0) {
+				start = clock_ns();
+				first = packet.timestamp;
+			}
+			due = start;
+			if (packet.timestamp > first)
+				due += (uint64_t)((packet.timestamp - first) / global->speed);
+
+			now = clock_ns();
+			if (due > now) {
+				replay_flush(global);
+				sleep_until(due);
+			} else if (now - due > global->max_lag) {
+				global->max_lag = now - due;
+			}
+		}
+
+		frame = &global->frames[global->count];
+		if (capture_frame(packet.linktype, packet.data, packet.len, frame) < 0)
+			continue;
+		frame->timestamp = packet.timestamp;
+		global->frames_80211++;
+
+		if (++global->count == global->batch_size)
+			replay_flush(global);
+	}
+	replay_flush(global);
+
+	return ret < 0 ? -EINVAL : 0;
+}
+
+static int replay_alloc(struct global *global)
+{
+	global->frames = calloc(global->batch_size, sizeof(*global->frames));
+	global->status = calloc(global->batch_size, sizeof(*global->status));
+	global->uas = calloc(global->batch_size, sizeof(*global->uas));
+	if (!global->frames || !global->status || !global->uas)
+		return -ENOMEM;
+
+	global->batch.status = global->status;
+	global->batch.uas = global->uas;
+
+	return 0;
+}
+
+static void replay_free(struct global *global)
+{
+	free(global->frames);
+	free(global->status);
+	free(global->uas);
+}
+
+int main(int argc, char *argv[])
+{
+	struct pcap_reader reader;
+	struct global global;
+	uint64_t start;
+	double seconds;
+	int ret;
+	int loop;
+
+	memset(&global, 0, sizeof(global));
+
+	if (read_arguments(argc, argv, &global) < 0) {
+		usage(argv[0]);
+		return -1;
+	}
+
+	if (replay_alloc(&global) < 0) {
+		fprintf(stderr, "%s: Couldn't allocate the batch\n", argv[0]);
+		replay_free(&global);
+		return -1;
+	}
+
+	ret = pcap_reader_open(&reader, global.pcap_path);
+	if (ret < 0) {
+		fprintf(stderr, "%s: Couldn't read %s: %s\n", argv[0], global.pcap_path,
+			strerror(-ret));
+		replay_free(&global);
+		return -1;
+	}
+
+	if (global.out_path) {
+		ret = pcap_writer_open(&global.out, global.out_path,
+				       pcap_path_format(global.out_path),
+				       LINKTYPE_IEEE802_11_RADIOTAP);
+		if (ret < 0) {
+			fprintf(stderr, "%s: Couldn't create %s: %s\n", argv[0],
+				global.out_path, strerror(-ret));
+			goto out;
+		}
+	}
+
+	signal(SIGINT, handle_signal);
+	signal(SIGTERM, handle_signal);
+
+	start = clock_ns();
+	for (loop = 0; loop < global.loops && !stop; loop++) {
+		pcap_reader_rewind(&reader);
+		ret = replay_file(&global, &reader);
+		if (ret < 0) {
+			fprintf(stderr, "%s: truncated or malformed record\n", global.pcap_path);
+			break;
+		}
+	}
+	seconds = (clock_ns() - start) / 1e9;
+
+	printf("%llu packets, %llu 802.11 frames, %llu ODID frames, %llu decode errors\n",
+	       (unsigned long long)global.packets,
+	       (unsigned long long)global.frames_80211,
+	       (unsigned long long)global.odid_frames,
+	       (unsigned long long)global.decode_errors);
+	printf("%.3f s, %.0f frames/s, %.0f ODID frames/s\n", seconds,
+	       seconds > 0 ? global.frames_80211 / seconds : 0,
+	       seconds > 0 ? global.odid_frames / seconds : 0);
+	if (global.speed > 0)
+		printf("%gx real time, at most %.3f ms behind\n", global.speed,
+		       global.max_lag / 1e6);
+
+	if (global.out_path) {
+		if (pcap_writer_close(&global.out) < 0 || global.write_errors)
+			fprintf(stderr, "%s: Couldn't write all frames to %s\n", argv[0],
+				global.out_path);
+		else
+			printf("%llu ODID frames written to %s\n",
+			       (unsigned long long)global.out.packets, global.out_path);
+	}
+
+out:
+	pcap_reader_close(&reader);
+	replay_free(&global);
+
+	return ret < 0 ? -1 : 0;
+}
@@ -0,0 +1,186 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "drones.h"
+
+static unsigned int drone_hash(const struct drone_table *table, const uint8_t *mac)
+{
+	uint64_t key = 0;
+
+	memcpy(&key, mac, 6);
+	return (unsigned int)((key * 0x9E3779B97F4A7C15ULL) >> 32) & (table->size - 1);
+}
+
+/**
+ * drone_table_init - allocate an empty table
+ * @table: table to initialize
+ * @size: number of slots, rounded up to a power of two
+ *
+ * Return: 0 on success, -ENOMEM if the slots cannot be allocated
+ */
+int drone_table_init(struct drone_table *table, unsigned int size)
+{
+	memset(table, 0, sizeof(*table));
+
+	table->size = 16;
+	while (table->size < size)
+		table->size <<= 1;
+
+	table->drones = calloc(table->size, sizeof(*table->drones));
+	if (!table->drones)
+		return -ENOMEM;
+
+	return 0;
+}
+
+/**
+ * drone_table_get - find the drone with a MAC address, add it if it is new
+ * @table: table
+ * @mac: sender address, 6 bytes
+ *
+ * New drones start with no frames and no valid messages.
+ *
+ * Return: the drone, NULL if it is new and the table is full
+ */
+struct drone *drone_table_get(struct drone_table *table, const uint8_t *mac)
+{
+	unsigned int mask = table->size - 1;
+	unsigned int i = drone_hash(table, mac);
+	struct drone *drone;
+
+	for (;; i = (i + 1) & mask) {
+		drone = &table->drones[i];
+		if (!drone->used)
+			break;
+		if (memcmp(drone->mac, mac, 6) == 0)
+			return drone;
+	}
+
+	/* keep a quarter free, for short probe sequences */
+	if (table->count >= table->size / 4 * 3) {
+		table->full++;
+		return NULL;
+	}
+
+	memset(drone, 0, sizeof(*drone));
+	memcpy(drone->mac, mac, 6);
+	drone->used = 1;
+	table->count++;
+
+	return drone;
+}
+
+/**
+ * drone_table_remove - empty a slot and move later drones of the same probe
+ * sequence back, so lookups still find them
+ * @table: table
+ * @i: slot to empty
+ */
+static void drone_table_remove(struct drone_table *table, unsigned int i)
+{
+	unsigned int mask = table->size - 1;
+	unsigned int j = i;
+	unsigned int home;
+
+	table->count--;
+	for (;;) {
+		table->drones[i].used = 0;
+		for (;;) {
+			j = (j + 1) & mask;
+			if (!table->drones[j].used)
+				return;
+
+			/* stays if its home slot is cyclically in (i, j] */
+			home = drone_hash(table, table->drones[j].mac);
+			if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+				continue;
+			break;
+		}
+		table->drones[i] = table->drones[j];
+		i = j;
+	}
+}
+
+/**
+ * drone_table_expire - remove the drones not seen for a while
+ * @table: table
+ * @now: current time, in nanoseconds
+ * @max_age: remove drones with no frame for longer than this, in nanoseconds
+ *
+ * Return: number of drones removed
+ */
+unsigned int drone_table_expire(struct drone_table *table, uint64_t now, uint64_t max_age)
+{
+	unsigned int removed = 0;
+	unsigned int i = 0;
+
+	while (i < table->size) {
+		struct drone *drone = &table->drones[i];
+
+		if (drone->used && now > drone->last_seen && now - drone->last_seen > max_age) {
+			/* a later drone may have moved into the slot, look again */
+			drone_table_remove(table, i);
+			removed++;
+			continue;
+		}
+		i++;
+	}
+
+	return removed;
+}
+
+/**
+ * drone_table_print - write one line per drone
+ * @table: table
+ * @fp: output
+ * @now: current time, in nanoseconds, for the age column
+ */
+void drone_table_print(struct drone_table *table, FILE *fp, uint64_t now)
+{
+	unsigned int i;
+
+	fprintf(fp, "%-17s %-20s %11s %12s %7s %6s %5s %9s %7s %6s\n",
+		"MAC", "UAS ID", "Latitude", "Longitude", "Alt(m)", "Speed",
+		"RSSI", "Frames", "Dup", "Age(s)");
+
+	for (i = 0; i < table->size; i++) {
+		struct drone *drone = &table->drones[i];
+		const uint8_t *m = drone->mac;
+		char id[ODID_ID_SIZE + 1];
+		double age;
+
+		if (!drone->used)
+			continue;
+
+		if (drone->uas.BasicIDValid)
+			snprintf(id, sizeof(id), "%s", drone->uas.BasicID.UASID);
+		else
+			strcpy(id, "-");
+		age = now > drone->last_seen ? (now - drone->last_seen) / 1e9 : 0;
+
+		fprintf(fp, "%02x:%02x:%02x:%02x:%02x:%02x %-20s ",
+			m[0], m[1], m[2], m[3], m[4], m[5], id);
+		if (drone->uas.LocationValid)
+			fprintf(fp, "%11.6f %12.6f %7.1f %6.1f ",
+				drone->uas.Location.Latitude, drone->uas.Location.Longitude,
+				drone->uas.Location.AltitudeGeo,
+				drone->uas.Location.SpeedHorizontal);
+		else
+			fprintf(fp, "%11s %12s %7s %6s ", "-", "-", "-", "-");
+		fprintf(fp, "%5d %9llu %7llu %6.1f\n", drone->rssi,
+			(unsigned long long)drone->frames,
+			(unsigned long long)drone->duplicates, age);
+	}
+}
+
+/**
+ * drone_table_free - free the slots
+ * @table: table
+ */
+void drone_table_free(struct drone_table *table)
+{
+	free(table->drones);
+	table->drones = NULL;
+	table->size = table->count = 0;
+}
@@ -0,0 +1,53 @@
+#ifndef _DRONES_H_
+#define _DRONES_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <opendroneid.h>
+
+#define DRONES_DEFAULT_SIZE	1024
+
+/**
+ * struct drone - a drone seen by the scanner
+ * @mac: sender address of its frames
+ * @used: the table slot holds a drone
+ * @message_counter: counter of the last frame
+ * @rssi: signal strength of the last frame
+ * @first_seen: receive time of the first frame, in nanoseconds
+ * @last_seen: receive time of the last frame, in nanoseconds
+ * @frames: frames with a new counter, decoded into @uas
+ * @duplicates: frames repeating the counter of the frame before
+ * @uas: the messages of all frames, each type as last received
+ */
+struct drone {
+	uint8_t mac[6];
+	uint8_t used;
+	uint8_t message_counter;
+	int8_t rssi;
+	uint64_t first_seen;
+	uint64_t last_seen;
+	uint64_t frames;
+	uint64_t duplicates;
+	ODID_UAS_Data uas;
+};
+
+/*
+ * Drones by MAC address, in an open addressing hash table with linear
+ * probing. The table never grows: when it is full, frames of new drones are
+ * counted in @full and ignored until old drones expire.
+ */
+struct drone_table {
+	struct drone *drones;
+	unsigned int size;	/* power of two */
+	unsigned int count;
+	uint64_t full;
+};
+
+int drone_table_init(struct drone_table *table, unsigned int size);
+struct drone *drone_table_get(struct drone_table *table, const uint8_t *mac);
+unsigned int drone_table_expire(struct drone_table *table, uint64_t now, uint64_t max_age);
+void drone_table_print(struct drone_table *table, FILE *fp, uint64_t now);
+void drone_table_free(struct drone_table *table);
+
+#endif /* _DRONES_H_ */
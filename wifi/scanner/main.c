@@ -0,0 +1,360 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+
+#include <net/if.h>
+
+#include <opendroneid.h>
+
+#include "capture.h"
+#include "pcap.h"
+#include "drones.h"
+#include "ring.h"
+
+#define DEFAULT_INTERVAL	1
+#define DEFAULT_EXPIRE		60
+#define RING_POLL_MS		100
+#define EXPIRE_PERIOD_NS	1000000000ULL
+
+struct global {
+	char wlan_iface[IFNAMSIZ];
+	const char *pcap_path;
+	int loops;
+	int interval;
+	int expire;
+	int quiet;
+	unsigned int block_size;
+	unsigned int block_count;
+	unsigned int table_size;
+
+	uint32_t linktype;
+	struct drone_table drones;
+
+	/* statistics */
+	uint64_t packets;
+	uint64_t malformed;
+	uint64_t odid_frames;
+	uint64_t duplicates;
+	uint64_t decode_errors;
+	uint64_t ring_packets;
+	uint64_t ring_drops;
+};
+
+static volatile sig_atomic_t stop;
+
+static void handle_signal(int sig)
+{
+	stop = 1;
+}
+
+void usage(char *name)
+{
+	fprintf(stderr,"%s\n", name);
+	fprintf(stderr,"\t-w\tmonitor interface (default: mon0)\n");
+	fprintf(stderr,"\t-r\tread frames from a pcap or pcapng file instead, as fast as possible\n");
+	fprintf(stderr,"\t-l\tread the pcap file this many times (default: 1)\n");
+	fprintf(stderr,"\t-t\tprint the drones every this many seconds, 0 to print them at the end only (default: %d)\n", DEFAULT_INTERVAL);
+	fprintf(stderr,"\t-e\tforget drones not seen for this many seconds (default: %d)\n", DEFAULT_EXPIRE);
+	fprintf(stderr,"\t-b\tring block size, in bytes (default: %d)\n", RING_DEFAULT_BLOCK_SIZE);
+	fprintf(stderr,"\t-n\tnumber of ring blocks (default: %d)\n", RING_DEFAULT_BLOCK_COUNT);
+	fprintf(stderr,"\t-s\tmaximum number of drones (default: %d)\n", DRONES_DEFAULT_SIZE);
+	fprintf(stderr,"\t-q\tprint the statistics only\n");
+}
+
+int read_arguments(int argc, char *argv[], struct global *global)
+{
+	int opt;
+
+	strncpy(global->wlan_iface, "mon0", sizeof(global->wlan_iface) - 1);
+	global->loops = 1;
+	global->interval = DEFAULT_INTERVAL;
+	global->expire = DEFAULT_EXPIRE;
+	global->block_size = RING_DEFAULT_BLOCK_SIZE;
+	global->block_count = RING_DEFAULT_BLOCK_COUNT;
+	global->table_size = DRONES_DEFAULT_SIZE;
+
+	while((opt = getopt(argc, argv, "hw:r:l:t:e:b:n:s:q")) != -1) {
+		switch (opt) {
+		case 'h':
+			usage(argv[0]);
+			exit(0);
+			break;
+		case 'w':
+			strncpy(global->wlan_iface, optarg, sizeof(global->wlan_iface) - 1);
+			break;
+		case 'r':
+			global->pcap_path = optarg;
+			break;
+		case 'l':
+			global->loops = atoi(optarg);
+			break;
+		case 't':
+			global->interval = atoi(optarg);
+			break;
+		case 'e':
+			global->expire = atoi(optarg);
+			break;
+		case 'b':
+			global->block_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			global->block_count = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			global->table_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'q':
+			global->quiet = 1;
+			break;
+		default:
+			return -1;
+		}
+	}
+
+	if (global->loops < 1 || global->interval < 0 || global->expire < 1)
+		return -1;
+
+	return 0;
+}
+
+static uint64_t clock_ns(clockid_t clock)
+{
+	struct timespec ts;
+
+	clock_gettime(clock, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/**
+ * handle_packet - take the ODID frames of a captured packet into the drone table
+ * @user: global state
+ * @data: captured packet, with the header of the link type
+ * @len: length of the captured packet
+ * @timestamp: receive time in nanoseconds since the epoch
+ *
+ * Frames are parsed in place. A frame repeating the counter of the drone's last
+ * frame, e.g. a retransmission, is not decoded again. Other frames are decoded
+ * straight into the drone, so messages missing from a frame keep their last
+ * value.
+ */
+static void handle_packet(void *user, const uint8_t *data, size_t len, uint64_t timestamp)
+{
+	struct global *global = user;
+	struct odid_nan_frame_view view;
+	struct odid_wifi_frame frame;
+	struct drone *drone;
+
+	global->packets++;
+
+	if (capture_frame(global->linktype, data, len, &frame) < 0) {
+		global->malformed++;
+		return;
+	}
+
+	if (odid_wifi_parse_message_pack_nan_action_frame(&view, frame.buf, frame.len) < 0)
+		return;
+	global->odid_frames++;
+
+	drone = drone_table_get(&global->drones, view.mac);
+	if (!drone)
+		return;
+
+	if (drone->frames > 0 && view.message_counter == drone->message_counter) {
+		drone->duplicates++;
+		global->duplicates++;
+	} else if (decodeMessagePack(&drone->uas, (ODID_MessagePack_encoded *)view.pack) == ODID_SUCCESS) {
+		drone->frames++;
+		drone->message_counter = view.message_counter;
+	} else {
+		global->decode_errors++;
+	}
+
+	if (!drone->last_seen)
+		drone->first_seen = timestamp;
+	drone->last_seen = timestamp;
+	drone->rssi = frame.rssi;
+}
+
+static void print_stats(struct global *global, FILE *fp)
+{
+	fprintf(fp, "%llu packets, %llu ODID frames, %llu duplicates, %llu decode errors, "
+		"%llu malformed or not 802.11, %u drones",
+		(unsigned long long)global->packets,
+		(unsigned long long)global->odid_frames,
+		(unsigned long long)global->duplicates,
+		(unsigned long long)global->decode_errors,
+		(unsigned long long)global->malformed,
+		global->drones.count);
+	if (global->drones.full)
+		fprintf(fp, ", %llu frames of new drones ignored, table full",
+			(unsigned long long)global->drones.full);
+	if (!global->pcap_path)
+		fprintf(fp, ", ring: %llu packets, %llu dropped",
+			(unsigned long long)global->ring_packets,
+			(unsigned long long)global->ring_drops);
+	fprintf(fp, "\n");
+}
+
+static void print_drones(struct global *global, uint64_t now)
+{
+	drone_table_expire(&global->drones, now, global->expire * 1000000000ULL);
+
+	if (!global->quiet) {
+		/* redraw in place on a terminal */
+		if (isatty(STDOUT_FILENO))
+			printf("\033[H\033[2J");
+		drone_table_print(&global->drones, stdout, now);
+	}
+	print_stats(global, stdout);
+	fflush(stdout);
+}
+
+/**
+ * scan_interface - take the ODID frames received on the monitor interface
+ * @global: global state
+ *
+ * Drones not seen for the expire time are forgotten every second, whether or
+ * not they are printed, so the table does not fill up with drones that left.
+ */
+static int scan_interface(struct global *global)
+{
+	struct tpacket_stats_v3 stats;
+	struct ring ring;
+	uint64_t next_print, next_expire, now;
+	int ret;
+
+	ret = ring_open(&ring, global->wlan_iface, global->block_size, global->block_count);
+	if (ret < 0) {
+		fprintf(stderr, "Couldn't open the packet ring on %s: %s\n",
+			global->wlan_iface, strerror(-ret));
+		return ret;
+	}
+	global->linktype = ring.linktype;
+
+	now = clock_ns(CLOCK_MONOTONIC);
+	next_print = now + global->interval * 1000000000ULL;
+	next_expire = now + EXPIRE_PERIOD_NS;
+	while (!stop) {
+		ret = ring_read(&ring, RING_POLL_MS, handle_packet, global);
+		if (ret < 0) {
+			fprintf(stderr, "Couldn't read the packet ring: %s\n", strerror(-ret));
+			break;
+		}
+
+		now = clock_ns(CLOCK_MONOTONIC);
+		if (now >= next_expire) {
+			drone_table_expire(&global->drones, clock_ns(CLOCK_REALTIME),
+					   global->expire * 1000000000ULL);
+			next_expire = now + EXPIRE_PERIOD_NS;
+		}
+
+		if (global->interval > 0 && now >= next_print) {
+			if (ring_stats(&ring, &stats) == 0) {
+				global->ring_packets += stats.tp_packets;
+				global->ring_drops += stats.tp_drops;
+			}
+			print_drones(global, clock_ns(CLOCK_REALTIME));
+			next_print += global->interval * 1000000000ULL;
+		}
+	}
+
+	if (ring_stats(&ring, &stats) == 0) {
+		global->ring_packets += stats.tp_packets;
+		global->ring_drops += stats.tp_drops;
+	}
+	ring_close(&ring);
+	print_drones(global, clock_ns(CLOCK_REALTIME));
+
+	return ret < 0 ? ret : 0;
+}
+
+/**
+ * scan_file - run the frames of a capture file through the scanner
+ * @global: global state
+ *
+ * Without a Wi-Fi card, for testing and for measuring the packet rate the
+ * scanner sustains. The drones are printed once at the end, aged by the time
+ * of the last packet.
+ */
+static int scan_file(struct global *global)
+{
+	struct pcap_reader reader;
+	struct pcap_packet packet;
+	uint64_t last = 0;
+	uint64_t start;
+	double seconds;
+	int ret = 0;
+	int loop;
+
+	ret = pcap_reader_open(&reader, global->pcap_path);
+	if (ret < 0) {
+		fprintf(stderr, "Couldn't read %s: %s\n", global->pcap_path, strerror(-ret));
+		return ret;
+	}
+	/* pcapng files may have other interfaces, their packets are counted as malformed */
+	if (reader.format == PCAP_FORMAT_PCAP &&
+	    reader.linktype != LINKTYPE_IEEE802_11 &&
+	    reader.linktype != LINKTYPE_IEEE802_11_RADIOTAP) {
+		fprintf(stderr, "%s: link type %u is not 802.11\n", global->pcap_path,
+			reader.linktype);
+		pcap_reader_close(&reader);
+		return -EPROTONOSUPPORT;
+	}
+
+	start = clock_ns(CLOCK_MONOTONIC);
+	for (loop = 0; loop < global->loops && !stop; loop++) {
+		pcap_reader_rewind(&reader);
+		while ((ret = pcap_reader_next(&reader, &packet)) > 0) {
+			global->linktype = packet.linktype;
+			handle_packet(global, packet.data, packet.len, packet.timestamp);
+			last = packet.timestamp;
+		}
+		if (ret < 0) {
+			fprintf(stderr, "%s: truncated or malformed record\n", global->pcap_path);
+			break;
+		}
+	}
+	seconds = (clock_ns(CLOCK_MONOTONIC) - start) / 1e9;
+	pcap_reader_close(&reader);
+
+	print_drones(global, last);
+	printf("%.3f s, %.0f packets/s\n", seconds,
+	       seconds > 0 ? global->packets / seconds : 0);
+
+	return ret;
+}
+
+int main(int argc, char *argv[])
+{
+	struct global global;
+	int ret;
+
+	memset(&global, 0, sizeof(global));
+
+	if (read_arguments(argc, argv, &global) < 0) {
+		usage(argv[0]);
+		return -1;
+	}
+
+	ret = drone_table_init(&global.drones, global.table_size);
+	if (ret < 0) {
+		fprintf(stderr, "%s: Couldn't allocate the drone table\n", argv[0]);
+		return -1;
+	}
+
+	signal(SIGINT, handle_signal);
+	signal(SIGTERM, handle_signal);
+
+	if (global.pcap_path)
+		ret = scan_file(&global);
+	else
+		ret = scan_interface(&global);
+
+	drone_table_free(&global.drones);
+
+	return ret < 0 ? -1 : 0;
+}
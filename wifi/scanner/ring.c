@@ -0,0 +1,239 @@
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <linux/filter.h>
+#include <linux/if_arp.h>
+#include <linux/if_ether.h>
+
+#include "capture.h"
+#include "ring.h"
+
+#define BPF_INSN(code, jt, jf, k) ((struct sock_filter){ (code), (jt), (jf), (k) })
+
+/**
+ * ring_attach_filter - let only public action frames into the ring
+ * @ring: ring with the link type set
+ *
+ * NAN service discovery frames are public action frames (category 4) with the
+ * vendor specific action (9). Everything else, beacons and data frames on a
+ * busy channel, is dropped in the kernel before it takes space in the ring.
+ */
+static int ring_attach_filter(struct ring *ring)
+{
+	struct sock_filter code[16];
+	struct sock_fprog prog;
+	unsigned int n = 0;
+
+	if (ring->linktype == LINKTYPE_IEEE802_11_RADIOTAP) {
+		/* X = little endian it_len, the length of the radiotap header */
+		code[n++] = BPF_INSN(BPF_LD | BPF_B | BPF_ABS, 0, 0, 3);
+		code[n++] = BPF_INSN(BPF_ALU | BPF_LSH | BPF_K, 0, 0, 8);
+		code[n++] = BPF_INSN(BPF_MISC | BPF_TAX, 0, 0, 0);
+		code[n++] = BPF_INSN(BPF_LD | BPF_B | BPF_ABS, 0, 0, 2);
+		code[n++] = BPF_INSN(BPF_ALU | BPF_OR | BPF_X, 0, 0, 0);
+		code[n++] = BPF_INSN(BPF_MISC | BPF_TAX, 0, 0, 0);
+	} else {
+		code[n++] = BPF_INSN(BPF_LDX | BPF_W | BPF_IMM, 0, 0, 0);
+	}
+	/* frame control: management frame of subtype action */
+	code[n++] = BPF_INSN(BPF_LD | BPF_B | BPF_IND, 0, 0, 0);
+	code[n++] = BPF_INSN(BPF_ALU | BPF_AND | BPF_K, 0, 0, 0xfc);
+	code[n++] = BPF_INSN(BPF_JMP | BPF_JEQ | BPF_K, 0, 5, 0xd0);
+	/* category and action after the 24 byte header */
+	code[n++] = BPF_INSN(BPF_LD | BPF_B | BPF_IND, 0, 0, 24);
+	code[n++] = BPF_INSN(BPF_JMP | BPF_JEQ | BPF_K, 0, 3, 0x04);
+	code[n++] = BPF_INSN(BPF_LD | BPF_B | BPF_IND, 0, 0, 25);
+	code[n++] = BPF_INSN(BPF_JMP | BPF_JEQ | BPF_K, 0, 1, 0x09);
+	code[n++] = BPF_INSN(BPF_RET | BPF_K, 0, 0, 0xffff);
+	code[n++] = BPF_INSN(BPF_RET | BPF_K, 0, 0, 0);
+
+	prog.len = n;
+	prog.filter = code;
+	if (setsockopt(ring->fd, SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)) < 0)
+		return -errno;
+
+	return 0;
+}
+
+/**
+ * ring_open - open a packet socket with a receive ring on a monitor interface
+ * @ring: ring to initialize
+ * @iface: monitor interface, with radiotap headers or plain 802.11 frames
+ * @block_size: size of each block, a multiple of the page size
+ * @block_count: number of blocks
+ *
+ * The socket is bound to the interface only after the filter and the ring are
+ * set up, so no other packets get in.
+ *
+ * Return: 0 on success, negative errno on failure, -EPROTONOSUPPORT if the
+ * interface is not a monitor interface
+ */
+int ring_open(struct ring *ring, const char *iface, unsigned int block_size,
+	      unsigned int block_count)
+{
+	int version = TPACKET_V3;
+	struct tpacket_req3 req;
+	struct sockaddr_ll sll;
+	struct ifreq ifr;
+	void *map;
+	int ifindex;
+	int ret;
+
+	memset(ring, 0, sizeof(*ring));
+	ring->fd = -1;
+
+	if (block_count == 0 || block_size < RING_FRAME_SIZE ||
+	    block_size % getpagesize() != 0)
+		return -EINVAL;
+
+	/* protocol 0: nothing is received before bind() */
+	ring->fd = socket(AF_PACKET, SOCK_RAW, 0);
+	if (ring->fd < 0)
+		return -errno;
+
+	memset(&ifr, 0, sizeof(ifr));
+	strncpy(ifr.ifr_name, iface, sizeof(ifr.ifr_name) - 1);
+	if (ioctl(ring->fd, SIOCGIFINDEX, &ifr) < 0)
+		goto err_errno;
+	ifindex = ifr.ifr_ifindex;
+
+	if (ioctl(ring->fd, SIOCGIFHWADDR, &ifr) < 0)
+		goto err_errno;
+	switch (ifr.ifr_hwaddr.sa_family) {
+	case ARPHRD_IEEE80211_RADIOTAP:
+		ring->linktype = LINKTYPE_IEEE802_11_RADIOTAP;
+		break;
+	case ARPHRD_IEEE80211:
+		ring->linktype = LINKTYPE_IEEE802_11;
+		break;
+	default:
+		ret = -EPROTONOSUPPORT;
+		goto err;
+	}
+
+	ret = ring_attach_filter(ring);
+	if (ret < 0)
+		goto err;
+
+	if (setsockopt(ring->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0)
+		goto err_errno;
+
+	memset(&req, 0, sizeof(req));
+	req.tp_block_size = block_size;
+	req.tp_block_nr = block_count;
+	req.tp_frame_size = RING_FRAME_SIZE;
+	req.tp_frame_nr = block_size / RING_FRAME_SIZE * block_count;
+	req.tp_retire_blk_tov = RING_BLOCK_TIMEOUT_MS;
+	if (setsockopt(ring->fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0)
+		goto err_errno;
+
+	ring->map_size = (size_t)block_size * block_count;
+	map = mmap(NULL, ring->map_size, PROT_READ | PROT_WRITE,
+		   MAP_SHARED | MAP_POPULATE, ring->fd, 0);
+	if (map == MAP_FAILED)
+		goto err_errno;
+	ring->map = map;
+	ring->block_size = block_size;
+	ring->block_count = block_count;
+
+	memset(&sll, 0, sizeof(sll));
+	sll.sll_family = AF_PACKET;
+	sll.sll_protocol = htons(ETH_P_ALL);
+	sll.sll_ifindex = ifindex;
+	if (bind(ring->fd, (struct sockaddr *)&sll, sizeof(sll)) < 0)
+		goto err_errno;
+
+	return 0;
+
+err_errno:
+	ret = -errno;
+err:
+	ring_close(ring);
+	return ret;
+}
+
+/**
+ * ring_read - hand the packets of the next block to a handler
+ * @ring: ring
+ * @timeout_ms: maximum time to wait for a block, -1 to wait forever
+ * @handler: called for each packet, in order
+ * @user: argument of @handler
+ *
+ * The packets stay in the ring while @handler runs. The block is given back to
+ * the kernel afterwards.
+ *
+ * Return: number of packets in the block, 0 if no block was ready before the
+ * timeout or a signal, negative errno on failure
+ */
+int ring_read(struct ring *ring, int timeout_ms, ring_handler handler, void *user)
+{
+	struct tpacket_block_desc *block;
+	struct tpacket3_hdr *hdr;
+	struct pollfd pfd;
+	unsigned int count, i;
+
+	block = (struct tpacket_block_desc *)(ring->map + (size_t)ring->current * ring->block_size);
+
+	if (!(__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+		pfd.fd = ring->fd;
+		pfd.events = POLLIN | POLLERR;
+		pfd.revents = 0;
+		if (poll(&pfd, 1, timeout_ms) < 0)
+			return errno == EINTR ? 0 : -errno;
+		if (pfd.revents & POLLERR)
+			return -EIO;
+		if (!(__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER))
+			return 0;
+	}
+
+	count = block->hdr.bh1.num_pkts;
+	hdr = (struct tpacket3_hdr *)((uint8_t *)block + block->hdr.bh1.offset_to_first_pkt);
+	for (i = 0; i < count; i++) {
+		handler(user, (uint8_t *)hdr + hdr->tp_mac, hdr->tp_snaplen,
+			hdr->tp_sec * 1000000000ULL + hdr->tp_nsec);
+		hdr = (struct tpacket3_hdr *)((uint8_t *)hdr + hdr->tp_next_offset);
+	}
+
+	__atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+	ring->current = (ring->current + 1) % ring->block_count;
+
+	return count;
+}
+
+/**
+ * ring_stats - read and reset the packet and drop counters of the socket
+ * @ring: ring
+ * @stats: output
+ *
+ * Return: 0 on success, negative errno on failure
+ */
+int ring_stats(struct ring *ring, struct tpacket_stats_v3 *stats)
+{
+	socklen_t len = sizeof(*stats);
+
+	if (getsockopt(ring->fd, SOL_PACKET, PACKET_STATISTICS, stats, &len) < 0)
+		return -errno;
+
+	return 0;
+}
+
+/**
+ * ring_close - unmap the ring and close the socket
+ * @ring: ring
+ */
+void ring_close(struct ring *ring)
+{
+	if (ring->map)
+		munmap(ring->map, ring->map_size);
+	ring->map = NULL;
+	if (ring->fd >= 0)
+		close(ring->fd);
+	ring->fd = -1;
+}
@@ -0,0 +1,45 @@
+#ifndef _RING_H_
+#define _RING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <linux/if_packet.h>
+
+#define RING_DEFAULT_BLOCK_SIZE		(1 << 20)
+#define RING_DEFAULT_BLOCK_COUNT	16
+#define RING_FRAME_SIZE			2048
+#define RING_BLOCK_TIMEOUT_MS		50
+
+/**
+ * ring_handler - called for each packet of a block
+ * @user: argument of ring_read()
+ * @data: captured packet, in the ring
+ * @len: length of the captured packet
+ * @timestamp: receive time in nanoseconds since the epoch
+ */
+typedef void (*ring_handler)(void *user, const uint8_t *data, size_t len,
+			     uint64_t timestamp);
+
+/*
+ * TPACKET_V3 receive ring of an AF_PACKET socket. The kernel fills blocks of
+ * packets in the mapped memory and hands a block over when it is full or the
+ * block timeout expires, so there is one poll() per block rather than a
+ * recvmsg() and a copy per packet.
+ */
+struct ring {
+	int fd;
+	uint8_t *map;
+	size_t map_size;
+	unsigned int block_size;
+	unsigned int block_count;
+	unsigned int current;	/* next block to read */
+	uint32_t linktype;	/* of the captured packets */
+};
+
+int ring_open(struct ring *ring, const char *iface, unsigned int block_size,
+	      unsigned int block_count);
+int ring_read(struct ring *ring, int timeout_ms, ring_handler handler, void *user);
+int ring_stats(struct ring *ring, struct tpacket_stats_v3 *stats);
+void ring_close(struct ring *ring);
+
+#endif /* _RING_H_ */
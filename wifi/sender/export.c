@@ -0,0 +1,266 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "export.h"
+
+static int export_open_file(struct export *exp)
+{
+	exp->fp = fopen(exp->path, "a");
+	if (!exp->fp)
+		return -errno;
+
+	if (fseek(exp->fp, 0, SEEK_END) == 0 && ftell(exp->fp) > 0)
+		exp->file_size = ftell(exp->fp);
+	else
+		exp->file_size = 0;
+
+	return 0;
+}
+
+/**
+ * export_rotate - move the current file out of the way and start a new one
+ * @exp: export context
+ *
+ * path.N-1 becomes path.N and so on, the current file becomes path.1. The
+ * oldest file is overwritten.
+ */
+static int export_rotate(struct export *exp)
+{
+	char from[sizeof(exp->path) + 16];
+	char to[sizeof(exp->path) + 16];
+	int i;
+
+	if (exp->fp) {
+		fclose(exp->fp);
+		exp->fp = NULL;
+	}
+
+	for (i = exp->rotate_count - 1; i >= 1; i--) {
+		snprintf(from, sizeof(from), "%s.%d", exp->path, i);
+		snprintf(to, sizeof(to), "%s.%d", exp->path, i + 1);
+		if (rename(from, to) < 0 && errno != ENOENT)
+			return -errno;
+	}
+
+	if (exp->rotate_count > 0) {
+		snprintf(to, sizeof(to), "%s.1", exp->path);
+		if (rename(exp->path, to) < 0 && errno != ENOENT)
+			return -errno;
+	} else if (unlink(exp->path) < 0 && errno != ENOENT) {
+		return -errno;
+	}
+
+	return export_open_file(exp);
+}
+
+/**
+ * export_write_buffer - write a full buffer of complete lines to the file
+ * @exp: export context
+ * @buf: lines to write
+ * @len: length of the lines
+ *
+ * Runs on the export thread, without the lock.
+ */
+static int export_write_buffer(struct export *exp, const char *buf, size_t len)
+{
+	int ret;
+
+	if (exp->rotate_size && exp->file_size > 0 &&
+	    exp->file_size + len > exp->rotate_size) {
+		ret = export_rotate(exp);
+		if (ret < 0)
+			return ret;
+	}
+
+	/* reopen after an earlier failure */
+	if (!exp->fp) {
+		ret = export_open_file(exp);
+		if (ret < 0)
+			return ret;
+	}
+
+	if (fwrite(buf, 1, len, exp->fp) != len || fflush(exp->fp) != 0) {
+		ret = -errno;
+		fclose(exp->fp);
+		exp->fp = NULL;
+		return ret ? ret : -EIO;
+	}
+	exp->file_size += len;
+
+	return 0;
+}
+
+static void *export_thread(void *arg)
+{
+	struct export *exp = arg;
+	struct timespec deadline;
+	const char *buf;
+	size_t len;
+	int stop = 0;
+	int ret;
+
+	pthread_mutex_lock(&exp->lock);
+	while (!stop) {
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		deadline.tv_sec += exp->flush_ms / 1000;
+		deadline.tv_nsec += (exp->flush_ms % 1000) * 1000000L;
+		if (deadline.tv_nsec >= 1000000000L) {
+			deadline.tv_sec++;
+			deadline.tv_nsec -= 1000000000L;
+		}
+
+		while (!exp->stop && !exp->full) {
+			if (pthread_cond_timedwait(&exp->wake, &exp->lock, &deadline) == ETIMEDOUT)
+				break;
+		}
+		stop = exp->stop;
+
+		/* swap the buffers, export_write() continues in the other one */
+		buf = exp->active.Buffer;
+		len = exp->active.Length;
+		exp->active_index ^= 1;
+		odid_json_init(&exp->active, exp->buffers[exp->active_index],
+			       exp->buffer_size, NULL, NULL);
+		exp->full = 0;
+		pthread_mutex_unlock(&exp->lock);
+
+		ret = len > 0 ? export_write_buffer(exp, buf, len) : 0;
+
+		pthread_mutex_lock(&exp->lock);
+		if (ret < 0)
+			exp->io_errors++;
+	}
+	pthread_mutex_unlock(&exp->lock);
+
+	return NULL;
+}
+
+/**
+ * export_open - open an NDJSON file and start the export thread
+ * @exp: export context to initialize
+ * @path: file to append to
+ * @buffer_size: size of each of the two buffers, at least ODID_JSON_MAX_SIZE
+ * @flush_ms: maximum time a line waits in a buffer
+ * @rotate_size: rotate the file before it grows past this size, 0 to never rotate
+ * @rotate_count: number of rotated files to keep
+ *
+ * Return: 0 on success, negative errno on failure
+ */
+int export_open(struct export *exp, const char *path, size_t buffer_size,
+		int flush_ms, size_t rotate_size, int rotate_count)
+{
+	pthread_condattr_t attr;
+	int ret;
+
+	memset(exp, 0, sizeof(*exp));
+
+	if (strlen(path) >= sizeof(exp->path) || buffer_size < ODID_JSON_MAX_SIZE ||
+	    flush_ms <= 0 || rotate_count < 0)
+		return -EINVAL;
+
+	strcpy(exp->path, path);
+	exp->buffer_size = buffer_size;
+	exp->flush_ms = flush_ms;
+	exp->rotate_size = rotate_size;
+	exp->rotate_count = rotate_count;
+
+	exp->buffers[0] = malloc(buffer_size);
+	exp->buffers[1] = malloc(buffer_size);
+	if (!exp->buffers[0] || !exp->buffers[1]) {
+		ret = -ENOMEM;
+		goto err_free;
+	}
+	/* touch the pages now rather than on the frame processing thread */
+	memset(exp->buffers[0], 0, buffer_size);
+	memset(exp->buffers[1], 0, buffer_size);
+	odid_json_init(&exp->active, exp->buffers[0], buffer_size, NULL, NULL);
+
+	ret = export_open_file(exp);
+	if (ret < 0)
+		goto err_free;
+
+	pthread_mutex_init(&exp->lock, NULL);
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&exp->wake, &attr);
+	pthread_condattr_destroy(&attr);
+
+	ret = -pthread_create(&exp->thread, NULL, export_thread, exp);
+	if (ret < 0)
+		goto err_destroy;
+
+	return 0;
+
+err_destroy:
+	pthread_cond_destroy(&exp->wake);
+	pthread_mutex_destroy(&exp->lock);
+	fclose(exp->fp);
+	exp->fp = NULL;
+err_free:
+	free(exp->buffers[0]);
+	free(exp->buffers[1]);
+	exp->buffers[0] = exp->buffers[1] = NULL;
+	return ret;
+}
+
+/**
+ * export_write - append one line with the drone data
+ * @exp: export context
+ * @drone: drone data
+ *
+ * Never waits for the file. When the active buffer fills up before the export
+ * thread has written the other one, the line is dropped and counted.
+ *
+ * Return: 0 on success, -ENOSPC if the line was dropped
+ */
+int export_write(struct export *exp, const ODID_UAS_Data *drone)
+{
+	int ret = 0;
+
+	pthread_mutex_lock(&exp->lock);
+	if (odid_json_write(&exp->active, drone, ODID_JSON_NEWLINE) == ODID_SUCCESS) {
+		exp->lines++;
+	} else {
+		exp->dropped++;
+		ret = -ENOSPC;
+	}
+
+	/* hand the buffer over before the next line might not fit */
+	if (!exp->full && exp->active.Length > exp->buffer_size - ODID_JSON_MAX_SIZE) {
+		exp->full = 1;
+		pthread_cond_signal(&exp->wake);
+	}
+	pthread_mutex_unlock(&exp->lock);
+
+	return ret;
+}
+
+/**
+ * export_close - write the remaining lines, stop the thread and close the file
+ * @exp: export context
+ *
+ * The statistics stay valid after closing.
+ */
+void export_close(struct export *exp)
+{
+	if (!exp->buffers[0])
+		return;
+
+	pthread_mutex_lock(&exp->lock);
+	exp->stop = 1;
+	pthread_cond_signal(&exp->wake);
+	pthread_mutex_unlock(&exp->lock);
+	pthread_join(exp->thread, NULL);
+
+	pthread_cond_destroy(&exp->wake);
+	pthread_mutex_destroy(&exp->lock);
+	if (exp->fp)
+		fclose(exp->fp);
+	exp->fp = NULL;
+	free(exp->buffers[0]);
+	free(exp->buffers[1]);
+	exp->buffers[0] = exp->buffers[1] = NULL;
+}
@@ -0,0 +1,53 @@
+#ifndef _EXPORT_H_
+#define _EXPORT_H_
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include <opendroneid.h>
+
+#define EXPORT_DEFAULT_BUFFER_SIZE	(256 * 1024)
+#define EXPORT_DEFAULT_FLUSH_MS		1000
+#define EXPORT_DEFAULT_ROTATE_SIZE	(64 * 1024 * 1024)
+#define EXPORT_DEFAULT_ROTATE_COUNT	5
+
+/*
+ * NDJSON export of drone data. export_write() appends a line to the active
+ * buffer and returns. A background thread swaps the buffers when the active
+ * one is full or older than the flush interval, writes the other one to the
+ * file and rotates the file when it grows past the rotate size.
+ */
+struct export {
+	char path[256];
+	size_t buffer_size;
+	size_t rotate_size;	/* 0: never rotate */
+	int rotate_count;	/* number of old files kept as path.1 .. path.N */
+	int flush_ms;
+
+	pthread_mutex_t lock;
+	pthread_cond_t wake;	/* signals the thread: buffer full or stop */
+	pthread_t thread;
+
+	ODID_Json_writer active;	/* filled by export_write() under lock */
+	char *buffers[2];
+	int active_index;
+	int full;	/* active buffer is due for writing */
+	int stop;
+
+	/* only used by the thread */
+	FILE *fp;
+	size_t file_size;
+
+	/* statistics, under lock */
+	uint64_t lines;
+	uint64_t dropped;
+	uint64_t io_errors;
+};
+
+int export_open(struct export *exp, const char *path, size_t buffer_size,
+		int flush_ms, size_t rotate_size, int rotate_count);
+int export_write(struct export *exp, const ODID_UAS_Data *drone);
+void export_close(struct export *exp);
+
+#endif /* _EXPORT_H_ */
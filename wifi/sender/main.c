@@ -3,6 +3,8 @@
 #include <unistd.h>
 #include <stdlib.h>
 #include <errno.h>
+#include <signal.h>
+#include <time.h>
 
 #include <net/if.h>
 #include <sys/ioctl.h>
@@ -28,17 +30,34 @@
 
 #include <opendroneid.h>
 
+#include "capture.h"
+#include "export.h"
+
 struct global {
 	char server[1024];
 	char port[16];
 	char wlan_iface[16];
 	char mac[6];
 	uint8_t send_counter;
+	struct odid_nan_frame nan_frame;
 	int refresh_rate;
 	int test_json;
 	int set_ssid_string;
+	int flush_ms;
+	size_t rotate_size;
+	struct export sent_export;
+	struct export rcvd_export;
+	const char *dump_path;
+	struct pcap_writer dump;
 };
 
+static volatile sig_atomic_t stop;
+
+static void handle_signal(int sig)
+{
+	stop = 1;
+}
+
 void usage(char *name)
 {
 	fprintf(stderr,"%s\n", name);
@@ -48,8 +67,11 @@ void usage(char *name)
 	fprintf(stderr,"\t-i\tDrone ID (string)\n");
 	fprintf(stderr,"\t-t\tDrone type (number)\n");
 	fprintf(stderr,"\t-r\tRefresh rate of beacon sends, in seconds\n");
-	fprintf(stderr,"\t-T\tTest JSON Input/Output (debug)\n");
+	fprintf(stderr,"\t-T\tTest JSON Input/Output, appended to drone.json and rcvd_drone.json (debug)\n");
+	fprintf(stderr,"\t-F\tJSON flush interval, in milliseconds (default: %d)\n", EXPORT_DEFAULT_FLUSH_MS);
+	fprintf(stderr,"\t-R\tRotate the JSON files at this size, in bytes, 0 to never rotate (default: %d)\n", EXPORT_DEFAULT_ROTATE_SIZE);
 	fprintf(stderr,"\t-S\tadditionally set an SSID string (debug/legacy)\n");
+	fprintf(stderr,"\t-P\twrite the sent frames to a pcap file, pcapng if the name ends in .pcapng\n");
 }
 
 static int nl80211_id = -1;
@@ -130,9 +152,12 @@ int read_arguments(int argc, char *argv[], ODID_UAS_Data *drone, struct global *
 	strncpy(drone->BasicID.UASID, "1", sizeof(drone->BasicID.UASID));
 	drone->BasicID.IDType = ODID_IDTYPE_SERIAL_NUMBER;
 	drone->BasicID.UAType = ODID_UATYPE_FREE_BALLOON; /* balloon */
+	drone->BasicIDValid = 1;
 	global->refresh_rate = 1;
+	global->flush_ms = EXPORT_DEFAULT_FLUSH_MS;
+	global->rotate_size = EXPORT_DEFAULT_ROTATE_SIZE;
 
-	while((opt = getopt(argc, argv, "hp:H:i:t:r:TSw:")) != -1) {
+	while((opt = getopt(argc, argv, "hp:H:i:t:r:TSw:F:R:P:")) != -1) {
 		switch (opt) {
 		case 'h':
 			usage(argv[0]);
@@ -164,6 +189,15 @@ int read_arguments(int argc, char *argv[], ODID_UAS_Data *drone, struct global *
 		case 'S':
 			global->set_ssid_string = 1;
 			break;
+		case 'F':
+			global->flush_ms = atoi(optarg);
+			break;
+		case 'R':
+			global->rotate_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'P':
+			global->dump_path = optarg;
+			break;
 		default:
 			fprintf(stderr, "unknown option\n");
 			break;
@@ -173,10 +207,24 @@ int read_arguments(int argc, char *argv[], ODID_UAS_Data *drone, struct global *
 	return 0;
 }
 
+/**
+ * gps_value - a value from gpsd, or a default when gpsd has none
+ * @value: value from gpsd, NaN when it is not known, e.g. without a fix
+ * @unknown: value to use instead
+ */
+static double gps_value(double value, double unknown)
+{
+	return isnan(value) ? unknown : value;
+}
+
 /**
  * drone_adopt_gps_data - adopt GPS data into the drone status info
  * @gpsdata: gps data from gpsd
  * @drone: general drone status information
+ *
+ * gpsd reports the expected errors in meters, m/s and seconds, they are
+ * converted to the accuracy enums of the Location message. Values gpsd does
+ * not know are NaN and become the Unknown values of the message.
  */
 static void drone_adopt_gps_data(ODID_UAS_Data *drone,
 				 struct gps_data_t *gpsdata)
@@ -188,28 +236,33 @@ static void drone_adopt_gps_data(ODID_UAS_Data *drone,
 	*/
 	printf("\nGPS:\tmode %d\n", gpsdata->fix.mode);
 
-	/* Latitude/Longitude */
-	drone->Location.Latitude = gpsdata->fix.latitude;
-	drone->Location.Longitude = gpsdata->fix.longitude;
-	drone->Location.HorizAccuracy = gpsdata->fix.epy > gpsdata->fix.epx ? gpsdata->fix.epy : gpsdata->fix.epx;
+	drone->LocationValid = 1;
+
+	/* Latitude/Longitude, fmax() ignores an axis without an error */
+	drone->Location.Latitude = gps_value(gpsdata->fix.latitude, 0);
+	drone->Location.Longitude = gps_value(gpsdata->fix.longitude, 0);
+	drone->Location.HorizAccuracy = createEnumHorizontalAccuracy(
+		gps_value(fmax(gpsdata->fix.epx, gpsdata->fix.epy), INFINITY));
 
 	/* Altitude */
-	drone->Location.AltitudeGeo = gpsdata->fix.altitude;
-	drone->Location.VertAccuracy = gpsdata->fix.epv;
+	drone->Location.AltitudeGeo = gps_value(gpsdata->fix.altitude, -1000);
+	drone->Location.VertAccuracy = createEnumVerticalAccuracy(
+		gps_value(gpsdata->fix.epv, INFINITY));
 
 	/* Horizontal movement */
-	drone->Location.Direction = gpsdata->fix.track;
-	drone->Location.SpeedAccuracy = gpsdata->fix.eps;
-	drone->Location.SpeedHorizontal = gpsdata->fix.speed;
+	drone->Location.Direction = gps_value(gpsdata->fix.track, 361);
+	drone->Location.SpeedHorizontal = gps_value(gpsdata->fix.speed, 255);
+	drone->Location.SpeedAccuracy = createEnumSpeedAccuracy(
+		gps_value(gpsdata->fix.eps, INFINITY));
 
-	/* Vertical movement */
-	drone->Location.SpeedVertical = gpsdata->fix.climb;
-	drone->Location.SpeedAccuracy = gpsdata->fix.epc;
+	/* Vertical movement, the message has no accuracy for it */
+	drone->Location.SpeedVertical = gps_value(gpsdata->fix.climb, 63);
 
 	/* Time */
-	time_in_tenth = gpsdata->fix.time * 10;
+	time_in_tenth = gps_value(gpsdata->fix.time, 0) * 10;
 	drone->Location.TimeStamp = (float)((time_in_tenth % 36000) / 10);
-	drone->Location.TSAccuracy = (float)gpsdata->fix.ept;
+	drone->Location.TSAccuracy = createEnumTimestampAccuracy(
+		gps_value(gpsdata->fix.ept, INFINITY));
 
 	printf("drone:\n\t"
 		"TimeStamp: %f, time since last hour (100ms): %ld, TSAccuracy: %d\n\t"
@@ -247,29 +300,41 @@ static void drone_set_ssid(ODID_UAS_Data *drone, struct global *global)
 
 /**
  * drone_test_receive_data - receive and process drone information
+ * @buf: the sent frame
+ * @buf_size: length of the frame, up to a full message pack of 297 bytes
+ * @global: export of the received drones
  */
-static void drone_test_receive_data(uint8_t *buf, size_t buf_size)
+static void drone_test_receive_data(uint8_t *buf, size_t buf_size, struct global *global)
 {
 	ODID_UAS_Data rcvd;
 	char mac[6];
 	int ret;
-	FILE *fp;
-	char filename[] = "rcvd_drone.json";
-	char *drone_str;
 
+	memset(&rcvd, 0, sizeof(rcvd));
 	ret = odid_wifi_receive_message_pack_nan_action_frame(&rcvd, mac, buf, buf_size);
 	if (ret < 0)
 		return;
 
-	drone_str = drone_export_gps_data(&rcvd);
-	if (drone_str != NULL) {
-		fp = fopen(filename, "w");
-		if (fp != NULL) {
-			fputs(drone_str, fp);
-			fclose(fp);
-		}
-	}
-	free(drone_str);
+	export_write(&global->rcvd_export, &rcvd);
+}
+
+/**
+ * drone_dump_frame - add a sent frame to the capture file
+ * @global: capture file
+ * @buf: the frame, starting at the 802.11 header
+ * @len: length of the frame
+ */
+static void drone_dump_frame(struct global *global, const uint8_t *buf, size_t len)
+{
+	struct timespec ts;
+	int ret;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ret = pcap_writer_write(&global->dump, buf, len,
+				ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+	if (ret < 0)
+		fprintf(stderr, "%s: Couldn't write to %s: %d (%s)\n", __func__,
+			global->dump_path, ret, strerror(-ret));
 }
 
 /**
@@ -278,35 +343,29 @@ static void drone_test_receive_data(uint8_t *buf, size_t buf_size)
  */
 static void drone_send_data(ODID_UAS_Data *drone, struct global *global, struct nl_sock *nl_sock, int if_index)
 {
-	uint8_t frame_buf[1024];
+	uint8_t *frame_buf = global->nan_frame.buf;
 	int ret;
-	FILE *fp;
-	char filename[] = "drone.json";
-	char *drone_str;
 
 	if (global->set_ssid_string)
 		drone_set_ssid(drone, global);
 
-	if (global->test_json) {
-		drone_str = drone_export_gps_data(drone);
-		if (drone_str != NULL) {
-			fp = fopen(filename, "w");
-			if (fp != NULL) {
-				fputs(drone_str, fp);
-				fclose(fp);
-			}
-		}
-		free(drone_str);
-	}
+	if (global->test_json)
+		export_write(&global->sent_export, drone);
 
-	ret = odid_wifi_build_message_pack_nan_action_frame(drone, global->mac, global->send_counter++, frame_buf, sizeof(frame_buf));
+	/* only the location follows the GPS, the other messages stay as encoded */
+	ret = odid_wifi_update_message_pack_nan_action_frame(&global->nan_frame, drone,
+							     global->send_counter++,
+							     ODID_TYPE_BIT(ODID_MESSAGETYPE_LOCATION));
 	if (ret < 0) {
-		fprintf(stderr, "%s: odid_wifi_build_message_pack_nan_action_frame failed: %d (%s)", __func__, ret, strerror(ret));
+		fprintf(stderr, "%s: Couldn't update the NAN action frame: %d\n", __func__, ret);
 		return;
 	}
 
 	if (global->test_json)
-		drone_test_receive_data(frame_buf, (uint8_t)ret);
+		drone_test_receive_data(frame_buf, ret, global);
+
+	if (global->dump_path)
+		drone_dump_frame(global, frame_buf, ret);
 
 	ret = send_nl80211_action(nl_sock, if_index, frame_buf, ret);
 	if (ret < 0) {
@@ -364,6 +423,12 @@ int main(int argc, char *argv[])
 		return -1;
 	}
 
+	ret = odid_wifi_prepare_message_pack_nan_action_frame(&global.nan_frame, global.mac);
+	if (ret < 0) {
+		fprintf(stderr, "%s: Couldn't prepare the NAN action frame: %d\n", argv[0], ret);
+		return -1;
+	}
+
 	nl_sock = nl80211_socket_create();
 	if (!nl_sock) {
 		fprintf(stderr, "%s: Couldn't open nl80211 socket\n", argv[0]);
@@ -376,9 +441,35 @@ int main(int argc, char *argv[])
 		goto out;
 	}
 
+	if (global.test_json) {
+		ret = export_open(&global.sent_export, "drone.json", EXPORT_DEFAULT_BUFFER_SIZE,
+				  global.flush_ms, global.rotate_size, EXPORT_DEFAULT_ROTATE_COUNT);
+		if (ret == 0)
+			ret = export_open(&global.rcvd_export, "rcvd_drone.json", EXPORT_DEFAULT_BUFFER_SIZE,
+					  global.flush_ms, global.rotate_size, EXPORT_DEFAULT_ROTATE_COUNT);
+		if (ret < 0) {
+			fprintf(stderr, "%s: Couldn't open JSON export: %d (%s)\n", argv[0],
+				ret, strerror(-ret));
+			goto out;
+		}
+	}
+
+	if (global.dump_path) {
+		ret = pcap_writer_open(&global.dump, global.dump_path,
+				       pcap_path_format(global.dump_path), LINKTYPE_IEEE802_11);
+		if (ret < 0) {
+			fprintf(stderr, "%s: Couldn't create %s: %d (%s)\n", argv[0],
+				global.dump_path, ret, strerror(-ret));
+			goto out;
+		}
+	}
+
+	signal(SIGINT, handle_signal);
+	signal(SIGTERM, handle_signal);
+
 	gps_stream(&gpsdata, WATCH_ENABLE | WATCH_JSON, NULL);
 
-	while (1) {
+	while (!stop) {
 		sleep(global.refresh_rate);
 
 		/* read as much as we can using gps_read() */
@@ -399,6 +490,9 @@ int main(int argc, char *argv[])
 	gps_stream(&gpsdata, WATCH_DISABLE, NULL);
 	gps_close(&gpsdata);
 out:
+	export_close(&global.sent_export);
+	export_close(&global.rcvd_export);
+	pcap_writer_close(&global.dump);
 	nl_socket_free(nl_sock);
 
 	return 0;